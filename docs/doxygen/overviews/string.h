@@ -253,7 +253,9 @@ the entire string has to be parsed in order to find the character.
 Since iterating over a string by index is a common programming technique and
 was also possible and encouraged by wxString using the access operator[]()
 wxString implements caching of the last used index so that iterating over
-a string is a linear operation even in UTF-8 mode.
+a string is a linear operation even in UTF-8 mode. Long strings are also
+indexed when they're accessed in this way, making random access to them fast
+too.
 
 It is nonetheless recommended to use @b iterators (instead of index based
 access) like this:
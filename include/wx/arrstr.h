@@ -63,6 +63,17 @@ public:
 
     wxArrayString() { }
     wxArrayString(const wxArrayString& a) : wxArrayStringBase(a) { }
+#ifdef wxHAS_RVALUE_REF
+    wxArrayString(wxArrayString&& a) wxNOEXCEPT
+        : wxArrayStringBase(std::move(a)) { }
+
+    // we need to define the assignment operators explicitly as declaring the
+    // move ctor suppresses the implicitly generated ones
+    wxArrayString& operator=(const wxArrayString& a)
+        { wxArrayStringBase::operator=(a); return *this; }
+    wxArrayString& operator=(wxArrayString&& a) wxNOEXCEPT
+        { wxArrayStringBase::operator=(std::move(a)); return *this; }
+#endif // wxHAS_RVALUE_REF
     wxArrayString(size_t sz, const char** a);
     wxArrayString(size_t sz, const wchar_t** a);
     wxArrayString(size_t sz, const wxString* a);
@@ -172,6 +183,12 @@ public:
   wxArrayString(const wxArrayString& array);
     // assignment operator
   wxArrayString& operator=(const wxArrayString& src);
+#ifdef wxHAS_RVALUE_REF
+    // move ctor and assignment operator reuse the elements of the other array
+    // if possible, leaving it empty
+  wxArrayString(wxArrayString&& array);
+  wxArrayString& operator=(wxArrayString&& src);
+#endif // wxHAS_RVALUE_REF
     // not virtual, this class should not be derived from
  ~wxArrayString();
 
@@ -375,6 +392,7 @@ public:
 protected:
   void Init(bool autoSort);             // common part of all ctors
   void Copy(const wxArrayString& src);  // copies the contents of another array
+  void Move(wxArrayString& src);        // same, but may take them from it
 
   CompareFunction m_compareFunction;    // set only from wxSortedArrayString
 
@@ -285,6 +285,28 @@ typedef short int WXTYPE;
     #define wxOVERRIDE
 #endif /*  HAVE_OVERRIDE */
 
+/*
+    Check for rvalue references support, which is used to provide move ctors
+    and assignment operators for some classes.
+
+    Notice that we also need std::move() from the standard library, which is
+    not available with the ancient libstdc++ used under OS X < 10.7 even when
+    using C++11 compiler.
+ */
+#ifndef wxHAS_RVALUE_REF
+    #if (__cplusplus >= 201103L || wxCHECK_VISUALC_VERSION(10)) \
+            && ( (!defined __GLIBCXX__) || (__GLIBCXX__ > 20070719) )
+        #define wxHAS_RVALUE_REF
+    #endif
+#endif /* !wxHAS_RVALUE_REF */
+
+/* wxNOEXCEPT is used for the functions which are guaranteed not to throw */
+#if __cplusplus >= 201103L || wxCHECK_VISUALC_VERSION(14)
+    #define wxNOEXCEPT noexcept
+#else
+    #define wxNOEXCEPT
+#endif
+
 /* wxFALLTHROUGH is used to notate explicit fallthroughs in switch statements */
 
 #if __cplusplus >= 201703L
@@ -73,6 +73,8 @@ class WXDLLIMPEXP_FWD_BASE wxEventFilter;
 
 class WXDLLIMPEXP_FWD_BASE wxMSVC_FWD_MULTIPLE_BASES wxEvtHandler;
 class wxEventConnectionRef;
+class wxPendingEventsQueue;
+class wxDynamicEventsIndex;
 
 // ----------------------------------------------------------------------------
 // Event types
@@ -3592,6 +3594,10 @@ public:
     // buffer as other wxString objects in this thread.
     virtual void QueueEvent(wxEvent *event);
 
+    // Queue event for processing later replacing the still pending event of
+    // the same type, with the same id and key, if any, with it
+    void QueueEventCoalesced(wxEvent *event, long key = 0);
+
     // Add an event to be processed later: notice that this function is not
     // safe to call from threads other than main, use QueueEvent()
     virtual void AddPendingEvent(const wxEvent& event)
@@ -3934,7 +3940,12 @@ protected:
     typedef wxVector<wxDynamicEventTableEntry*> DynamicEvents;
     DynamicEvents* m_dynamicEvents;
 
-    wxList*             m_pendingEvents;
+    // index of m_dynamicEvents by event type, only created if there are many
+    // of them
+    wxDynamicEventsIndex* m_dynamicEventsIndex;
+
+    // events queued by QueueEvent() and not processed yet, allocated on demand
+    wxPendingEventsQueue* m_pendingEvents;
 
 #if wxUSE_THREADS
     // critical section protecting m_pendingEvents
@@ -3976,6 +3987,9 @@ private:
     // try to process events in all handlers chained to this one
     bool DoTryChain(wxEvent& event);
 
+    // common part of QueueEvent() and QueueEventCoalesced()
+    void DoQueueEvent(wxEvent *event, bool coalesce, long key);
+
     // Head of the event filter linked list.
     static wxEventFilter* ms_filterList;
 
@@ -4065,6 +4079,15 @@ inline void wxQueueEvent(wxEvtHandler *dest, wxEvent *event)
     dest->QueueEvent(event);
 }
 
+// Wrapper around wxEvtHandler::QueueEventCoalesced(), also thread-safe.
+inline void wxQueueEventCoalesced(wxEvtHandler *dest, wxEvent *event,
+                                  long key = 0)
+{
+    wxCHECK_RET( dest, "need an object to queue event for" );
+
+    dest->QueueEventCoalesced(event, key);
+}
+
 typedef void (wxEvtHandler::*wxEventFunction)(wxEvent&);
 typedef void (wxEvtHandler::*wxIdleEventFunction)(wxIdleEvent&);
 typedef void (wxEvtHandler::*wxThreadEventFunction)(wxThreadEvent&);
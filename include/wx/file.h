@@ -185,6 +185,51 @@ private:
   wxFile    m_file;     // the temporary file
 };
 
+// ----------------------------------------------------------------------------
+// class wxMappedFile: provides read-only access to the entire contents of the
+// file as a contiguous memory block. The file is mapped into memory if the OS
+// supports it, so that its data is only read from the disk when it's actually
+// accessed, and simply read into memory otherwise.
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxMappedFile
+{
+public:
+  // ctors
+    // default
+  wxMappedFile() { Init(); }
+    // maps the given file, use IsOpened() to check if this succeeded
+  wxMappedFile(const wxString& strName) { Init(); Open(strName); }
+
+  // map the given file, closing the previously opened one, if any
+  bool Open(const wxString& strName);
+  // unmap the file, invalidating any pointers returned by GetData()
+  void Close();
+
+  // is the file opened?
+  bool IsOpened() const { return m_opened; }
+  // is the file really mapped or just read into memory?
+  bool IsMapped() const { return m_mapped; }
+
+  // get the pointer to the file contents (may be NULL if it's empty)
+  const void *GetData() const { return m_data; }
+  // get the file length
+  size_t GetLength() const { return m_length; }
+
+  // dtor unmaps the file
+ ~wxMappedFile() { Close(); }
+
+private:
+  void Init();
+
+  const void *m_data;   // the file contents
+  size_t      m_length; // and its length
+  bool        m_opened, // true if Open() succeeded
+              m_mapped; // true if m_data was mapped and not allocated
+
+  wxDECLARE_NO_COPY_CLASS(wxMappedFile);
+};
+
 #endif // wxUSE_FILE
 
 #endif // _WX_FILEH__
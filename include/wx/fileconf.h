@@ -215,8 +215,13 @@ private:
   // common part of from dtor and DeleteAll
   void CleanUp();
 
-  // parse the whole file
-  void Parse(const wxTextBuffer& buffer, bool bLocal);
+  // parse the whole file contents: the text must be NUL-terminated and is
+  // modified in place, name is only used in the error messages
+  void Parse(wxChar *text, size_t len, const wxString& name,
+             bool bLocal, bool skipEmptyLines = false);
+
+  // return the text of all lines of the local file
+  wxString GetLinesText() const;
 
   // the same as SetPath("/")
   void SetRootPath();
@@ -105,6 +105,7 @@ class WXDLLIMPEXP_FWD_CORE wxDatePickerCtrl;
 #endif
 
 class wxGridFixedIndicesSet;
+class wxGridLineOffsets;
 
 class wxGridOperations;
 class wxGridRowOperations;
@@ -658,6 +659,158 @@ private:
 };
 
 
+// ----------------------------------------------------------------------------
+// wxGridBlockCoords: location of a block of cells in the grid
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxGridBlockCoords
+{
+public:
+    wxGridBlockCoords()
+        : m_topRow(-1), m_leftCol(-1), m_bottomRow(-1), m_rightCol(-1)
+    {
+    }
+
+    wxGridBlockCoords(int topRow, int leftCol, int bottomRow, int rightCol)
+        : m_topRow(topRow),
+          m_leftCol(leftCol),
+          m_bottomRow(bottomRow),
+          m_rightCol(rightCol)
+    {
+    }
+
+    // default copy ctor and assignment operator are ok
+
+    int GetTopRow() const { return m_topRow; }
+    void SetTopRow(int row) { m_topRow = row; }
+    int GetLeftCol() const { return m_leftCol; }
+    void SetLeftCol(int col) { m_leftCol = col; }
+    int GetBottomRow() const { return m_bottomRow; }
+    void SetBottomRow(int row) { m_bottomRow = row; }
+    int GetRightCol() const { return m_rightCol; }
+    void SetRightCol(int col) { m_rightCol = col; }
+
+    wxGridCellCoords GetTopLeft() const
+        { return wxGridCellCoords(m_topRow, m_leftCol); }
+    wxGridCellCoords GetBottomRight() const
+        { return wxGridCellCoords(m_bottomRow, m_rightCol); }
+
+    bool Intersects(const wxGridBlockCoords& other) const
+    {
+        return m_topRow <= other.m_bottomRow && m_bottomRow >= other.m_topRow &&
+               m_leftCol <= other.m_rightCol && m_rightCol >= other.m_leftCol;
+    }
+
+    bool Contains(const wxGridCellCoords& cell) const
+    {
+        return m_topRow <= cell.GetRow() && cell.GetRow() <= m_bottomRow &&
+               m_leftCol <= cell.GetCol() && cell.GetCol() <= m_rightCol;
+    }
+
+    bool Contains(const wxGridBlockCoords& other) const
+    {
+        return m_topRow <= other.m_topRow && other.m_bottomRow <= m_bottomRow &&
+               m_leftCol <= other.m_leftCol && other.m_rightCol <= m_rightCol;
+    }
+
+    bool operator==(const wxGridBlockCoords& other) const
+    {
+        return m_topRow == other.m_topRow && m_leftCol == other.m_leftCol &&
+               m_bottomRow == other.m_bottomRow && m_rightCol == other.m_rightCol;
+    }
+
+    bool operator!=(const wxGridBlockCoords& other) const
+    {
+        return !(*this == other);
+    }
+
+    bool operator!() const
+    {
+        return m_topRow == -1 && m_leftCol == -1 &&
+               m_bottomRow == -1 && m_rightCol == -1;
+    }
+
+private:
+    int m_topRow;
+    int m_leftCol;
+    int m_bottomRow;
+    int m_rightCol;
+};
+
+// ----------------------------------------------------------------------------
+// wxGridBlocks: a range of selected blocks returned by GetSelectedBlocks()
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxGridBlocks
+{
+public:
+    class WXDLLIMPEXP_CORE iterator
+    {
+    public:
+        typedef int difference_type;
+        typedef wxGridBlockCoords value_type;
+        typedef const wxGridBlockCoords* pointer;
+        typedef const wxGridBlockCoords& reference;
+
+// We avoid dependency on standard library by default but if we do use
+// std::string, then it's ok to use iterator tags as well.
+#if wxUSE_STD_STRING
+        typedef std::forward_iterator_tag iterator_category;
+#endif // wxUSE_STD_STRING
+
+        iterator() : m_selection(NULL), m_band(0), m_range(0) { }
+
+        reference operator*() const { return m_block; }
+        pointer operator->() const { return &m_block; }
+
+        iterator& operator++();
+        iterator operator++(int)
+        {
+            iterator tmp(*this);
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const iterator& other) const
+        {
+            return m_selection == other.m_selection &&
+                   m_band == other.m_band &&
+                   m_range == other.m_range;
+        }
+
+        bool operator!=(const iterator& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        iterator(const wxGridSelection* selection, size_t band);
+
+        // update m_block to correspond to the current position
+        void UpdateBlock();
+
+        const wxGridSelection* m_selection;
+        size_t m_band,
+               m_range;
+        wxGridBlockCoords m_block;
+
+        friend class wxGridBlocks;
+    };
+
+    iterator begin() const { return iterator(m_selection, 0); }
+    iterator end() const;
+
+private:
+    explicit wxGridBlocks(const wxGridSelection* selection)
+        : m_selection(selection)
+    {
+    }
+
+    const wxGridSelection* const m_selection;
+
+    friend class wxGrid;
+};
+
 // For comparisons...
 //
 extern WXDLLIMPEXP_CORE wxGridCellCoords wxGridNoCellCoords;
@@ -1491,6 +1644,12 @@ public:
     // and also set the grid size to just fit its contents
     void     AutoSize();
 
+    // limit the cells examined when auto-sizing a column (row) to those in the
+    // visible rows (columns) and the given number of other ones, which is
+    // much faster for big grids; 0 means to examine all of them
+    void     SetAutoSizeSampleCount( int count );
+    int      GetAutoSizeSampleCount() const { return m_autoSizeSampleCount; }
+
     // Note for both AutoSizeRowLabelSize and AutoSizeColLabelSize:
     // If col equals to wxGRID_AUTOSIZE value then function autosizes labels column
     // instead of data column. Note that this operation may be slow for large
@@ -1611,6 +1770,9 @@ public:
     wxArrayInt GetSelectedRows() const;
     wxArrayInt GetSelectedCols() const;
 
+    // get the entire selection as a range of non-overlapping blocks
+    wxGridBlocks GetSelectedBlocks() const;
+
     // This function returns the rectangle that encloses the block of cells
     // limited by TopLeft and BottomRight cell in device coords and clipped
     //  to the client size of the grid window.
@@ -1930,21 +2092,22 @@ protected:
     // NB: *never* access m_row/col arrays directly because they are created
     //     on demand, *always* use accessor functions instead!
 
-    // init the m_rowHeights/Bottoms arrays with default values
+    // init the m_rowHeights array and m_rowOffsets with default values
     void InitRowHeights();
 
     int        m_defaultRowHeight;
     int        m_minAcceptableRowHeight;
     wxArrayInt m_rowHeights;
-    wxArrayInt m_rowBottoms;
 
-    // init the m_colWidths/Rights arrays
+    // init the m_colWidths array and m_colOffsets
     void InitColWidths();
 
+    // recompute m_colOffsets from m_colWidths after the columns were changed
+    void UpdateColRights();
+
     int        m_defaultColWidth;
     int        m_minAcceptableColWidth;
     wxArrayInt m_colWidths;
-    wxArrayInt m_colRights;
 
     int m_sortCol;
     bool m_sortIsAscending;
@@ -2004,6 +2167,14 @@ protected:
     // common part of AutoSizeColumn/Row()
     void AutoSizeColOrRow(int n, bool setAsMin, wxGridDirection direction);
 
+    // fill the array with the rows (columns) to examine when auto-sizing a
+    // column (row) or leave it empty if all of them should be examined
+    void GetAutoSizeSample(wxGridDirection direction, wxArrayInt& lines) const;
+
+    // the number of lines examined by auto-sizing in addition to the visible
+    // ones or 0 to examine all of them
+    int m_autoSizeSampleCount;
+
     // Calculate the minimum acceptable size for labels area
     wxCoord CalcColOrRowLabelAreaMinSize(wxGridDirection direction);
 
@@ -2372,6 +2543,12 @@ private:
     wxGridFixedIndicesSet *m_setFixedRows,
                           *m_setFixedCols;
 
+    // the positions of the ends of the rows and columns, i.e. the bottom of
+    // each row and the right side of each column, empty if all of them use
+    // the default size
+    wxGridLineOffsets *m_rowOffsets,
+                      *m_colOffsets;
+
     wxDECLARE_DYNAMIC_CLASS(wxGrid);
     wxDECLARE_EVENT_TABLE();
     wxDECLARE_NO_COPY_CLASS(wxGrid);
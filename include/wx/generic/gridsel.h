@@ -16,16 +16,18 @@
 #if wxUSE_GRID
 
 #include "wx/grid.h"
+#include "wx/vector.h"
 
 class WXDLLIMPEXP_CORE wxGridSelection
 {
 public:
     wxGridSelection(wxGrid *grid,
                     wxGrid::wxGridSelectionModes sel = wxGrid::wxGridSelectCells);
+    ~wxGridSelection();
 
-    bool IsSelection();
-    bool IsInSelection(int row, int col);
-    bool IsInSelection(const wxGridCellCoords& coords)
+    bool IsSelection() const { return !m_bands.empty(); }
+    bool IsInSelection(int row, int col) const;
+    bool IsInSelection(const wxGridCellCoords& coords) const
     {
         return IsInSelection(coords.GetRow(), coords.GetCol());
     }
@@ -71,42 +73,114 @@ public:
     void UpdateRows( size_t pos, int numRows );
     void UpdateCols( size_t pos, int numCols );
 
+    // These functions return the selection in the old format, using the
+    // separate arrays for cells, blocks, rows and columns.
+    wxGridCellCoordsArray GetCellSelection() const;
+    wxGridCellCoordsArray GetBlockSelectionTopLeft() const;
+    wxGridCellCoordsArray GetBlockSelectionBottomRight() const;
+    wxArrayInt GetRowSelection() const;
+    wxArrayInt GetColSelection() const;
+
 private:
-    int BlockContain( int topRow1, int leftCol1,
-                       int bottomRow1, int rightCol1,
-                       int topRow2, int leftCol2,
-                       int bottomRow2, int rightCol2 );
-      // returns 1, if Block1 contains Block2,
-      //        -1, if Block2 contains Block1,
-      //         0, otherwise
-
-    int BlockContainsCell( int topRow, int leftCol,
-                           int bottomRow, int rightCol,
-                           int row, int col )
-      // returns 1, if Block contains Cell,
-      //         0, otherwise
+    // A range of rows or columns, both ends included.
+    struct Range
     {
-        return ( topRow <= row && row <= bottomRow &&
-                 leftCol <= col && col <= rightCol );
-    }
+        Range(int first_, int last_) : first(first_), last(last_) { }
+
+        bool operator==(const Range& other) const
+            { return first == other.first && last == other.last; }
+        bool operator!=(const Range& other) const
+            { return !(*this == other); }
 
-    void SelectBlockNoEvent(int topRow, int leftCol,
-                            int bottomRow, int rightCol)
+        int first,
+            last;
+    };
+
+    typedef wxVector<Range> Ranges;
+
+    // Consecutive rows having the same selected columns.
+    struct RowBand
     {
-        SelectBlock(topRow, leftCol, bottomRow, rightCol,
-                    wxKeyboardState(), false);
-    }
+        RowBand(int topRow_, int bottomRow_)
+            : topRow(topRow_), bottomRow(bottomRow_)
+        {
+        }
+
+        int topRow,
+            bottomRow;
+
+        // sorted, non-overlapping and non-adjacent ranges of columns
+        Ranges cols;
+    };
+
+    typedef wxVector<RowBand *> RowBands;
+
+    // Return the index of the first range ending at or after the given value.
+    static size_t FindRange(const Ranges& ranges, int n);
+
+    // Check if the given value is inside one of the ranges.
+    static bool RangesContain(const Ranges& ranges, int n);
+
+    // Add or remove the given range to/from the ranges.
+    static void AddRange(Ranges& ranges, int first, int last);
+    static void RemoveRange(Ranges& ranges, int first, int last);
+
+    // Append the range to the ranges, merging it with the last one if they
+    // are adjacent. The range must not be before the last one.
+    static void AppendRange(Ranges& ranges, int first, int last);
+
+    // Return the index of the first band ending at or after the given row.
+    size_t FindBand(int row) const;
+
+    // Append the band to the bands, merging it with the last one if they're
+    // adjacent and have the same columns or deleting it if it's empty.
+    static void AppendBand(RowBands& bands, RowBand *band);
+
+    // Replace the bands in [first, last) range with the given ones, merging
+    // them with the neighbouring bands if necessary.
+    void ReplaceBands(size_t first, size_t last, RowBands& bands);
+
+    // Delete all bands.
+    void DeleteBands();
+
+    // Add or remove the given block to/from the selection, without refreshing
+    // the grid or sending any events.
+    void DoChangeBlock(int topRow, int leftCol, int bottomRow, int rightCol,
+                       bool select);
+
+    // Check if all cells of the given block are selected.
+    bool IsBlockSelected(int topRow, int leftCol, int bottomRow, int rightCol) const;
+
+    // Check if all cells of the given row are selected.
+    bool IsRowSelected(int row) const;
+
+    // Get the rows with all their cells selected.
+    void GetFullRows(Ranges& rows, int numCols) const;
+
+    // Get the columns with all their cells selected.
+    void GetFullCols(Ranges& cols, int numRows) const;
+
+    // Refresh the given block unless the grid is frozen.
+    void RefreshBlock(int topRow, int leftCol, int bottomRow, int rightCol);
+
+    // Send wxEVT_GRID_RANGE_SELECT for the given block.
+    void SendRangeSelectEvent(int topRow, int leftCol,
+                              int bottomRow, int rightCol,
+                              bool selecting,
+                              const wxKeyboardState& kbd = wxKeyboardState());
 
-    wxGridCellCoordsArray               m_cellSelection;
-    wxGridCellCoordsArray               m_blockSelectionTopLeft;
-    wxGridCellCoordsArray               m_blockSelectionBottomRight;
-    wxArrayInt                          m_rowSelection;
-    wxArrayInt                          m_colSelection;
+    // The selection is stored as a sorted vector of non-overlapping row bands
+    // with the adjacent bands always having different selected columns. This
+    // allows to check if a cell is selected using two binary searches and all
+    // the blocks formed by a band and one of its column ranges are disjoint.
+    RowBands                            m_bands;
 
     wxGrid                              *m_grid;
     wxGrid::wxGridSelectionModes        m_selectionMode;
 
     friend class WXDLLIMPEXP_FWD_CORE wxGrid;
+    friend class wxGridBlocks;
+    friend class wxGridBlocks::iterator;
 
     wxDECLARE_NO_COPY_CLASS(wxGridSelection);
 };
@@ -15,6 +15,9 @@
 
 #if wxUSE_GRID
 
+#include "wx/hashmap.h"
+#include "wx/vector.h"
+
 // Internally used (and hence intentionally not exported) event telling wxGrid
 // to hide the currently shown editor.
 wxDECLARE_EVENT( wxEVT_GRID_HIDE_EDITOR, wxCommandEvent );
@@ -26,56 +29,6 @@ wxDECLARE_EVENT( wxEVT_GRID_HIDE_EDITOR, wxCommandEvent );
 WX_DEFINE_ARRAY_WITH_DECL_PTR(wxGridCellAttr *, wxArrayAttrs,
                                  class WXDLLIMPEXP_ADV);
 
-struct wxGridCellWithAttr
-{
-    wxGridCellWithAttr(int row, int col, wxGridCellAttr *attr_)
-        : coords(row, col), attr(attr_)
-    {
-        wxASSERT( attr );
-    }
-
-    wxGridCellWithAttr(const wxGridCellWithAttr& other)
-        : coords(other.coords),
-          attr(other.attr)
-    {
-        attr->IncRef();
-    }
-
-    wxGridCellWithAttr& operator=(const wxGridCellWithAttr& other)
-    {
-        coords = other.coords;
-        if (attr != other.attr)
-        {
-            attr->DecRef();
-            attr = other.attr;
-            attr->IncRef();
-        }
-        return *this;
-    }
-
-    void ChangeAttr(wxGridCellAttr* new_attr)
-    {
-        if (attr != new_attr)
-        {
-            // "Delete" (i.e. DecRef) the old attribute.
-            attr->DecRef();
-            attr = new_attr;
-            // Take ownership of the new attribute, i.e. no IncRef.
-        }
-    }
-
-    ~wxGridCellWithAttr()
-    {
-        attr->DecRef();
-    }
-
-    wxGridCellCoords coords;
-    wxGridCellAttr  *attr;
-};
-
-WX_DECLARE_OBJARRAY_WITH_DECL(wxGridCellWithAttr, wxGridCellWithAttrArray,
-                              class WXDLLIMPEXP_ADV);
-
 
 // ----------------------------------------------------------------------------
 // private classes
@@ -408,19 +361,59 @@ private:
 // ----------------------------------------------------------------------------
 
 // this class stores attributes set for cells
+//
+// as there can be a lot of them, they are stored sparsely: there is a bucket
+// for each row having any cell attributes, with the buckets sorted by row and
+// the attributes in each of them sorted by column, so that both finding the
+// attribute of the given cell and updating the attributes when rows are
+// inserted or deleted are fast
 class WXDLLIMPEXP_ADV wxGridCellAttrData
 {
 public:
+    wxGridCellAttrData() { }
+    ~wxGridCellAttrData();
+
     void SetAttr(wxGridCellAttr *attr, int row, int col);
     wxGridCellAttr *GetAttr(int row, int col) const;
     void UpdateAttrRows( size_t pos, int numRows );
     void UpdateAttrCols( size_t pos, int numCols );
 
 private:
-    // searches for the attr for given cell, returns wxNOT_FOUND if not found
-    int FindIndex(int row, int col) const;
+    // the attribute of a single cell, we own a reference to it
+    struct CellAttr
+    {
+        CellAttr(int col_, wxGridCellAttr *attr_) : col(col_), attr(attr_) { }
+
+        int col;
+        wxGridCellAttr *attr;
+    };
+
+    typedef wxVector<CellAttr> CellAttrs;
+
+    // the attributes of all cells in the given row
+    struct RowAttrs
+    {
+        explicit RowAttrs(int row_) : row(row_) { }
+
+        int row;
+        CellAttrs cells;
+    };
+
+    // return the index of the first bucket for a row >= row in m_rows
+    size_t FindRow(int row) const;
+
+    // return the index of the first attribute for a column >= col in cells
+    static size_t FindCol(const CellAttrs& cells, int col);
+
+    // release the attributes in the given range of cells and remove them
+    static void RemoveCells(CellAttrs& cells, size_t from, size_t to);
+
+    // remove the buckets in the given range of rows and delete them
+    void RemoveRows(size_t from, size_t to);
+
+    wxVector<RowAttrs *> m_rows;
 
-    wxGridCellWithAttrArray m_attrs;
+    wxDECLARE_NO_COPY_CLASS(wxGridCellAttrData);
 };
 
 // this class stores attributes set for rows or columns
@@ -436,6 +429,10 @@ public:
     void UpdateAttrRowsOrCols( size_t pos, int numRowsOrCols );
 
 private:
+    // return the index of the first element >= rowOrCol in m_rowsOrCols
+    size_t FindIndex(int rowOrCol) const;
+
+    // both arrays are sorted by the row or column index
     wxArrayInt m_rowsOrCols;
     wxArrayAttrs m_attrs;
 };
@@ -450,6 +447,106 @@ public:
                            m_colAttrs;
 };
 
+// this class stores the positions of the rows or columns of the grid
+//
+// the sizes of all lines are kept in their display order in a Fenwick (binary
+// indexed) tree, so that both changing the size of a single line and finding
+// the end of a line or the line at the given coordinate take O(log N) time,
+// while with the simple array of the line ends changing the size of the first
+// line required updating all the others
+class wxGridLineOffsets
+{
+public:
+    wxGridLineOffsets() { }
+
+    bool IsEmpty() const { return m_tree.empty(); }
+    int GetCount() const { return static_cast<int>(m_tree.size()); }
+
+    void Clear() { m_tree.clear(); }
+
+    // (re)initialize the tree with the given sizes, which are taken in the
+    // display order specified by the second array if it's given and not empty
+    //
+    // negative sizes correspond to the hidden lines and are counted as 0
+    void Init(const wxArrayInt& sizes, const wxArrayInt* order = NULL);
+
+    // add the given number of lines of the same size at the end
+    void Append(int count, int size);
+
+    // change the size of the line at the given display position
+    void Add(int pos, int diff);
+
+    // return the end of the line at the given display position, i.e. the
+    // total size of all lines up to and including this one
+    int GetEnd(int pos) const;
+
+    // return the display position of the line containing the given coordinate
+    // or GetCount() if it is beyond the end of the last line
+    int FindPos(int coord) const;
+
+private:
+    // the element at index i contains the sum of the sizes of the lines at
+    // positions in [i + 1 - lowbit(i + 1), i] range, where lowbit(n) is the
+    // value of the lowest bit set in n
+    wxVector<int> m_tree;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridLineOffsets);
+};
+
+// this class caches the extents of the cells text while auto-sizing the grid
+//
+// measuring the text is relatively slow and the same strings often occur in
+// many cells, so the text extents computed by wxGridCellStringRenderer are
+// remembered for each font while an object of this class exists: the cache is
+// only used for the duration of a single auto-sizing operation as the results
+// depend on the DC used, and it is emptied when it becomes too big as an
+// operation such as AutoSizeColumns() could examine a huge number of cells
+class wxGridTextExtentCache
+{
+public:
+    // make this cache the current one unless there is already another one
+    wxGridTextExtentCache();
+    ~wxGridTextExtentCache();
+
+    // return the currently active cache or NULL if none
+    static wxGridTextExtentCache *Get() { return ms_current; }
+
+    // return true and fill the size if the extent of this text is known
+    bool Find(const wxFont& font, const wxString& text, wxSize *size) const;
+
+    // remember the extent of the given text
+    void Store(const wxFont& font, const wxString& text, const wxSize& size);
+
+private:
+    // the maximal number of strings remembered by the cache
+    enum { MAX_ENTRIES = 10000 };
+
+    WX_DECLARE_STRING_HASH_MAP(wxSize, Extents);
+
+    // the extents of the strings using the given font
+    struct FontExtents
+    {
+        explicit FontExtents(const wxFont& font_) : font(font_) { }
+
+        // we keep a reference to the font to ensure that the identity of its
+        // data, which is used for finding it, doesn't change
+        wxFont font;
+        Extents extents;
+    };
+
+    // return the extents for the given font or NULL if none
+    FontExtents *FindFont(const wxFont& font) const;
+
+    wxVector<FontExtents *> m_fonts;
+
+    // the total number of strings in all m_fonts elements
+    size_t m_count;
+
+    static wxGridTextExtentCache *ms_current;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridTextExtentCache);
+};
+
 // ----------------------------------------------------------------------------
 // operations classes abstracting the difference between operating on rows and
 // columns
@@ -526,8 +623,8 @@ public:
     // Get the height/width of the given row/column
     virtual int GetLineSize(const wxGrid *grid, int line) const = 0;
 
-    // Get wxGrid::m_rowBottoms/m_colRights array
-    virtual const wxArrayInt& GetLineEnds(const wxGrid *grid) const = 0;
+    // Get wxGrid::m_rowOffsets/m_colOffsets object
+    virtual const wxGridLineOffsets& GetLineOffsets(const wxGrid *grid) const = 0;
 
     // Get default height row height or column width
     virtual int GetDefaultLineSize(const wxGrid *grid) const = 0;
@@ -610,8 +707,8 @@ public:
         { return grid->GetRowBottom(line); }
     virtual int GetLineSize(const wxGrid *grid, int line) const wxOVERRIDE
         { return grid->GetRowHeight(line); }
-    virtual const wxArrayInt& GetLineEnds(const wxGrid *grid) const wxOVERRIDE
-        { return grid->m_rowBottoms; }
+    virtual const wxGridLineOffsets& GetLineOffsets(const wxGrid *grid) const wxOVERRIDE
+        { return *grid->m_rowOffsets; }
     virtual int GetDefaultLineSize(const wxGrid *grid) const wxOVERRIDE
         { return grid->GetDefaultRowSize(); }
     virtual int GetMinimalAcceptableLineSize(const wxGrid *grid) const wxOVERRIDE
@@ -676,8 +773,8 @@ public:
         { return grid->GetColRight(line); }
     virtual int GetLineSize(const wxGrid *grid, int line) const wxOVERRIDE
         { return grid->GetColWidth(line); }
-    virtual const wxArrayInt& GetLineEnds(const wxGrid *grid) const wxOVERRIDE
-        { return grid->m_colRights; }
+    virtual const wxGridLineOffsets& GetLineOffsets(const wxGrid *grid) const wxOVERRIDE
+        { return *grid->m_colOffsets; }
     virtual int GetDefaultLineSize(const wxGrid *grid) const wxOVERRIDE
         { return grid->GetDefaultColSize(); }
     virtual int GetMinimalAcceptableLineSize(const wxGrid *grid) const wxOVERRIDE
@@ -70,7 +70,10 @@ enum wxImageResizeQuality
     wxIMAGE_QUALITY_NORMAL = wxIMAGE_QUALITY_NEAREST,
 
     // highest (but best) quality
-    wxIMAGE_QUALITY_HIGH = 4
+    wxIMAGE_QUALITY_HIGH = 4,
+
+    // Lanczos-3 filter, sharper than box average when reducing the size
+    wxIMAGE_QUALITY_LANCZOS = 5
 };
 
 // alpha channel values: fully transparent, default threshold separating
@@ -327,6 +330,7 @@ public:
     wxImage ResampleBox(int width, int height) const;
     wxImage ResampleBilinear(int width, int height) const;
     wxImage ResampleBicubic(int width, int height) const;
+    wxImage ResampleLanczos(int width, int height) const;
 
     // blur the image according to the specified pixel radius
     wxImage Blur(int radius) const;
@@ -424,6 +428,12 @@ public:
     void SetLoadFlags(int flags);
     int GetLoadFlags() const;
 
+    // Set the maximal number of threads used by the image processing functions
+    // such as Blur(), Rotate() or ConvertToGreyscale(): 1 (default) means to
+    // not use any additional threads and 0 means to use all available CPUs.
+    static void SetMaxProcessingThreads(int count);
+    static int GetMaxProcessingThreads();
+
     static bool CanRead( const wxString& name );
     static int GetImageCount( const wxString& name, wxBitmapType type = wxBITMAP_TYPE_ANY );
     virtual bool LoadFile( const wxString& name, wxBitmapType type = wxBITMAP_TYPE_ANY, int index = -1 );
@@ -45,12 +45,23 @@ public:
     wxStreamBuffer *GetInputStreamBuffer() const { return m_i_streambuf; }
 
 protected:
+    // this ctor is only for the derived classes, which must call
+    // InitFromData() from their own ctor
+    wxMemoryInputStream() { m_i_streambuf = NULL; m_length = 0; }
+
+    // common part of ctors taking the data: read it directly from the given
+    // memory buffer, which must remain valid while this stream is used
+    void InitFromData(const void *data, size_t length);
+
     wxStreamBuffer *m_i_streambuf;
 
     size_t OnSysRead(void *buffer, size_t nbytes) wxOVERRIDE;
     wxFileOffset OnSysSeek(wxFileOffset pos, wxSeekMode mode) wxOVERRIDE;
     wxFileOffset OnSysTell() const wxOVERRIDE;
 
+    const void *DoPeekData(size_t *size) wxOVERRIDE;
+    void DoConsume(size_t size) wxOVERRIDE;
+
 private:
     // common part of ctors taking wxInputStream
     void InitFromStream(wxInputStream& stream, wxFileOffset lenFile);
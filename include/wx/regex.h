@@ -68,6 +68,7 @@ enum
 // ----------------------------------------------------------------------------
 
 class WXDLLIMPEXP_FWD_BASE wxRegExImpl;
+class WXDLLIMPEXP_FWD_BASE wxRegExIteratorImpl;
 
 class WXDLLIMPEXP_BASE wxRegEx
 {
@@ -97,8 +98,7 @@ public:
     //
     // may only be called after successful call to Compile()
     bool Matches(const wxString& text, int flags = 0) const;
-    bool Matches(const wxChar *text, int flags, size_t len) const
-        { return Matches(wxString(text, len), flags); }
+    bool Matches(const wxChar *text, int flags, size_t len) const;
 
     // get the start index and the length of the match of the expression
     // (index 0) or a bracketed subexpression (index != 0)
@@ -142,6 +142,10 @@ public:
     int ReplaceAll(wxString *text, const wxString& replacement) const
         { return Replace(text, replacement, 0); }
 
+    // set the maximal number of compiled expressions kept in the process-wide
+    // cache shared by all wxRegEx objects, 0 disables caching entirely
+    static void SetCacheSize(size_t size);
+
     // dtor not virtual, don't derive from this class
     ~wxRegEx();
 
@@ -156,6 +160,42 @@ private:
     // instances of the handle wxRegEx must not be copied.
     wxRegEx(const wxRegEx&);
     wxRegEx &operator=(const wxRegEx&);
+
+    friend class wxRegExIterator;
+};
+
+// ----------------------------------------------------------------------------
+// wxRegExIterator: finds all matches of a regular expression in a string
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxRegExIterator
+{
+public:
+    // the regex must be valid and compiled without wxRE_NOSUB, the text is
+    // converted to the format used by the regex library only once here
+    //
+    // flags may be combination of wxRE_NOTBOL and wxRE_NOTEOL and apply to
+    // the text as a whole
+    wxRegExIterator(const wxRegEx& re, const wxString& text, int flags = 0);
+    ~wxRegExIterator();
+
+    // find the next match after the previous one, return false if there are
+    // no more of them
+    bool FindNext();
+
+    // get the start index (in the entire text) and the length of the match
+    // of the expression (index 0) or a bracketed subexpression (index != 0)
+    //
+    // may only be called after FindNext() returned true
+    bool GetMatch(size_t *start, size_t *len, size_t index = 0) const;
+
+    // return the part of the text corresponding to the match
+    wxString GetMatch(size_t index = 0) const;
+
+private:
+    wxRegExIteratorImpl *m_impl;
+
+    wxDECLARE_NO_COPY_CLASS(wxRegExIterator);
 };
 
 #endif // wxUSE_REGEX
@@ -186,6 +186,26 @@ public:
     virtual wxFileOffset TellI() const;
 
 
+    // zero-copy read functions
+    // ------------------------
+
+    // return the pointer to the next chunk of data in the stream without
+    // copying it and fill in its size, blocking until something appears in
+    // the stream if necessary, or return NULL if there is no more data
+    //
+    // the data is not removed from the stream and the returned pointer
+    // remains valid only until the next call to any other function of this
+    // stream, except Consume() which must be used to skip over the data
+    // actually used by the caller
+    const void *PeekData(size_t *size);
+
+    // skip the given number of bytes, which can't be greater than the size
+    // returned by the last call to PeekData()
+    //
+    // LastRead() returns the number of bytes consumed after calling this
+    void Consume(size_t size);
+
+
     // stream-like operators
     // ---------------------
 
@@ -200,6 +220,15 @@ protected:
     // read
     virtual size_t OnSysRead(void *buffer, size_t size) = 0;
 
+    // implementation of PeekData() and Consume() which may be overridden by
+    // the streams having their data in memory to give direct access to it
+    //
+    // the default implementation reads the next chunk of data (or just a
+    // single byte for non-seekable streams) into the write back buffer and
+    // returns it from there, which avoids copying it again in the caller
+    virtual const void *DoPeekData(size_t *size);
+    virtual void DoConsume(size_t size);
+
     // write-back buffer support
     // -------------------------
 
@@ -484,6 +513,13 @@ public:
     bool FillBuffer();
     size_t GetDataLeft();
 
+    // Zero-copy access to the buffer contents: return the pointer to the data
+    // available for reading, filling the buffer first if necessary, and its
+    // size, or NULL if there is no more data. Consume() must be called to
+    // advance the current position past the data which was actually used.
+    const void *PeekData(size_t *size);
+    void Consume(size_t size);
+
     // misc accessors
     wxStreamBase *GetStream() const { return m_stream; }
     bool HasBuffer() const { return m_buffer_start != m_buffer_end; }
@@ -578,6 +614,9 @@ protected:
     virtual wxFileOffset OnSysSeek(wxFileOffset seek, wxSeekMode mode) wxOVERRIDE;
     virtual wxFileOffset OnSysTell() const wxOVERRIDE;
 
+    virtual const void *DoPeekData(size_t *size) wxOVERRIDE;
+    virtual void DoConsume(size_t size) wxOVERRIDE;
+
     wxStreamBuffer *m_i_streambuf;
 
     wxDECLARE_NO_COPY_CLASS(wxBufferedInputStream);
@@ -41,6 +41,10 @@
 #include "wx/stringops.h"
 #include "wx/unichar.h"
 
+#ifdef wxHAS_RVALUE_REF
+    #include <utility>      // for std::move()
+#endif
+
 // by default we cache the mapping of the positions in UTF-8 string to the byte
 // offset as this results in noticeable performance improvements for loops over
 // strings using indices; comment out this line to disable this
@@ -73,6 +77,18 @@
     #endif
 #endif // wxUSE_STRING_POS_CACHE
 
+// in addition to the cache above, which only helps with sequential access, long
+// UTF-8 strings also get a sparse index of the byte offsets of every 64th
+// character (or just a flag indicating that they contain ASCII only) built on
+// demand, making random access to them fast too; the index is stored in the
+// same thread-local cache, so it can only be used if the cache is, and, as
+// with the cache, change this to 0 to disable it
+#if wxUSE_STRING_POS_CACHE
+    #define wxUSE_STRING_POS_INDEX 1
+#else
+    #define wxUSE_STRING_POS_INDEX 0
+#endif
+
 class WXDLLIMPEXP_FWD_BASE wxString;
 
 // unless this symbol is predefined to disable the compatibility functions, do
@@ -379,6 +395,7 @@ private:
   // translates position index in wxString to/from index in underlying
   // wxStringImpl:
   static size_t PosToImpl(size_t pos) { return pos; }
+  static size_t PosToImplIndexed(size_t pos) { return pos; }
   static void PosLenToImpl(size_t pos, size_t len,
                            size_t *implPos, size_t *implLen)
     { *implPos = pos; *implLen = len; }
@@ -407,6 +424,80 @@ private:
   static SubstrBufFromWC ImplStr(const wchar_t* str, size_t n)
     { return ConvertStr(str, n, wxMBConvUTF8()); }
 
+#if wxUSE_STRING_POS_INDEX
+  // sparse index of the positions in a long string: it remembers the offset
+  // in m_impl of every STEP-th character, so that finding the offset of any
+  // character never requires scanning more than STEP characters, or, for the
+  // (common) case of strings containing only ASCII characters, just that the
+  // offsets are the same as positions
+  //
+  // the index is built by PosToImplIndexed() and stored in the cache element
+  // of the string, so that it's never shared between threads and doesn't take
+  // any space in the string object itself, and discarded as soon as the string
+  // is modified in any way or its cache element is reused for another string
+  //
+  // NB: just as Cache below, this struct must be a POD
+  struct PosIndex
+  {
+      enum
+      {
+          STEP = 64,        // distance between the indexed characters
+          MIN_LEN = 1024    // strings shorter than this (in bytes) are not
+                            // indexed as scanning them is fast enough
+      };
+
+      enum State
+      {
+          State_None,       // no index (yet)
+          State_ASCII,      // the string is pure ASCII, offsets == positions
+          State_Offsets     // offsets contains the indexed offsets
+      };
+
+      // free the index, if any
+      void Reset()
+      {
+          if ( state != State_None )
+          {
+              free(offsets);
+              offsets = NULL;
+              state = State_None;
+          }
+      }
+
+      size_t *offsets;      // offsets of characters 0, STEP, 2*STEP, ...
+      size_t count;         // number of elements in offsets
+      size_t len;           // length of the string, in characters
+      State state;
+  };
+
+  // find the offset of the character at the given position using the index,
+  // return false if the string is not indexed
+  bool IndexedPosToImpl(const PosIndex& index, size_t pos, size_t *impl) const
+  {
+      switch ( index.state )
+      {
+          case PosIndex::State_None:
+              return false;
+
+          case PosIndex::State_ASCII:
+              *impl = pos;
+              return true;
+
+          case PosIndex::State_Offsets:
+              *impl = DoIndexedPosToImpl(index, pos);
+              return true;
+      }
+
+      return false;
+  }
+
+  size_t DoIndexedPosToImpl(const PosIndex& index, size_t pos) const;
+  size_t DoIndexedPosFromImpl(const PosIndex& index, size_t impl) const;
+
+  // create the index for this string
+  void BuildPosIndex(PosIndex& index) const;
+#endif // wxUSE_STRING_POS_INDEX
+
 #if wxUSE_STRING_POS_CACHE
   // this is an extremely simple cache used by PosToImpl(): each cache element
   // contains the string it applies to and the index corresponding to the last
@@ -427,11 +518,24 @@ private:
                  impl,          // the corresponding position in its m_impl
                  len;           // cached length or npos if unknown
 
+#if wxUSE_STRING_POS_INDEX
+          PosIndex index;       // index of this string if it's long enough
+#endif // wxUSE_STRING_POS_INDEX
+
           // reset cached index to 0
           void ResetPos() { pos = impl = 0; }
 
+          // reset length and anything else depending on the string contents
+          void ResetLen()
+          {
+              len = npos;
+#if wxUSE_STRING_POS_INDEX
+              index.Reset();
+#endif // wxUSE_STRING_POS_INDEX
+          }
+
           // reset position and length
-          void Reset() { ResetPos(); len = npos; }
+          void Reset() { ResetPos(); ResetLen(); }
       };
 
       // cache the indices mapping for the last few string used
@@ -478,6 +582,15 @@ private:
   // callable from a debugger, to show the cache contents
   friend struct wxStrCacheDumper;
 
+#if wxUSE_STRING_POS_INDEX
+  // free the indices stored in the cache of the current thread, this must be
+  // done when the thread terminates as they would be leaked otherwise
+  static void FreeCacheIndices();
+
+  friend struct wxStrCacheCleaner;
+  friend class wxThreadSpecificInfo;
+#endif // wxUSE_STRING_POS_INDEX
+
   // uncomment this to have access to some profiling statistics on program
   // termination
   //#define wxPROFILE_STRING_CACHE
@@ -595,6 +708,22 @@ private:
       if ( pos == cache->pos )
           return cache->impl;
 
+#if wxUSE_STRING_POS_INDEX
+      // scanning forward from the cached position is the fastest way to deal
+      // with sequential access, but use the index when jumping around
+      if ( pos < cache->pos || pos - cache->pos > PosIndex::STEP )
+      {
+          size_t impl;
+          if ( IndexedPosToImpl(cache->index, pos, &impl) )
+          {
+              cache->pos = pos;
+              cache->impl = impl;
+
+              return impl;
+          }
+      }
+#endif // wxUSE_STRING_POS_INDEX
+
       // this seems to happen only rarely so just reset the cache in this case
       // instead of complicating code even further by seeking backwards in this
       // case
@@ -632,7 +761,7 @@ private:
   {
       Cache::Element * const cache = FindCacheElement();
       if ( cache )
-          cache->len = npos;
+          cache->ResetLen();
   }
 
   void SetCachedLength(size_t len)
@@ -641,7 +770,9 @@ private:
       // present in the cache before, this seems to do no harm and the
       // potential for avoiding length recomputation for long strings looks
       // interesting
-      GetCacheElement()->len = len;
+      Cache::Element * const cache = GetCacheElement();
+      cache->ResetLen();
+      cache->len = len;
   }
 
   void UpdateCachedLength(ptrdiff_t delta)
@@ -651,6 +782,9 @@ private:
       {
           wxSTRING_CACHE_ASSERT( (ptrdiff_t)cache->len + delta >= 0 );
 
+#if wxUSE_STRING_POS_INDEX
+          cache->index.Reset();
+#endif // wxUSE_STRING_POS_INDEX
           cache->len += delta;
       }
   }
@@ -676,6 +810,30 @@ private:
       return pos == 0 || pos == npos ? pos : DoPosToImpl(pos);
   }
 
+  // same as PosToImpl() but also indexes the string if it's long enough and
+  // wasn't indexed yet: notice that this can't be used by the functions
+  // modifying the string (after invalidating the cache) as the index would be
+  // left out of date by their changes
+  size_t PosToImplIndexed(size_t pos) const
+  {
+#if wxUSE_STRING_POS_INDEX
+      if ( m_impl.length() >= PosIndex::MIN_LEN )
+      {
+          Cache::Element * const cache = GetCacheElement();
+          if ( cache->index.state == PosIndex::State_None )
+          {
+              BuildPosIndex(cache->index);
+
+              // the index gives us the length for free
+              if ( cache->index.state != PosIndex::State_None )
+                  cache->len = cache->index.len;
+          }
+      }
+#endif // wxUSE_STRING_POS_INDEX
+
+      return PosToImpl(pos);
+  }
+
   void PosLenToImpl(size_t pos, size_t len, size_t *implPos, size_t *implLen) const;
 
   size_t LenToImpl(size_t len) const
@@ -689,8 +847,26 @@ private:
   {
       if ( pos == 0 || pos == npos )
           return pos;
-      else
-          return const_iterator(this, m_impl.begin() + pos) - begin();
+
+#if wxUSE_STRING_POS_INDEX
+      const Cache::Element * const cache = FindCacheElement();
+      if ( cache )
+      {
+          switch ( cache->index.state )
+          {
+              case PosIndex::State_None:
+                  break;
+
+              case PosIndex::State_ASCII:
+                  return pos;
+
+              case PosIndex::State_Offsets:
+                  return DoIndexedPosFromImpl(cache->index, pos);
+          }
+      }
+#endif // wxUSE_STRING_POS_INDEX
+
+      return const_iterator(this, m_impl.begin() + pos) - begin();
   }
 #endif // !wxUSE_UNICODE_UTF8/wxUSE_UNICODE_UTF8
 
@@ -900,9 +1076,9 @@ public:
   };
 
   iterator GetIterForNthChar(size_t n)
-    { return iterator(this, m_impl.begin() + PosToImpl(n)); }
+    { return iterator(this, m_impl.begin() + PosToImplIndexed(n)); }
   const_iterator GetIterForNthChar(size_t n) const
-    { return const_iterator(this, m_impl.begin() + PosToImpl(n)); }
+    { return const_iterator(this, m_impl.begin() + PosToImplIndexed(n)); }
 #else // !wxUSE_UNICODE_UTF8
 
   class WXDLLIMPEXP_BASE iterator
@@ -1104,6 +1280,11 @@ public:
     // copy ctor
   wxString(const wxString& stringSrc) : m_impl(stringSrc.m_impl) { }
 
+#ifdef wxHAS_RVALUE_REF
+    // move ctor: takes the contents of the other string, leaving it empty
+  wxString(wxString&& stringSrc) wxNOEXCEPT { swap(stringSrc); }
+#endif // wxHAS_RVALUE_REF
+
     // string containing nRepeat copies of ch
   wxString(wxUniChar ch, size_t nRepeat = 1 )
     { assign(nRepeat, ch); }
@@ -1414,7 +1595,7 @@ public:
   // data access (all indexes are 0 based)
     // read access
     wxUniChar at(size_t n) const
-      { return wxStringOperations::DecodeChar(m_impl.begin() + PosToImpl(n)); }
+      { return wxStringOperations::DecodeChar(m_impl.begin() + PosToImplIndexed(n)); }
     wxUniChar GetChar(size_t n) const
       { return at(n); }
     // read/write access
@@ -1817,6 +1998,19 @@ public:
     return *this;
   }
 
+#ifdef wxHAS_RVALUE_REF
+    // from a temporary string: take its contents instead of copying them
+  wxString& operator=(wxString&& stringSrc) wxNOEXCEPT
+  {
+    // use a temporary to free our old contents and leave the source empty,
+    // this also works correctly in case of self-assignment
+    wxString tmp(std::move(stringSrc));
+    swap(tmp);
+
+    return *this;
+  }
+#endif // wxHAS_RVALUE_REF
+
   wxString& operator=(const wxCStrData& cstr)
     { return *this = cstr.AsString(); }
     // from a character
@@ -3478,6 +3672,7 @@ private:
 #endif // wxUSE_UNICODE_UTF8
 
   friend class WXDLLIMPEXP_FWD_BASE wxCStrData;
+  friend class WXDLLIMPEXP_FWD_BASE wxStringBuilder;
   friend class wxStringInternalBuffer;
   friend class wxStringInternalBufferLength;
 };
@@ -3744,7 +3939,12 @@ public:
     wxStringInternalBuffer(wxString& str, size_t lenWanted = 1024)
         : wxStringTypeBufferBase<wxStringCharType>(str, lenWanted) {}
     ~wxStringInternalBuffer()
-        { m_str.m_impl.assign(m_buf.data()); }
+    {
+        m_str.m_impl.assign(m_buf.data());
+#if wxUSE_STRING_POS_CACHE
+        m_str.InvalidateCache();
+#endif // wxUSE_STRING_POS_CACHE
+    }
 
     wxDECLARE_NO_COPY_CLASS(wxStringInternalBuffer);
 };
@@ -3759,6 +3959,9 @@ public:
     ~wxStringInternalBufferLength()
     {
         m_str.m_impl.assign(m_buf.data(), m_len);
+#if wxUSE_STRING_POS_CACHE
+        m_str.InvalidateCache();
+#endif // wxUSE_STRING_POS_CACHE
     }
 
     wxDECLARE_NO_COPY_CLASS(wxStringInternalBufferLength);
@@ -3834,6 +4037,121 @@ public:
 };
 #endif // wxUSE_UNICODE_UTF8/wxUSE_UNICODE_WCHAR
 
+// ----------------------------------------------------------------------------
+// wxStringBuilder: efficiently build a string from many small pieces
+// ----------------------------------------------------------------------------
+
+// The string contents are stored in a fixed size buffer inside this object
+// itself, which is typically allocated on the stack, for as long as they fit
+// into it and memory is only allocated for longer strings. The final string
+// is then returned by Release() without any extra copying if possible.
+class WXDLLIMPEXP_BASE wxStringBuilder
+{
+public:
+    wxStringBuilder() : m_len(0), m_inBuf(true) { }
+
+    // append the given string or character
+    wxStringBuilder& Append(const wxString& str)
+        { DoAppend(str.m_impl.data(), str.m_impl.length()); return *this; }
+    wxStringBuilder& Append(const char *psz);
+#if wxUSE_UNICODE_WCHAR
+    wxStringBuilder& Append(const wchar_t *pwz)
+        { DoAppend(pwz, wxStrlen(pwz)); return *this; }
+#else
+    wxStringBuilder& Append(const wchar_t *pwz)
+        { return Append(wxString(pwz)); }
+#endif
+    wxStringBuilder& Append(wxUniChar ch);
+    wxStringBuilder& Append(wxUniCharRef ch) { return Append(wxUniChar(ch)); }
+    wxStringBuilder& Append(char ch) { return Append(wxUniChar(ch)); }
+    wxStringBuilder& Append(wchar_t ch) { return Append(wxUniChar(ch)); }
+
+    // append the decimal representation of the given number, numbers are
+    // formatted in the same way as by wxString::operator<<()
+    wxStringBuilder& Append(int n)
+        { return Append(static_cast<long>(n)); }
+    wxStringBuilder& Append(unsigned int n)
+        { return Append(static_cast<unsigned long>(n)); }
+    wxStringBuilder& Append(long n)
+    {
+        DoAppendNumber(n < 0 ? 0 - static_cast<unsigned long>(n)
+                             : static_cast<unsigned long>(n), n < 0);
+        return *this;
+    }
+    wxStringBuilder& Append(unsigned long n)
+        { DoAppendNumber(n, false); return *this; }
+#ifdef wxHAS_LONG_LONG_T_DIFFERENT_FROM_LONG
+    wxStringBuilder& Append(wxLongLong_t n)
+    {
+        DoAppendNumber(n < 0 ? 0 - static_cast<wxULongLong_t>(n)
+                             : static_cast<wxULongLong_t>(n), n < 0);
+        return *this;
+    }
+    wxStringBuilder& Append(wxULongLong_t n)
+        { DoAppendNumber(n, false); return *this; }
+#endif // wxHAS_LONG_LONG_T_DIFFERENT_FROM_LONG
+    wxStringBuilder& Append(float f);
+    wxStringBuilder& Append(double d);
+
+    // stream-like synonym for Append()
+    template <typename T>
+    wxStringBuilder& operator<<(const T& value) { return Append(value); }
+
+    // reserve space for a string of the given length
+    void Reserve(size_t len);
+
+    // return true if nothing was appended yet
+    bool IsEmpty() const { return m_inBuf ? m_len == 0 : m_str.empty(); }
+
+    // clear the contents
+    void Clear() { m_len = 0; m_inBuf = true; m_str.clear(); }
+
+    // return a copy of the string
+    wxString ToString() const;
+
+    // return the string and clear this object, this is more efficient than
+    // ToString() as the string contents don't need to be copied if they
+    // had been already allocated on the heap
+    wxString Release();
+
+private:
+    // the size of the internal buffer, in code units
+    enum { BUF_LEN = 256 };
+
+    void DoAppend(const wxStringCharType *p, size_t len)
+    {
+        if ( m_inBuf && len <= BUF_LEN - m_len )
+        {
+            memcpy(m_buf + m_len, p, len*sizeof(wxStringCharType));
+            m_len += len;
+        }
+        else
+        {
+            DoAppendToString(p, len);
+        }
+    }
+
+    // slow part of DoAppend(), called when the internal buffer is too small
+    void DoAppendToString(const wxStringCharType *p, size_t len);
+
+    void DoAppendNumber(unsigned long n, bool negative);
+#ifdef wxHAS_LONG_LONG_T_DIFFERENT_FROM_LONG
+    void DoAppendNumber(wxULongLong_t n, bool negative);
+#endif
+
+
+    // the contents if m_inBuf is true
+    wxStringCharType m_buf[BUF_LEN];
+    size_t m_len;
+
+    // the contents if m_inBuf is false
+    wxString m_str;
+
+    bool m_inBuf;
+
+    wxDECLARE_NO_COPY_CLASS(wxStringBuilder);
+};
+
 
 // ---------------------------------------------------------------------------
 // wxString comparison functions: operator versions are always case sensitive
@@ -3897,6 +4215,32 @@ inline wxString operator+(const wxString& string, const wxScopedCharBuffer& buf)
 inline wxString operator+(const wxScopedCharBuffer& buf, const wxString& string)
     { return (const char *)buf + string; }
 
+#ifdef wxHAS_RVALUE_REF
+// If the left hand side is a temporary, we can just append to it instead of
+// creating a new string, which avoids reallocating the string for every part
+// of long "s1 + s2 + ... + sN" expressions. All the overloads taking a const
+// reference to wxString as the first argument must have their counterparts
+// here to avoid ambiguities.
+inline wxString operator+(wxString&& string1, const wxString& string2)
+    { string1 += string2; return std::move(string1); }
+inline wxString operator+(wxString&& string, const char *psz)
+    { string += psz; return std::move(string); }
+inline wxString operator+(wxString&& string, const wchar_t *pwz)
+    { string += pwz; return std::move(string); }
+inline wxString operator+(wxString&& string, wxUniChar ch)
+    { string += ch; return std::move(string); }
+inline wxString operator+(wxString&& string, wxUniCharRef ch)
+    { string += ch; return std::move(string); }
+inline wxString operator+(wxString&& string, char ch)
+    { string += ch; return std::move(string); }
+inline wxString operator+(wxString&& string, wchar_t ch)
+    { string += ch; return std::move(string); }
+inline wxString operator+(wxString&& string, const wxScopedWCharBuffer& buf)
+    { string += buf; return std::move(string); }
+inline wxString operator+(wxString&& string, const wxScopedCharBuffer& buf)
+    { string += buf; return std::move(string); }
+#endif // wxHAS_RVALUE_REF
+
 // comparison with char
 inline bool operator==(const wxUniChar& c, const wxString& s) { return s.IsSameAs(c); }
 inline bool operator==(const wxUniCharRef& c, const wxString& s) { return s.IsSameAs(c); }
@@ -63,6 +63,8 @@ class WXDLLIMPEXP_FWD_BASE wxLocale;
 class wxPluralFormsCalculator;
 wxDECLARE_SCOPED_PTR(wxPluralFormsCalculator, wxPluralFormsCalculatorPtr)
 
+class wxMsgCatalogFile;
+
 // ----------------------------------------------------------------------------
 // wxMsgCatalog corresponds to one loaded message catalog.
 // ----------------------------------------------------------------------------
@@ -70,16 +72,25 @@ wxDECLARE_SCOPED_PTR(wxPluralFormsCalculator, wxPluralFormsCalculatorPtr)
 class WXDLLIMPEXP_BASE wxMsgCatalog
 {
 public:
+    // flags for CreateFromFile()
+    enum
+    {
+        Load_Default = 0,
+
+        // map the file into memory and translate the messages only when
+        // they're requested instead of doing it for all of them when loading
+        Load_OnDemand = 1
+    };
+
     // Ctor is protected, because CreateFromXXX functions must be used,
     // but destruction should be unrestricted
-#if !wxUSE_UNICODE
     ~wxMsgCatalog();
-#endif
 
     // load the catalog from disk or from data; caller is responsible for
     // deleting them if not NULL
     static wxMsgCatalog *CreateFromFile(const wxString& filename,
-                                        const wxString& domain);
+                                        const wxString& domain,
+                                        int flags = Load_Default);
 
     static wxMsgCatalog *CreateFromData(const wxScopedCharBuffer& data,
                                         const wxString& domain);
@@ -92,7 +103,7 @@ public:
 
 protected:
     wxMsgCatalog(const wxString& domain)
-        : m_pNext(NULL), m_domain(domain)
+        : m_pNext(NULL), m_domain(domain), m_file(NULL)
 #if !wxUSE_UNICODE
         , m_conv(NULL)
 #endif
@@ -106,6 +117,10 @@ private:
     wxStringToStringHashMap m_messages; // all messages in the catalog
     wxString                m_domain;   // name of the domain
 
+    // the file from which the messages are loaded on demand or NULL if they
+    // were all loaded into m_messages when the catalog was created
+    wxMsgCatalogFile       *m_file;
+
 #if !wxUSE_UNICODE
     // the conversion corresponding to this catalog charset if we installed it
     // as the global one
@@ -222,12 +237,25 @@ class WXDLLIMPEXP_BASE wxFileTranslationsLoader
     : public wxTranslationsLoader
 {
 public:
+    wxFileTranslationsLoader() : m_loadFlags(wxMsgCatalog::Load_Default) { }
+
     static void AddCatalogLookupPathPrefix(const wxString& prefix);
 
+    // load the messages from the catalog files only when they're needed
+    void SetLoadOnDemand(bool onDemand = true)
+    {
+        m_loadFlags = onDemand ? wxMsgCatalog::Load_OnDemand
+                               : wxMsgCatalog::Load_Default;
+    }
+
     virtual wxMsgCatalog *LoadCatalog(const wxString& domain,
                                       const wxString& lang) wxOVERRIDE;
 
     virtual wxArrayString GetAvailableTranslations(const wxString& domain) const wxOVERRIDE;
+
+private:
+    // flags passed to wxMsgCatalog::CreateFromFile()
+    int m_loadFlags;
 };
 
 
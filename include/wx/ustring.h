@@ -629,6 +629,12 @@ inline wxUString operator+(const char *s1, const wxUString &s2)
     { return wxUString(s1) + s2; }
 inline wxUString operator+(const wxString &s1, const wxUString &s2)
     { return wxUString(s1) + s2; }
+#ifdef wxHAS_RVALUE_REF
+// This overload is needed to avoid ambiguity with operator+(wxString&&, const
+// wxString&) defined in wx/string.h.
+inline wxUString operator+(wxString &&s1, const wxUString &s2)
+    { return wxUString(s1) + s2; }
+#endif // wxHAS_RVALUE_REF
 inline wxUString operator+(const wxCStrData *s1, const wxUString &s2)
     { return wxUString(s1) + s2; }
 inline wxUString operator+(const wxChar16* s1, const wxUString &s2)
@@ -18,6 +18,7 @@
 #include "wx/object.h"
 #include "wx/string.h"
 #include "wx/stream.h"
+#include "wx/mstream.h"
 #include "wx/file.h"
 #include "wx/ffile.h"
 
@@ -150,6 +151,29 @@ private:
     wxDECLARE_NO_COPY_CLASS(wxFileStream);
 };
 
+// ----------------------------------------------------------------------------
+// wxMappedFileInputStream: read-only stream using wxMappedFile
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxMappedFileInputStream : public wxMemoryInputStream
+{
+public:
+    wxMappedFileInputStream(const wxString& fileName);
+
+    virtual bool IsOk() const wxOVERRIDE;
+
+    // direct access to the entire file contents, which remain valid for as
+    // long as this stream exists
+    const void *GetData() const { return m_file.GetData(); }
+
+    const wxMappedFile& GetMappedFile() const { return m_file; }
+
+private:
+    wxMappedFile m_file;
+
+    wxDECLARE_NO_COPY_CLASS(wxMappedFileInputStream);
+};
+
 #endif //wxUSE_FILE
 
 #if wxUSE_FFILE
@@ -21,6 +21,8 @@
 #include "wx/textbuf.h"
 #include "wx/versioninfo.h"
 
+#include <new>
+
 #ifdef WXMAKINGDLL_XML
     #define WXDLLIMPEXP_XML WXEXPORT
 #elif defined(WXUSINGDLL)
@@ -33,6 +35,7 @@ class WXDLLIMPEXP_FWD_XML wxXmlNode;
 class WXDLLIMPEXP_FWD_XML wxXmlAttribute;
 class WXDLLIMPEXP_FWD_XML wxXmlDocument;
 class WXDLLIMPEXP_FWD_XML wxXmlIOHandler;
+class wxXmlArena;
 class WXDLLIMPEXP_FWD_BASE wxInputStream;
 class WXDLLIMPEXP_FWD_BASE wxOutputStream;
 
@@ -56,6 +59,13 @@ enum wxXmlNodeType
 };
 
 
+// The classes below declare their own operator new, which can't be done if
+// it's redefined as WXDEBUG_NEW by wx/object.h, so undefine it temporarily.
+#if wxUSE_DEBUG_NEW_ALWAYS && defined(new)
+    #undef new
+    #define wxXML_RESTORE_DEBUG_NEW
+#endif
+
 // Represents node property(ies).
 // Example: in <img src="hello.gif" id="3"/> "src" is property with value
 //          "hello.gif" and "id" is prop. with value "3".
@@ -63,24 +73,54 @@ enum wxXmlNodeType
 class WXDLLIMPEXP_XML wxXmlAttribute
 {
 public:
-    wxXmlAttribute() : m_next(NULL) {}
+    wxXmlAttribute() : m_internedName(NULL), m_next(NULL) {}
     wxXmlAttribute(const wxString& name, const wxString& value,
                   wxXmlAttribute *next = NULL)
-            : m_name(name), m_value(value), m_next(next) {}
+            : m_name(name), m_internedName(NULL), m_value(value), m_next(next) {}
+    wxXmlAttribute(const wxXmlAttribute& attr)
+            : m_name(attr.GetName()), m_internedName(NULL),
+              m_value(attr.m_value), m_next(attr.m_next) {}
+    wxXmlAttribute& operator=(const wxXmlAttribute& attr)
+    {
+        SetName(attr.GetName());
+        m_value = attr.m_value;
+        m_next = attr.m_next;
+        return *this;
+    }
     virtual ~wxXmlAttribute() {}
 
-    const wxString& GetName() const { return m_name; }
+    const wxString& GetName() const
+        { return m_internedName ? *m_internedName : m_name; }
     const wxString& GetValue() const { return m_value; }
     wxXmlAttribute *GetNext() const { return m_next; }
 
-    void SetName(const wxString& name) { m_name = name; }
+    void SetName(const wxString& name) { m_name = name; m_internedName = NULL; }
     void SetValue(const wxString& value) { m_value = value; }
     void SetNext(wxXmlAttribute *next) { m_next = next; }
 
+    // Attributes may be allocated in the arena of a document loaded with
+    // wxXMLDOC_USE_ARENA, so they must be always freed using these operators.
+    // All the standard forms of new are provided as they would be hidden by
+    // the class-specific ones otherwise.
+    void *operator new(size_t size);
+    void *operator new(size_t size, const std::nothrow_t&) throw();
+    void *operator new(size_t WXUNUSED(size), void *where) { return where; }
+    void operator delete(void *buf);
+    void operator delete(void *buf, const std::nothrow_t&) throw();
+    void operator delete(void *WXUNUSED(buf), void *WXUNUSED(where)) { }
+#ifdef _WX_WANT_NEW_SIZET_WXCHAR_INT
+    // used by WXDEBUG_NEW, the file name and line number are ignored
+    void *operator new(size_t size, const wxChar *fileName, int lineNum);
+    void operator delete(void *buf, const wxChar *fileName, int lineNum);
+#endif
+
 private:
     wxString m_name;
+    const wxString *m_internedName; // name stored in the arena, if non-NULL
     wxString m_value;
     wxXmlAttribute *m_next;
+
+    friend class wxXmlArena;
 };
 
 #if WXWIN_COMPATIBILITY_2_8
@@ -103,7 +143,8 @@ class WXDLLIMPEXP_XML wxXmlNode
 {
 public:
     wxXmlNode()
-        : m_attrs(NULL), m_parent(NULL), m_children(NULL), m_next(NULL),
+        : m_internedName(NULL),
+          m_attrs(NULL), m_parent(NULL), m_children(NULL), m_next(NULL),
           m_lineNo(-1), m_noConversion(false)
     {
     }
@@ -135,7 +176,8 @@ public:
 
     // access methods:
     wxXmlNodeType GetType() const { return m_type; }
-    const wxString& GetName() const { return m_name; }
+    const wxString& GetName() const
+        { return m_internedName ? *m_internedName : m_name; }
     const wxString& GetContent() const { return m_content; }
 
     bool IsWhitespaceOnly() const;
@@ -161,7 +203,7 @@ public:
     int GetLineNumber() const { return m_lineNo; }
 
     void SetType(wxXmlNodeType type) { m_type = type; }
-    void SetName(const wxString& name) { m_name = name; }
+    void SetName(const wxString& name) { m_name = name; m_internedName = NULL; }
     void SetContent(const wxString& con) { m_content = con; }
 
     void SetParent(wxXmlNode *parent) { m_parent = parent; }
@@ -175,6 +217,22 @@ public:
     bool GetNoConversion() const { return m_noConversion; }
     void SetNoConversion(bool noconversion) { m_noConversion = noconversion; }
 
+    // Nodes may be allocated in the arena of a document loaded with
+    // wxXMLDOC_USE_ARENA, so they must be always freed using these operators.
+    // All the standard forms of new are provided as they would be hidden by
+    // the class-specific ones otherwise.
+    void *operator new(size_t size);
+    void *operator new(size_t size, const std::nothrow_t&) throw();
+    void *operator new(size_t WXUNUSED(size), void *where) { return where; }
+    void operator delete(void *buf);
+    void operator delete(void *buf, const std::nothrow_t&) throw();
+    void operator delete(void *WXUNUSED(buf), void *WXUNUSED(where)) { }
+#ifdef _WX_WANT_NEW_SIZET_WXCHAR_INT
+    // used by WXDEBUG_NEW, the file name and line number are ignored
+    void *operator new(size_t size, const wxChar *fileName, int lineNum);
+    void operator delete(void *buf, const wxChar *fileName, int lineNum);
+#endif
+
 #if WXWIN_COMPATIBILITY_2_8
     wxDEPRECATED( inline wxXmlAttribute *GetProperties() const );
     wxDEPRECATED( inline bool GetPropVal(const wxString& propName,
@@ -210,6 +268,7 @@ private:
 private:
     wxXmlNodeType m_type;
     wxString m_name;
+    const wxString *m_internedName; // name stored in the arena, if non-NULL
     wxString m_content;
     wxXmlAttribute *m_attrs;
     wxXmlNode *m_parent, *m_children, *m_next;
@@ -218,8 +277,15 @@ private:
 
     void DoFree();
     void DoCopy(const wxXmlNode& node);
+
+    friend class wxXmlArena;
 };
 
+#ifdef wxXML_RESTORE_DEBUG_NEW
+    #define new WXDEBUG_NEW
+    #undef wxXML_RESTORE_DEBUG_NEW
+#endif
+
 #if WXWIN_COMPATIBILITY_2_8
 inline wxXmlAttribute *wxXmlNode::GetProperties() const
     { return GetAttributes(); }
@@ -273,7 +339,8 @@ private:
 enum wxXmlDocumentLoadFlag
 {
     wxXMLDOC_NONE = 0,
-    wxXMLDOC_KEEP_WHITESPACE_NODES = 1
+    wxXMLDOC_KEEP_WHITESPACE_NODES = 1,
+    wxXMLDOC_USE_ARENA = 2
 };
 
 
@@ -359,6 +426,130 @@ private:
     wxDECLARE_CLASS(wxXmlDocument);
 };
 
+
+// This class parses XML incrementally, without building the entire tree of
+// wxXmlNode objects, and calls its virtual functions for the parsed items.
+
+struct wxXmlReaderContext;
+
+class WXDLLIMPEXP_XML wxXmlReader
+{
+public:
+    wxXmlReader() : m_ctx(NULL) { }
+    virtual ~wxXmlReader() { }
+
+    // Parses the given file or stream calling the On*() functions below.
+    // Returns false if a parsing error occurred, true if the document was
+    // parsed successfully or Stop() was called.
+    bool Parse(const wxString& filename, int flags = wxXMLDOC_NONE);
+    bool Parse(wxInputStream& stream, int flags = wxXMLDOC_NONE);
+
+    // The functions below can only be called during Parse(), i.e. from the
+    // callbacks.
+
+    // Stops parsing after the current callback returns.
+    void Stop();
+
+    // Returns the current line number and depth of the current element (1 for
+    // the root element).
+    int GetLineNumber() const;
+    int GetDepth() const;
+
+    // Access the attributes of the element in OnStartElement().
+    size_t GetAttributeCount() const;
+    wxString GetAttributeName(size_t n) const;
+    wxString GetAttributeValue(size_t n) const;
+    bool GetAttribute(const wxString& attrName, wxString *value) const;
+    wxString GetAttribute(const wxString& attrName,
+                          const wxString& defaultVal = wxEmptyString) const;
+
+    // Can be called from OnStartElement() to build the element with all its
+    // children as wxXmlNode and pass it to OnSubtree() instead of calling the
+    // other callbacks for them.
+    void ReadSubtree();
+
+protected:
+    // Callbacks called by Parse(), all of them do nothing by default.
+    virtual void OnStartElement(const wxString& WXUNUSED(name)) { }
+    virtual void OnEndElement(const wxString& WXUNUSED(name)) { }
+    virtual void OnText(const wxString& WXUNUSED(text)) { }
+    virtual void OnCData(const wxString& text) { OnText(text); }
+    virtual void OnComment(const wxString& WXUNUSED(comment)) { }
+    virtual void OnProcessingInstruction(const wxString& WXUNUSED(target),
+                                         const wxString& WXUNUSED(data)) { }
+
+    // Called with the element for which ReadSubtree() was called, takes
+    // ownership of the node which is just deleted by default.
+    virtual void OnSubtree(wxXmlNode *node) { delete node; }
+
+private:
+    wxXmlReaderContext *m_ctx;
+
+    friend struct wxXmlReaderContext;
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlReader);
+};
+
+
+// This class writes XML directly to a stream, without building the tree of
+// wxXmlNode objects first. It is also used by wxXmlDocument::Save().
+
+class wxXmlWriterImpl;
+
+class WXDLLIMPEXP_XML wxXmlWriter
+{
+public:
+    // The stream must remain valid for the lifetime of the writer. Indentation
+    // is done in the same way as by wxXmlDocument::Save().
+    explicit wxXmlWriter(wxOutputStream& stream, int indentstep = 2);
+
+    // Flushes all the data written so far, but doesn't close the elements
+    // which are still open.
+    ~wxXmlWriter();
+
+    // Change the line endings and, in ANSI build, the encoding of the strings
+    // passed to the writer. Must be called before writing anything.
+    void SetFileType(wxTextFileType fileType);
+#if !wxUSE_UNICODE
+    void SetEncoding(const wxString& enc);
+#endif
+
+    // Writes the XML declaration, which must be done first if it is written at
+    // all, and selects the encoding used for the output (UTF-8 by default).
+    bool WriteDeclaration(const wxString& version = wxS("1.0"),
+                          const wxString& encoding = wxS("UTF-8"));
+    bool WriteDoctype(const wxXmlDoctype& doctype);
+
+    // Elements must be properly nested. Attributes can only be written
+    // immediately after starting the element.
+    bool StartElement(const wxString& name);
+    bool WriteAttribute(const wxString& name, const wxString& value);
+    bool EndElement();
+
+    bool WriteText(const wxString& text);
+    bool WriteCData(const wxString& text);
+    bool WriteComment(const wxString& comment);
+    bool WriteProcessingInstruction(const wxString& target,
+                                    const wxString& data);
+
+    // Writes the node with all its children.
+    bool WriteNode(const wxXmlNode *node);
+
+    // Returns the number of currently open elements.
+    int GetDepth() const;
+
+    // Writes all the buffered data to the stream.
+    bool Flush();
+
+    // Returns false if an error occurred while writing.
+    bool IsOk() const;
+
+private:
+    wxXmlWriterImpl *m_impl;
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlWriter);
+};
+
 #endif // wxUSE_XML
 
 #endif // _WX_XML_H_
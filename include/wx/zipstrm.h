@@ -153,7 +153,7 @@ public:
     wxZipEntry& operator=(const wxZipEntry& entry);
 
     // Get accessors
-    wxDateTime   GetDateTime() const wxOVERRIDE            { return m_DateTime; }
+    wxDateTime   GetDateTime() const wxOVERRIDE;
     wxFileOffset GetSize() const wxOVERRIDE                { return m_Size; }
     wxFileOffset GetOffset() const wxOVERRIDE              { return m_Offset; }
     wxString     GetInternalName() const wxOVERRIDE        { return m_Name; }
@@ -179,7 +179,8 @@ public:
     inline bool IsMadeByUnix() const;
 
     // set accessors
-    void SetDateTime(const wxDateTime& dt) wxOVERRIDE      { m_DateTime = dt; }
+    void SetDateTime(const wxDateTime& dt) wxOVERRIDE
+        { m_DateTime = dt; m_DosDateTimePending = false; }
     void SetSize(wxFileOffset size) wxOVERRIDE             { m_Size = size; }
     void SetMethod(int method)                  { m_Method = (wxUint16)method; }
     void SetComment(const wxString& comment)    { m_Comment = comment; }
@@ -251,6 +252,11 @@ private:
 
     wxUint16 GetInternalFlags(bool checkForUTF8) const;
 
+    // the date read from the headers is only converted on demand
+    void SetDosDateTime(wxUint32 ddt)
+        { m_DosDateTime = ddt; m_DosDateTimePending = true; }
+    wxUint32 GetDosDateTime() const;
+
     wxUint8      m_SystemMadeBy;       // one of enum wxZipSystem
     wxUint8      m_VersionMadeBy;      // major * 10 + minor
 
@@ -258,6 +264,8 @@ private:
     wxUint16     m_Flags;
     wxUint16     m_Method;             // compression method (one of wxZipMethod)
     wxDateTime   m_DateTime;
+    wxUint32     m_DosDateTime;        // the date read from the archive,
+    bool         m_DosDateTimePending; // used instead of m_DateTime if true
     wxUint32     m_Crc;
     wxFileOffset m_CompressedSize;
     wxFileOffset m_Size;
@@ -324,6 +332,11 @@ public:
     void SetFormat(wxZipArchiveFormat format)   { m_format = format; }
     wxZipArchiveFormat GetFormat() const        { return m_format; }
 
+    // use up to the given number of threads for compressing the entries,
+    // 0 means to use as many threads as there are CPUs
+    void WXZIPFIX SetMaxThreads(int count);
+    int  GetMaxThreads() const                  { return m_maxThreads; }
+
 protected:
     virtual size_t WXZIPFIX OnSysWrite(const void *buffer, size_t size) wxOVERRIDE;
     virtual wxFileOffset OnSysTell() const wxOVERRIDE      { return m_entrySize; }
@@ -353,6 +366,7 @@ private:
 
     class wxStoredOutputStream *m_store;
     class wxZlibOutputStream2 *m_deflate;
+    class wxZipParallelDeflateStream *m_parallelDeflate;
     class wxZipStreamLink *m_backlink;
     wxZipEntryList_ m_entries;
     char *m_initialData;
@@ -369,6 +383,7 @@ private:
     wxString m_Comment;
     bool m_endrecWritten;
     wxZipArchiveFormat m_format;
+    int m_maxThreads;
 
     wxDECLARE_NO_COPY_CLASS(wxZipOutputStream);
 };
@@ -416,9 +431,11 @@ private:
     wxStreamError ReadLocal(bool readEndRec = false);
     wxStreamError ReadCentral();
 
-    wxUint32 ReadSignature();
+    wxUint32 ReadSignature() { return ReadSignature(*m_parent_i_stream); }
+    wxUint32 ReadSignature(wxInputStream& stream);
     bool FindEndRecord();
     bool LoadEndRecord();
+    void LoadCentralDir(wxUint64 size);
 
     bool AtHeader() const       { return m_headerSize == 0; }
     bool AfterHeader() const    { return m_headerSize > 0 && !m_decomp; }
@@ -442,6 +459,8 @@ private:
     class wxZipStreamLink *m_streamlink;
     wxFileOffset m_offsetAdjustment;
     wxFileOffset m_position;
+    class wxMemoryInputStream *m_centralDir;
+    wxFileOffset m_centralDirOffset;
     wxUint32 m_signature;
     size_t m_TotalEntries;
     wxString m_Comment;
@@ -76,6 +76,18 @@ public:
     */
     wxArrayString(const wxArrayString& array);
 
+    /**
+        Move constructor.
+
+        Takes the strings of the given array without copying them, leaving
+        it empty.
+
+        This constructor is only available when using C++11 compiler.
+
+        @since 3.1.3
+    */
+    wxArrayString(wxArrayString&& array);
+
     //@{
     /**
         Constructor from a C string array. Pass a size @a sz and an array @a arr.
@@ -250,6 +262,18 @@ public:
     */
     wxArrayString& operator=(const wxArrayString&);
 
+    /**
+        Move assignment operator.
+
+        Takes the strings of the given array without copying them if possible,
+        leaving it empty.
+
+        This operator is only available when using C++11 compiler.
+
+        @since 3.1.3
+    */
+    wxArrayString& operator=(wxArrayString&& array);
+
     /**
         Compares 2 arrays respecting the case. Returns @true only if the arrays have
         the same number of elements and the same strings in the same order.
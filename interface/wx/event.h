@@ -462,6 +462,39 @@ public:
      */
     virtual void QueueEvent(wxEvent *event);
 
+    /**
+        Queue event for a later processing, replacing a similar pending event.
+
+        This method works like QueueEvent() but if an event of the same type
+        and with the same ID, that was also queued using this method with the
+        same @a key, is still pending, i.e. hasn't been processed yet, it is
+        replaced by the new @a event instead of queuing the latter after it.
+        The new event takes the place of the old one in the queue, so it is
+        still processed before any events queued after the old one, and the
+        old event is deleted.
+
+        This is useful for the events such as progress notifications sent by
+        a worker thread, when only the latest of them matters, as it avoids
+        processing all of them in the main thread if it can't keep up with the
+        worker. The order of all the other pending events is not affected.
+
+        This method is thread-safe, just as QueueEvent(), but notice that it
+        doesn't call QueueEvent() internally, so overriding the latter
+        doesn't affect it.
+
+        @param event
+            A heap-allocated event to be queued, the function takes ownership
+            of it. This parameter shouldn't be @c NULL.
+        @param key
+            Additional value allowing to distinguish events of the same type
+            and with the same ID which must not replace each other.
+
+        @see wxQueueEventCoalesced()
+
+        @since 3.1.3
+     */
+    void QueueEventCoalesced(wxEvent *event, long key = 0);
+
     /**
         Post an event to be processed later.
 
@@ -4935,6 +4968,28 @@ void wxPostEvent(wxEvtHandler* dest, const wxEvent& event);
  */
 void wxQueueEvent(wxEvtHandler* dest, wxEvent *event);
 
+/**
+    Queue an event for processing on the given object, replacing a similar
+    pending event.
+
+    This is a wrapper around wxEvtHandler::QueueEventCoalesced(), see its
+    documentation for more details.
+
+    @header{wx/event.h}
+
+    @param dest
+        The object to queue the event on, can't be @c NULL.
+    @param event
+        The heap-allocated and non-@c NULL event to queue, the function takes
+        ownership of it.
+    @param key
+        Additional value allowing to distinguish events which must not replace
+        each other.
+
+    @since 3.1.3
+ */
+void wxQueueEventCoalesced(wxEvtHandler* dest, wxEvent *event, long key = 0);
+
 #endif // wxUSE_BASE
 
 #if wxUSE_GUI
@@ -458,3 +458,101 @@ public:
     int fd() const;
 };
 
+
+
+/**
+    @class wxMappedFile
+
+    wxMappedFile provides read-only access to the entire contents of a file as
+    a single contiguous block of memory.
+
+    If possible, i.e. under Unix and MSW, the file is mapped into the process
+    address space, so that opening it is fast even for big files and its data
+    is only read from the disk when it's actually accessed. Otherwise, or if
+    mapping this particular file fails, its contents are simply read into
+    memory. IsMapped() can be used to check which of these happened.
+
+    Note that the file should not be modified while it is mapped, as the
+    changes to it may or not be visible via the pointer returned by
+    GetData() and truncating it may even result in a crash when accessing the
+    data beyond its new end.
+
+    Example:
+    @code
+    wxMappedFile file("big.dat");
+    if ( file.IsOpened() )
+    {
+        const char* data = static_cast<const char*>(file.GetData());
+        ... use data[0]..data[file.GetLength() - 1] ...
+    }
+    @endcode
+
+    @library{wxbase}
+    @category{file}
+
+    @see wxFile, wxMappedFileInputStream
+
+    @since 3.1.3
+*/
+class wxMappedFile
+{
+public:
+    /**
+        Default constructor doesn't open any file.
+
+        Use Open() later to do it.
+    */
+    wxMappedFile();
+
+    /**
+        Constructor opening the given file.
+
+        Use IsOpened() to check if the file was successfully opened.
+    */
+    wxMappedFile(const wxString& strName);
+
+    /**
+        Destructor closes the file, invalidating the pointer returned by
+        GetData().
+    */
+    ~wxMappedFile();
+
+    /**
+        Opens the given file, closing the previously opened one, if any.
+
+        Returns @true if the file was successfully opened, even if it couldn't
+        be mapped into memory and was read into it instead.
+    */
+    bool Open(const wxString& strName);
+
+    /**
+        Closes the file.
+
+        This invalidates the pointer returned by GetData(). It is safe to
+        call this function even if the file is not opened.
+    */
+    void Close();
+
+    /**
+        Returns @true if the file was successfully opened.
+    */
+    bool IsOpened() const;
+
+    /**
+        Returns @true if the file is mapped into memory or @false if it was
+        read into it, because mapping it was impossible.
+    */
+    bool IsMapped() const;
+
+    /**
+        Returns the pointer to the file contents.
+
+        This pointer is @NULL if the file is not opened or is empty.
+    */
+    const void *GetData() const;
+
+    /**
+        Returns the length of the file data.
+    */
+    size_t GetLength() const;
+};
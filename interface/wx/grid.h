@@ -1548,6 +1548,148 @@ public:
     bool operator!() const;
 };
 
+/**
+    Represents a rectangular block of cells in the grid.
+
+    The block is given by the coordinates of its top left and bottom right
+    corners, both of which are included in it.
+
+    @since 3.1.3
+ */
+class wxGridBlockCoords
+{
+public:
+    /**
+        Default constructor initializes the object to invalid state.
+
+        All the coordinates are initially -1 and operator!() returns true for
+        an object created by this constructor.
+     */
+    wxGridBlockCoords();
+
+    /**
+        Constructor taking the coordinates of the corners of the block.
+     */
+    wxGridBlockCoords(int topRow, int leftCol, int bottomRow, int rightCol);
+
+    /// Return the row of the top left corner.
+    int GetTopRow() const;
+
+    /// Set the row of the top left corner.
+    void SetTopRow(int row);
+
+    /// Return the column of the top left corner.
+    int GetLeftCol() const;
+
+    /// Set the column of the top left corner.
+    void SetLeftCol(int col);
+
+    /// Return the row of the bottom right corner.
+    int GetBottomRow() const;
+
+    /// Set the row of the bottom right corner.
+    void SetBottomRow(int row);
+
+    /// Return the column of the bottom right corner.
+    int GetRightCol() const;
+
+    /// Set the column of the bottom right corner.
+    void SetRightCol(int col);
+
+    /**
+        Return the coordinates of the top left corner.
+     */
+    wxGridCellCoords GetTopLeft() const;
+
+    /**
+        Return the coordinates of the bottom right corner.
+     */
+    wxGridCellCoords GetBottomRight() const;
+
+    /**
+        Check whether this block has any cells in common with another one.
+     */
+    bool Intersects(const wxGridBlockCoords& other) const;
+
+    /**
+        Check whether the given cell is inside this block.
+     */
+    bool Contains(const wxGridCellCoords& cell) const;
+
+    /**
+        Check whether the given block is entirely inside this one.
+     */
+    bool Contains(const wxGridBlockCoords& other) const;
+
+    /**
+        Equality operator.
+     */
+    bool operator==(const wxGridBlockCoords& other) const;
+
+    /**
+        Inequality operator.
+     */
+    bool operator!=(const wxGridBlockCoords& other) const;
+
+    /**
+        Checks whether the coordinates are invalid.
+
+        Returns true only if all the coordinates are -1.
+     */
+    bool operator!() const;
+};
+
+/**
+    Represents the selected blocks of the grid.
+
+    Objects of this class are returned by wxGrid::GetSelectedBlocks() and
+    can only be used to iterate over the blocks, e.g.
+    @code
+    const wxGridBlocks blocks = grid->GetSelectedBlocks();
+    for ( wxGridBlocks::iterator it = blocks.begin();
+          it != blocks.end();
+          ++it )
+    {
+        const wxGridBlockCoords& block = *it;
+        ... do something with block ...
+    }
+    @endcode
+
+    Note that the iterators are invalidated by any change to the selection
+    or to the number of rows or columns of the grid.
+
+    @since 3.1.3
+ */
+class wxGridBlocks
+{
+public:
+    /**
+        Forward iterator over the selected blocks.
+
+        Dereferencing it yields a wxGridBlockCoords object.
+     */
+    class iterator
+    {
+    public:
+        iterator();
+
+        const wxGridBlockCoords& operator*() const;
+        const wxGridBlockCoords* operator->() const;
+
+        iterator& operator++();
+        iterator operator++(int);
+
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const;
+    };
+
+    /// Return the iterator pointing to the first selected block.
+    iterator begin() const;
+
+    /// Return the iterator pointing beyond the last selected block.
+    iterator end() const;
+};
+
 /**
     @class wxGridTableBase
 
@@ -3264,6 +3406,40 @@ public:
     */
     void AutoSizeRows(bool setAsMin = true);
 
+    /**
+        Limits the number of cells examined when auto-sizing.
+
+        By default, AutoSizeColumn() examines all cells of the column to find
+        the width required by the widest of them, which can take a long time
+        for a grid with many rows. After calling this function with non-zero
+        @a count, only the cells in the currently visible rows and in @a count
+        other rows, distributed over the entire grid, are examined instead.
+        The same applies to the cells examined by AutoSizeRow() and the
+        columns of the grid.
+
+        Notice that this means that the contents of some cells may not fit
+        into them after auto-sizing, but this is usually acceptable for big
+        grids in which most cells have similar contents.
+
+        @param count
+            The number of rows or columns to examine in addition to the visible
+            ones or 0 to examine all of them, which is the default.
+
+        @see GetAutoSizeSampleCount()
+
+        @since 3.1.3
+    */
+    void SetAutoSizeSampleCount(int count);
+
+    /**
+        Returns the number of rows or columns examined when auto-sizing.
+
+        @see SetAutoSizeSampleCount()
+
+        @since 3.1.3
+    */
+    int GetAutoSizeSampleCount() const;
+
     /**
         Returns @true if the cell value can overflow.
 
@@ -3973,42 +4149,78 @@ public:
     void DeselectCell( int row, int col );
 
     /**
-        Returns an array of individually selected cells.
+        Returns an array of selected cells not being part of a bigger block.
 
-        Notice that this array does @em not contain all the selected cells in
-        general as it doesn't include the cells selected as part of column, row
-        or block selection. You must use this method, GetSelectedCols(),
-        GetSelectedRows() and GetSelectionBlockTopLeft() and
-        GetSelectionBlockBottomRight() methods to obtain the entire selection
-        in general.
+        In wxGridSelectCells selection mode, this function together with
+        GetSelectionBlockTopLeft() and GetSelectionBlockBottomRight() returns
+        the selection as a set of non-overlapping blocks covering exactly the
+        selected cells: the blocks consisting of a single cell are returned by
+        this function and all the other ones by the block functions. In the
+        other selection modes, only whole rows and columns can be selected and
+        this function and the block functions return empty arrays, use
+        GetSelectedRows() and GetSelectedCols() to get the selection instead.
 
-        Please notice this behaviour is by design and is needed in order to
-        support grids of arbitrary size (when an entire column is selected in
-        a grid with a million of columns, we don't want to create an array with
-        a million of entries in this function, instead it returns an empty
-        array and GetSelectedCols() returns an array containing one element).
+        Notice that the blocks depend only on the selected cells and not on how
+        they were selected: e.g. adjacent cells selected individually may be
+        returned as a single block, overlapping blocks are split into several
+        non-overlapping ones and the rows or columns selected with SelectRow()
+        or SelectCol() are returned as blocks too. This is incompatible with
+        wxWidgets versions before 3.1.3, in which the cells, blocks, rows and
+        columns selected by the user or by the program were returned as is by
+        this function, the block functions and GetSelectedRows() and
+        GetSelectedCols() respectively.
+
+        Also notice that this function is not very efficient for big
+        selections, prefer using GetSelectedBlocks() in the new code.
     */
     wxGridCellCoordsArray GetSelectedCells() const;
 
+    /**
+        Returns the entire selection as a range of blocks.
+
+        The returned blocks never overlap and together cover exactly the
+        selected cells, including the ones selected as part of full rows or
+        columns. Unlike with GetSelectedCells() and the other functions
+        returning the selection in its historic form, it is not necessary to
+        combine the result of this function with anything else to obtain all
+        the selected cells.
+
+        Blocks are returned in the order of their top rows and, for blocks
+        starting in the same row, of their left columns.
+
+        @see wxGridBlocks
+
+        @since 3.1.3
+    */
+    wxGridBlocks GetSelectedBlocks() const;
+
     /**
         Returns an array of selected columns.
 
-        Please notice that this method alone is not sufficient to find all the
-        selected columns as it contains only the columns which were
-        individually selected but not those being part of the block selection
-        or being selected in virtue of all of their cells being selected
-        individually, please see GetSelectedCells() for more details.
+        This array contains all the columns with all their cells selected,
+        independently of how they were selected, e.g. it contains all the grid
+        columns after SelectAll(). In wxGridSelectCells mode, these columns are
+        returned by GetSelectionBlockTopLeft() and
+        GetSelectionBlockBottomRight() too, please see GetSelectedCells() for
+        more details. The columns are never returned in wxGridSelectRows mode.
+
+        Notice that, before wxWidgets 3.1.3, this array only contained the
+        columns selected with SelectCol() or by the user.
     */
     wxArrayInt GetSelectedCols() const;
 
     /**
         Returns an array of selected rows.
 
-        Please notice that this method alone is not sufficient to find all the
-        selected rows as it contains only the rows which were individually
-        selected but not those being part of the block selection or being
-        selected in virtue of all of their cells being selected individually,
-        please see GetSelectedCells() for more details.
+        This array contains all the rows with all their cells selected,
+        independently of how they were selected, e.g. it contains all the grid
+        rows after SelectAll(). In wxGridSelectCells mode, these rows are
+        returned by GetSelectionBlockTopLeft() and
+        GetSelectionBlockBottomRight() too, please see GetSelectedCells() for
+        more details. The rows are never returned in wxGridSelectColumns mode.
+
+        Notice that, before wxWidgets 3.1.3, this array only contained the
+        rows selected with SelectRow() or by the user.
     */
     wxArrayInt GetSelectedRows() const;
 
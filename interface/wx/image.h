@@ -57,7 +57,17 @@ enum wxImageResizeQuality
     image (meaning that both the new width and height will be smaller than
     the original size). Otherwise wxIMAGE_QUALITY_BICUBIC is used.
     */
-    wxIMAGE_QUALITY_HIGH
+    wxIMAGE_QUALITY_HIGH,
+
+    /**
+    Use Lanczos-3 filter. This is mostly useful for reducing the size of the
+    image, e.g. for creating thumbnails, as it preserves more details than
+    wxIMAGE_QUALITY_BOX_AVERAGE, at the cost of being somewhat slower and
+    possibly producing slight ringing artefacts near sharp edges.
+
+    @since 3.1.3
+    */
+    wxIMAGE_QUALITY_LANCZOS
 };
 
 /**
@@ -1649,6 +1659,30 @@ public:
      */
     static void SetDefaultLoadFlags(int flags);
 
+    /**
+        Sets the maximal number of threads used for processing images.
+
+        Some of the image processing functions, namely Blur(),
+        BlurHorizontal(), BlurVertical(), Rotate(), RotateHue() and
+        ConvertToGreyscale(), can split big images in several horizontal
+        bands and process them in parallel using additional threads. The
+        result is exactly the same as when using a single thread.
+
+        This setting is global and affects all subsequent calls to these
+        functions. It doesn't do anything if wxWidgets was built without
+        threads support.
+
+        @param count
+            The maximal number of threads to use, including the calling one.
+            The default value of 1 means that no additional threads are
+            created, while 0 means using as many threads as there are CPUs.
+
+        @see GetMaxProcessingThreads()
+
+        @since 3.1.3
+     */
+    static void SetMaxProcessingThreads(int count);
+
     /**
         Sets the flags used for loading image files by this object.
 
@@ -1931,6 +1965,15 @@ public:
      */
     static int GetDefaultLoadFlags();
 
+    /**
+        Returns the maximal number of threads used for processing images.
+
+        See SetMaxProcessingThreads() for more information.
+
+        @since 3.1.3
+     */
+    static int GetMaxProcessingThreads();
+
     //@{
     /**
         If the image file contains more than one image and the image handler is
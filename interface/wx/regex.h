@@ -81,6 +81,17 @@ enum
     It is possible to use the other if preferred by selecting it when building
     the wxWidgets.
 
+    Since wxWidgets 3.1.3, the compiled expressions are cached and shared by
+    all wxRegEx objects using the same expression and flags, so compiling an
+    expression which had been used recently is very fast, see SetCacheSize().
+    When using the builtin library, the text is also searched for the literal
+    prefix of the expression, if it has one, before running the full regular
+    expression matching, which makes checking for the expressions starting
+    with some fixed text much faster.
+
+    To find all the matches of an expression in a long text, use
+    wxRegExIterator.
+
     @library{wxbase}
     @category{data}
 
@@ -250,5 +261,95 @@ public:
         Replace the first occurrence.
     */
     int ReplaceFirst(wxString* text, const wxString& replacement) const;
+
+    /**
+        Set the maximal number of compiled expressions kept in the cache.
+
+        The cache is shared by all wxRegEx objects in the program and allows
+        to avoid compiling the same expression again. Its default size is 128
+        and setting it to 0 disables caching.
+
+        Notice that the expressions used by the existing wxRegEx objects remain
+        valid when they are removed from the cache.
+
+        Caching is always disabled, and this function does nothing, when using
+        the GNU regex library with @c re_search(), as it modifies the compiled
+        expressions while matching, so they can't be shared.
+
+        @since 3.1.3
+    */
+    static void SetCacheSize(size_t size);
+};
+
+/**
+    @class wxRegExIterator
+
+    Iterates over all the non-overlapping matches of a regular expression in
+    the given text.
+
+    Unlike calling wxRegEx::Matches() in a loop, this class converts the text
+    to the representation used by the regular expression library only once
+    and doesn't require creating a new string for the remaining part of the
+    text after each match. It also keeps its own matches and so doesn't
+    modify the wxRegEx object, which may be used for something else or even
+    destroyed while the iterator is used.
+
+    Example of using it:
+    @code
+    wxRegEx reEmail("([^@ ]+)@([[:alnum:].]+)");
+    wxRegExIterator it(reEmail, text);
+    while ( it.FindNext() )
+    {
+        size_t start, len;
+        it.GetMatch(&start, &len);
+        wxLogMessage("Found address of %s at %zu", it.GetMatch(1), start);
+    }
+    @endcode
+
+    @library{wxbase}
+    @category{data}
+
+    @since 3.1.3
+*/
+class wxRegExIterator
+{
+public:
+    /**
+        Create an iterator for finding the matches of @a re in @a text.
+
+        The regular expression must be valid and can't be compiled with
+        @c wxRE_NOSUB flag.
+
+        @e Flags may be combination of @c wxRE_NOTBOL and @c wxRE_NOTEOL, see
+        @ref wxRE_NOT_FLAGS, and apply to the text as a whole.
+    */
+    wxRegExIterator(const wxRegEx& re, const wxString& text, int flags = 0);
+
+    /**
+        Find the next match after the previous one.
+
+        The search starts after the end of the previous match or one character
+        after it if it was empty.
+
+        Returns @false if there are no more matches.
+    */
+    bool FindNext();
+
+    /**
+        Get the start index and the length of the last match of the expression
+        (if @a index is 0) or a bracketed subexpression (@a index different
+        from 0).
+
+        The start index is relative to the beginning of the entire text.
+
+        May only be called after FindNext() returned @true.
+    */
+    bool GetMatch(size_t* start, size_t* len, size_t index = 0) const;
+
+    /**
+        Returns the part of the text corresponding to the last match, with
+        @a index interpreted as above.
+    */
+    wxString GetMatch(size_t index = 0) const;
 };
 
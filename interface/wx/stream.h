@@ -310,6 +310,30 @@ public:
     */
     size_t GetDataLeft();
 
+    /**
+        Returns the pointer to the data available in the buffer without
+        copying it.
+
+        The buffer is filled first if it is empty. The pointer may be used to
+        access the number of bytes returned in @a size until the next call to
+        a function of this object other than Consume().
+
+        @return Pointer to the buffered data or @NULL if there is no more data.
+
+        @see wxInputStream::PeekData()
+
+        @since 3.1.3
+    */
+    const void *PeekData(size_t *size);
+
+    /**
+        Advances the current position in the buffer by the given number of
+        bytes, which can't be greater than the size returned by PeekData().
+
+        @since 3.1.3
+    */
+    void Consume(size_t size);
+
     /**
         Returns the current position (counted in bytes) in the stream buffer.
     */
@@ -619,6 +643,59 @@ public:
     */
     virtual char Peek();
 
+    /**
+        Returns the pointer to the next chunk of data in the stream without
+        copying it.
+
+        This function and Consume() allow reading the data from the stream
+        without copying it into a separate buffer, as Read() does, which is
+        more efficient when parsing the stream contents. Typical use is
+        @code
+        size_t size;
+        while ( const void* data = stream.PeekData(&size) )
+        {
+            // Examine up to size bytes of data, using n of them.
+            size_t n = Parse(static_cast<const char*>(data), size);
+            stream.Consume(n);
+        }
+        @endcode
+
+        Like Read(), this function blocks until some data appears in the
+        stream if there is none available currently.
+
+        Streams keeping their data in memory, such as wxMemoryInputStream
+        and wxBufferedInputStream, return the pointer to their data directly.
+        The other seekable streams, e.g. wxFileInputStream for a disk file,
+        read the next chunk of data into an internal buffer and return the
+        pointer to it, which is still more efficient than copying the data
+        into the caller buffer by small pieces. Non-seekable streams, such as
+        pipes or sockets, only read a single byte at a time to avoid blocking
+        while waiting for more data than is available.
+
+        @param size
+            Receives the size of the data available at the returned pointer,
+            which is always positive if the pointer is not @NULL. This
+            parameter must be non-@NULL.
+        @return
+            Pointer to the data remaining valid until the next call to any
+            function of this stream, except Consume(), or @NULL if there is
+            no more data in the stream.
+
+        @since 3.1.3
+    */
+    const void *PeekData(size_t *size);
+
+    /**
+        Skips the given number of bytes returned by PeekData().
+
+        The @a size parameter must not be greater than the size returned by
+        the last call to PeekData(). After calling this function, LastRead()
+        returns @a size.
+
+        @since 3.1.3
+    */
+    void Consume(size_t size);
+
     /**
         Reads the specified amount of bytes and stores the data in buffer.
         To check if the call was successful you must use LastRead() to check
@@ -273,6 +273,18 @@
     checking every character of a reasonably long (e.g. a couple of millions
     elements) string can take an unreasonably long time.
 
+    Since wxWidgets 3.1.3, this is mitigated for long strings (longer than 1KB)
+    by building an index for them when they're first accessed by position: for
+    strings containing only ASCII characters, accessing any character becomes
+    an O(1) operation again, while for the other ones the index stores the
+    position of every 64th character in the UTF-8 representation, so that at
+    most 64 characters need to be examined to find any of them. The index is
+    discarded when the string is modified, so it only helps with strings which
+    are accessed many times without being changed. It is kept in the same
+    per-thread cache as the last used position, so it doesn't make the string
+    objects themselves any bigger, but it's also not available on the
+    platforms where this cache is disabled, currently MSW and macOS.
+
     However, if you do use iterators, UTF-8 build can be a better choice than
     the default build, especially for the memory-constrained embedded systems.
     Notice also that GTK+ and DirectFB use UTF-8 internally, so using this
@@ -352,6 +364,18 @@ public:
     */
     wxString(const wxString& stringSrc);
 
+    /**
+       Move constructor.
+
+       Takes the contents of the given string without copying them, leaving
+       it empty.
+
+       This constructor is only available when using C++11 compiler.
+
+       @since 3.1.3
+    */
+    wxString(wxString&& stringSrc);
+
     /**
        Construct a string consisting of @a nRepeat copies of ch.
     */
@@ -445,6 +469,18 @@ public:
     */
     wxString operator =(const wxString& str);
 
+    /**
+        Move assignment operator.
+
+        Takes the contents of the given string without copying them, leaving
+        it empty.
+
+        This operator is only available when using C++11 compiler.
+
+        @since 3.1.3
+    */
+    wxString& operator=(wxString&& str);
+
     /**
         Assignment: see the relative wxString constructor.
     */
@@ -2034,6 +2070,117 @@ public:
 };
 
 
+/**
+    @class wxStringBuilder
+
+    wxStringBuilder allows to efficiently build a string from many parts.
+
+    This class stores the string being built in a fixed size buffer inside
+    the object itself, which is typically allocated on the stack, for as long
+    as it fits into it and only allocates memory on the heap for the longer
+    strings. This avoids the repeated memory allocations done when building
+    the same string using wxString::operator<<() or wxString::operator+(),
+    especially for the short strings.
+
+    Example of using it:
+    @code
+        wxStringBuilder builder;
+        for ( size_t n = 0; n < files.size(); n++ )
+            builder << n + 1 << ": " << files[n] << '\n';
+
+        wxString list = builder.Release();
+    @endcode
+
+    Notice that appending narrow strings containing non-ASCII characters
+    requires converting them and so is less efficient than appending wxString
+    or wide strings.
+
+    @library{wxbase}
+    @category{data}
+
+    @since 3.1.3
+*/
+class wxStringBuilder
+{
+public:
+    /**
+        Creates an empty string builder.
+    */
+    wxStringBuilder();
+
+    //@{
+    /**
+        Appends the given string or character.
+    */
+    wxStringBuilder& Append(const wxString& str);
+    wxStringBuilder& Append(const char* psz);
+    wxStringBuilder& Append(const wchar_t* pwz);
+    wxStringBuilder& Append(wxUniChar ch);
+    wxStringBuilder& Append(wxUniCharRef ch);
+    wxStringBuilder& Append(char ch);
+    wxStringBuilder& Append(wchar_t ch);
+    //@}
+
+    //@{
+    /**
+        Appends the given number.
+
+        The numbers are formatted in the same way as by wxString::operator<<(),
+        but the integer ones are formatted without any memory allocations.
+    */
+    wxStringBuilder& Append(int n);
+    wxStringBuilder& Append(unsigned int n);
+    wxStringBuilder& Append(long n);
+    wxStringBuilder& Append(unsigned long n);
+    wxStringBuilder& Append(wxLongLong_t n);
+    wxStringBuilder& Append(wxULongLong_t n);
+    wxStringBuilder& Append(float f);
+    wxStringBuilder& Append(double d);
+    //@}
+
+    /**
+        Stream-like synonym for Append().
+
+        Can be used with any type supported by Append().
+    */
+    template <typename T>
+    wxStringBuilder& operator<<(const T& value);
+
+    /**
+        Reserves enough space for a string of the given length.
+
+        Calling this function is not necessary, but allows to avoid the
+        reallocations if the final string length is known in advance.
+    */
+    void Reserve(size_t len);
+
+    /**
+        Returns @true if the string is empty.
+    */
+    bool IsEmpty() const;
+
+    /**
+        Makes the string empty.
+    */
+    void Clear();
+
+    /**
+        Returns a copy of the string built so far.
+
+        @see Release()
+    */
+    wxString ToString() const;
+
+    /**
+        Returns the string built so far and makes this object empty.
+
+        This is more efficient than ToString() as the string contents don't
+        need to be copied if they had been already allocated on the heap.
+    */
+    wxString Release();
+};
+
+
 /** @addtogroup group_funcmacro_string */
 //@{
 
@@ -351,6 +351,28 @@ public:
         wxTranslations::AddCatalog().
     */
     static void AddCatalogLookupPathPrefix(const wxString& prefix);
+
+    /**
+        Load the catalogs found by this loader on demand.
+
+        By default, all messages of a catalog are translated into wxString
+        objects when it is loaded. If this option is enabled, the catalog
+        files are mapped into memory instead and each message is looked up
+        in the file, using its hash table, and converted only when its
+        translation is requested for the first time.
+
+        This makes loading the catalogs much faster and uses less memory if
+        only a small part of the messages is used, which is typically the
+        case for the applications using many catalogs.
+
+        See wxMsgCatalog::Load_OnDemand for more details.
+
+        This only applies to subsequent invocations of
+        wxTranslations::AddCatalog().
+
+        @since 3.1.3
+    */
+    void SetLoadOnDemand(bool onDemand = true);
 };
 
 /**
@@ -411,17 +433,46 @@ protected:
 class wxMsgCatalog
 {
 public:
+    /**
+        Flags for CreateFromFile().
+
+        @since 3.1.3
+     */
+    enum
+    {
+        /// Translate all the messages when the catalog is loaded.
+        Load_Default = 0,
+
+        /**
+            Map the catalog file into memory and translate the messages only
+            when they are requested.
+
+            The messages are looked up using the hash table stored in the
+            file by msgfmt or, if there is none, using binary search in the
+            sorted table of messages. If the catalog contains neither of
+            them, all messages are translated when loading it, as with
+            Load_Default.
+
+            This flag is only supported in Unicode build and is ignored
+            otherwise.
+         */
+        Load_OnDemand = 1
+    };
+
     /**
         Creates catalog loaded from a MO file.
 
         @param filename  Path to the MO file to load.
         @param domain    Catalog's domain. This typically matches
                          the @a filename.
+        @param flags     Either Load_Default or Load_OnDemand, this parameter
+                         is new since wxWidgets 3.1.3.
 
         @return Successfully loaded catalog or NULL on failure.
      */
     static wxMsgCatalog *CreateFromFile(const wxString& filename,
-                                        const wxString& domain);
+                                        const wxString& domain,
+                                        int flags = Load_Default);
 
     /**
         Creates catalog from MO file data in memory buffer.
@@ -217,6 +217,59 @@ public:
 
 
 
+/**
+    @class wxMappedFileInputStream
+
+    This class provides read-only access to a file mapped into memory.
+
+    Unlike wxFileInputStream, this stream doesn't copy the file data into an
+    internal buffer but reads it directly from the memory the file is mapped
+    to, using wxMappedFile. This is especially advantageous for big files
+    containing data accessed in random order, e.g. ZIP archives, as only the
+    parts of the file which are really used are read from the disk.
+
+    As the stream is seekable and has all of its data in a contiguous memory
+    block, the code using it may also access this data directly, using either
+    GetData() or wxMemoryInputStream::GetInputStreamBuffer().
+
+    @library{wxbase}
+    @category{streams}
+
+    @see wxFileInputStream, wxMemoryInputStream
+
+    @since 3.1.3
+*/
+class wxMappedFileInputStream : public wxMemoryInputStream
+{
+public:
+    /**
+        Maps the specified file into memory.
+
+        @warning
+        You should use IsOk() to verify if the constructor succeeded.
+    */
+    wxMappedFileInputStream(const wxString& fileName);
+
+    /**
+        Returns @true if the file was successfully opened and the stream is
+        ready.
+    */
+    virtual bool IsOk() const;
+
+    /**
+        Returns the pointer to the entire contents of the file.
+
+        The returned pointer remains valid for the lifetime of this object. It
+        may be @NULL if the file couldn't be opened or is empty.
+    */
+    const void *GetData() const;
+
+    /**
+        Returns the underlying mapped file object.
+    */
+    const wxMappedFile& GetMappedFile() const;
+};
+
 /**
     @class wxFFileInputStream
 
@@ -556,7 +556,15 @@ public:
 enum wxXmlDocumentLoadFlag
 {
     wxXMLDOC_NONE,
-    wxXMLDOC_KEEP_WHITESPACE_NODES
+    wxXMLDOC_KEEP_WHITESPACE_NODES,
+
+    /**
+        Allocate all nodes and attributes of the document in a single memory
+        arena and store each distinct element and attribute name only once.
+
+        @since 3.1.3
+     */
+    wxXMLDOC_USE_ARENA
 };
 
 
@@ -840,6 +848,19 @@ public:
         less memory however makes impossible to recreate exactly the loaded text with a
         Save() call later. Read the initial description of this class for more info.
 
+        If @a flags contains wxXMLDOC_USE_ARENA, all the nodes and attributes
+        are allocated from big memory blocks instead of individually, and all
+        the elements and attributes with the same name share the same string
+        for it. This makes loading big documents faster, as well as traversing
+        and destroying them, and uses less memory. The loaded nodes can still
+        be used, modified, detached and deleted exactly as usual, however the
+        memory used by them is only freed once all nodes of the document are
+        deleted, so this flag should not be used if only a small part of a big
+        document is going to be kept after destroying the rest of it. Also
+        note that the nodes of a single document loaded in this way must not
+        be deleted from different threads concurrently. This flag is available
+        since wxWidgets 3.1.3.
+
         Returns true on success, false otherwise.
     */
     virtual bool Load(const wxString& filename,
@@ -934,3 +955,382 @@ public:
     */
     static wxVersionInfo GetLibraryVersionInfo();
 };
+
+
+
+/**
+    @class wxXmlReader
+
+    This class parses XML documents incrementally and calls its virtual
+    functions for the elements, text and other items found in the document,
+    without building the tree of wxXmlNode objects for the entire document as
+    wxXmlDocument::Load() does.
+
+    This makes it possible to process documents of any size, as the memory
+    used by the parser doesn't depend on the size of the document, and is
+    also faster than loading the document if only a part of it is needed.
+
+    To use this class, derive from it and override the callbacks for the
+    items of interest, e.g.:
+
+    @code
+    class ItemsReader : public wxXmlReader
+    {
+    protected:
+        virtual void OnStartElement(const wxString& name)
+        {
+            if ( name == "item" && GetAttribute("type") == "full" )
+                ReadSubtree();
+        }
+
+        virtual void OnSubtree(wxXmlNode* node)
+        {
+            ... use the node, it contains all the item children ...
+
+            delete node;
+        }
+    };
+
+    ItemsReader reader;
+    if ( !reader.Parse("huge.xml") )
+        ... handle the error ...
+    @endcode
+
+    Notice that, as with wxXmlDocument::Load(), the consecutive text parts
+    of the document are passed to the reader as a single string and the
+    text consisting of only whitespace is ignored by default.
+
+    @since 3.1.3
+
+    @library{wxxml}
+    @category{xml}
+
+    @see wxXmlDocument
+*/
+class wxXmlReader
+{
+public:
+    /**
+        Default constructor.
+    */
+    wxXmlReader();
+
+    /**
+        Virtual destructor.
+    */
+    virtual ~wxXmlReader();
+
+    /**
+        Parses the given file calling the callbacks for its contents.
+
+        @param filename
+            The name of the file to parse.
+        @param flags
+            Either wxXMLDOC_NONE or wxXMLDOC_KEEP_WHITESPACE_NODES to pass
+            the text consisting of whitespace only to OnText() too.
+
+        @return @false if the file couldn't be opened or a parsing error
+            occurred, @true if the document was parsed successfully or
+            Stop() was called.
+    */
+    bool Parse(const wxString& filename, int flags = wxXMLDOC_NONE);
+
+    /**
+        Parses the data from the given stream.
+
+        This is the same as the overload taking the file name, but reads the
+        document from the stream.
+    */
+    bool Parse(wxInputStream& stream, int flags = wxXMLDOC_NONE);
+
+    /**
+        Stops parsing.
+
+        This function can be called from any callback to stop parsing the
+        document after it returns. Parse() returns @true in this case.
+    */
+    void Stop();
+
+    /**
+        Returns the number of the line currently being parsed.
+
+        This function can only be called from the callbacks.
+    */
+    int GetLineNumber() const;
+
+    /**
+        Returns the depth of the current element.
+
+        The depth of the root element is 1, the depth of its children is 2
+        and so on. When called from OnStartElement() or OnEndElement(), this
+        function returns the depth of the element itself.
+
+        This function can only be called from the callbacks.
+    */
+    int GetDepth() const;
+
+    /**
+        Returns the number of attributes of the element.
+
+        This function and the other functions for accessing the attributes
+        can only be called from OnStartElement(), the attributes are only
+        converted to wxString when they are accessed.
+    */
+    size_t GetAttributeCount() const;
+
+    /**
+        Returns the name of the attribute with the given index.
+
+        @a n must be less than GetAttributeCount().
+    */
+    wxString GetAttributeName(size_t n) const;
+
+    /**
+        Returns the value of the attribute with the given index.
+
+        @a n must be less than GetAttributeCount().
+    */
+    wxString GetAttributeValue(size_t n) const;
+
+    /**
+        Returns @true if the element has the attribute with the given name and
+        stores its value in @a value if it's not @NULL.
+    */
+    bool GetAttribute(const wxString& attrName, wxString* value) const;
+
+    /**
+        Returns the value of the attribute with the given name or @a defaultVal
+        if the element doesn't have it.
+    */
+    wxString GetAttribute(const wxString& attrName,
+                          const wxString& defaultVal = wxEmptyString) const;
+
+    /**
+        Reads the current element as wxXmlNode.
+
+        This function can only be called from OnStartElement() and results in
+        the element, with all its attributes and children, being read into a
+        wxXmlNode which is passed to OnSubtree() when the end of the element
+        is reached. No other callbacks, including OnEndElement(), are called
+        for this element.
+    */
+    void ReadSubtree();
+
+protected:
+    /**
+        Called when an element starts.
+
+        Its attributes can be retrieved using GetAttribute() and the other
+        functions for accessing them.
+    */
+    virtual void OnStartElement(const wxString& name);
+
+    /**
+        Called when an element ends.
+    */
+    virtual void OnEndElement(const wxString& name);
+
+    /**
+        Called with the text found inside an element.
+    */
+    virtual void OnText(const wxString& text);
+
+    /**
+        Called with the contents of a CDATA section.
+
+        Default implementation calls OnText().
+    */
+    virtual void OnCData(const wxString& text);
+
+    /**
+        Called with the contents of a comment.
+    */
+    virtual void OnComment(const wxString& comment);
+
+    /**
+        Called for a processing instruction.
+    */
+    virtual void OnProcessingInstruction(const wxString& target,
+                                         const wxString& data);
+
+    /**
+        Called with the element for which ReadSubtree() was called.
+
+        The function takes ownership of @a node, which doesn't have any parent
+        or siblings. Default implementation simply deletes it.
+    */
+    virtual void OnSubtree(wxXmlNode* node);
+};
+
+
+
+/**
+    @class wxXmlWriter
+
+    This class writes XML documents directly to a stream, without building
+    the tree of wxXmlNode objects first, which is both faster and uses less
+    memory when generating big documents.
+
+    The output is formatted in the same way as by wxXmlDocument::Save(), which
+    uses this class itself, and all the text and attribute values are escaped
+    as necessary, e.g.:
+
+    @code
+    wxFileOutputStream stream("items.xml");
+    wxXmlWriter writer(stream);
+    writer.WriteDeclaration();
+    writer.StartElement("items");
+    for ( size_t n = 0; n < items.size(); n++ )
+    {
+        writer.StartElement("item");
+        writer.WriteAttribute("type", items[n].type);
+        writer.WriteText(items[n].text);
+        writer.EndElement();
+    }
+    writer.EndElement();
+
+    if ( !writer.Flush() )
+        ... handle the error ...
+    @endcode
+
+    All the writing functions return @false if an error occurred, either
+    now or previously, and nothing else is written after an error. The
+    output is buffered, so Flush() must be called to ensure that all the
+    data is written to the stream before using it.
+
+    @since 3.1.3
+
+    @library{wxxml}
+    @category{xml}
+
+    @see wxXmlDocument, wxXmlReader
+*/
+class wxXmlWriter
+{
+public:
+    /**
+        Creates the writer for the given stream.
+
+        @param stream
+            The stream to write to, must remain valid while the writer is
+            used.
+        @param indentstep
+            The number of spaces to indent the nested elements by or
+            @c wxXML_NO_INDENTATION to not insert any whitespace at all, as
+            with wxXmlDocument::Save().
+    */
+    explicit wxXmlWriter(wxOutputStream& stream, int indentstep = 2);
+
+    /**
+        Destructor flushes the data written so far.
+
+        Notice that it does not close the elements which are still open.
+    */
+    ~wxXmlWriter();
+
+    /**
+        Sets the line endings to use.
+
+        Unix line endings are used by default. This function must be called
+        before writing anything.
+    */
+    void SetFileType(wxTextFileType fileType);
+
+    /**
+        Sets the encoding of the strings passed to the writer.
+
+        This function is only available in ANSI build and must be called
+        before writing anything, the default encoding is UTF-8.
+    */
+    void SetEncoding(const wxString& enc);
+
+    /**
+        Writes the XML declaration.
+
+        This function can only be called before writing anything else.
+
+        @param version
+            The XML version to specify in the declaration.
+        @param encoding
+            The encoding to specify in the declaration, which is also used
+            for all the data written after it. Without calling this function
+            UTF-8 is always used.
+    */
+    bool WriteDeclaration(const wxString& version = "1.0",
+                          const wxString& encoding = "UTF-8");
+
+    /**
+        Writes the DOCTYPE declaration.
+
+        Does nothing if @a doctype is empty.
+    */
+    bool WriteDoctype(const wxXmlDoctype& doctype);
+
+    /**
+        Starts a new element inside the current one.
+
+        Each call to this function must be matched by a call to EndElement().
+    */
+    bool StartElement(const wxString& name);
+
+    /**
+        Adds an attribute to the element.
+
+        This function can only be called immediately after StartElement() or
+        another call to this function.
+    */
+    bool WriteAttribute(const wxString& name, const wxString& value);
+
+    /**
+        Ends the last started element.
+
+        Elements without any children are written as <tt>\<name/\></tt>.
+    */
+    bool EndElement();
+
+    /**
+        Writes the text, escaping the characters special in XML.
+    */
+    bool WriteText(const wxString& text);
+
+    /**
+        Writes a CDATA section containing the given text.
+    */
+    bool WriteCData(const wxString& text);
+
+    /**
+        Writes a comment.
+    */
+    bool WriteComment(const wxString& comment);
+
+    /**
+        Writes a processing instruction.
+    */
+    bool WriteProcessingInstruction(const wxString& target,
+                                    const wxString& data);
+
+    /**
+        Writes the node and all of its children.
+
+        This can be used to mix writing the parts of the document directly
+        and writing the existing wxXmlNode objects.
+    */
+    bool WriteNode(const wxXmlNode* node);
+
+    /**
+        Returns the number of the elements started but not ended yet.
+    */
+    int GetDepth() const;
+
+    /**
+        Writes all the data buffered so far to the stream.
+
+        Returns @false if an error occurred.
+    */
+    bool Flush();
+
+    /**
+        Returns @false if an error occurred while writing.
+    */
+    bool IsOk() const;
+};
@@ -621,5 +621,36 @@ public:
         @since 3.1.1
     */
     wxZipArchiveFormat GetFormat() const;
+
+    /**
+        Set the maximal number of threads to use for compressing the entries.
+
+        By default, all data is compressed by the thread writing it. If @a
+        count is greater than 1, the entries using wxZIP_METHOD_DEFLATE are
+        split into blocks which are compressed by up to @a count worker
+        threads simultaneously, while the calling thread writes out the
+        already compressed blocks in order. The special value 0 means to use
+        as many threads as there are CPUs, see wxThread::GetCPUCount().
+
+        The resulting archive is a standard zip file which can be read by
+        wxZipInputStream or any other program and is only very slightly
+        bigger than the one created without using threads. Notice that only
+        the entries bigger than 128KB benefit from using the threads, the
+        smaller ones are compressed by the calling thread as usual.
+
+        This function does nothing if wxUSE_THREADS is 0.
+
+        @since 3.1.3
+    */
+    void SetMaxThreads(int count);
+
+    /**
+        Returns the maximal number of threads used for compressing the entries.
+
+        See SetMaxThreads() for more information.
+
+        @since 3.1.3
+    */
+    int GetMaxThreads() const;
 };
 
@@ -254,6 +254,48 @@ void wxArrayString::Copy(const wxArrayString& src)
     Add(src[n]);
 }
 
+void wxArrayString::Move(wxArrayString& src)
+{
+  // we can only reuse the elements of the other array if we don't need to
+  // sort them or if they're already sorted in the order we need
+  if ( m_autoSort &&
+        (!src.m_autoSort || src.m_compareFunction != m_compareFunction) )
+  {
+    Copy(src);
+    src.Clear();
+    return;
+  }
+
+  wxSwap(m_nSize, src.m_nSize);
+  wxSwap(m_nCount, src.m_nCount);
+  wxSwap(m_pItems, src.m_pItems);
+}
+
+#ifdef wxHAS_RVALUE_REF
+
+wxArrayString::wxArrayString(wxArrayString&& src)
+{
+  Init(src.m_autoSort);
+
+  Move(src);
+}
+
+wxArrayString& wxArrayString::operator=(wxArrayString&& src)
+{
+  if ( &src != this )
+  {
+    Clear();
+
+    Move(src);
+
+    m_autoSort = src.m_autoSort;
+  }
+
+  return *this;
+}
+
+#endif // wxHAS_RVALUE_REF
+
 // grow the array
 wxString *wxArrayString::Grow(size_t nIncrement)
 {
@@ -49,7 +49,9 @@
 #include "wx/thread.h"
 
 #if wxUSE_BASE
+    #include "wx/hashmap.h"
     #include "wx/scopedptr.h"
+    #include "wx/weakref.h"
 
     wxDECLARE_SCOPED_PTR(wxEvent, wxEventPtr)
     wxDEFINE_SCOPED_PTR(wxEvent, wxEventPtr)
@@ -1116,16 +1118,335 @@ void wxEventHashTable::GrowEventTypeTable()
     delete[] oldEventTypeTable;
 }
 
+// ----------------------------------------------------------------------------
+// wxPendingEventsQueue
+// ----------------------------------------------------------------------------
+
+// The queue of the events pending processing for a single wxEvtHandler.
+//
+// This is a simple ring buffer of the event pointers which, unlike wxList used
+// before, doesn't allocate anything when a new event is queued, except when it
+// needs to grow. The events queued with QueueEventCoalesced() are also indexed
+// by their type, id and key, so that finding the event to replace doesn't
+// require scanning the entire queue. It is not thread-safe by itself, all
+// accesses to it must be protected by wxEvtHandler::m_pendingEventsLock.
+class wxPendingEventsQueue
+{
+public:
+    wxPendingEventsQueue()
+    {
+        m_entries = NULL;
+        m_size =
+        m_first =
+        m_count =
+        m_base = 0;
+    }
+
+    ~wxPendingEventsQueue()
+    {
+        for ( size_t n = 0; n < m_count; n++ )
+            delete Get(n);
+
+        delete [] m_entries;
+    }
+
+    bool IsEmpty() const { return m_count == 0; }
+    size_t GetCount() const { return m_count; }
+
+    // Get the n-th event counting from the oldest one.
+    wxEvent* Get(size_t n) const
+    {
+        return m_entries[(m_first + n) & (m_size - 1)].event;
+    }
+
+    // Add a new event at the end of the queue, taking ownership of it.
+    //
+    // If coalesce is true, the event replaces the pending event with the same
+    // type, id and key if there is one, which is then returned and must be
+    // deleted by the caller.
+    wxEvent* Push(wxEvent* event, bool coalesce = false, long key = 0)
+    {
+        if ( coalesce )
+        {
+            const Key k(event->GetEventType(), event->GetId(), key);
+            const CoalescedMap::iterator it = m_coalesced.find(k);
+            if ( it != m_coalesced.end() )
+            {
+                Entry& entry = At(it->second - m_base);
+                wxEvent* const old = entry.event;
+                entry.event = event;
+                return old;
+            }
+
+            m_coalesced[k] = m_base + m_count;
+        }
+
+        if ( m_count == m_size )
+            Grow();
+
+        Entry& entry = At(m_count++);
+        entry.event = event;
+        entry.key = key;
+        entry.coalesce = coalesce;
+
+        return NULL;
+    }
+
+    // Remove the n-th event from the queue and return it, the caller becomes
+    // responsible for deleting it.
+    wxEvent* Remove(size_t n)
+    {
+        const Entry entry = At(n);
+
+        if ( entry.coalesce )
+        {
+            m_coalesced.erase(Key(entry.event->GetEventType(),
+                                  entry.event->GetId(),
+                                  entry.key));
+        }
+
+        if ( n == 0 )
+        {
+            // this is by far the most common case, in which the positions of
+            // all the remaining events just decrease by 1
+            m_first = (m_first + 1) & (m_size - 1);
+            m_base++;
+        }
+        else
+        {
+            for ( size_t i = n + 1; i < m_count; i++ )
+                At(i - 1) = At(i);
+
+            // the events following the removed one were moved, update the
+            // positions of the coalesced ones among them
+            const size_t pos = m_base + n;
+            for ( CoalescedMap::iterator it = m_coalesced.begin();
+                  it != m_coalesced.end();
+                  ++it )
+            {
+                if ( it->second > pos )
+                    it->second--;
+            }
+        }
+
+        if ( !--m_count )
+        {
+            m_base = 0;
+
+            if ( m_size > MAX_RETAINED_SIZE )
+            {
+                // don't keep a lot of memory allocated after a burst of events
+                wxDELETEA(m_entries);
+                m_size =
+                m_first = 0;
+            }
+        }
+
+        return entry.event;
+    }
+
+private:
+    // we don't free the buffer when the queue becomes empty unless it is
+    // bigger than this
+    enum { MAX_RETAINED_SIZE = 256 };
+
+    struct Entry
+    {
+        wxEvent* event;
+
+        // the key passed to QueueEventCoalesced(), only used if coalesce is
+        // true
+        long key;
+        bool coalesce;
+    };
+
+    // the key identifying the events which can be coalesced together
+    struct Key
+    {
+        Key(wxEventType type_, int id_, long key_)
+            : type(type_), id(id_), key(key_) { }
+
+        wxEventType type;
+        int id;
+        long key;
+    };
+
+    class KeyHash
+    {
+    public:
+        KeyHash() { }
+        unsigned long operator()(const Key& k) const
+            { return (unsigned long)k.type ^ ((unsigned long)k.id << 8) ^ k.key; }
+
+        KeyHash& operator=(const KeyHash&) { return *this; }
+    };
+
+    class KeyEqual
+    {
+    public:
+        KeyEqual() { }
+        bool operator()(const Key& a, const Key& b) const
+            { return a.type == b.type && a.id == b.id && a.key == b.key; }
+
+        KeyEqual& operator=(const KeyEqual&) { return *this; }
+    };
+
+    // maps the coalesced events keys to their positions in the queue, offset
+    // by m_base
+    WX_DECLARE_HASH_MAP(Key, size_t, KeyHash, KeyEqual, CoalescedMap);
+
+    Entry& At(size_t n)
+    {
+        return m_entries[(m_first + n) & (m_size - 1)];
+    }
+
+    void Grow()
+    {
+        // the size must always be a power of 2 for the masks above to work
+        const size_t size = m_size ? 2*m_size : 16;
+        Entry* const entries = new Entry[size];
+        for ( size_t n = 0; n < m_count; n++ )
+            entries[n] = At(n);
+
+        delete [] m_entries;
+        m_entries = entries;
+        m_size = size;
+        m_first = 0;
+    }
+
+    Entry* m_entries;
+
+    // the allocated size of m_entries, the index of the oldest event in it,
+    // the number of events in the queue and the number of events removed from
+    // its front since it was last empty, which is subtracted from the values
+    // in m_coalesced to get the positions of the events in the queue
+    size_t m_size,
+           m_first,
+           m_count,
+           m_base;
+
+    // the events queued with QueueEventCoalesced()
+    CoalescedMap m_coalesced;
+
+    wxDECLARE_NO_COPY_CLASS(wxPendingEventsQueue);
+};
+
+// ----------------------------------------------------------------------------
+// wxDynamicEventsIndex
+// ----------------------------------------------------------------------------
+
+typedef wxVector<wxDynamicEventTableEntry*> wxDynamicEventTableEntries;
+
+WX_DECLARE_HASH_MAP(wxEventType, wxDynamicEventTableEntries,
+                    wxIntegerHash, wxIntegerEqual,
+                    wxDynamicEventTableEntriesByType);
+
+// Index of the dynamically bound event handlers by their event type.
+//
+// It is only created for the handlers with many dynamically bound entries, as
+// just scanning wxEvtHandler::m_dynamicEvents is as fast when there are only a
+// few of them. The entries are stored in the same order as in the main
+// vector and, just as there, the unbound ones are replaced with NULL until
+// they are pruned.
+class wxDynamicEventsIndex
+{
+public:
+    explicit wxDynamicEventsIndex(const wxDynamicEventTableEntries& entries)
+    {
+        m_numUnbound = 0;
+
+        for ( size_t n = 0; n < entries.size(); n++ )
+        {
+            if ( entries[n] )
+                Add(entries[n]);
+            else
+                m_numUnbound++;
+        }
+    }
+
+    void Add(wxDynamicEventTableEntry* entry)
+    {
+        m_entries[entry->m_eventType].push_back(entry);
+    }
+
+    // Must be called before deleting the unbound entry.
+    void Remove(const wxDynamicEventTableEntry* entry)
+    {
+        wxDynamicEventTableEntries& entries = m_entries[entry->m_eventType];
+        for ( size_t n = entries.size(); n; n-- )
+        {
+            if ( entries[n - 1] == entry )
+            {
+                entries[n - 1] = NULL;
+                m_numUnbound++;
+                return;
+            }
+        }
+
+        wxFAIL_MSG( "unbound entry not found in the index" );
+    }
+
+    // Return the entries for the given event type, or NULL if none.
+    wxDynamicEventTableEntries* Find(wxEventType eventType)
+    {
+        const wxDynamicEventTableEntriesByType::iterator
+            it = m_entries.find(eventType);
+
+        return it == m_entries.end() ? NULL : &it->second;
+    }
+
+    bool HasUnbound() const { return m_numUnbound != 0; }
+
+    // Remove the NULL entries left by Remove().
+    void Prune()
+    {
+        for ( wxDynamicEventTableEntriesByType::iterator it = m_entries.begin();
+              it != m_entries.end();
+              ++it )
+        {
+            wxDynamicEventTableEntries& entries = it->second;
+
+            size_t nNew = 0;
+            for ( size_t n = 0; n != entries.size(); n++ )
+            {
+                if ( entries[n] )
+                    entries[nNew++] = entries[n];
+            }
+
+            entries.resize(nNew);
+        }
+
+        m_numUnbound = 0;
+    }
+
+private:
+    wxDynamicEventTableEntriesByType m_entries;
+
+    // the number of NULL entries, either here or in the main vector
+    size_t m_numUnbound;
+
+    wxDECLARE_NO_COPY_CLASS(wxDynamicEventsIndex);
+};
+
 // ----------------------------------------------------------------------------
 // wxEvtHandler
 // ----------------------------------------------------------------------------
 
+// the number of dynamically bound event handlers starting from which we create
+// wxDynamicEventsIndex for them
+static const size_t wxDYNAMIC_EVENTS_INDEX_THRESHOLD = 16;
+
+// the maximal number of pending events processed by a single call to
+// wxEvtHandler::ProcessPendingEvents()
+static const size_t wxPENDING_EVENTS_BATCH_SIZE = 64;
+
 wxEvtHandler::wxEvtHandler()
 {
     m_nextHandler = NULL;
     m_previousHandler = NULL;
     m_enabled = true;
     m_dynamicEvents = NULL;
+    m_dynamicEventsIndex = NULL;
     m_pendingEvents = NULL;
 
     // no client data (yet)
@@ -1162,6 +1483,7 @@ wxEvtHandler::~wxEvtHandler()
             delete entry;
         }
         delete m_dynamicEvents;
+        delete m_dynamicEventsIndex;
     }
 
     // Remove us from the list of the pending events if necessary.
@@ -1250,6 +1572,16 @@ bool wxEvtHandler::ProcessThreadEvent(const wxEvent& event)
 #endif // wxUSE_THREADS
 
 void wxEvtHandler::QueueEvent(wxEvent *event)
+{
+    DoQueueEvent(event, false, 0);
+}
+
+void wxEvtHandler::QueueEventCoalesced(wxEvent *event, long key)
+{
+    DoQueueEvent(event, true, key);
+}
+
+void wxEvtHandler::DoQueueEvent(wxEvent *event, bool coalesce, long key)
 {
     wxCHECK_RET( event, "NULL event can't be posted" );
 
@@ -1269,14 +1601,34 @@ void wxEvtHandler::QueueEvent(wxEvent *event)
     wxENTER_CRIT_SECT( m_pendingEventsLock );
 
     if ( !m_pendingEvents )
-        m_pendingEvents = new wxList;
+        m_pendingEvents = new wxPendingEventsQueue;
+
+    const bool hadPendingEvents = !m_pendingEvents->IsEmpty();
+
+    wxEvent* const replaced = m_pendingEvents->Push(event, coalesce, key);
+    if ( replaced )
+    {
+        // nothing else to do, we must already be in the list of the handlers
+        // with pending events, just get rid of the now obsolete event outside
+        // of the critical section
+        wxLEAVE_CRIT_SECT( m_pendingEventsLock );
+
+        delete replaced;
 
-    m_pendingEvents->Append(event);
+        return;
+    }
 
     // 2) Add this event handler to list of event handlers that
     //    have pending events.
+    //
+    //    If we already had any pending events, we must be already in this
+    //    list (or in the list of the handlers with delayed events) as we only
+    //    remove ourselves from it when our queue becomes empty, so avoid
+    //    locking the global list unnecessarily in this, common, case of
+    //    posting many events in a row.
 
-    wxTheApp->AppendPendingEventHandler(this);
+    if ( !hadPendingEvents )
+        wxTheApp->AppendPendingEventHandler(this);
 
     // only release m_pendingEventsLock now because otherwise there is a race
     // condition as described in the ticket #9093: we could process the event
@@ -1293,8 +1645,6 @@ void wxEvtHandler::QueueEvent(wxEvent *event)
 
 void wxEvtHandler::DeletePendingEvents()
 {
-    if (m_pendingEvents)
-        m_pendingEvents->DeleteContents(true);
     wxDELETE(m_pendingEvents);
 }
 
@@ -1308,65 +1658,81 @@ void wxEvtHandler::ProcessPendingEvents()
         return;
     }
 
-    // we need to process only a single pending event in this call because
-    // each call to ProcessEvent() could result in the destruction of this
-    // same event handler (see the comment at the end of this function)
+    // Each call to ProcessEvent() could result in the destruction of this
+    // same event handler, so we need to check for it before processing the
+    // next event, but processing several events in one go is still much more
+    // efficient than returning to wxApp after each of them when a lot of
+    // events are queued, e.g. by a worker thread.
+    wxWeakRef<wxEvtHandler> self(this);
 
-    wxENTER_CRIT_SECT( m_pendingEventsLock );
-
-    // this method is only called by wxApp if this handler does have
-    // pending events
-    wxCHECK_RET( m_pendingEvents && !m_pendingEvents->IsEmpty(),
-                 "should have pending events if called" );
-
-    wxList::compatibility_iterator node = m_pendingEvents->GetFirst();
-    wxEvent* pEvent = static_cast<wxEvent *>(node->GetData());
-
-    // find the first event which can be processed now:
-    wxEventLoopBase* evtLoop = wxEventLoopBase::GetActive();
-    if (evtLoop && evtLoop->IsYielding())
+    for ( size_t n = 0; n < wxPENDING_EVENTS_BATCH_SIZE; n++ )
     {
-        while (node && pEvent && !evtLoop->IsEventAllowedInsideYield(pEvent->GetEventCategory()))
-        {
-            node = node->GetNext();
-            pEvent = node ? static_cast<wxEvent *>(node->GetData()) : NULL;
-        }
+        wxEvent* pEvent;
+        bool hasMore;
 
-        if (!node)
         {
-            // all our events are NOT processable now... signal this:
-            wxTheApp->DelayPendingEventHandler(this);
+            wxCRIT_SECT_LOCKER(lock, m_pendingEventsLock);
 
-            // see the comment at the beginning of evtloop.h header for the
-            // logic behind YieldFor() and behind DelayPendingEventHandler()
+            if ( !m_pendingEvents || m_pendingEvents->IsEmpty() )
+            {
+                // this method is only called by wxApp if this handler does
+                // have pending events, but they could have been deleted
+                // meanwhile: just ensure that we don't get called again
+                wxTheApp->RemovePendingEventHandler(this);
+                return;
+            }
 
-            wxLEAVE_CRIT_SECT( m_pendingEventsLock );
+            // find the first event which can be processed now:
+            size_t index = 0;
 
-            return;
-        }
-    }
+            wxEventLoopBase* evtLoop = wxEventLoopBase::GetActive();
+            if (evtLoop && evtLoop->IsYielding())
+            {
+                const size_t count = m_pendingEvents->GetCount();
+                while ( index < count &&
+                            !evtLoop->IsEventAllowedInsideYield(
+                                m_pendingEvents->Get(index)->GetEventCategory()) )
+                {
+                    index++;
+                }
 
-    wxEventPtr event(pEvent);
+                if ( index == count )
+                {
+                    // all our events are NOT processable now... signal this:
+                    wxTheApp->DelayPendingEventHandler(this);
 
-    // it's important we remove event from list before processing it, else a
-    // nested event loop, for example from a modal dialog, might process the
-    // same event again.
-    m_pendingEvents->Erase(node);
+                    // see the comment at the beginning of evtloop.h header for
+                    // the logic behind YieldFor() and behind
+                    // DelayPendingEventHandler()
 
-    if ( m_pendingEvents->IsEmpty() )
-    {
-        // if there are no more pending events left, we don't need to
-        // stay in this list
-        wxTheApp->RemovePendingEventHandler(this);
-    }
+                    return;
+                }
+            }
 
-    wxLEAVE_CRIT_SECT( m_pendingEventsLock );
+            // it's important we remove event from list before processing it,
+            // else a nested event loop, for example from a modal dialog, might
+            // process the same event again.
+            pEvent = m_pendingEvents->Remove(index);
 
-    ProcessEvent(*event);
+            hasMore = !m_pendingEvents->IsEmpty();
+            if ( !hasMore )
+            {
+                // if there are no more pending events left, we don't need to
+                // stay in this list
+                wxTheApp->RemovePendingEventHandler(this);
+            }
+        }
+
+        wxEventPtr event(pEvent);
+
+        ProcessEvent(*event);
 
-    // careful: this object could have been deleted by the event handler
-    // executed by the above ProcessEvent() call, so we can't access any fields
-    // of this object any more
+        // careful: this object could have been deleted by the event handler
+        // executed by the above ProcessEvent() call, so we can't access any
+        // fields of this object any more if it was
+        if ( !hasMore || !self )
+            break;
+    }
 }
 
 /* static */
@@ -1747,6 +2113,13 @@ void wxEvtHandler::DoBind(int id,
     // than inserting the element at the front.
     m_dynamicEvents->push_back(entry);
 
+    // Index the entries by their type if there are many of them to avoid
+    // having to look at all of them in SearchDynamicEventTable().
+    if ( m_dynamicEventsIndex )
+        m_dynamicEventsIndex->Add(entry);
+    else if ( m_dynamicEvents->size() >= wxDYNAMIC_EVENTS_INDEX_THRESHOLD )
+        m_dynamicEventsIndex = new wxDynamicEventsIndex(*m_dynamicEvents);
+
     // Make sure we get to know when a sink is destroyed
     wxEvtHandler *eventSink = func->GetEvtHandler();
     if ( eventSink && eventSink != this )
@@ -1791,6 +2164,9 @@ wxEvtHandler::DoUnbind(int id,
 
             delete entry->m_callbackUserData;
 
+            if ( m_dynamicEventsIndex )
+                m_dynamicEventsIndex->Remove(entry);
+
             // We can't delete the entry from the vector if we're currently
             // iterating over it. As we don't know whether we're or not, just
             // null it for now and we will really erase it when we do finish
@@ -1843,15 +2219,29 @@ bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
 
     DynamicEvents& dynamicEvents = *m_dynamicEvents;
 
-    bool needToPruneDeleted = false;
+    // If we have an index, we only need to look at the entries for this event
+    // type, and there may be none of them at all.
+    DynamicEvents* entries = &dynamicEvents;
+    if ( m_dynamicEventsIndex )
+        entries = m_dynamicEventsIndex->Find(event.GetEventType());
+
+    bool needToPruneDeleted = m_dynamicEventsIndex &&
+                                m_dynamicEventsIndex->HasUnbound();
 
     // We can't use Get{First,Next}DynamicEntry() here as they hide the deleted
     // but not yet pruned entries from the caller, but here we do want to know
     // about them, so iterate directly. Remember to do it in the reverse order
     // to honour the order of handlers connection.
-    for ( size_t n = dynamicEvents.size(); n; n-- )
+    for ( size_t n = entries ? entries->size() : 0; n; n-- )
     {
-        wxDynamicEventTableEntry* const entry = dynamicEvents[n - 1];
+        // The entries could have been pruned by a nested event dispatch too.
+        if ( n > entries->size() )
+        {
+            n = entries->size() + 1;
+            continue;
+        }
+
+        wxDynamicEventTableEntry* const entry = (*entries)[n - 1];
 
         if ( !entry )
         {
@@ -1887,6 +2277,11 @@ bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
         }
     }
 
+    // A nested event dispatch from one of the handlers above could have
+    // already pruned the unbound entries, so check if it's still needed.
+    if ( needToPruneDeleted && m_dynamicEventsIndex )
+        needToPruneDeleted = m_dynamicEventsIndex->HasUnbound();
+
     if ( needToPruneDeleted )
     {
         size_t nNew = 0;
@@ -1896,8 +2291,10 @@ bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
                 dynamicEvents[nNew++] = dynamicEvents[n];
         }
 
-        wxASSERT( nNew != dynamicEvents.size() );
         dynamicEvents.resize(nNew);
+
+        if ( m_dynamicEventsIndex )
+            m_dynamicEventsIndex->Prune();
     }
 
     return false;
@@ -1974,6 +2371,9 @@ void wxEvtHandler::OnSinkDestroyed( wxEvtHandler *sink )
     {
         if ( entry->m_fn->GetEvtHandler() == sink )
         {
+            if ( m_dynamicEventsIndex )
+                m_dynamicEventsIndex->Remove(entry);
+
             delete entry->m_callbackUserData;
             delete entry;
 
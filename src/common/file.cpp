@@ -50,6 +50,9 @@
     #include  <unistd.h>
     #include  <time.h>
     #include  <sys/stat.h>
+    #ifdef __UNIX__
+        #include  <sys/mman.h>
+    #endif
     #ifdef __GNUWIN32__
         #include "wx/msw/wrapwin.h"
     #endif
@@ -70,6 +73,12 @@
 #endif  //Win/UNIX
 
 #include  <stdio.h>       // SEEK_xxx constants
+#include  <stdlib.h>      // malloc() and free()
+
+#if defined(__WINDOWS__) && !defined(__UNIX__)
+    #include "wx/msw/wrapwin.h"
+    #include  <io.h>        // _get_osfhandle()
+#endif
 
 #include <errno.h>
 
@@ -628,5 +637,118 @@ void wxTempFile::Discard()
     }
 }
 
-#endif // wxUSE_FILE
+// ============================================================================
+// implementation of wxMappedFile
+// ============================================================================
+
+void wxMappedFile::Init()
+{
+    m_data = NULL;
+    m_length = 0;
+    m_opened =
+    m_mapped = false;
+}
+
+bool wxMappedFile::Open(const wxString& strName)
+{
+    Close();
+
+    wxFile file;
+    if ( !file.Open(strName) )
+        return false;
+
+    const wxFileOffset len = file.Length();
+    if ( len == wxInvalidOffset )
+        return false;
+
+    m_length = wx_truncate_cast(size_t, len);
+    if ( (wxFileOffset)m_length != len )
+    {
+        wxLogError(_("File \"%s\" is too big to be loaded into memory."),
+                   strName);
+        m_length = 0;
+        return false;
+    }
+
+    // there is nothing to map for empty files, and mmap() would fail for them
+    if ( !m_length )
+    {
+        m_opened = true;
+        return true;
+    }
+
+#if defined(__UNIX__)
+    void * const data = mmap(NULL, m_length, PROT_READ, MAP_PRIVATE,
+                             file.fd(), 0);
+    if ( data != MAP_FAILED )
+    {
+        m_data = data;
+        m_mapped = true;
+    }
+#elif defined(__WINDOWS__)
+    HANDLE hMapping = ::CreateFileMapping
+                        (
+                            (HANDLE)_get_osfhandle(file.fd()),
+                            NULL,
+                            PAGE_READONLY,
+                            0, 0,
+                            NULL
+                        );
+    if ( hMapping )
+    {
+        // the view keeps the mapping object alive, so we don't need to keep
+        // its handle
+        m_data = ::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+        m_mapped = m_data != NULL;
 
+        ::CloseHandle(hMapping);
+    }
+#endif // platform
+
+    if ( !m_mapped )
+    {
+        // either mapping files is not supported at all or this particular
+        // file can't be mapped, just read it into memory then
+        void * const data = malloc(m_length);
+        if ( !data )
+        {
+            wxLogError(_("File \"%s\" is too big to be loaded into memory."),
+                       strName);
+            m_length = 0;
+            return false;
+        }
+
+        if ( file.Read(data, m_length) != (ssize_t)m_length )
+        {
+            free(data);
+            m_length = 0;
+            return false;
+        }
+
+        m_data = data;
+    }
+
+    m_opened = true;
+
+    return true;
+}
+
+void wxMappedFile::Close()
+{
+    if ( m_mapped )
+    {
+#if defined(__UNIX__)
+        munmap(const_cast<void *>(m_data), m_length);
+#elif defined(__WINDOWS__)
+        ::UnmapViewOfFile(m_data);
+#endif // platform
+    }
+    else
+    {
+        free(const_cast<void *>(m_data));
+    }
+
+    Init();
+}
+
+#endif // wxUSE_FILE
@@ -36,8 +36,8 @@
 
 #include  "wx/file.h"
 #include  "wx/textfile.h"
-#include  "wx/memtext.h"
 #include  "wx/config.h"
+#include  "wx/hashmap.h"
 #include  "wx/fileconf.h"
 #include  "wx/filefn.h"
 
@@ -76,6 +76,13 @@ static wxString FilterOutEntryName(const wxString& str);
 // get the name to use in wxFileConfig ctor
 static wxString GetAppName(const wxString& appname);
 
+// read the entire contents of the config file into the given buffer
+static bool ReadConfigFile(const wxString& path, wxMemoryBuffer& buf);
+
+// convert the contents of the config file to NUL-terminated text
+static bool
+ConvertConfigText(wxMemoryBuffer& buf, const wxMBConv& conv, wxWxCharBuffer& text);
+
 // ============================================================================
 // private classes
 // ============================================================================
@@ -94,6 +101,60 @@ static wxString GetAppName(const wxString& appname);
     WX_DEFINE_SORTED_ARRAY(wxFileConfigGroup *, ArrayGroups);
 #endif
 
+// ----------------------------------------------------------------------------
+// hash maps for looking up entries and groups by name
+// ----------------------------------------------------------------------------
+
+// The keys of these maps point to the names stored in the entries and groups
+// themselves, so the names don't need to be copied. They are hashed and
+// compared in the same way as CompareEntries() and CompareGroups() do it, i.e.
+// case-insensitively unless wxCONFIG_CASE_SENSITIVE is set.
+typedef const wxString *wxFileConfigNameKey;
+
+struct wxFileConfigNameHash
+{
+    wxFileConfigNameHash() { }
+
+    unsigned long operator()(wxFileConfigNameKey name) const
+    {
+#if wxCONFIG_CASE_SENSITIVE
+        return wxStringHash()(*name);
+#else
+        unsigned long hash = 0;
+        const wxString::const_iterator end = name->end();
+        for ( wxString::const_iterator i = name->begin(); i != end; ++i )
+            hash = 31*hash + wxTolower(*i).GetValue();
+
+        return hash;
+#endif
+    }
+
+    wxFileConfigNameHash& operator=(const wxFileConfigNameHash&) { return *this; }
+};
+
+struct wxFileConfigNameEqual
+{
+    wxFileConfigNameEqual() { }
+
+    bool operator()(wxFileConfigNameKey a, wxFileConfigNameKey b) const
+    {
+#if wxCONFIG_CASE_SENSITIVE
+        return *a == *b;
+#else
+        return a->length() == b->length() && a->CmpNoCase(*b) == 0;
+#endif
+    }
+
+    wxFileConfigNameEqual& operator=(const wxFileConfigNameEqual&) { return *this; }
+};
+
+WX_DECLARE_HASH_MAP(wxFileConfigNameKey, wxFileConfigEntry *,
+                    wxFileConfigNameHash, wxFileConfigNameEqual,
+                    wxFileConfigEntriesHash);
+WX_DECLARE_HASH_MAP(wxFileConfigNameKey, wxFileConfigGroup *,
+                    wxFileConfigNameHash, wxFileConfigNameEqual,
+                    wxFileConfigGroupsHash);
+
 // ----------------------------------------------------------------------------
 // wxFileConfigLineList
 // ----------------------------------------------------------------------------
@@ -176,8 +237,14 @@ class wxFileConfigGroup
 private:
   wxFileConfig *m_pConfig;          // config object we belong to
   wxFileConfigGroup  *m_pParent;    // parent group (NULL for root group)
-  ArrayEntries  m_aEntries;         // entries in this group
-  ArrayGroups   m_aSubgroups;       // subgroups
+  // entries and subgroups of this group: the arrays are only sorted on
+  // demand, when they're enumerated, while the hashes are used for lookup
+  mutable ArrayEntries m_aEntries;
+  mutable ArrayGroups  m_aSubgroups;
+  mutable bool  m_entriesSorted,
+                m_subgroupsSorted;
+  wxFileConfigEntriesHash m_entriesHash;
+  wxFileConfigGroupsHash  m_subgroupsHash;
   wxString      m_strName;          // group's name
   wxFileConfigLineList *m_pLine;    // pointer to our line in the linked list
   wxFileConfigEntry *m_pLastEntry;  // last entry/subgroup of this group in the
@@ -201,9 +268,10 @@ public:
   wxFileConfigGroup    *Parent()  const { return m_pParent; }
   wxFileConfig   *Config()  const { return m_pConfig; }
 
-  const ArrayEntries& Entries() const { return m_aEntries;   }
-  const ArrayGroups&  Groups()  const { return m_aSubgroups; }
-  bool  IsEmpty() const { return Entries().IsEmpty() && Groups().IsEmpty(); }
+  // these functions return the entries and subgroups sorted by name
+  const ArrayEntries& Entries() const;
+  const ArrayGroups&  Groups()  const;
+  bool  IsEmpty() const { return m_aEntries.IsEmpty() && m_aSubgroups.IsEmpty(); }
 
   // find entry/subgroup (NULL if not found)
   wxFileConfigGroup *FindSubgroup(const wxString& name) const;
@@ -308,11 +376,13 @@ void wxFileConfig::Init()
     // parse the global file
     if ( m_fnGlobalFile.IsOk() && m_fnGlobalFile.FileExists() )
     {
-        wxTextFile fileGlobal(m_fnGlobalFile.GetFullPath());
-
-        if ( fileGlobal.Open(*m_conv/*ignored in ANSI build*/) )
+        const wxString path = m_fnGlobalFile.GetFullPath();
+        wxMemoryBuffer buf;
+        if ( ReadConfigFile(path, buf) )
         {
-            Parse(fileGlobal, false /* global */);
+            wxWxCharBuffer text;
+            if ( ConvertConfigText(buf, *m_conv, text) )
+                Parse(text.data(), text.length(), path, false /* global */);
             SetRootPath();
         }
         else
@@ -324,15 +394,17 @@ void wxFileConfig::Init()
     // parse the local file
     if ( m_fnLocalFile.IsOk() && m_fnLocalFile.FileExists() )
     {
-        wxTextFile fileLocal(m_fnLocalFile.GetFullPath());
-        if ( fileLocal.Open(*m_conv/*ignored in ANSI build*/) )
+        const wxString path = m_fnLocalFile.GetFullPath();
+        wxMemoryBuffer buf;
+        if ( ReadConfigFile(path, buf) )
         {
-            Parse(fileLocal, true /* local */);
+            wxWxCharBuffer text;
+            if ( ConvertConfigText(buf, *m_conv, text) )
+                Parse(text.data(), text.length(), path, true /* local */);
             SetRootPath();
         }
         else
         {
-            const wxString path = m_fnLocalFile.GetFullPath();
             wxLogWarning(_("can't open user configuration file '%s'."),
                          path.c_str());
 
@@ -406,7 +478,6 @@ wxFileConfig::wxFileConfig(wxInputStream &inStream, const wxMBConv& conv)
     m_linesTail = NULL;
 
     // read the entire stream contents in memory
-    wxWxCharBuffer cbuf;
     static const size_t chunkLen = 1024;
 
     wxMemoryBuffer buf(chunkLen);
@@ -425,46 +496,18 @@ wxFileConfig::wxFileConfig(wxInputStream &inStream, const wxMBConv& conv)
     }
     while ( !inStream.Eof() );
 
-#if wxUSE_UNICODE
-    size_t len;
-    cbuf = conv.cMB2WC((char *)buf.GetData(), buf.GetDataLen() + 1, &len);
-    if ( !len && buf.GetDataLen() )
+    // parse the input contents if there is anything to parse
+    wxWxCharBuffer text;
+    if ( ConvertConfigText(buf, conv, text) )
     {
-        wxLogError(_("Failed to read config options."));
+        // notice that we throw away the empty lines here, as well as the
+        // original EOL kind, maybe we should preserve them?
+        Parse(text.data(), text.length(), wxString(), true /* local */,
+              true /* skip empty lines */);
     }
-#else // !wxUSE_UNICODE
-    // no need for conversion
-    cbuf = wxCharBuffer::CreateNonOwned((char *)buf.GetData(), buf.GetDataLen());
-#endif // wxUSE_UNICODE/!wxUSE_UNICODE
-
-    // parse the input contents if there is anything to parse
-    if ( cbuf )
+    else
     {
-        // now break it into lines
-        wxMemoryText memText;
-        for ( const wxChar *s = cbuf; ; ++s )
-        {
-            const wxChar *e = s;
-            while ( *e != '\0' && *e != '\n' && *e != '\r' )
-                ++e;
-
-            // notice that we throw away the original EOL kind here, maybe we
-            // should preserve it?
-            if ( e != s )
-                memText.AddLine(wxString(s, e));
-
-            if ( *e == '\0' )
-                break;
-
-            // skip the second EOL byte if it's a DOS one
-            if ( *e == '\r' && e[1] == '\n' )
-                ++e;
-
-            s = e;
-        }
-
-        // Finally we can parse it all.
-        Parse(memText, true /* local */);
+        wxLogError(_("Failed to read config options."));
     }
 
     SetRootPath();
@@ -498,26 +541,61 @@ wxFileConfig::~wxFileConfig()
 // parse a config file
 // ----------------------------------------------------------------------------
 
-void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
+void wxFileConfig::Parse(wxChar *text, size_t len, const wxString& name,
+                         bool bLocal, bool skipEmptyLines)
 {
+  // the text is parsed in place, without copying the individual lines: each
+  // of them is NUL-terminated by overwriting its EOL character
+  const wxChar * const end = text + len;
+  wxChar *pNext = text;
+  size_t nLineCount = 0;
 
-  size_t nLineCount = buffer.GetLineCount();
-
-  for ( size_t n = 0; n < nLineCount; n++ )
+  while ( pNext != end )
   {
-    wxString strLine = buffer[n];
-    // FIXME-UTF8: rewrite using iterators, without this buffer
-    wxWxCharBuffer buf(strLine.c_str());
+    wxChar * const pLine = pNext;
+    wxChar *pEOL = pLine;
+    while ( pEOL != end && *pEOL != wxT('\n') && *pEOL != wxT('\r') )
+      pEOL++;
+
+    // all EOL kinds are recognized, but only DOS one consists of 2 chars
+    pNext = pEOL;
+    if ( pNext != end ) {
+      if ( *pNext == wxT('\r') && pNext + 1 != end && pNext[1] == wxT('\n') )
+        pNext++;
+      pNext++;
+    }
+
+    // notice that this works for the last line too, as the text is always
+    // NUL-terminated
+    *pEOL = wxT('\0');
+
+    if ( skipEmptyLines && pEOL == pLine )
+      continue;
+
+    const size_t n = nLineCount++;
     const wxChar *pStart;
     const wxChar *pEnd;
 
-    // add the line to linked list
-    if ( bLocal )
-      LineListAppend(strLine);
+    // add the line to linked list: we don't use LineListAppend() here as
+    // its tracing code noticeably slows down loading big files
+    if ( bLocal ) {
+      wxFileConfigLineList *pLineList =
+        new wxFileConfigLineList(wxString(pLine, pEOL));
+
+      if ( m_linesTail == NULL ) {
+        m_linesHead = pLineList;
+      }
+      else {
+        m_linesTail->SetNext(pLineList);
+        pLineList->SetPrev(m_linesTail);
+      }
+
+      m_linesTail = pLineList;
+    }
 
 
     // skip leading spaces
-    for ( pStart = buf; wxIsspace(*pStart); pStart++ )
+    for ( pStart = pLine; wxIsspace(*pStart); pStart++ )
       ;
 
     // skip blank/comment lines
@@ -541,7 +619,7 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
 
       if ( *pEnd != wxT(']') ) {
         wxLogError(_("file '%s': unexpected character %c at line %zu."),
-                   buffer.GetName(), *pEnd, n + 1);
+                   name, *pEnd, n + 1);
         continue; // skip this line
       }
 
@@ -577,7 +655,7 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
 
           default:
             wxLogWarning(_("file '%s', line %zu: '%s' ignored after group header."),
-                         buffer.GetName(), n + 1, pEnd);
+                         name, n + 1, pEnd);
             bCont = false;
         }
       }
@@ -606,7 +684,7 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
 
       if ( *pEnd++ != wxT('=') ) {
         wxLogError(_("file '%s', line %zu: '=' expected."),
-                   buffer.GetName(), n + 1);
+                   name, n + 1);
       }
       else {
         wxFileConfigEntry *pEntry = m_pCurrentGroup->FindEntry(strKey);
@@ -619,7 +697,7 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
           if ( bLocal && pEntry->IsImmutable() ) {
             // immutable keys can't be changed by user
             wxLogWarning(_("file '%s', line %zu: value for immutable key '%s' ignored."),
-                         buffer.GetName(), n + 1, strKey.c_str());
+                         name, n + 1, strKey.c_str());
             continue;
           }
           // the condition below catches the cases (a) and (b) but not (c):
@@ -629,7 +707,7 @@ void wxFileConfig::Parse(const wxTextBuffer& buffer, bool bLocal)
           // which is exactly what we want.
           else if ( !bLocal || pEntry->IsLocal() ) {
             wxLogWarning(_("file '%s', line %zu: key '%s' was first found at line %d."),
-                         buffer.GetName(), n + 1, strKey.c_str(), pEntry->Line());
+                         name, n + 1, strKey.c_str(), pEntry->Line());
 
           }
         }
@@ -671,6 +749,49 @@ wxFileConfig::DoSetPath(const wxString& strPath, bool createMissingComponents)
         return true;
     }
 
+    // if there are no "." or ".." components in the path, which is by far the
+    // most common case, we can just follow it without splitting it first
+    if ( *strPath.begin() != wxT('.') &&
+            strPath.find(wxT("/.")) == wxString::npos ) {
+        const bool absolute = *strPath.begin() == wxCONFIG_PATH_SEPARATOR;
+
+        wxFileConfigGroup *pGroup = absolute ? m_pRootGroup : m_pCurrentGroup;
+        wxString strFullPath;
+        if ( !absolute )
+            strFullPath = m_strPath;
+
+        const wxString::const_iterator end = strPath.end();
+        for ( wxString::const_iterator p = strPath.begin(); p != end; ) {
+            if ( *p == wxCONFIG_PATH_SEPARATOR ) {
+                // ignore extra separators, as wxSplitPath() does
+                ++p;
+                continue;
+            }
+
+            const wxString::const_iterator start = p;
+            while ( p != end && *p != wxCONFIG_PATH_SEPARATOR )
+                ++p;
+
+            const wxString strName(start, p);
+            wxFileConfigGroup *pNextGroup = pGroup->FindSubgroup(strName);
+            if ( pNextGroup == NULL )
+            {
+                if ( !createMissingComponents )
+                    return false;
+
+                pNextGroup = pGroup->AddSubgroup(strName);
+            }
+
+            pGroup = pNextGroup;
+            strFullPath << wxCONFIG_PATH_SEPARATOR << strName;
+        }
+
+        m_pCurrentGroup = pGroup;
+        m_strPath = strFullPath;
+
+        return true;
+    }
+
     if ( strPath[0] == wxCONFIG_PATH_SEPARATOR ) {
         // absolute path
         wxSplitPath(aParts, strPath);
@@ -988,14 +1109,7 @@ bool wxFileConfig::Flush(bool /* bCurrentOnly */)
   }
 
   // write all strings to file
-  wxString filetext;
-  filetext.reserve(4096);
-  for ( wxFileConfigLineList *p = m_linesHead; p != NULL; p = p->Next() )
-  {
-    filetext << p->Text() << wxTextFile::GetEOL();
-  }
-
-  if ( !file.Write(filetext, *m_conv) )
+  if ( !file.Write(GetLinesText(), *m_conv) )
   {
     wxLogError(_("can't write user configuration file."));
     return false;
@@ -1018,18 +1132,14 @@ bool wxFileConfig::Flush(bool /* bCurrentOnly */)
 bool wxFileConfig::Save(wxOutputStream& os, const wxMBConv& conv)
 {
     // save unconditionally, even if not dirty
-    for ( wxFileConfigLineList *p = m_linesHead; p != NULL; p = p->Next() )
+    const wxString text = GetLinesText();
+    const wxCharBuffer buf(text.mb_str(conv));
+    if ( (!buf.length() && !text.empty()) ||
+            !os.Write(buf, buf.length()).IsOk() )
     {
-        wxString line = p->Text();
-        line += wxTextFile::GetEOL();
+        wxLogError(_("Error saving user configuration data."));
 
-        wxCharBuffer buf(line.mb_str(conv));
-        if ( !os.Write(buf, strlen(buf)) )
-        {
-            wxLogError(_("Error saving user configuration data."));
-
-            return false;
-        }
+        return false;
     }
 
     ResetDirty();
@@ -1296,6 +1406,27 @@ bool wxFileConfig::LineListIsEmpty()
     return m_linesHead == NULL;
 }
 
+wxString wxFileConfig::GetLinesText() const
+{
+    const wxString eol = wxTextFile::GetEOL();
+
+    // compute the total size first to avoid reallocating the string
+    size_t len = 0;
+    wxFileConfigLineList *p;
+    for ( p = m_linesHead; p != NULL; p = p->Next() )
+        len += p->Text().length() + eol.length();
+
+    wxString text;
+    text.reserve(len);
+    for ( p = m_linesHead; p != NULL; p = p->Next() )
+    {
+        text += p->Text();
+        text += eol;
+    }
+
+    return text;
+}
+
 // ============================================================================
 // wxFileConfig::wxFileConfigGroup
 // ============================================================================
@@ -1312,6 +1443,9 @@ wxFileConfigGroup::wxFileConfigGroup(wxFileConfigGroup *pParent,
                            m_aSubgroups(CompareGroups),
                            m_strName(strName)
 {
+  m_entriesSorted =
+  m_subgroupsSorted = true;
+
   m_pConfig = pConfig;
   m_pParent = pParent;
   m_pLine   = NULL;
@@ -1506,13 +1640,15 @@ void wxFileConfigGroup::Rename(const wxString& newName)
     if ( newName == m_strName )
         return;
 
-    // we need to remove the group from the parent and it back under the new
-    // name to keep the parents array of subgroups alphabetically sorted
-    m_pParent->m_aSubgroups.Remove(this);
+    // we need to remove the group from the parent hash and add it back under
+    // the new name, the parent array of subgroups will be sorted again when
+    // it's needed
+    m_pParent->m_subgroupsHash.erase(&m_strName);
 
     m_strName = newName;
 
-    m_pParent->m_aSubgroups.Add(this);
+    m_pParent->m_subgroupsHash[&m_strName] = this;
+    m_pParent->m_subgroupsSorted = false;
 
     // update the group lines recursively
     UpdateGroupAndSubgroupsLines();
@@ -1531,67 +1667,46 @@ wxString wxFileConfigGroup::GetFullName() const
 // find an item
 // ----------------------------------------------------------------------------
 
-// use binary search because the array is sorted
 wxFileConfigEntry *
 wxFileConfigGroup::FindEntry(const wxString& name) const
 {
-  size_t
-       lo = 0,
-       hi = m_aEntries.GetCount();
-  wxFileConfigEntry *pEntry;
-
-  while ( lo < hi ) {
-    size_t i;
-    i = (lo + hi)/2;
-    pEntry = m_aEntries[i];
-
-    int res;
-    #if wxCONFIG_CASE_SENSITIVE
-      res = pEntry->Name().compare(name);
-    #else
-      res = pEntry->Name().CmpNoCase(name);
-    #endif
-
-    if ( res > 0 )
-      hi = i;
-    else if ( res < 0 )
-      lo = i + 1;
-    else
-      return pEntry;
-  }
+  wxFileConfigEntriesHash::const_iterator it = m_entriesHash.find(&name);
 
-  return NULL;
+  return it == m_entriesHash.end() ? NULL : it->second;
 }
 
 wxFileConfigGroup *
 wxFileConfigGroup::FindSubgroup(const wxString& name) const
 {
-  size_t
-       lo = 0,
-       hi = m_aSubgroups.GetCount();
-  wxFileConfigGroup *pGroup;
-
-  while ( lo < hi ) {
-    size_t i;
-    i = (lo + hi)/2;
-    pGroup = m_aSubgroups[i];
-
-    int res;
-    #if wxCONFIG_CASE_SENSITIVE
-      res = pGroup->Name().compare(name);
-    #else
-      res = pGroup->Name().CmpNoCase(name);
-    #endif
-
-    if ( res > 0 )
-      hi = i;
-    else if ( res < 0 )
-      lo = i + 1;
-    else
-      return pGroup;
+  wxFileConfigGroupsHash::const_iterator it = m_subgroupsHash.find(&name);
+
+  return it == m_subgroupsHash.end() ? NULL : it->second;
+}
+
+// ----------------------------------------------------------------------------
+// enumerate items
+// ----------------------------------------------------------------------------
+
+const ArrayEntries& wxFileConfigGroup::Entries() const
+{
+  if ( !m_entriesSorted )
+  {
+    m_aEntries.Sort(CompareEntries);
+    m_entriesSorted = true;
   }
 
-  return NULL;
+  return m_aEntries;
+}
+
+const ArrayGroups& wxFileConfigGroup::Groups() const
+{
+  if ( !m_subgroupsSorted )
+  {
+    m_aSubgroups.Sort(CompareGroups);
+    m_subgroupsSorted = true;
+  }
+
+  return m_aSubgroups;
 }
 
 // ----------------------------------------------------------------------------
@@ -1605,7 +1720,16 @@ wxFileConfigEntry *wxFileConfigGroup::AddEntry(const wxString& strName, int nLin
 
     wxFileConfigEntry   *pEntry = new wxFileConfigEntry(this, strName, nLine);
 
-    m_aEntries.Add(pEntry);
+    // don't insert the new entry in the right place in the array, as this
+    // would be too slow when adding many entries, just append it and sort the
+    // array later if it's not already sorted
+    if ( m_entriesSorted && !m_aEntries.IsEmpty() &&
+            CompareEntries(m_aEntries.Last(), pEntry) > 0 )
+        m_entriesSorted = false;
+
+    m_aEntries.AddAt(pEntry, m_aEntries.GetCount());
+    m_entriesHash[&pEntry->Name()] = pEntry;
+
     return pEntry;
 }
 
@@ -1616,7 +1740,13 @@ wxFileConfigGroup *wxFileConfigGroup::AddSubgroup(const wxString& strName)
 
     wxFileConfigGroup   *pGroup = new wxFileConfigGroup(this, strName, m_pConfig);
 
-    m_aSubgroups.Add(pGroup);
+    if ( m_subgroupsSorted && !m_aSubgroups.IsEmpty() &&
+            CompareGroups(m_aSubgroups.Last(), pGroup) > 0 )
+        m_subgroupsSorted = false;
+
+    m_aSubgroups.AddAt(pGroup, m_aSubgroups.GetCount());
+    m_subgroupsHash[&pGroup->Name()] = pGroup;
+
     return pGroup;
 }
 
@@ -1746,6 +1876,7 @@ bool wxFileConfigGroup::DeleteSubgroup(wxFileConfigGroup *pGroup)
                     pGroup->Name().c_str() );
     }
 
+    m_subgroupsHash.erase(&pGroup->Name());
     m_aSubgroups.Remove(pGroup);
     delete pGroup;
 
@@ -1794,6 +1925,7 @@ bool wxFileConfigGroup::DeleteEntry(const wxString& name)
     m_pConfig->LineListRemove(pLine);
   }
 
+  m_entriesHash.erase(&pEntry->Name());
   m_aEntries.Remove(pEntry);
   delete pEntry;
 
@@ -2103,4 +2235,68 @@ static wxString GetAppName(const wxString& appName)
         return appName;
 }
 
+// ----------------------------------------------------------------------------
+// reading config files
+// ----------------------------------------------------------------------------
+
+static bool ReadConfigFile(const wxString& path, wxMemoryBuffer& buf)
+{
+    wxFile file;
+    if ( !file.Open(path) )
+        return false;
+
+    const wxFileOffset length = file.Length();
+    if ( length == wxInvalidOffset )
+        return false;
+
+    wxCHECK_MSG( (wxFileOffset)(size_t)length == length, false,
+                 wxT("huge file not supported") );
+
+    char * const data = static_cast<char *>(buf.GetWriteBuf(length));
+    size_t len = 0;
+    while ( len < (size_t)length )
+    {
+        const ssize_t nread = file.Read(data + len, length - len);
+        if ( nread == wxInvalidOffset )
+            return false;
+
+        // the file could have been truncated since we got its length
+        if ( nread == 0 )
+            break;
+
+        len += nread;
+    }
+
+    buf.UngetWriteBuf(len);
+
+    return true;
+}
+
+static bool
+ConvertConfigText(wxMemoryBuffer& buf, const wxMBConv& conv, wxWxCharBuffer& text)
+{
+#if wxUSE_UNICODE
+    // empty buffer can't be converted, but is not an error
+    if ( !buf.GetDataLen() )
+    {
+        text = wxWCharBuffer(L"");
+        return true;
+    }
+
+    // notice that the converted buffer is always NUL-terminated
+    text = conv.cMB2WC(static_cast<char *>(buf.GetData()), buf.GetDataLen(), NULL);
+
+    return text.data() != NULL;
+#else // !wxUSE_UNICODE
+    wxUnusedVar(conv);
+
+    // no need for conversion, just reuse the data, after NUL-terminating it
+    buf.AppendByte('\0');
+    text = wxCharBuffer::CreateNonOwned(static_cast<char *>(buf.GetData()),
+                                        buf.GetDataLen() - 1);
+
+    return true;
+#endif // wxUSE_UNICODE/!wxUSE_UNICODE
+}
+
 #endif // wxUSE_CONFIG
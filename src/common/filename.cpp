@@ -2106,8 +2106,11 @@ wxString wxFileName::GetFullPath( wxPathFormat format ) const
     wxString fullpath = GetPath(wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR,
                                 format);
 
-    // now just add the file name and extension to it
-    fullpath += GetFullName();
+    // now just add the file name and extension to it, without using
+    // GetFullName() to avoid creating a temporary string
+    fullpath += m_name;
+    if ( m_hasExt )
+        fullpath << wxFILE_SEP_EXT << m_ext;
 
     return fullpath;
 }
@@ -63,7 +63,7 @@ public:
     wxArchiveFSEntry *GetNext(wxArchiveFSEntry *fse);
 
 private:
-    wxArchiveFSEntry *AddToCache(wxArchiveEntry *entry);
+    wxArchiveFSEntry *AddToCache(wxArchiveEntry *entry, const wxString& name);
     void CloseStreams();
 
     int m_refcount;
@@ -116,9 +116,10 @@ wxArchiveFSCacheDataImpl::~wxArchiveFSCacheDataImpl()
     CloseStreams();
 }
 
-wxArchiveFSEntry *wxArchiveFSCacheDataImpl::AddToCache(wxArchiveEntry *entry)
+wxArchiveFSEntry *wxArchiveFSCacheDataImpl::AddToCache(wxArchiveEntry *entry,
+                                                       const wxString& name)
 {
-    m_hash[entry->GetName(wxPATH_UNIX)] = entry;
+    m_hash[name] = entry;
     wxArchiveFSEntry *fse = new wxArchiveFSEntry;
     *m_endptr = fse;
     (*m_endptr)->entry = entry;
@@ -147,9 +148,11 @@ wxArchiveEntry *wxArchiveFSCacheDataImpl::Get(const wxString& name)
 
     while ((entry = m_archive->GetNextEntry()) != NULL)
     {
-        AddToCache(entry);
+        const wxString entryName = entry->GetName(wxPATH_UNIX);
 
-        if (entry->GetName(wxPATH_UNIX) == name)
+        AddToCache(entry, entryName);
+
+        if (entryName == name)
             return entry;
     }
 
@@ -175,7 +178,7 @@ wxArchiveFSEntry *wxArchiveFSCacheDataImpl::GetNext(wxArchiveFSEntry *fse)
         wxArchiveEntry *entry = m_archive->GetNextEntry();
 
         if (entry)
-            next = AddToCache(entry);
+            next = AddToCache(entry, entry->GetName(wxPATH_UNIX));
         else
             CloseStreams();
     }
@@ -31,6 +31,10 @@
 #include "wx/wfstream.h"
 #include "wx/xpmdecod.h"
 
+#if wxUSE_THREADS
+    #include "wx/thread.h"
+#endif
+
 // For memcpy
 #include <string.h>
 
@@ -133,6 +137,168 @@ wxImageRefData::~wxImageRefData()
 }
 
 
+//-----------------------------------------------------------------------------
+// helpers for processing the image in parallel
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+// Maximal number of threads used for image processing, 1 by default meaning
+// that everything is done in the calling thread and 0 meaning to use as many
+// threads as there are CPUs.
+int gs_maxProcessingThreads = 1;
+
+// Size of the bands of rows (or columns) processed at once: they should be
+// small enough to fit into the CPU cache, but big enough for the overhead of
+// distributing them among the threads to be negligible.
+const size_t BAND_SIZE_IN_BYTES = 256*1024;
+
+// Base class for the image operations which can be applied to the different
+// parts of the image independently.
+class ImageBandsProcessor
+{
+public:
+    ImageBandsProcessor() { }
+    virtual ~ImageBandsProcessor() { }
+
+    // Process the lines (usually rows) in [start, end) range.
+    virtual void ProcessBand(int start, int end) = 0;
+
+    wxDECLARE_NO_COPY_CLASS(ImageBandsProcessor);
+};
+
+#if wxUSE_THREADS
+
+// Object shared by all the threads processing the same image and giving out
+// the bands to process to them.
+class ImageBandsDispatcher
+{
+public:
+    ImageBandsDispatcher(ImageBandsProcessor& processor,
+                         int count,
+                         int linesPerBand)
+        : m_processor(processor),
+          m_count(count),
+          m_linesPerBand(linesPerBand),
+          m_next(0)
+    {
+    }
+
+    // Process the bands until there are no more of them left.
+    void ProcessAll()
+    {
+        int start, end;
+        while ( GetNext(start, end) )
+            m_processor.ProcessBand(start, end);
+    }
+
+private:
+    bool GetNext(int& start, int& end)
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        if ( m_next >= m_count )
+            return false;
+
+        start = m_next;
+        m_next = wxMin(m_next + m_linesPerBand, m_count);
+        end = m_next;
+
+        return true;
+    }
+
+    ImageBandsProcessor& m_processor;
+    const int m_count;
+    const int m_linesPerBand;
+
+    wxCriticalSection m_cs;
+    int m_next;
+
+    wxDECLARE_NO_COPY_CLASS(ImageBandsDispatcher);
+};
+
+class ImageBandsThread : public wxThread
+{
+public:
+    explicit ImageBandsThread(ImageBandsDispatcher& dispatcher)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_dispatcher(dispatcher)
+    {
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        m_dispatcher.ProcessAll();
+
+        return 0;
+    }
+
+private:
+    ImageBandsDispatcher& m_dispatcher;
+
+    wxDECLARE_NO_COPY_CLASS(ImageBandsThread);
+};
+
+#endif // wxUSE_THREADS
+
+// Process "count" lines of "bytesPerLine" size each, possibly using several
+// threads if this was allowed by wxImage::SetMaxProcessingThreads(). The
+// processor must not use any state shared between the different bands.
+void ProcessImageBands(ImageBandsProcessor& processor,
+                       int count,
+                       size_t bytesPerLine)
+{
+#if wxUSE_THREADS
+    int threads = gs_maxProcessingThreads;
+    if ( threads == 0 )
+        threads = wxThread::GetCPUCount();
+
+    const int linesPerBand =
+        static_cast<int>(wxMax(BAND_SIZE_IN_BYTES / wxMax(bytesPerLine, 1), 1));
+
+    // There is no need to use more threads than there are bands.
+    threads = wxMin(threads, (count + linesPerBand - 1) / linesPerBand);
+
+    if ( threads > 1 )
+    {
+        ImageBandsDispatcher dispatcher(processor, count, linesPerBand);
+
+        wxVector<ImageBandsThread*> workers;
+        for ( int n = 1; n < threads; n++ )
+        {
+            ImageBandsThread* const thread = new ImageBandsThread(dispatcher);
+            if ( thread->Run() != wxTHREAD_NO_ERROR )
+            {
+                // Not fatal, we'll just use fewer threads.
+                delete thread;
+                break;
+            }
+
+            workers.push_back(thread);
+        }
+
+        // The current thread participates in the processing too.
+        dispatcher.ProcessAll();
+
+        for ( size_t n = 0; n < workers.size(); n++ )
+        {
+            workers[n]->Wait();
+            delete workers[n];
+        }
+
+        return;
+    }
+#else // !wxUSE_THREADS
+    wxUnusedVar(bytesPerLine);
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+
+    processor.ProcessBand(0, count);
+}
+
+} // anonymous namespace
+
 //-----------------------------------------------------------------------------
 // wxImage
 //-----------------------------------------------------------------------------
@@ -481,6 +647,10 @@ wxImage::Scale( int width, int height, wxImageResizeQuality quality ) const
                         ? ResampleBox(width, height)
                         : ResampleBicubic(width, height);
             break;
+
+        case wxIMAGE_QUALITY_LANCZOS:
+            image = ResampleLanczos(width, height);
+            break;
     }
 
     // If the original image has a mask, apply the mask to the new image
@@ -619,6 +789,12 @@ wxImage wxImage::ResampleBox(int width, int height) const
     // downsampling that gives reasonably smooth results To scale the image
     // down we will need to gather a grid of pixels of the size of the scale
     // factor in each direction and then do an averaging of the pixels.
+    //
+    // As the box filter is separable, we first sum up the columns of all the
+    // source rows covered by the box of the current destination row and then
+    // add up these column sums for each destination pixel. All the sums are
+    // integer, so the result is exactly the same as when summing up all the
+    // pixels of each box directly, but each source pixel is only read once.
 
     wxImage ret_image(width, height, false);
 
@@ -629,6 +805,7 @@ wxImage wxImage::ResampleBox(int width, int height) const
     ResampleBoxPrecalc(hPrecalcs, M_IMGDATA->m_width);
 
 
+    const int old_width = M_IMGDATA->m_width;
     const unsigned char* src_data = M_IMGDATA->m_data;
     const unsigned char* src_alpha = M_IMGDATA->m_alpha;
     unsigned char* dst_data = ret_image.GetData();
@@ -640,48 +817,68 @@ wxImage wxImage::ResampleBox(int width, int height) const
         dst_alpha = ret_image.GetAlpha();
     }
 
-    int averaged_pixels, src_pixel_index;
-    double sum_r, sum_g, sum_b, sum_a;
+    // Sums of the colour components (premultiplied by alpha if we have it)
+    // and of alpha itself for all source columns.
+    const int channels = src_alpha ? 4 : 3;
+    wxVector<wxUint64> columnSums(old_width * channels);
+    wxUint64* const sums = &columnSums[0];
 
     for ( int y = 0; y < height; y++ )         // Destination image - Y direction
     {
         // Source pixel in the Y direction
         const BoxPrecalc& vPrecalc = vPrecalcs[y];
 
+        memset(sums, 0, old_width * channels * sizeof(wxUint64));
+
+        for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
+        {
+            const unsigned char* src = src_data + j * old_width * 3;
+
+            if ( src_alpha )
+            {
+                const unsigned char* alpha = src_alpha + j * old_width;
+                wxUint64* sum = sums;
+                for ( int i = 0; i < old_width; ++i, src += 3, sum += 4 )
+                {
+                    const unsigned a = alpha[i];
+                    sum[0] += src[0] * a;
+                    sum[1] += src[1] * a;
+                    sum[2] += src[2] * a;
+                    sum[3] += a;
+                }
+            }
+            else
+            {
+                for ( int i = 0; i < old_width * 3; ++i )
+                    sums[i] += src[i];
+            }
+        }
+
+        const int box_height = vPrecalc.boxEnd - vPrecalc.boxStart + 1;
+
         for ( int x = 0; x < width; x++ )      // Destination image - X direction
         {
             // Source pixel in the X direction
             const BoxPrecalc& hPrecalc = hPrecalcs[x];
 
             // Box of pixels to average
-            averaged_pixels = 0;
-            sum_r = sum_g = sum_b = sum_a = 0.0;
+            wxUint64 sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
 
-            for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
+            const wxUint64* sum = sums + hPrecalc.boxStart * channels;
+            for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
             {
-                for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
-                {
-                    // Calculate the actual index in our source pixels
-                    src_pixel_index = j * M_IMGDATA->m_width + i;
+                sum_r += sum[0];
+                sum_g += sum[1];
+                sum_b += sum[2];
+                if ( src_alpha )
+                    sum_a += sum[3];
 
-                    if (src_alpha)
-                    {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * src_alpha[src_pixel_index];
-                        sum_g += src_data[src_pixel_index * 3 + 1] * src_alpha[src_pixel_index];
-                        sum_b += src_data[src_pixel_index * 3 + 2] * src_alpha[src_pixel_index];
-                        sum_a += src_alpha[src_pixel_index];
-                    }
-                    else
-                    {
-                        sum_r += src_data[src_pixel_index * 3 + 0];
-                        sum_g += src_data[src_pixel_index * 3 + 1];
-                        sum_b += src_data[src_pixel_index * 3 + 2];
-                    }
-
-                    averaged_pixels++;
-                }
+                sum += channels;
             }
 
+            const wxUint64 averaged_pixels =
+                box_height * (hPrecalc.boxEnd - hPrecalc.boxStart + 1);
+
             // Calculate the average from the sum and number of averaged pixels
             if (src_alpha)
             {
@@ -715,6 +912,278 @@ wxImage wxImage::ResampleBox(int width, int height) const
 namespace
 {
 
+// Number of fractional bits in the fixed point filter weights.
+const int RESAMPLE_WEIGHT_BITS = 14;
+
+// Number of extra fractional bits kept in the intermediate results of the
+// horizontal pass to avoid accumulating rounding errors.
+const int RESAMPLE_EXTRA_BITS = 6;
+
+// Filter table used for resampling the image in one direction: each of the
+// destination pixels is a weighted sum of "taps" source pixels.
+struct ResampleFilter
+{
+    ResampleFilter(int newDim, int taps_)
+        : taps(taps_),
+          offsets(newDim * taps_),
+          weights(newDim * taps_)
+    {
+    }
+
+    // Set the source pixels and their weights for the given destination
+    // pixel, the weights don't need to be normalized.
+    void Set(int dst, const int* offs, const double* w)
+    {
+        int* const dstOffsets = &offsets[dst * taps];
+        int* const dstWeights = &weights[dst * taps];
+
+        double total = 0;
+        for ( int n = 0; n < taps; n++ )
+            total += w[n];
+
+        // Convert the weights to fixed point by rounding their running sum
+        // rather than each of them individually: this diffuses the rounding
+        // error of each weight into the next one instead of accumulating it,
+        // which matters for the wide filters used for big downscaling factors
+        // where each weight is only a few units, and also ensures that they
+        // sum up to exactly 1, as otherwise the uniformly coloured areas could
+        // slightly change their colour.
+        const int one = 1 << RESAMPLE_WEIGHT_BITS;
+        double partial = 0;
+        int sum = 0;
+        for ( int n = 0; n < taps; n++ )
+        {
+            partial += w[n];
+
+            const int next = n == taps - 1 ? one
+                                           : wxRound(partial * one / total);
+
+            dstOffsets[n] = offs[n];
+            dstWeights[n] = next - sum;
+
+            sum = next;
+        }
+    }
+
+    int taps;
+    wxVector<int> offsets;
+    wxVector<int> weights;
+};
+
+inline unsigned char ClampToByte(int value)
+{
+    return value < 0 ? 0 : value > 255 ? 255 : static_cast<unsigned char>(value);
+}
+
+// Apply the horizontal filter to a single row of the source image, storing
+// the results with RESAMPLE_EXTRA_BITS fractional bits in "out".
+//
+// If "alpha" is non-NULL, the output has 4 channels and, if "premultiply" is
+// true, the colour components are weighted by alpha (without any extra bits,
+// as they already have 16 significant bits then).
+void ResampleRow(const unsigned char* data,
+                 const unsigned char* alpha,
+                 bool premultiply,
+                 const ResampleFilter& filter,
+                 int width,
+                 int* out)
+{
+    const int shift = RESAMPLE_WEIGHT_BITS - RESAMPLE_EXTRA_BITS;
+    const int round = 1 << (shift - 1);
+    const int taps = filter.taps;
+    const int* offsets = &filter.offsets[0];
+    const int* weights = &filter.weights[0];
+
+    if ( !alpha )
+    {
+        for ( int x = 0; x < width; x++, offsets += taps, weights += taps )
+        {
+            int r = 0, g = 0, b = 0;
+            for ( int n = 0; n < taps; n++ )
+            {
+                const unsigned char* const src = data + offsets[n] * 3;
+                r += src[0] * weights[n];
+                g += src[1] * weights[n];
+                b += src[2] * weights[n];
+            }
+
+            *out++ = (r + round) >> shift;
+            *out++ = (g + round) >> shift;
+            *out++ = (b + round) >> shift;
+        }
+    }
+    else if ( !premultiply )
+    {
+        for ( int x = 0; x < width; x++, offsets += taps, weights += taps )
+        {
+            int r = 0, g = 0, b = 0, a = 0;
+            for ( int n = 0; n < taps; n++ )
+            {
+                const unsigned char* const src = data + offsets[n] * 3;
+                r += src[0] * weights[n];
+                g += src[1] * weights[n];
+                b += src[2] * weights[n];
+                a += alpha[offsets[n]] * weights[n];
+            }
+
+            *out++ = (r + round) >> shift;
+            *out++ = (g + round) >> shift;
+            *out++ = (b + round) >> shift;
+            *out++ = (a + round) >> shift;
+        }
+    }
+    else // premultiplied alpha
+    {
+        // The products of colour and alpha use 16 bits and the weights may be
+        // slightly greater than 1 for the filters with negative lobes, but
+        // the sums still fit into 31 bits.
+        const int roundPremult = 1 << (RESAMPLE_WEIGHT_BITS - 1);
+        const int maxPremult = 255 * 255;
+        const int maxAlpha = 255 << RESAMPLE_EXTRA_BITS;
+
+        for ( int x = 0; x < width; x++, offsets += taps, weights += taps )
+        {
+            int r = 0, g = 0, b = 0, a = 0;
+            for ( int n = 0; n < taps; n++ )
+            {
+                const unsigned char* const src = data + offsets[n] * 3;
+                const int aw = alpha[offsets[n]] * weights[n];
+                r += src[0] * aw;
+                g += src[1] * aw;
+                b += src[2] * aw;
+                a += aw;
+            }
+
+            r = (r + roundPremult) >> RESAMPLE_WEIGHT_BITS;
+            g = (g + roundPremult) >> RESAMPLE_WEIGHT_BITS;
+            b = (b + roundPremult) >> RESAMPLE_WEIGHT_BITS;
+            a = (a + round) >> shift;
+
+            *out++ = wxMax(0, wxMin(r, maxPremult));
+            *out++ = wxMax(0, wxMin(g, maxPremult));
+            *out++ = wxMax(0, wxMin(b, maxPremult));
+            *out++ = wxMax(0, wxMin(a, maxAlpha));
+        }
+    }
+}
+
+// Resample the image using the given separable filters: the horizontal filter
+// is applied to the source rows first and the vertical one is then applied to
+// the results of the first pass. Only as many rows as there are taps in the
+// vertical filter are kept in memory at any time and each of the source rows
+// is processed only once, as the filter offsets are increasing.
+//
+// The destination image must have the right size and have alpha if and only
+// if the source image has it. If "premultiply" is true, the colours are
+// weighted by alpha, otherwise alpha is treated as an independent channel.
+void ResampleSeparable(const wxImage& src,
+                       wxImage& dst,
+                       const ResampleFilter& hFilter,
+                       const ResampleFilter& vFilter,
+                       bool premultiply)
+{
+    const int old_width = src.GetWidth();
+    const int width = dst.GetWidth();
+    const int height = dst.GetHeight();
+
+    const unsigned char* const src_data = src.GetData();
+    const unsigned char* const src_alpha = src.GetAlpha();
+    unsigned char* dst_data = dst.GetData();
+    unsigned char* dst_alpha = dst.GetAlpha();
+
+    if ( !src_alpha )
+        premultiply = false;
+
+    const int channels = src_alpha ? 4 : 3;
+    const int stride = width * channels;
+    const int taps = vFilter.taps;
+
+    // Ring buffer of the horizontally resampled rows and the index of the
+    // source row stored in each of its slots.
+    wxVector<int> rows(taps * stride);
+    wxVector<int> rowInSlot(taps, -1);
+
+    wxVector<int> sums(stride);
+    int* const sum = &sums[0];
+
+    const int shift = RESAMPLE_WEIGHT_BITS + RESAMPLE_EXTRA_BITS;
+    const int round = 1 << (shift - 1);
+
+    for ( int y = 0; y < height; y++ )
+    {
+        const int* const offsets = &vFilter.offsets[y * taps];
+        const int* const weights = &vFilter.weights[y * taps];
+
+        memset(sum, 0, stride * sizeof(int));
+
+        for ( int n = 0; n < taps; n++ )
+        {
+            const int weight = weights[n];
+            if ( !weight )
+                continue;
+
+            const int srcRow = offsets[n];
+            const int slot = srcRow % taps;
+            int* const row = &rows[slot * stride];
+            if ( rowInSlot[slot] != srcRow )
+            {
+                ResampleRow(src_data + srcRow * old_width * 3,
+                            src_alpha ? src_alpha + srcRow * old_width : NULL,
+                            premultiply,
+                            hFilter,
+                            width,
+                            row);
+                rowInSlot[slot] = srcRow;
+            }
+
+            for ( int i = 0; i < stride; i++ )
+                sum[i] += row[i] * weight;
+        }
+
+        if ( !premultiply )
+        {
+            for ( int x = 0; x < width; x++ )
+            {
+                const int* const p = sum + x * channels;
+
+                *dst_data++ = ClampToByte((p[0] + round) >> shift);
+                *dst_data++ = ClampToByte((p[1] + round) >> shift);
+                *dst_data++ = ClampToByte((p[2] + round) >> shift);
+                if ( dst_alpha )
+                    *dst_alpha++ = ClampToByte((p[3] + round) >> shift);
+            }
+        }
+        else
+        {
+            for ( int x = 0; x < width; x++ )
+            {
+                const int* const p = sum + x * 4;
+
+                // Colour sums have RESAMPLE_WEIGHT_BITS fractional bits and
+                // the alpha one has RESAMPLE_EXTRA_BITS more than that.
+                const wxInt64 a = p[3];
+                if ( a > 0 )
+                {
+                    for ( int c = 0; c < 3; c++ )
+                    {
+                        const wxInt64
+                            v = ((wxInt64(p[c]) << RESAMPLE_EXTRA_BITS) + a / 2) / a;
+                        *dst_data++ = ClampToByte(static_cast<int>(wxMin(v, 255)));
+                    }
+                }
+                else
+                {
+                    *dst_data++ = 0;
+                    *dst_data++ = 0;
+                    *dst_data++ = 0;
+                }
+
+                *dst_alpha++ = ClampToByte((p[3] + round) >> shift);
+            }
+        }
+    }
+}
+
 struct BilinearPrecalc
 {
     int offset1;
@@ -770,83 +1239,40 @@ void ResampleBilinearPrecalc(wxVector<BilinearPrecalc>& precalcs, int oldDim)
     }
 }
 
-} // anonymous namespace
-
-wxImage wxImage::ResampleBilinear(int width, int height) const
+void ResampleBilinearFilter(ResampleFilter& filter, int oldDim)
 {
-    // This function implements a Bilinear algorithm for resampling.
-    wxImage ret_image(width, height, false);
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = NULL;
+    const int newDim = filter.offsets.size() / filter.taps;
 
-    if ( src_alpha )
-    {
-        ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
-    }
-
-    wxVector<BilinearPrecalc> vPrecalcs(height);
-    wxVector<BilinearPrecalc> hPrecalcs(width);
-    ResampleBilinearPrecalc(vPrecalcs, M_IMGDATA->m_height);
-    ResampleBilinearPrecalc(hPrecalcs, M_IMGDATA->m_width);
+    wxVector<BilinearPrecalc> precalcs(newDim);
+    ResampleBilinearPrecalc(precalcs, oldDim);
 
-    // initialize alpha values to avoid g++ warnings about possibly
-    // uninitialized variables
-    double r1, g1, b1, a1 = 0;
-    double r2, g2, b2, a2 = 0;
-
-    for ( int dsty = 0; dsty < height; dsty++ )
+    for ( int dst = 0; dst < newDim; dst++ )
     {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BilinearPrecalc& vPrecalc = vPrecalcs[dsty];
-        const int y_offset1 = vPrecalc.offset1;
-        const int y_offset2 = vPrecalc.offset2;
-        const double dy = vPrecalc.dd;
-        const double dy1 = vPrecalc.dd1;
+        const BilinearPrecalc& precalc = precalcs[dst];
 
+        const int offsets[2] = { precalc.offset1, precalc.offset2 };
+        const double weights[2] = { precalc.dd1, precalc.dd };
+        filter.Set(dst, offsets, weights);
+    }
+}
 
-        for ( int dstx = 0; dstx < width; dstx++ )
-        {
-            // X-axis of pixel to interpolate from
-            const BilinearPrecalc& hPrecalc = hPrecalcs[dstx];
-
-            const int x_offset1 = hPrecalc.offset1;
-            const int x_offset2 = hPrecalc.offset2;
-            const double dx = hPrecalc.dd;
-            const double dx1 = hPrecalc.dd1;
-
-            int src_pixel_index00 = y_offset1 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index01 = y_offset1 * M_IMGDATA->m_width + x_offset2;
-            int src_pixel_index10 = y_offset2 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index11 = y_offset2 * M_IMGDATA->m_width + x_offset2;
-
-            // first line
-            r1 = src_data[src_pixel_index00 * 3 + 0] * dx1 + src_data[src_pixel_index01 * 3 + 0] * dx;
-            g1 = src_data[src_pixel_index00 * 3 + 1] * dx1 + src_data[src_pixel_index01 * 3 + 1] * dx;
-            b1 = src_data[src_pixel_index00 * 3 + 2] * dx1 + src_data[src_pixel_index01 * 3 + 2] * dx;
-            if ( src_alpha )
-                a1 = src_alpha[src_pixel_index00] * dx1 + src_alpha[src_pixel_index01] * dx;
+} // anonymous namespace
 
-            // second line
-            r2 = src_data[src_pixel_index10 * 3 + 0] * dx1 + src_data[src_pixel_index11 * 3 + 0] * dx;
-            g2 = src_data[src_pixel_index10 * 3 + 1] * dx1 + src_data[src_pixel_index11 * 3 + 1] * dx;
-            b2 = src_data[src_pixel_index10 * 3 + 2] * dx1 + src_data[src_pixel_index11 * 3 + 2] * dx;
-            if ( src_alpha )
-                a2 = src_alpha[src_pixel_index10] * dx1 + src_alpha[src_pixel_index11] * dx;
+wxImage wxImage::ResampleBilinear(int width, int height) const
+{
+    // This function implements a Bilinear algorithm for resampling.
+    wxImage ret_image(width, height, false);
 
-            // result lines
+    if ( M_IMGDATA->m_alpha )
+        ret_image.SetAlpha();
 
-            dst_data[0] = static_cast<unsigned char>(r1 * dy1 + r2 * dy + .5);
-            dst_data[1] = static_cast<unsigned char>(g1 * dy1 + g2 * dy + .5);
-            dst_data[2] = static_cast<unsigned char>(b1 * dy1 + b2 * dy + .5);
-            dst_data += 3;
+    ResampleFilter vFilter(height, 2);
+    ResampleFilter hFilter(width, 2);
+    ResampleBilinearFilter(vFilter, M_IMGDATA->m_height);
+    ResampleBilinearFilter(hFilter, M_IMGDATA->m_width);
 
-            if ( src_alpha )
-                *dst_alpha++ = static_cast<unsigned char>(a1 * dy1 + a2 * dy +.5);
-        }
-    }
+    // Alpha is interpolated independently of the colour components here.
+    ResampleSeparable(*this, ret_image, hFilter, vFilter, false);
 
     return ret_image;
 }
@@ -920,6 +1346,17 @@ void ResampleBicubicPrecalc(wxVector<BicubicPrecalc> &aWeight, int oldDim)
     }
 }
 
+void ResampleBicubicFilter(ResampleFilter& filter, int oldDim)
+{
+    const int newDim = filter.offsets.size() / filter.taps;
+
+    wxVector<BicubicPrecalc> precalcs(newDim);
+    ResampleBicubicPrecalc(precalcs, oldDim);
+
+    for ( int dst = 0; dst < newDim; dst++ )
+        filter.Set(dst, precalcs[dst].offset, precalcs[dst].weight);
+}
+
 } // anonymous namespace
 
 // This is the bicubic resampling algorithm
@@ -955,208 +1392,345 @@ wxImage wxImage::ResampleBicubic(int width, int height) const
 
     ret_image.Create(width, height, false);
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = NULL;
-
-    if ( src_alpha )
-    {
+    if ( M_IMGDATA->m_alpha )
         ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
-    }
 
-    // Precalculate weights
-    wxVector<BicubicPrecalc> vPrecalcs(height);
-    wxVector<BicubicPrecalc> hPrecalcs(width);
+    // Precalculate weights: as the B-spline kernel is separable, we can apply
+    // it to the rows and to the columns independently.
+    ResampleFilter vFilter(height, 4);
+    ResampleFilter hFilter(width, 4);
 
-    ResampleBicubicPrecalc(vPrecalcs, M_IMGDATA->m_height);
-    ResampleBicubicPrecalc(hPrecalcs, M_IMGDATA->m_width);
+    ResampleBicubicFilter(vFilter, M_IMGDATA->m_height);
+    ResampleBicubicFilter(hFilter, M_IMGDATA->m_width);
 
-    for ( int dsty = 0; dsty < height; dsty++ )
-    {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BicubicPrecalc& vPrecalc = vPrecalcs[dsty];
+    ResampleSeparable(*this, ret_image, hFilter, vFilter, true);
 
-        for ( int dstx = 0; dstx < width; dstx++ )
-        {
-            // X-axis of pixel to interpolate from
-            const BicubicPrecalc& hPrecalc = hPrecalcs[dstx];
+    return ret_image;
+}
 
-            // Sums for each color channel
-            double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+namespace
+{
 
-            // Here we actually determine the RGBA values for the destination pixel
-            for ( int k = -1; k <= 2; k++ )
-            {
-                // Y offset
-                const int y_offset = vPrecalc.offset[k + 1];
+inline double sinc(double x)
+{
+    if ( x == 0.0 )
+        return 1.0;
 
-                // Loop across the X axis
-                for ( int i = -1; i <= 2; i++ )
-                {
-                    // X offset
-                    const int x_offset = hPrecalc.offset[i + 1];
-
-                    // Calculate the exact position where the source data
-                    // should be pulled from based on the x_offset and y_offset
-                    int src_pixel_index = y_offset*M_IMGDATA->m_width + x_offset;
-
-                    // Calculate the weight for the specified pixel according
-                    // to the bicubic b-spline kernel we're using for
-                    // interpolation
-                    const double
-                        pixel_weight = vPrecalc.weight[k + 1] * hPrecalc.weight[i + 1];
-
-                    // Create a sum of all velues for each color channel
-                    // adjusted for the pixel's calculated weight
-                    if ( src_alpha )
-                    {
-                        const unsigned char a = src_alpha[src_pixel_index];
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight * a;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight * a;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight * a;
-                        sum_a += a * pixel_weight;
-                    }
-                    else
-                    {
-                        sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight;
-                        sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight;
-                        sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight;
-                    }
-                }
-            }
+    x *= M_PI;
+    return sin(x) / x;
+}
 
-            // Put the data into the destination image.  The summed values are
-            // of double data type and are rounded here for accuracy
-            if ( src_alpha )
-            {
-                if ( sum_a )
-                {
-                     dst_data[0] = (unsigned char)(sum_r / sum_a + 0.5);
-                     dst_data[1] = (unsigned char)(sum_g / sum_a + 0.5);
-                     dst_data[2] = (unsigned char)(sum_b / sum_a + 0.5);
-                }
-                else
-                {
-                    dst_data[0] = 0;
-                    dst_data[1] = 0;
-                    dst_data[2] = 0;
-                }
-                *dst_alpha++ = (unsigned char)sum_a;
-            }
-            else
-            {
-                dst_data[0] = (unsigned char)(sum_r + 0.5);
-                dst_data[1] = (unsigned char)(sum_g + 0.5);
-                dst_data[2] = (unsigned char)(sum_b + 0.5);
-            }
-            dst_data += 3;
+inline double lanczos3_weight(double x)
+{
+    return x > -3.0 && x < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+}
+
+// Compute the number of taps needed by the Lanczos filter for the given scale.
+int ResampleLanczosTaps(int newDim, int oldDim)
+{
+    // When downscaling, the kernel is stretched to cover all the source
+    // pixels contributing to the destination one to avoid aliasing.
+    const double support = 3.0 * wxMax(double(oldDim) / newDim, 1.0);
+
+    return static_cast<int>(ceil(2 * support)) + 1;
+}
+
+void ResampleLanczosFilter(ResampleFilter& filter, int oldDim)
+{
+    const int taps = filter.taps;
+    const int newDim = filter.offsets.size() / taps;
+
+    // Unlike in the bilinear and bicubic cases, pixel centres are mapped to
+    // each other here, i.e. [-0.5 .. newDim-0.5] is mapped to
+    // [-0.5 .. oldDim-0.5], as is customary for the downscaling filters.
+    const double scale = double(oldDim) / newDim;
+    const double filterScale = wxMax(scale, 1.0);
+    const double support = 3.0 * filterScale;
+
+    wxVector<int> offsets(taps);
+    wxVector<double> weights(taps);
+
+    for ( int dst = 0; dst < newDim; dst++ )
+    {
+        const double center = (dst + 0.5) * scale;
+        const int first = static_cast<int>(floor(center - support));
+
+        for ( int n = 0; n < taps; n++ )
+        {
+            const int srcpix = first + n;
+
+            // Extend the border pixels outside of the image.
+            offsets[n] = srcpix < 0
+                            ? 0
+                            : srcpix >= oldDim
+                                ? oldDim - 1
+                                : srcpix;
+
+            weights[n] = lanczos3_weight((srcpix + 0.5 - center) / filterScale);
         }
+
+        filter.Set(dst, &offsets[0], &weights[0]);
     }
+}
+
+} // anonymous namespace
+
+wxImage wxImage::ResampleLanczos(int width, int height) const
+{
+    // This function implements resampling using Lanczos-3 (i.e. windowed sinc)
+    // filter which preserves more details than the box average when reducing
+    // the image size, at the price of possible slight ringing near the edges.
+    wxImage ret_image(width, height, false);
+
+    if ( M_IMGDATA->m_alpha )
+        ret_image.SetAlpha();
+
+    ResampleFilter vFilter(height, ResampleLanczosTaps(height, M_IMGDATA->m_height));
+    ResampleFilter hFilter(width, ResampleLanczosTaps(width, M_IMGDATA->m_width));
+
+    ResampleLanczosFilter(vFilter, M_IMGDATA->m_height);
+    ResampleLanczosFilter(hFilter, M_IMGDATA->m_width);
+
+    ResampleSeparable(*this, ret_image, hFilter, vFilter, true);
 
     return ret_image;
 }
 
-// Blur in the horizontal direction
-wxImage wxImage::BlurHorizontal(int blurRadius) const
+namespace
 {
-    wxImage ret_image(MakeEmptyClone());
 
-    wxCHECK( ret_image.IsOk(), ret_image );
+// Common base class for the horizontal and vertical blur implementations.
+class BlurProcessorBase : public ImageBandsProcessor
+{
+protected:
+    BlurProcessorBase(const wxImage& src, wxImage& dst, int blurRadius)
+        : m_srcData(src.GetData()),
+          m_srcAlpha(src.GetAlpha()),
+          m_dstData(dst.GetData()),
+          m_dstAlpha(dst.GetAlpha()),
+          m_width(src.GetWidth()),
+          m_height(src.GetHeight()),
+          m_blurRadius(blurRadius),
+          // number of pixels we average over
+          m_blurArea(blurRadius*2 + 1)
+    {
+    }
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
+    const unsigned char* const m_srcData;
+    const unsigned char* const m_srcAlpha;
+    unsigned char* const m_dstData;
+    unsigned char* const m_dstAlpha;
+    const int m_width;
+    const int m_height;
+    const int m_blurRadius;
+    const int m_blurArea;
+};
 
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
+class BlurHorizontalProcessor : public BlurProcessorBase
+{
+public:
+    BlurHorizontalProcessor(const wxImage& src, wxImage& dst, int blurRadius)
+        : BlurProcessorBase(src, dst, blurRadius)
+    {
+    }
 
     // Horizontal blurring algorithm - average all pixels in the specified blur
     // radius in the X or horizontal direction
-    for ( int y = 0; y < M_IMGDATA->m_height; y++ )
+    virtual void ProcessBand(int start, int end) wxOVERRIDE
     {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in the blur radius for the first
-        // pixel of the row
-        for ( int kernel_x = -blurRadius; kernel_x <= blurRadius; kernel_x++ )
+        for ( int y = start; y < end; y++ )
         {
-            // To deal with the pixels at the start of a row so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous row
-            if ( kernel_x < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = kernel_x + y * M_IMGDATA->m_width;
+            // Variables used in the blurring algorithm
+            long sum_r = 0,
+                 sum_g = 0,
+                 sum_b = 0,
+                 sum_a = 0;
+
+            long pixel_idx;
+            const unsigned char *src;
+            unsigned char *dst;
+
+            // Calculate the average of all pixels in the blur radius for the first
+            // pixel of the row
+            for ( int kernel_x = -m_blurRadius; kernel_x <= m_blurRadius; kernel_x++ )
+            {
+                // To deal with the pixels at the start of a row so it's not
+                // grabbing GOK values from memory at negative indices of the
+                // image's data or grabbing from the previous row
+                if ( kernel_x < 0 )
+                    pixel_idx = y * m_width;
+                else
+                    pixel_idx = kernel_x + y * m_width;
+
+                src = m_srcData + pixel_idx*3;
+                sum_r += src[0];
+                sum_g += src[1];
+                sum_b += src[2];
+                if ( m_srcAlpha )
+                    sum_a += m_srcAlpha[pixel_idx];
+            }
 
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+            dst = m_dstData + y * m_width*3;
+            dst[0] = (unsigned char)(sum_r / m_blurArea);
+            dst[1] = (unsigned char)(sum_g / m_blurArea);
+            dst[2] = (unsigned char)(sum_b / m_blurArea);
+            if ( m_srcAlpha )
+                m_dstAlpha[y * m_width] = (unsigned char)(sum_a / m_blurArea);
+
+            // Now average the values of the rest of the pixels by just moving the
+            // blur radius box along the row
+            for ( int x = 1; x < m_width; x++ )
+            {
+                // Take care of edge pixels on the left edge by essentially
+                // duplicating the edge pixel
+                if ( x - m_blurRadius - 1 < 0 )
+                    pixel_idx = y * m_width;
+                else
+                    pixel_idx = (x - m_blurRadius - 1) + y * m_width;
+
+                // Subtract the value of the pixel at the left side of the blur
+                // radius box
+                src = m_srcData + pixel_idx*3;
+                sum_r -= src[0];
+                sum_g -= src[1];
+                sum_b -= src[2];
+                if ( m_srcAlpha )
+                    sum_a -= m_srcAlpha[pixel_idx];
+
+                // Take care of edge pixels on the right edge
+                if ( x + m_blurRadius > m_width - 1 )
+                    pixel_idx = m_width - 1 + y * m_width;
+                else
+                    pixel_idx = x + m_blurRadius + y * m_width;
+
+                // Add the value of the pixel being added to the end of our box
+                src = m_srcData + pixel_idx*3;
+                sum_r += src[0];
+                sum_g += src[1];
+                sum_b += src[2];
+                if ( m_srcAlpha )
+                    sum_a += m_srcAlpha[pixel_idx];
+
+                // Save off the averaged data
+                dst = m_dstData + x*3 + y*m_width*3;
+                dst[0] = (unsigned char)(sum_r / m_blurArea);
+                dst[1] = (unsigned char)(sum_g / m_blurArea);
+                dst[2] = (unsigned char)(sum_b / m_blurArea);
+                if ( m_srcAlpha )
+                    m_dstAlpha[x + y * m_width] = (unsigned char)(sum_a / m_blurArea);
+            }
         }
+    }
+};
 
-        dst = dst_data + y * M_IMGDATA->m_width*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+class BlurVerticalProcessor : public BlurProcessorBase
+{
+public:
+    BlurVerticalProcessor(const wxImage& src, wxImage& dst, int blurRadius)
+        : BlurProcessorBase(src, dst, blurRadius)
+    {
+    }
 
-        // Now average the values of the rest of the pixels by just moving the
-        // blur radius box along the row
-        for ( int x = 1; x < M_IMGDATA->m_width; x++ )
+    // Vertical blurring algorithm - same as horizontal but switched the
+    // opposite direction, notice that the bands are bands of columns here
+    virtual void ProcessBand(int start, int end) wxOVERRIDE
+    {
+        for ( int x = start; x < end; x++ )
         {
-            // Take care of edge pixels on the left edge by essentially
-            // duplicating the edge pixel
-            if ( x - blurRadius - 1 < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = (x - blurRadius - 1) + y * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the left side of the blur
-            // radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
+            // Variables used in the blurring algorithm
+            long sum_r = 0,
+                 sum_g = 0,
+                 sum_b = 0,
+                 sum_a = 0;
+
+            long pixel_idx;
+            const unsigned char *src;
+            unsigned char *dst;
+
+            // Calculate the average of all pixels in our blur radius box for the
+            // first pixel of the column
+            for ( int kernel_y = -m_blurRadius; kernel_y <= m_blurRadius; kernel_y++ )
+            {
+                // To deal with the pixels at the start of a column so it's not
+                // grabbing GOK values from memory at negative indices of the
+                // image's data or grabbing from the previous column
+                if ( kernel_y < 0 )
+                    pixel_idx = x;
+                else
+                    pixel_idx = x + kernel_y * m_width;
+
+                src = m_srcData + pixel_idx*3;
+                sum_r += src[0];
+                sum_g += src[1];
+                sum_b += src[2];
+                if ( m_srcAlpha )
+                    sum_a += m_srcAlpha[pixel_idx];
+            }
+
+            dst = m_dstData + x*3;
+            dst[0] = (unsigned char)(sum_r / m_blurArea);
+            dst[1] = (unsigned char)(sum_g / m_blurArea);
+            dst[2] = (unsigned char)(sum_b / m_blurArea);
+            if ( m_srcAlpha )
+                m_dstAlpha[x] = (unsigned char)(sum_a / m_blurArea);
+
+            // Now average the values of the rest of the pixels by just moving the
+            // box along the column from top to bottom
+            for ( int y = 1; y < m_height; y++ )
+            {
+                // Take care of pixels that would be beyond the top edge by
+                // duplicating the top edge pixel for the column
+                if ( y - m_blurRadius - 1 < 0 )
+                    pixel_idx = x;
+                else
+                    pixel_idx = x + (y - m_blurRadius - 1) * m_width;
+
+                // Subtract the value of the pixel at the top of our blur radius box
+                src = m_srcData + pixel_idx*3;
+                sum_r -= src[0];
+                sum_g -= src[1];
+                sum_b -= src[2];
+                if ( m_srcAlpha )
+                    sum_a -= m_srcAlpha[pixel_idx];
+
+                // Take care of the pixels that would be beyond the bottom edge of
+                // the image similar to the top edge
+                if ( y + m_blurRadius > m_height - 1 )
+                    pixel_idx = x + (m_height - 1) * m_width;
+                else
+                    pixel_idx = x + (m_blurRadius + y) * m_width;
+
+                // Add the value of the pixel being added to the end of our box
+                src = m_srcData + pixel_idx*3;
+                sum_r += src[0];
+                sum_g += src[1];
+                sum_b += src[2];
+                if ( m_srcAlpha )
+                    sum_a += m_srcAlpha[pixel_idx];
+
+                // Save off the averaged data
+                dst = m_dstData + (x + y * m_width) * 3;
+                dst[0] = (unsigned char)(sum_r / m_blurArea);
+                dst[1] = (unsigned char)(sum_g / m_blurArea);
+                dst[2] = (unsigned char)(sum_b / m_blurArea);
+                if ( m_srcAlpha )
+                    m_dstAlpha[x + y * m_width] = (unsigned char)(sum_a / m_blurArea);
+            }
+        }
+    }
+};
+
+} // anonymous namespace
 
-            // Take care of edge pixels on the right edge
-            if ( x + blurRadius > M_IMGDATA->m_width - 1 )
-                pixel_idx = M_IMGDATA->m_width - 1 + y * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + blurRadius + y * M_IMGDATA->m_width;
+// Blur in the horizontal direction
+wxImage wxImage::BlurHorizontal(int blurRadius) const
+{
+    wxImage ret_image(MakeEmptyClone());
 
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+    wxCHECK( ret_image.IsOk(), ret_image );
 
-            // Save off the averaged data
-            dst = dst_data + x*3 + y*M_IMGDATA->m_width*3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-        }
-    }
+    BlurHorizontalProcessor processor(*this, ret_image, blurRadius);
+    ProcessImageBands(processor, M_IMGDATA->m_height, M_IMGDATA->m_width*3);
 
     return ret_image;
 }
@@ -1168,98 +1742,8 @@ wxImage wxImage::BlurVertical(int blurRadius) const
 
     wxCHECK( ret_image.IsOk(), ret_image );
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
-
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
-
-    // Vertical blurring algorithm - same as horizontal but switched the
-    // opposite direction
-    for ( int x = 0; x < M_IMGDATA->m_width; x++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in our blur radius box for the
-        // first pixel of the column
-        for ( int kernel_y = -blurRadius; kernel_y <= blurRadius; kernel_y++ )
-        {
-            // To deal with the pixels at the start of a column so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous column
-            if ( kernel_y < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + kernel_y * M_IMGDATA->m_width;
-
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
-
-        dst = dst_data + x*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[x] = (unsigned char)(sum_a / blurArea);
-
-        // Now average the values of the rest of the pixels by just moving the
-        // box along the column from top to bottom
-        for ( int y = 1; y < M_IMGDATA->m_height; y++ )
-        {
-            // Take care of pixels that would be beyond the top edge by
-            // duplicating the top edge pixel for the column
-            if ( y - blurRadius - 1 < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + (y - blurRadius - 1) * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the top of our blur radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
-
-            // Take care of the pixels that would be beyond the bottom edge of
-            // the image similar to the top edge
-            if ( y + blurRadius > M_IMGDATA->m_height - 1 )
-                pixel_idx = x + (M_IMGDATA->m_height - 1) * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + (blurRadius + y) * M_IMGDATA->m_width;
-
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-
-            // Save off the averaged data
-            dst = dst_data + (x + y * M_IMGDATA->m_width) * 3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-        }
-    }
+    BlurVerticalProcessor processor(*this, ret_image, blurRadius);
+    ProcessImageBands(processor, M_IMGDATA->m_width, M_IMGDATA->m_height*3);
 
     return ret_image;
 }
@@ -1737,6 +2221,57 @@ wxImage wxImage::ConvertToGreyscale(void) const
     return ConvertToGreyscale(0.299, 0.587, 0.114);
 }
 
+namespace
+{
+
+class GreyscaleProcessor : public ImageBandsProcessor
+{
+public:
+    GreyscaleProcessor(const wxImage& src,
+                       wxImage& dst,
+                       double weight_r, double weight_g, double weight_b)
+        : m_src(src.GetData()),
+          m_dst(dst.GetData()),
+          m_width(src.GetWidth()),
+          m_hasMask(src.HasMask()),
+          m_maskRed(src.GetMaskRed()),
+          m_maskGreen(src.GetMaskGreen()),
+          m_maskBlue(src.GetMaskBlue()),
+          m_weightRed(weight_r),
+          m_weightGreen(weight_g),
+          m_weightBlue(weight_b)
+    {
+    }
+
+    virtual void ProcessBand(int start, int end) wxOVERRIDE
+    {
+        const unsigned char* src = m_src + size_t(start) * m_width * 3;
+        unsigned char* dst = m_dst + size_t(start) * m_width * 3;
+        size_t size = size_t(end - start) * m_width;
+        while (size--)
+        {
+            unsigned char r = *src++;
+            unsigned char g = *src++;
+            unsigned char b = *src++;
+            if (!m_hasMask || r != m_maskRed || g != m_maskGreen || b != m_maskBlue)
+                wxColour::MakeGrey(&r, &g, &b, m_weightRed, m_weightGreen, m_weightBlue);
+            *dst++ = r;
+            *dst++ = g;
+            *dst++ = b;
+        }
+    }
+
+private:
+    const unsigned char* const m_src;
+    unsigned char* const m_dst;
+    const int m_width;
+    const bool m_hasMask;
+    const unsigned char m_maskRed, m_maskGreen, m_maskBlue;
+    const double m_weightRed, m_weightGreen, m_weightBlue;
+};
+
+} // anonymous namespace
+
 wxImage wxImage::ConvertToGreyscale(double weight_r, double weight_g, double weight_b) const
 {
     wxImage image;
@@ -1752,26 +2287,14 @@ wxImage wxImage::ConvertToGreyscale(double weight_r, double weight_g, double wei
         image.SetAlpha();
         memcpy(image.GetAlpha(), alpha, size);
     }
-    const unsigned char mask_r = M_IMGDATA->m_maskRed;
-    const unsigned char mask_g = M_IMGDATA->m_maskGreen;
-    const unsigned char mask_b = M_IMGDATA->m_maskBlue;
-    const bool hasMask = M_IMGDATA->m_hasMask;
-    if (hasMask)
-        image.SetMaskColour(mask_r, mask_g, mask_b);
+    if (M_IMGDATA->m_hasMask)
+        image.SetMaskColour(M_IMGDATA->m_maskRed,
+                            M_IMGDATA->m_maskGreen,
+                            M_IMGDATA->m_maskBlue);
+
+    GreyscaleProcessor processor(*this, image, weight_r, weight_g, weight_b);
+    ProcessImageBands(processor, h, w*3);
 
-    const unsigned char* src = M_IMGDATA->m_data;
-    unsigned char* dst = image.GetData();
-    while (size--)
-    {
-        unsigned char r = *src++;
-        unsigned char g = *src++;
-        unsigned char b = *src++;
-        if (!hasMask || r != mask_r || g != mask_g || b != mask_b)
-            wxColour::MakeGrey(&r, &g, &b, weight_r, weight_g, weight_b);
-        *dst++ = r;
-        *dst++ = g;
-        *dst++ = b;
-    }
     return image;
 }
 
@@ -2467,6 +2990,20 @@ int wxImage::GetDefaultLoadFlags()
     return wxImageRefData::sm_defaultLoadFlags;
 }
 
+/* static */
+void wxImage::SetMaxProcessingThreads(int count)
+{
+    wxCHECK_RET( count >= 0, wxS("invalid number of threads") );
+
+    gs_maxProcessingThreads = count;
+}
+
+/* static */
+int wxImage::GetMaxProcessingThreads()
+{
+    return gs_maxProcessingThreads;
+}
+
 void wxImage::SetLoadFlags(int flags)
 {
     AllocExclusive();
@@ -3228,44 +3765,71 @@ wxImage::RGBValue wxImage::HSVtoRGB(const HSVValue& hsv)
                     (unsigned char)(blue * 255.0));
 }
 
-/*
- * Rotates the hue of each pixel of the image. angle is a double in the range
- * -1.0..1.0 where -1.0 is -360 degrees and 1.0 is 360 degrees
- */
-void wxImage::RotateHue(double angle)
+namespace
 {
-    AllocExclusive();
 
-    unsigned long count;
-    wxImage::HSVValue hsv;
-    wxImage::RGBValue rgb;
+class RotateHueProcessor : public ImageBandsProcessor
+{
+public:
+    RotateHueProcessor(wxImage& image, double angle)
+        : m_data(image.GetData()),
+          m_width(image.GetWidth()),
+          m_angle(angle)
+    {
+    }
 
-    wxASSERT (angle >= -1.0 && angle <= 1.0);
-    count = M_IMGDATA->m_width * M_IMGDATA->m_height;
-    if ( count > 0 && !wxIsNullDouble(angle) )
+    virtual void ProcessBand(int start, int end) wxOVERRIDE
     {
+        wxImage::HSVValue hsv;
+        wxImage::RGBValue rgb;
+
         unsigned char* srcBytePtr;
         unsigned char* dstBytePtr;
-        srcBytePtr = M_IMGDATA->m_data;
+        srcBytePtr = m_data + size_t(start) * m_width * 3;
         dstBytePtr = srcBytePtr;
-        do
+
+        for ( size_t count = size_t(end - start) * m_width; count; count-- )
         {
             rgb.red = *srcBytePtr++;
             rgb.green = *srcBytePtr++;
             rgb.blue = *srcBytePtr++;
-            hsv = RGBtoHSV(rgb);
+            hsv = wxImage::RGBtoHSV(rgb);
 
-            hsv.hue = hsv.hue + angle;
+            hsv.hue = hsv.hue + m_angle;
             if (hsv.hue > 1.0)
                 hsv.hue = hsv.hue - 1.0;
             else if (hsv.hue < 0.0)
                 hsv.hue = hsv.hue + 1.0;
 
-            rgb = HSVtoRGB(hsv);
+            rgb = wxImage::HSVtoRGB(hsv);
             *dstBytePtr++ = rgb.red;
             *dstBytePtr++ = rgb.green;
             *dstBytePtr++ = rgb.blue;
-        } while (--count != 0);
+        }
+    }
+
+private:
+    unsigned char* const m_data;
+    const int m_width;
+    const double m_angle;
+};
+
+} // anonymous namespace
+
+/*
+ * Rotates the hue of each pixel of the image. angle is a double in the range
+ * -1.0..1.0 where -1.0 is -360 degrees and 1.0 is 360 degrees
+ */
+void wxImage::RotateHue(double angle)
+{
+    AllocExclusive();
+
+    wxASSERT (angle >= -1.0 && angle <= 1.0);
+    if ( M_IMGDATA->m_width > 0 && M_IMGDATA->m_height > 0 &&
+            !wxIsNullDouble(angle) )
+    {
+        RotateHueProcessor processor(*this, angle);
+        ProcessImageBands(processor, M_IMGDATA->m_height, M_IMGDATA->m_width*3);
     }
 }
 
@@ -3527,114 +4091,78 @@ wxRotatePoint(double x, double y, double cos_angle, double sin_angle,
     return wxRotatePoint (wxRealPoint(x,y), cos_angle, sin_angle, p0);
 }
 
-wxImage wxImage::Rotate(double angle,
-                        const wxPoint& centre_of_rotation,
-                        bool interpolating,
-                        wxPoint *offset_after_rotation) const
+namespace
 {
-    // screen coordinates are a mirror image of "real" coordinates
-    angle = -angle;
-
-    const bool has_alpha = HasAlpha();
-
-    const int w = GetWidth();
-    const int h = GetHeight();
-
-    int i;
-
-    // Create pointer-based array to accelerate access to wxImage's data
-    unsigned char ** data = new unsigned char * [h];
-    data[0] = GetData();
-    for (i = 1; i < h; i++)
-        data[i] = data[i - 1] + (3 * w);
-
-    // Same for alpha channel
-    unsigned char ** alpha = NULL;
-    if (has_alpha)
-    {
-        alpha = new unsigned char * [h];
-        alpha[0] = GetAlpha();
-        for (i = 1; i < h; i++)
-            alpha[i] = alpha[i - 1] + w;
-    }
-
-    // precompute coefficients for rotation formula
-    const double cos_angle = cos(angle);
-    const double sin_angle = sin(angle);
-
-    // Create new Image to store the result
-    // First, find rectangle that covers the rotated image;  to do that,
-    // rotate the four corners
-
-    const wxRealPoint p0(centre_of_rotation.x, centre_of_rotation.y);
-
-    wxRealPoint p1 = wxRotatePoint (0, 0, cos_angle, sin_angle, p0);
-    wxRealPoint p2 = wxRotatePoint (0, h, cos_angle, sin_angle, p0);
-    wxRealPoint p3 = wxRotatePoint (w, 0, cos_angle, sin_angle, p0);
-    wxRealPoint p4 = wxRotatePoint (w, h, cos_angle, sin_angle, p0);
-
-    int x1a = (int) floor (wxMin (wxMin(p1.x, p2.x), wxMin(p3.x, p4.x)));
-    int y1a = (int) floor (wxMin (wxMin(p1.y, p2.y), wxMin(p3.y, p4.y)));
-    int x2a = (int) ceil (wxMax (wxMax(p1.x, p2.x), wxMax(p3.x, p4.x)));
-    int y2a = (int) ceil (wxMax (wxMax(p1.y, p2.y), wxMax(p3.y, p4.y)));
 
-    // Create rotated image
-    wxImage rotated (x2a - x1a + 1, y2a - y1a + 1, false);
-    // With alpha channel
-    if (has_alpha)
-        rotated.SetAlpha();
-
-    if (offset_after_rotation != NULL)
-    {
-        *offset_after_rotation = wxPoint (x1a, y1a);
+class RotateProcessor : public ImageBandsProcessor
+{
+public:
+    RotateProcessor(unsigned char** data,
+                    unsigned char** alpha,
+                    int w, int h,
+                    double cos_angle, double sin_angle,
+                    const wxRealPoint& p0,
+                    int x1a, int y1a,
+                    wxImage& rotated,
+                    bool interpolating)
+        : m_data(data),
+          m_alpha(alpha),
+          m_w(w),
+          m_h(h),
+          m_cos(cos_angle),
+          m_sin(sin_angle),
+          m_p0(p0),
+          m_x1a(x1a),
+          m_y1a(y1a),
+          m_rW(rotated.GetWidth()),
+          m_dst(rotated.GetData()),
+          m_alphaDst(rotated.GetAlpha()),
+          m_hasAlpha(alpha != NULL),
+          m_blankRed(0),
+          m_blankGreen(0),
+          m_blankBlue(0),
+          m_interpolating(interpolating)
+    {
+        // if the rotated image has a mask, use its RGB values as the blank
+        // pixel, else, fall back to default (black).
+        if ( rotated.HasMask() )
+        {
+            m_blankRed = rotated.GetMaskRed();
+            m_blankGreen = rotated.GetMaskGreen();
+            m_blankBlue = rotated.GetMaskBlue();
+        }
     }
 
-    // the rotated (destination) image is always accessed sequentially via this
-    // pointer, there is no need for pointer-based arrays here
-    unsigned char *dst = rotated.GetData();
-
-    unsigned char *alpha_dst = has_alpha ? rotated.GetAlpha() : NULL;
-
-    // if the original image has a mask, use its RGB values as the blank pixel,
-    // else, fall back to default (black).
-    unsigned char blank_r = 0;
-    unsigned char blank_g = 0;
-    unsigned char blank_b = 0;
-
-    if (HasMask())
+    virtual void ProcessBand(int start, int end) wxOVERRIDE
     {
-        blank_r = GetMaskRed();
-        blank_g = GetMaskGreen();
-        blank_b = GetMaskBlue();
-        rotated.SetMaskColour( blank_r, blank_g, blank_b );
+        if ( m_interpolating )
+            ProcessInterpolating(start, end);
+        else
+            ProcessNotInterpolating(start, end);
     }
 
-    // Now, for each point of the rotated image, find where it came from, by
-    // performing an inverse rotation (a rotation of -angle) and getting the
-    // pixel at those coordinates
-
-    const int rH = rotated.GetHeight();
-    const int rW = rotated.GetWidth();
-
-    // do the (interpolating) test outside of the loops, so that it is done
-    // only once, instead of repeating it for each pixel.
-    if (interpolating)
+private:
+    void ProcessInterpolating(int start, int end)
     {
-        for (int y = 0; y < rH; y++)
+        for (int y = start; y < end; y++)
         {
-            for (int x = 0; x < rW; x++)
+            unsigned char *dst = m_dst + size_t(y) * m_rW * 3;
+            unsigned char *alpha_dst = m_hasAlpha ? m_alphaDst + size_t(y) * m_rW
+                                                  : NULL;
+
+            for (int x = 0; x < m_rW; x++)
             {
-                wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
+                wxRealPoint src = wxRotatePoint (x + m_x1a, y + m_y1a, m_cos, -m_sin, m_p0);
 
-                if (-0.25 < src.x && src.x < w - 0.75 &&
-                    -0.25 < src.y && src.y < h - 0.75)
+                if (-0.25 < src.x && src.x < m_w - 0.75 &&
+                    -0.25 < src.y && src.y < m_h - 0.75)
                 {
                     // interpolate using the 4 enclosing grid-points.  Those
                     // points can be obtained using floor and ceiling of the
                     // exact coordinates of the point
                     int x1, y1, x2, y2;
 
-                    if (0 < src.x && src.x < w - 1)
+                    if (0 < src.x && src.x < m_w - 1)
                     {
                         x1 = wxRound(floor(src.x));
                         x2 = wxRound(ceil(src.x));
@@ -3644,7 +4172,7 @@ wxImage wxImage::Rotate(double angle,
                         x1 = x2 = wxRound (src.x);
                     }
 
-                    if (0 < src.y && src.y < h - 1)
+                    if (0 < src.y && src.y < m_h - 1)
                     {
                         y1 = wxRound(floor(src.y));
                         y2 = wxRound(ceil(src.y));
@@ -3676,51 +4204,51 @@ wxImage wxImage::Rotate(double angle,
                     // d1,d2,d3,d4 are positive -- no need for abs()
                     if (d1 < wxROTATE_EPSILON)
                     {
-                        unsigned char *p = data[y1] + (3 * x1);
+                        unsigned char *p = m_data[y1] + (3 * x1);
                         *(dst++) = *(p++);
                         *(dst++) = *(p++);
                         *(dst++) = *p;
 
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y1] + x1);
+                        if (m_hasAlpha)
+                            *(alpha_dst++) = *(m_alpha[y1] + x1);
                     }
                     else if (d2 < wxROTATE_EPSILON)
                     {
-                        unsigned char *p = data[y1] + (3 * x2);
+                        unsigned char *p = m_data[y1] + (3 * x2);
                         *(dst++) = *(p++);
                         *(dst++) = *(p++);
                         *(dst++) = *p;
 
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y1] + x2);
+                        if (m_hasAlpha)
+                            *(alpha_dst++) = *(m_alpha[y1] + x2);
                     }
                     else if (d3 < wxROTATE_EPSILON)
                     {
-                        unsigned char *p = data[y2] + (3 * x2);
+                        unsigned char *p = m_data[y2] + (3 * x2);
                         *(dst++) = *(p++);
                         *(dst++) = *(p++);
                         *(dst++) = *p;
 
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y2] + x2);
+                        if (m_hasAlpha)
+                            *(alpha_dst++) = *(m_alpha[y2] + x2);
                     }
                     else if (d4 < wxROTATE_EPSILON)
                     {
-                        unsigned char *p = data[y2] + (3 * x1);
+                        unsigned char *p = m_data[y2] + (3 * x1);
                         *(dst++) = *(p++);
                         *(dst++) = *(p++);
                         *(dst++) = *p;
 
-                        if (has_alpha)
-                            *(alpha_dst++) = *(alpha[y2] + x1);
+                        if (m_hasAlpha)
+                            *(alpha_dst++) = *(m_alpha[y2] + x1);
                     }
                     else
                     {
                         // weights for the weighted average are proportional to the inverse of the distance
-                        unsigned char *v1 = data[y1] + (3 * x1);
-                        unsigned char *v2 = data[y1] + (3 * x2);
-                        unsigned char *v3 = data[y2] + (3 * x2);
-                        unsigned char *v4 = data[y2] + (3 * x1);
+                        unsigned char *v1 = m_data[y1] + (3 * x1);
+                        unsigned char *v2 = m_data[y1] + (3 * x2);
+                        unsigned char *v3 = m_data[y2] + (3 * x2);
+                        unsigned char *v4 = m_data[y2] + (3 * x1);
 
                         const double w1 = 1/d1, w2 = 1/d2, w3 = 1/d3, w4 = 1/d4;
 
@@ -3739,12 +4267,12 @@ wxImage wxImage::Rotate(double angle,
                                w3 * *v3 + w4 * *v4) /
                               (w1 + w2 + w3 + w4) );
 
-                        if (has_alpha)
+                        if (m_hasAlpha)
                         {
-                            v1 = alpha[y1] + (x1);
-                            v2 = alpha[y1] + (x2);
-                            v3 = alpha[y2] + (x2);
-                            v4 = alpha[y2] + (x1);
+                            v1 = m_alpha[y1] + (x1);
+                            v2 = m_alpha[y1] + (x2);
+                            v3 = m_alpha[y2] + (x2);
+                            v4 = m_alpha[y2] + (x1);
 
                             *(alpha_dst++) = (unsigned char)
                                 ( (w1 * *v1 + w2 * *v2 +
@@ -3755,50 +4283,150 @@ wxImage wxImage::Rotate(double angle,
                 }
                 else
                 {
-                    *(dst++) = blank_r;
-                    *(dst++) = blank_g;
-                    *(dst++) = blank_b;
+                    *(dst++) = m_blankRed;
+                    *(dst++) = m_blankGreen;
+                    *(dst++) = m_blankBlue;
 
-                    if (has_alpha)
+                    if (m_hasAlpha)
                         *(alpha_dst++) = 0;
                 }
             }
         }
     }
-    else // not interpolating
+
+    void ProcessNotInterpolating(int start, int end)
     {
-        for (int y = 0; y < rH; y++)
+        for (int y = start; y < end; y++)
         {
-            for (int x = 0; x < rW; x++)
+            unsigned char *dst = m_dst + size_t(y) * m_rW * 3;
+            unsigned char *alpha_dst = m_hasAlpha ? m_alphaDst + size_t(y) * m_rW
+                                                  : NULL;
+
+            for (int x = 0; x < m_rW; x++)
             {
-                wxRealPoint src = wxRotatePoint (x + x1a, y + y1a, cos_angle, -sin_angle, p0);
+                wxRealPoint src = wxRotatePoint (x + m_x1a, y + m_y1a, m_cos, -m_sin, m_p0);
 
                 const int xs = wxRound (src.x);      // wxRound rounds to the
                 const int ys = wxRound (src.y);      // closest integer
 
-                if (0 <= xs && xs < w && 0 <= ys && ys < h)
+                if (0 <= xs && xs < m_w && 0 <= ys && ys < m_h)
                 {
-                    unsigned char *p = data[ys] + (3 * xs);
+                    unsigned char *p = m_data[ys] + (3 * xs);
                     *(dst++) = *(p++);
                     *(dst++) = *(p++);
                     *(dst++) = *p;
 
-                    if (has_alpha)
-                        *(alpha_dst++) = *(alpha[ys] + (xs));
+                    if (m_hasAlpha)
+                        *(alpha_dst++) = *(m_alpha[ys] + (xs));
                 }
                 else
                 {
-                    *(dst++) = blank_r;
-                    *(dst++) = blank_g;
-                    *(dst++) = blank_b;
+                    *(dst++) = m_blankRed;
+                    *(dst++) = m_blankGreen;
+                    *(dst++) = m_blankBlue;
 
-                    if (has_alpha)
+                    if (m_hasAlpha)
                         *(alpha_dst++) = 255;
                 }
             }
         }
     }
 
+    unsigned char** const m_data;
+    unsigned char** const m_alpha;
+    const int m_w;
+    const int m_h;
+    const double m_cos;
+    const double m_sin;
+    const wxRealPoint m_p0;
+    const int m_x1a;
+    const int m_y1a;
+    const int m_rW;
+    unsigned char* const m_dst;
+    unsigned char* const m_alphaDst;
+    const bool m_hasAlpha;
+    unsigned char m_blankRed;
+    unsigned char m_blankGreen;
+    unsigned char m_blankBlue;
+    const bool m_interpolating;
+};
+
+} // anonymous namespace
+
+wxImage wxImage::Rotate(double angle,
+                        const wxPoint& centre_of_rotation,
+                        bool interpolating,
+                        wxPoint *offset_after_rotation) const
+{
+    // screen coordinates are a mirror image of "real" coordinates
+    angle = -angle;
+
+    const bool has_alpha = HasAlpha();
+
+    const int w = GetWidth();
+    const int h = GetHeight();
+
+    int i;
+
+    // Create pointer-based array to accelerate access to wxImage's data
+    unsigned char ** data = new unsigned char * [h];
+    data[0] = GetData();
+    for (i = 1; i < h; i++)
+        data[i] = data[i - 1] + (3 * w);
+
+    // Same for alpha channel
+    unsigned char ** alpha = NULL;
+    if (has_alpha)
+    {
+        alpha = new unsigned char * [h];
+        alpha[0] = GetAlpha();
+        for (i = 1; i < h; i++)
+            alpha[i] = alpha[i - 1] + w;
+    }
+
+    // precompute coefficients for rotation formula
+    const double cos_angle = cos(angle);
+    const double sin_angle = sin(angle);
+
+    // Create new Image to store the result
+    // First, find rectangle that covers the rotated image;  to do that,
+    // rotate the four corners
+
+    const wxRealPoint p0(centre_of_rotation.x, centre_of_rotation.y);
+
+    wxRealPoint p1 = wxRotatePoint (0, 0, cos_angle, sin_angle, p0);
+    wxRealPoint p2 = wxRotatePoint (0, h, cos_angle, sin_angle, p0);
+    wxRealPoint p3 = wxRotatePoint (w, 0, cos_angle, sin_angle, p0);
+    wxRealPoint p4 = wxRotatePoint (w, h, cos_angle, sin_angle, p0);
+
+    int x1a = (int) floor (wxMin (wxMin(p1.x, p2.x), wxMin(p3.x, p4.x)));
+    int y1a = (int) floor (wxMin (wxMin(p1.y, p2.y), wxMin(p3.y, p4.y)));
+    int x2a = (int) ceil (wxMax (wxMax(p1.x, p2.x), wxMax(p3.x, p4.x)));
+    int y2a = (int) ceil (wxMax (wxMax(p1.y, p2.y), wxMax(p3.y, p4.y)));
+
+    // Create rotated image
+    wxImage rotated (x2a - x1a + 1, y2a - y1a + 1, false);
+    // With alpha channel
+    if (has_alpha)
+        rotated.SetAlpha();
+
+    if (offset_after_rotation != NULL)
+    {
+        *offset_after_rotation = wxPoint (x1a, y1a);
+    }
+
+    // the mask colour, if any, is used for the blank pixels
+    if (HasMask())
+        rotated.SetMaskColour( GetMaskRed(), GetMaskGreen(), GetMaskBlue() );
+
+    // Now, for each point of the rotated image, find where it came from, by
+    // performing an inverse rotation (a rotation of -angle) and getting the
+    // pixel at those coordinates. As each row of the rotated image is computed
+    // independently of all the others, they can be processed in parallel.
+    RotateProcessor processor(data, alpha, w, h, cos_angle, sin_angle, p0,
+                              x1a, y1a, rotated, interpolating);
+    ProcessImageBands(processor, rotated.GetHeight(), rotated.GetWidth()*3);
+
     delete [] data;
     delete [] alpha;
 
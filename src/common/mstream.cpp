@@ -44,6 +44,11 @@
 wxIMPLEMENT_ABSTRACT_CLASS(wxMemoryInputStream, wxInputStream);
 
 wxMemoryInputStream::wxMemoryInputStream(const void *data, size_t len)
+{
+    InitFromData(data, len);
+}
+
+void wxMemoryInputStream::InitFromData(const void *data, size_t len)
 {
     m_i_streambuf = new wxStreamBuffer(wxStreamBuffer::read);
     m_i_streambuf->SetBufferIO(const_cast<void *>(data), len);
@@ -148,6 +153,21 @@ wxFileOffset wxMemoryInputStream::OnSysTell() const
     return m_i_streambuf->Tell();
 }
 
+const void *wxMemoryInputStream::DoPeekData(size_t *size)
+{
+    // just return the pointer to our data directly
+    const void * const data = m_i_streambuf->PeekData(size);
+    if ( !data )
+        m_lasterror = wxSTREAM_EOF;
+
+    return data;
+}
+
+void wxMemoryInputStream::DoConsume(size_t size)
+{
+    m_i_streambuf->Consume(size);
+}
+
 // ----------------------------------------------------------------------------
 // wxMemoryOutputStream
 // ----------------------------------------------------------------------------
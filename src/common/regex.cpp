@@ -33,8 +33,13 @@
     #include "wx/log.h"
     #include "wx/intl.h"
     #include "wx/crt.h"
+    #include "wx/hashmap.h"
+    #include "wx/module.h"
 #endif //WX_PRECOMP
 
+#include "wx/atomic.h"
+#include "wx/thread.h"
+
 // At least FreeBSD requires this.
 #if defined(__UNIX__)
 #   include <sys/types.h>
@@ -44,15 +49,12 @@
 
 // WXREGEX_USING_BUILTIN    defined when using the built-in regex lib
 // WXREGEX_USING_RE_SEARCH  defined when using re_search in the GNU regex lib
-// WXREGEX_IF_NEED_LEN()    wrap the len parameter only used with the built-in
-//                          or GNU regex
 // WXREGEX_CONVERT_TO_MB    defined when the regex lib is using chars and
 //                          wxChar is wide, so conversion must be done
 // WXREGEX_CHAR(x)          Convert wxChar to wxRegChar
 //
 #ifdef __REG_NOFRONT
 #   define WXREGEX_USING_BUILTIN
-#   define WXREGEX_IF_NEED_LEN(x) ,x
 #   if wxUSE_UNICODE
 #       define WXREGEX_CHAR(x) (x).wc_str()
 #   else
@@ -60,10 +62,7 @@
 #   endif
 #else
 #   ifdef HAVE_RE_SEARCH
-#       define WXREGEX_IF_NEED_LEN(x) ,x
 #       define WXREGEX_USING_RE_SEARCH
-#   else
-#       define WXREGEX_IF_NEED_LEN(x)
 #   endif
 #   if wxUSE_UNICODE
 #       define WXREGEX_CONVERT_TO_MB
@@ -85,7 +84,7 @@ class wxRegExMatches
 public:
     typedef regmatch_t *match_type;
 
-    wxRegExMatches(size_t n)        { m_matches = new regmatch_t[n]; }
+    wxRegExMatches(size_t n)        { m_matches = new regmatch_t[n]; m_offset = 0; }
     ~wxRegExMatches()               { delete [] m_matches; }
 
     // we just use casts here because the fields of regmatch_t struct may be 64
@@ -94,18 +93,36 @@ public:
     // absolutely impractical anyhow
     size_t Start(size_t n) const
     {
-        return wx_truncate_cast(size_t, m_matches[n].rm_so);
+        return Offset(m_matches[n].rm_so);
     }
 
     size_t End(size_t n) const
     {
-        return wx_truncate_cast(size_t, m_matches[n].rm_eo);
+        return Offset(m_matches[n].rm_eo);
+    }
+
+    // set the offset of the text passed to the regex library from the start
+    // of the text the match positions should be relative to
+    void SetOffset(size_t offset)   { m_offset = offset; }
+
+    // set the match, without the offset, directly
+    void Set(size_t n, size_t start, size_t end)
+    {
+        m_matches[n].rm_so = start;
+        m_matches[n].rm_eo = end;
     }
 
     regmatch_t *get() const         { return m_matches; }
 
 private:
+    // the offsets of unmatched subexpressions are -1 and must remain so
+    size_t Offset(regoff_t off) const
+    {
+        return off == -1 ? (size_t)-1 : wx_truncate_cast(size_t, off) + m_offset;
+    }
+
     regmatch_t *m_matches;
+    size_t m_offset;
 };
 
 #else // WXREGEX_USING_RE_SEARCH
@@ -121,6 +138,7 @@ public:
         m_matches.num_regs = n;
         m_matches.start = new regoff_t[n];
         m_matches.end = new regoff_t[n];
+        m_offset = 0;
     }
 
     ~wxRegExMatches()
@@ -129,13 +147,27 @@ public:
         delete [] m_matches.end;
     }
 
-    size_t Start(size_t n) const    { return m_matches.start[n]; }
-    size_t End(size_t n) const      { return m_matches.end[n]; }
+    size_t Start(size_t n) const    { return Offset(m_matches.start[n]); }
+    size_t End(size_t n) const      { return Offset(m_matches.end[n]); }
+
+    void SetOffset(size_t offset)   { m_offset = offset; }
+
+    void Set(size_t n, size_t start, size_t end)
+    {
+        m_matches.start[n] = start;
+        m_matches.end[n] = end;
+    }
 
     re_registers *get()             { return &m_matches; }
 
 private:
+    size_t Offset(regoff_t off) const
+    {
+        return off == -1 ? (size_t)-1 : off + m_offset;
+    }
+
     re_registers m_matches;
+    size_t m_offset;
 };
 
 #endif // WXREGEX_USING_RE_SEARCH
@@ -147,6 +179,88 @@ typedef wxChar wxRegChar;
 typedef char wxRegChar;
 #endif
 
+typedef wxCharTypeBuffer<wxRegChar> wxRegCharBuffer;
+
+// helpers for copying the result of WXREGEX_CHAR(), which is either a pointer
+// to the internal string data or a temporary buffer, to a buffer we own
+inline wxRegCharBuffer wxMakeRegCharBuffer(const wxRegChar *str, size_t len)
+{
+    return wxRegCharBuffer(str, len);
+}
+
+inline wxRegCharBuffer
+wxMakeRegCharBuffer(const wxScopedCharTypeBuffer<wxRegChar>& buf, size_t)
+{
+    return wxRegCharBuffer(buf);
+}
+
+// the compiled RE, which is immutable and can be shared by several wxRegEx
+// objects (possibly used by different threads) and wxRegExCache
+class wxRegExCompiled
+{
+public:
+    // compile the expression, returns NULL and logs an error on failure
+    static wxRegExCompiled *Create(const wxString& expr, int flags);
+
+    void IncRef() { wxAtomicInc(m_refCount); }
+    void DecRef()
+    {
+        if ( !wxAtomicDec(m_refCount) )
+            delete this;
+    }
+
+    // the number of subexpressions, including the whole match, or 0 if
+    // compiled with wxRE_NOSUB
+    size_t GetMatchCount() const { return m_nMatches; }
+
+    // match the RE against the given text and fill in the matches (if not
+    // NULL) on success
+    //
+    // the matching starts at the given position in the text of the given
+    // length and the positions of the matches are relative to its beginning
+    bool Exec(const wxRegChar *text, size_t start, size_t len, int flags,
+              wxRegExMatches *matches) const;
+
+    // return the string containing the error message for the given err code
+    wxString GetErrorMsg(int errorcode, bool badconv) const;
+
+    // only used by wxRegExCache: the key and the links of the LRU list
+    const wxString& GetExpr() const { return m_expr; }
+    int GetFlags() const { return m_flags; }
+
+    wxRegExCompiled *m_cachePrev,
+                    *m_cacheNext;
+
+private:
+    wxRegExCompiled(const wxString& expr, int flags);
+    ~wxRegExCompiled();
+
+    // compiled RE
+    regex_t         m_RegEx;
+
+    // the number of subexpressions
+    size_t          m_nMatches;
+
+    // true if m_RegEx is valid
+    bool            m_isCompiled;
+
+#ifdef WXREGEX_USING_BUILTIN
+    // the literal text all the matches must start with, if any: if it can't
+    // be found in the text, there is no need to run the RE engine at all
+    wxRegCharBuffer m_prefix;
+
+    // true if the entire RE is the literal string above
+    bool            m_isLiteral;
+#endif // WXREGEX_USING_BUILTIN
+
+    const wxString  m_expr;
+    const int       m_flags;
+
+    wxAtomicInt     m_refCount;
+
+    wxDECLARE_NO_COPY_CLASS(wxRegExCompiled);
+};
+
 // the real implementation of wxRegEx
 class wxRegExImpl
 {
@@ -156,35 +270,32 @@ public:
     ~wxRegExImpl();
 
     // return true if Compile() had been called successfully
-    bool IsValid() const { return m_isCompiled; }
+    bool IsValid() const { return m_compiled != NULL; }
 
     // RE operations
     bool Compile(const wxString& expr, int flags = 0);
-    bool Matches(const wxRegChar *str, int flags
-                 WXREGEX_IF_NEED_LEN(size_t len)) const;
+    bool Matches(const wxRegChar *str, int flags, size_t len) const;
     bool GetMatch(size_t *start, size_t *len, size_t index = 0) const;
     size_t GetMatchCount() const;
     int Replace(wxString *pattern, const wxString& replacement,
                 size_t maxMatches = 0) const;
 
-private:
-    // return the string containing the error message for the given err code
-    wxString GetErrorMsg(int errorcode, bool badconv) const;
+    wxRegExCompiled *GetCompiled() const { return m_compiled; }
 
+private:
     // init the members
     void Init()
     {
-        m_isCompiled = false;
+        m_compiled = NULL;
         m_Matches = NULL;
-        m_nMatches = 0;
     }
 
     // free the RE if compiled
     void Free()
     {
-        if ( IsValid() )
+        if ( m_compiled )
         {
-            wx_regfree(&m_RegEx);
+            m_compiled->DecRef();
         }
 
         delete m_Matches;
@@ -197,37 +308,287 @@ private:
         Init();
     }
 
-    // compiled RE
-    regex_t         m_RegEx;
+    // compiled RE, possibly shared with other wxRegEx objects
+    wxRegExCompiled *m_compiled;
 
     // the subexpressions data
     wxRegExMatches *m_Matches;
-    size_t          m_nMatches;
+};
 
-    // true if m_RegEx is valid
-    bool            m_isCompiled;
+// the implementation of wxRegExIterator
+class wxRegExIteratorImpl
+{
+public:
+    wxRegExIteratorImpl(wxRegExCompiled *compiled,
+                        const wxRegCharBuffer& text,
+                        int flags)
+        : m_compiled(compiled),
+          m_matches(compiled->GetMatchCount()),
+          m_text(text),
+          m_flags(flags)
+    {
+        m_compiled->IncRef();
+        m_pos = 0;
+        m_matched = false;
+    }
+
+    ~wxRegExIteratorImpl()
+    {
+        m_compiled->DecRef();
+    }
+
+    bool FindNext();
+    bool GetMatch(size_t *start, size_t *len, size_t index) const;
+    wxString GetMatch(size_t index) const;
+
+private:
+    wxRegExCompiled * const m_compiled;
+    wxRegExMatches m_matches;
+
+    // the entire text converted to the format used by the regex library
+    const wxRegCharBuffer m_text;
+    const int m_flags;
+
+    // the position to look for the next match at
+    size_t m_pos;
+
+    // true if the last call to FindNext() succeeded
+    bool m_matched;
+
+    wxDECLARE_NO_COPY_CLASS(wxRegExIteratorImpl);
+};
+
+// the cache of the recently compiled REs, allowing to reuse them when the
+// same expression is compiled again: this is common when wxRegEx objects are
+// created in a loop or when many patterns are applied to a lot of text
+//
+// all its methods must be called with gs_csRegExCache locked
+class wxRegExCache
+{
+public:
+    wxRegExCache() { m_first = m_last = NULL; }
+    ~wxRegExCache() { Shrink(0); }
+
+    // return the cached expression after adding a reference to it, or NULL
+    wxRegExCompiled *Find(const wxString& expr, int flags);
+
+    // add a new expression to the cache, which keeps a reference to it
+    void Add(wxRegExCompiled *compiled, size_t maxSize);
+
+    // remove the least recently used entries until at most size are left
+    void Shrink(size_t size);
+
+private:
+    // a key combining the expression and the compilation flags, the keys in
+    // the map point to the expression stored in wxRegExCompiled itself
+    struct Key
+    {
+        Key(const wxString& expr_, int flags_) : expr(&expr_), flags(flags_) { }
+
+        const wxString *expr;
+        int flags;
+    };
+
+    class KeyHash
+    {
+    public:
+        KeyHash() { }
+        unsigned long operator()(const Key& key) const
+            { return wxStringHash()(*key.expr) ^ key.flags; }
+
+        KeyHash& operator=(const KeyHash&) { return *this; }
+    };
+
+    class KeyEqual
+    {
+    public:
+        KeyEqual() { }
+        bool operator()(const Key& a, const Key& b) const
+            { return a.flags == b.flags && *a.expr == *b.expr; }
+
+        KeyEqual& operator=(const KeyEqual&) { return *this; }
+    };
+
+    WX_DECLARE_HASH_MAP(Key, wxRegExCompiled *, KeyHash, KeyEqual, Map);
+
+    // operations on the LRU list, with the most recently used entry first
+    void Unlink(wxRegExCompiled *compiled);
+    void LinkAtFront(wxRegExCompiled *compiled);
+
+    Map m_map;
+    wxRegExCompiled *m_first,
+                    *m_last;
+
+    wxDECLARE_NO_COPY_CLASS(wxRegExCache);
 };
 
+// the global cache is only created when it's used for the first time
+static wxRegExCache *gs_regexCache = NULL;
+
+// the maximal number of the entries in it
+#ifndef WXREGEX_USING_RE_SEARCH
+static size_t gs_regexCacheMaxSize = 128;
+#else
+// ReSearch() below modifies the pattern, so it can't be shared
+static size_t gs_regexCacheMaxSize = 0;
+#endif
+
+wxCRIT_SECT_DECLARE(gs_csRegExCache);
 
 // ============================================================================
 // implementation
 // ============================================================================
 
 // ----------------------------------------------------------------------------
-// wxRegExImpl
+// helper functions
 // ----------------------------------------------------------------------------
 
-wxRegExImpl::wxRegExImpl()
+#ifdef WXREGEX_USING_BUILTIN
+
+// Return true if the expression may contain alternation outside of any group,
+// meaning that its matches don't necessarily start with the same text.
+//
+// This errs on the side of caution and doesn't try to parse bracket
+// expressions, which can contain both literal '|' and parentheses.
+static bool HasTopLevelAlternation(const wxString& expr, int flags)
 {
-    Init();
+    if ( expr.find(wxT('|')) == wxString::npos )
+        return false;
+
+    if ( (flags & wxRE_BASIC) || expr.find(wxT('[')) != wxString::npos )
+        return true;
+
+    int depth = 0;
+    for ( wxString::const_iterator i = expr.begin(); i != expr.end(); ++i )
+    {
+        switch ( (*i).GetValue() )
+        {
+            case wxT('\\'):
+                if ( ++i == expr.end() )
+                    return true;
+                break;
+
+            case wxT('('):
+                depth++;
+                break;
+
+            case wxT(')'):
+                depth--;
+                break;
+
+            case wxT('|'):
+                if ( depth <= 0 )
+                    return true;
+                break;
+        }
+    }
+
+    return false;
 }
 
-wxRegExImpl::~wxRegExImpl()
+// Return the literal text all the matches of the given expression start with.
+//
+// This is conservative and returns an empty string if there is any doubt.
+static wxString GetLiteralPrefix(const wxString& expr, int flags)
 {
-    Free();
+    if ( (flags & wxRE_ICASE) || HasTopLevelAlternation(expr, flags) )
+        return wxString();
+
+    size_t len = expr.find_first_of(wxT("\\^$.[]()*+?{}"));
+    if ( len == wxString::npos )
+        return expr;
+
+    // a quantifier applies to the previous character, which is then not a
+    // part of the prefix, and in basic syntax it may be escaped, as in "a\{2\}"
+    const wxUniChar ch = expr[len];
+    if ( len && (ch == wxT('*') || ch == wxT('+') || ch == wxT('?') ||
+                    ch == wxT('{') || ch == wxT('\\')) )
+        len--;
+
+    return expr.substr(0, len);
 }
 
-wxString wxRegExImpl::GetErrorMsg(int errorcode, bool badconv) const
+// Return the first occurrence of the literal text in the given string or NULL.
+static const wxRegChar *
+FindLiteral(const wxRegChar *str, size_t len,
+            const wxRegChar *lit, size_t litLen)
+{
+    if ( len < litLen )
+        return NULL;
+
+    // the last position at which the literal could start
+    const wxRegChar * const last = str + len - litLen;
+    for ( const wxRegChar *p = str; ; p++ )
+    {
+        p = wxTmemchr(p, *lit, last - p + 1);
+        if ( !p )
+            return NULL;
+
+        if ( wxTmemcmp(p + 1, lit + 1, litLen - 1) == 0 )
+            return p;
+
+        if ( p == last )
+            return NULL;
+    }
+}
+
+#endif // WXREGEX_USING_BUILTIN
+
+#ifdef WXREGEX_USING_RE_SEARCH
+
+// On GNU, regexec is implemented as a wrapper around re_search. re_search
+// requires a length parameter which the POSIX regexec does not have,
+// therefore regexec must do a strlen on the search text each time it is
+// called. This can drastically affect performance when matching is done in
+// a loop along a string, such as during a search and replace. Therefore if
+// re_search is detected by configure, it is used directly.
+//
+static int ReSearch(const regex_t *preg,
+                    const char *text,
+                    size_t len,
+                    re_registers *matches,
+                    int eflags)
+{
+    regex_t *pattern = const_cast<regex_t*>(preg);
+
+    pattern->not_bol = (eflags & REG_NOTBOL) != 0;
+    pattern->not_eol = (eflags & REG_NOTEOL) != 0;
+    pattern->regs_allocated = REGS_FIXED;
+
+    int ret = re_search(pattern, text, len, 0, len, matches);
+    return ret >= 0 ? 0 : REG_NOMATCH;
+}
+
+#endif // WXREGEX_USING_RE_SEARCH
+
+// ----------------------------------------------------------------------------
+// wxRegExCompiled
+// ----------------------------------------------------------------------------
+
+wxRegExCompiled::wxRegExCompiled(const wxString& expr, int flags)
+    : m_expr(expr),
+      m_flags(flags)
+{
+    m_cachePrev =
+    m_cacheNext = NULL;
+
+    m_nMatches = 0;
+    m_isCompiled = false;
+
+#ifdef WXREGEX_USING_BUILTIN
+    m_isLiteral = false;
+#endif // WXREGEX_USING_BUILTIN
+
+    m_refCount = 1;
+}
+
+wxRegExCompiled::~wxRegExCompiled()
+{
+    if ( m_isCompiled )
+        wx_regfree(&m_RegEx);
+}
+
+wxString wxRegExCompiled::GetErrorMsg(int errorcode, bool badconv) const
 {
 #ifdef WXREGEX_CONVERT_TO_MB
     // currently only needed when using system library in Unicode mode
@@ -261,10 +622,9 @@ wxString wxRegExImpl::GetErrorMsg(int errorcode, bool badconv) const
     return szError;
 }
 
-bool wxRegExImpl::Compile(const wxString& expr, int flags)
+/* static */
+wxRegExCompiled *wxRegExCompiled::Create(const wxString& expr, int flags)
 {
-    Reinit();
-
 #ifdef WX_NO_REGEX_ADVANCED
 #   define FLAVORS wxRE_BASIC
 #else
@@ -293,108 +653,127 @@ bool wxRegExImpl::Compile(const wxString& expr, int flags)
     if ( flags & wxRE_NEWLINE )
         flagsRE |= REG_NEWLINE;
 
+    wxRegExCompiled * const compiled = new wxRegExCompiled(expr, flags);
+
     // compile it
 #ifdef WXREGEX_USING_BUILTIN
     bool conv = true;
     // FIXME-UTF8: use wc_str() after removing ANSI build
-    int errorcode = wx_re_comp(&m_RegEx, expr.c_str(), expr.length(), flagsRE);
+    int errorcode = wx_re_comp(&compiled->m_RegEx, expr.c_str(), expr.length(), flagsRE);
 #else
     // FIXME-UTF8: this is potentially broken, we shouldn't even try it
     //             and should always use builtin regex library (or PCRE?)
     const wxWX2MBbuf conv = expr.mbc_str();
-    int errorcode = conv ? regcomp(&m_RegEx, conv, flagsRE) : REG_BADPAT;
+    int errorcode = conv ? regcomp(&compiled->m_RegEx, conv, flagsRE) : REG_BADPAT;
 #endif
 
     if ( errorcode )
     {
         wxLogError(_("Invalid regular expression '%s': %s"),
-                   expr.c_str(), GetErrorMsg(errorcode, !conv).c_str());
+                   expr.c_str(), compiled->GetErrorMsg(errorcode, !conv).c_str());
 
-        m_isCompiled = false;
+        delete compiled;
+
+        return NULL;
     }
-    else // ok
+
+    compiled->m_isCompiled = true;
+
+    // don't allocate the matches array now, but do it later if necessary
+    if ( !(flags & wxRE_NOSUB) )
     {
-        // don't allocate the matches array now, but do it later if necessary
-        if ( flags & wxRE_NOSUB )
-        {
-            // we don't need it at all
-            m_nMatches = 0;
-        }
-        else
-        {
-            // we will alloc the array later (only if really needed) but count
-            // the number of sub-expressions in the regex right now
+        // we will alloc the array later (only if really needed) but count
+        // the number of sub-expressions in the regex right now
 
-            // there is always one for the whole expression
-            m_nMatches = 1;
+        // there is always one for the whole expression
+        compiled->m_nMatches = 1;
 
-            // and some more for bracketed subexperessions
-            for ( const wxChar *cptr = expr.c_str(); *cptr; cptr++ )
+        // and some more for bracketed subexperessions
+        for ( const wxChar *cptr = expr.c_str(); *cptr; cptr++ )
+        {
+            if ( *cptr == wxT('\\') )
             {
-                if ( *cptr == wxT('\\') )
-                {
-                    // in basic RE syntax groups are inside \(...\)
-                    if ( *++cptr == wxT('(') && (flags & wxRE_BASIC) )
-                    {
-                        m_nMatches++;
-                    }
-                }
-                else if ( *cptr == wxT('(') && !(flags & wxRE_BASIC) )
+                // in basic RE syntax groups are inside \(...\)
+                if ( *++cptr == wxT('(') && (flags & wxRE_BASIC) )
                 {
-                    // we know that the previous character is not an unquoted
-                    // backslash because it would have been eaten above, so we
-                    // have a bare '(' and this indicates a group start for the
-                    // extended syntax. '(?' is used for extensions by perl-
-                    // like REs (e.g. advanced), and is not valid for POSIX
-                    // extended, so ignore them always.
-                    if ( cptr[1] != wxT('?') )
-                        m_nMatches++;
+                    compiled->m_nMatches++;
                 }
             }
+            else if ( *cptr == wxT('(') && !(flags & wxRE_BASIC) )
+            {
+                // we know that the previous character is not an unquoted
+                // backslash because it would have been eaten above, so we
+                // have a bare '(' and this indicates a group start for the
+                // extended syntax. '(?' is used for extensions by perl-
+                // like REs (e.g. advanced), and is not valid for POSIX
+                // extended, so ignore them always.
+                if ( cptr[1] != wxT('?') )
+                    compiled->m_nMatches++;
+            }
         }
+    }
 
-        m_isCompiled = true;
+#ifdef WXREGEX_USING_BUILTIN
+    const wxString prefix = GetLiteralPrefix(expr, flags);
+    if ( !prefix.empty() )
+    {
+        compiled->m_prefix = wxMakeRegCharBuffer(WXREGEX_CHAR(prefix),
+                                                 prefix.length());
+        compiled->m_isLiteral = prefix.length() == expr.length();
     }
+#endif // WXREGEX_USING_BUILTIN
 
-    return IsValid();
+    return compiled;
 }
 
-#ifdef WXREGEX_USING_RE_SEARCH
-
-// On GNU, regexec is implemented as a wrapper around re_search. re_search
-// requires a length parameter which the POSIX regexec does not have,
-// therefore regexec must do a strlen on the search text each time it is
-// called. This can drastically affect performance when matching is done in
-// a loop along a string, such as during a search and replace. Therefore if
-// re_search is detected by configure, it is used directly.
-//
-static int ReSearch(const regex_t *preg,
-                    const char *text,
-                    size_t len,
-                    re_registers *matches,
-                    int eflags)
+bool wxRegExCompiled::Exec(const wxRegChar *text,
+                           size_t start,
+                           size_t len,
+                           int flags,
+                           wxRegExMatches *matches) const
 {
-    regex_t *pattern = const_cast<regex_t*>(preg);
+    // translate our flags to regexec() ones
+    wxASSERT_MSG( !(flags & ~(wxRE_NOTBOL | wxRE_NOTEOL)),
+                  wxT("unrecognized flags in wxRegEx::Matches") );
 
-    pattern->not_bol = (eflags & REG_NOTBOL) != 0;
-    pattern->not_eol = (eflags & REG_NOTEOL) != 0;
-    pattern->regs_allocated = REGS_FIXED;
+    const wxRegChar *str = text ? text + start : NULL;
+    len -= start;
 
-    int ret = re_search(pattern, text, len, 0, len, matches);
-    return ret >= 0 ? 0 : REG_NOMATCH;
-}
+#ifdef WXREGEX_USING_BUILTIN
+    const size_t prefixLen = m_prefix.length();
+    if ( prefixLen && str )
+    {
+        // no match can start before the first occurrence of the prefix
+        const wxRegChar * const
+            found = FindLiteral(str, len, m_prefix.data(), prefixLen);
+        if ( !found )
+            return false;
 
-#endif // WXREGEX_USING_RE_SEARCH
+        start += found - str;
 
-bool wxRegExImpl::Matches(const wxRegChar *str,
-                          int flags
-                          WXREGEX_IF_NEED_LEN(size_t len)) const
-{
-    wxCHECK_MSG( IsValid(), false, wxT("must successfully Compile() first") );
+        if ( m_isLiteral )
+        {
+            // there is no need to run the RE at all
+            if ( matches && m_nMatches )
+            {
+                matches->SetOffset(0);
+                matches->Set(0, start, start + prefixLen);
+            }
 
-    // translate our flags to regexec() ones
-    wxASSERT_MSG( !(flags & ~(wxRE_NOTBOL | wxRE_NOTEOL)),
-                  wxT("unrecognized flags in wxRegEx::Matches") );
+            return true;
+        }
+
+        if ( found != str )
+        {
+            len -= found - str;
+            str = found;
+
+            // the expression starts with a literal, so it doesn't make sense
+            // for "^" to match at the start of the string passed to it
+            flags |= wxRE_NOTBOL;
+        }
+    }
+#endif // WXREGEX_USING_BUILTIN
 
     int flagsRE = 0;
     if ( flags & wxRE_NOTBOL )
@@ -402,22 +781,22 @@ bool wxRegExImpl::Matches(const wxRegChar *str,
     if ( flags & wxRE_NOTEOL )
         flagsRE |= REG_NOTEOL;
 
-    // allocate matches array if needed
-    wxRegExImpl *self = wxConstCast(this, wxRegExImpl);
-    if ( !m_Matches && m_nMatches )
+    wxRegExMatches::match_type pmatch = NULL;
+    if ( matches && m_nMatches )
     {
-        self->m_Matches = new wxRegExMatches(m_nMatches);
+        matches->SetOffset(start);
+        pmatch = matches->get();
     }
 
-    wxRegExMatches::match_type matches = m_Matches ? m_Matches->get() : NULL;
-
     // do match it
 #if defined WXREGEX_USING_BUILTIN
-    int rc = wx_re_exec(&self->m_RegEx, str, len, NULL, m_nMatches, matches, flagsRE);
+    int rc = wx_re_exec(const_cast<regex_t *>(&m_RegEx), str, len, NULL,
+                        m_nMatches, pmatch, flagsRE);
 #elif defined WXREGEX_USING_RE_SEARCH
-    int rc = str ? ReSearch(&self->m_RegEx, str, len, matches, flagsRE) : REG_BADPAT;
+    int rc = str ? ReSearch(&m_RegEx, str, len, pmatch, flagsRE) : REG_BADPAT;
 #else
-    int rc = str ? regexec(&self->m_RegEx, str, m_nMatches, matches, flagsRE) : REG_BADPAT;
+    wxUnusedVar(len);
+    int rc = str ? regexec(&m_RegEx, str, m_nMatches, pmatch, flagsRE) : REG_BADPAT;
 #endif
 
     switch ( rc )
@@ -438,12 +817,153 @@ bool wxRegExImpl::Matches(const wxRegChar *str,
     }
 }
 
+// ----------------------------------------------------------------------------
+// wxRegExCache
+// ----------------------------------------------------------------------------
+
+void wxRegExCache::Unlink(wxRegExCompiled *compiled)
+{
+    if ( compiled->m_cachePrev )
+        compiled->m_cachePrev->m_cacheNext = compiled->m_cacheNext;
+    else
+        m_first = compiled->m_cacheNext;
+
+    if ( compiled->m_cacheNext )
+        compiled->m_cacheNext->m_cachePrev = compiled->m_cachePrev;
+    else
+        m_last = compiled->m_cachePrev;
+
+    compiled->m_cachePrev =
+    compiled->m_cacheNext = NULL;
+}
+
+void wxRegExCache::LinkAtFront(wxRegExCompiled *compiled)
+{
+    compiled->m_cacheNext = m_first;
+    if ( m_first )
+        m_first->m_cachePrev = compiled;
+    else
+        m_last = compiled;
+
+    m_first = compiled;
+}
+
+wxRegExCompiled *wxRegExCache::Find(const wxString& expr, int flags)
+{
+    const Map::iterator it = m_map.find(Key(expr, flags));
+    if ( it == m_map.end() )
+        return NULL;
+
+    wxRegExCompiled * const compiled = it->second;
+    if ( compiled != m_first )
+    {
+        Unlink(compiled);
+        LinkAtFront(compiled);
+    }
+
+    compiled->IncRef();
+
+    return compiled;
+}
+
+void wxRegExCache::Add(wxRegExCompiled *compiled, size_t maxSize)
+{
+    // the same expression could have been compiled by another thread in the
+    // meanwhile, just keep using the existing entry then
+    wxRegExCompiled *&
+        entry = m_map[Key(compiled->GetExpr(), compiled->GetFlags())];
+    if ( entry )
+        return;
+
+    entry = compiled;
+    compiled->IncRef();
+    LinkAtFront(compiled);
+
+    Shrink(maxSize);
+}
+
+void wxRegExCache::Shrink(size_t size)
+{
+    while ( m_map.size() > size )
+    {
+        wxRegExCompiled * const compiled = m_last;
+        Unlink(compiled);
+
+        m_map.erase(Key(compiled->GetExpr(), compiled->GetFlags()));
+
+        compiled->DecRef();
+    }
+}
+
+// ----------------------------------------------------------------------------
+// wxRegExImpl
+// ----------------------------------------------------------------------------
+
+wxRegExImpl::wxRegExImpl()
+{
+    Init();
+}
+
+wxRegExImpl::~wxRegExImpl()
+{
+    Free();
+}
+
+bool wxRegExImpl::Compile(const wxString& expr, int flags)
+{
+    Reinit();
+
+    {
+        wxCRIT_SECT_LOCKER(lock, gs_csRegExCache);
+
+        if ( gs_regexCache )
+            m_compiled = gs_regexCache->Find(expr, flags);
+    }
+
+    if ( !m_compiled )
+    {
+        // don't lock the cache while compiling, this can take some time
+        m_compiled = wxRegExCompiled::Create(expr, flags);
+        if ( !m_compiled )
+        {
+            // error message already given in wxRegExCompiled::Create()
+            return false;
+        }
+
+        wxCRIT_SECT_LOCKER(lock, gs_csRegExCache);
+
+        if ( gs_regexCacheMaxSize )
+        {
+            if ( !gs_regexCache )
+                gs_regexCache = new wxRegExCache;
+
+            gs_regexCache->Add(m_compiled, gs_regexCacheMaxSize);
+        }
+    }
+
+    return IsValid();
+}
+
+bool wxRegExImpl::Matches(const wxRegChar *str, int flags, size_t len) const
+{
+    wxCHECK_MSG( IsValid(), false, wxT("must successfully Compile() first") );
+
+    // allocate matches array if needed
+    if ( !m_Matches && m_compiled->GetMatchCount() )
+    {
+        wxConstCast(this, wxRegExImpl)->m_Matches =
+            new wxRegExMatches(m_compiled->GetMatchCount());
+    }
+
+    return m_compiled->Exec(str, 0, len, flags, m_Matches);
+}
+
 bool wxRegExImpl::GetMatch(size_t *start, size_t *len, size_t index) const
 {
     wxCHECK_MSG( IsValid(), false, wxT("must successfully Compile() first") );
-    wxCHECK_MSG( m_nMatches, false, wxT("can't use with wxRE_NOSUB") );
+    wxCHECK_MSG( m_compiled->GetMatchCount(), false, wxT("can't use with wxRE_NOSUB") );
     wxCHECK_MSG( m_Matches, false, wxT("must call Matches() first") );
-    wxCHECK_MSG( index < m_nMatches, false, wxT("invalid match index") );
+    wxCHECK_MSG( index < m_compiled->GetMatchCount(), false, wxT("invalid match index") );
 
     if ( start )
         *start = m_Matches->Start(index);
@@ -456,9 +976,9 @@ bool wxRegExImpl::GetMatch(size_t *start, size_t *len, size_t index) const
 size_t wxRegExImpl::GetMatchCount() const
 {
     wxCHECK_MSG( IsValid(), 0, wxT("must successfully Compile() first") );
-    wxCHECK_MSG( m_nMatches, 0, wxT("can't use with wxRE_NOSUB") );
+    wxCHECK_MSG( m_compiled->GetMatchCount(), 0, wxT("can't use with wxRE_NOSUB") );
 
-    return m_nMatches;
+    return m_compiled->GetMatchCount();
 }
 
 int wxRegExImpl::Replace(wxString *text,
@@ -477,7 +997,7 @@ int wxRegExImpl::Replace(wxString *text,
     if (!textstr)
     {
         wxLogError(_("Failed to find match for regular expression: %s"),
-                   GetErrorMsg(0, true).c_str());
+                   m_compiled->GetErrorMsg(0, true).c_str());
         return 0;
     }
     size_t textlen = strlen(textstr);
@@ -517,8 +1037,8 @@ int wxRegExImpl::Replace(wxString *text,
 #else
                     textstr.data() + matchStart,
 #endif
-                    countRepl ? wxRE_NOTBOL : 0
-                    WXREGEX_IF_NEED_LEN(textlen - matchStart)) )
+                    countRepl ? wxRE_NOTBOL : 0,
+                    textlen - matchStart) )
     {
         // the string possibly contains back references: we need to calculate
         // the replacement text anew after each match
@@ -654,8 +1174,20 @@ bool wxRegEx::Matches(const wxString& str, int flags) const
 {
     wxCHECK_MSG( IsValid(), false, wxT("must successfully Compile() first") );
 
-    return m_impl->Matches(WXREGEX_CHAR(str), flags
-                            WXREGEX_IF_NEED_LEN(str.length()));
+    return m_impl->Matches(WXREGEX_CHAR(str), flags, str.length());
+}
+
+bool wxRegEx::Matches(const wxChar *text, int flags, size_t len) const
+{
+    wxCHECK_MSG( IsValid(), false, wxT("must successfully Compile() first") );
+
+#ifdef WXREGEX_USING_BUILTIN
+    // the built-in library uses wxChar and doesn't need NUL-terminated text,
+    // so there is no need to copy it
+    return m_impl->Matches(text, flags, len);
+#else
+    return Matches(wxString(text, len), flags);
+#endif
 }
 
 bool wxRegEx::GetMatch(size_t *start, size_t *len, size_t index) const
@@ -690,4 +1222,142 @@ int wxRegEx::Replace(wxString *pattern,
     return m_impl->Replace(pattern, replacement, maxMatches);
 }
 
+/* static */
+void wxRegEx::SetCacheSize(size_t size)
+{
+#ifdef WXREGEX_USING_RE_SEARCH
+    // ReSearch() modifies the pattern, so the cache must remain disabled
+    wxUnusedVar(size);
+#else
+    wxCRIT_SECT_LOCKER(lock, gs_csRegExCache);
+
+    gs_regexCacheMaxSize = size;
+
+    if ( gs_regexCache )
+        gs_regexCache->Shrink(size);
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// wxRegExIterator
+// ----------------------------------------------------------------------------
+
+bool wxRegExIteratorImpl::FindNext()
+{
+    const size_t len = m_text.length();
+    if ( m_pos > len )
+    {
+        m_matched = false;
+        return false;
+    }
+
+    // "^" may only match at the start of the entire text
+    m_matched = m_compiled->Exec(m_text.data(), m_pos, len,
+                                 m_pos ? m_flags | wxRE_NOTBOL : m_flags,
+                                 &m_matches);
+    if ( !m_matched )
+        return false;
+
+    // continue looking after the end of this match, but don't find the same
+    // empty match again
+    const size_t end = m_matches.End(0);
+    m_pos = end == m_matches.Start(0) ? end + 1 : end;
+
+    return true;
+}
+
+bool
+wxRegExIteratorImpl::GetMatch(size_t *start, size_t *len, size_t index) const
+{
+    wxCHECK_MSG( m_matched, false, wxT("must call FindNext() first") );
+    wxCHECK_MSG( index < m_compiled->GetMatchCount(), false,
+                 wxT("invalid match index") );
+
+    if ( start )
+        *start = m_matches.Start(index);
+    if ( len )
+        *len = m_matches.End(index) - m_matches.Start(index);
+
+    return true;
+}
+
+wxString wxRegExIteratorImpl::GetMatch(size_t index) const
+{
+    size_t start, len;
+    if ( !GetMatch(&start, &len, index) || start == (size_t)-1 )
+        return wxString();
+
+#ifndef WXREGEX_CONVERT_TO_MB
+    return wxString(m_text.data() + start, len);
+#else
+    return wxString(m_text.data() + start, *wxConvCurrent, len);
+#endif
+}
+
+wxRegExIterator::wxRegExIterator(const wxRegEx& re,
+                                 const wxString& text,
+                                 int flags)
+{
+    m_impl = NULL;
+
+    wxCHECK_RET( re.IsValid(), wxT("must successfully Compile() first") );
+
+    wxRegExCompiled * const compiled = re.m_impl->GetCompiled();
+    wxCHECK_RET( compiled->GetMatchCount(), wxT("can't use with wxRE_NOSUB") );
+
+    m_impl = new wxRegExIteratorImpl
+                 (
+                    compiled,
+                    wxMakeRegCharBuffer(WXREGEX_CHAR(text), text.length()),
+                    flags
+                 );
+}
+
+wxRegExIterator::~wxRegExIterator()
+{
+    delete m_impl;
+}
+
+bool wxRegExIterator::FindNext()
+{
+    return m_impl && m_impl->FindNext();
+}
+
+bool wxRegExIterator::GetMatch(size_t *start, size_t *len, size_t index) const
+{
+    wxCHECK_MSG( m_impl, false, wxT("invalid wxRegExIterator") );
+
+    return m_impl->GetMatch(start, len, index);
+}
+
+wxString wxRegExIterator::GetMatch(size_t index) const
+{
+    wxCHECK_MSG( m_impl, wxString(), wxT("invalid wxRegExIterator") );
+
+    return m_impl->GetMatch(index);
+}
+
+// ----------------------------------------------------------------------------
+// wxRegExModule: frees the cache on shutdown
+// ----------------------------------------------------------------------------
+
+class wxRegExModule : public wxModule
+{
+public:
+    wxRegExModule() { }
+
+    virtual bool OnInit() wxOVERRIDE { return true; }
+    virtual void OnExit() wxOVERRIDE
+    {
+        wxCRIT_SECT_LOCKER(lock, gs_csRegExCache);
+
+        wxDELETE(gs_regexCache);
+    }
+
+private:
+    wxDECLARE_DYNAMIC_CLASS(wxRegExModule);
+};
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxRegExModule, wxModule);
+
 #endif // wxUSE_REGEX
@@ -955,6 +955,31 @@ const unsigned char tableUtf8Lengths[256] = {
                    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0   // F5..FF
 };
 
+// Runs of ASCII characters, which are common even in non-English text, are
+// converted by the functions below in blocks of this many characters at once.
+static const size_t ASCII_BLOCK_LEN = 8;
+
+// Check if the block of ASCII_BLOCK_LEN bytes starting at p contains only ASCII
+// characters. This is done by testing the high bits of all bytes together,
+// using memcpy() to avoid any problems with unaligned pointers.
+static inline bool IsASCIIBlock(const char *p)
+{
+    wxUint32 words[ASCII_BLOCK_LEN / sizeof(wxUint32)];
+    memcpy(words, p, sizeof(words));
+
+    return !((words[0] | words[1]) & 0x80808080);
+}
+
+// Same as above but for a block of ASCII_BLOCK_LEN wide characters.
+static inline bool IsASCIIBlock(const wchar_t *wp)
+{
+    wxUint32 bits = 0;
+    for ( size_t n = 0; n < ASCII_BLOCK_LEN; n++ )
+        bits |= static_cast<wxUint32>(wp[n]);
+
+    return bits <= 0x7F;
+}
+
 size_t
 wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
                             const char *src, size_t srcLen) const
@@ -967,6 +992,26 @@ wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
 
     for ( const char *p = src; ; p++ )
     {
+        // Notice that we always leave at least one byte to the code below, so
+        // that it still handles the end of the string.
+        while ( srcLen > ASCII_BLOCK_LEN &&
+                    (!out || dstLen >= ASCII_BLOCK_LEN) &&
+                        IsASCIIBlock(p) )
+        {
+            if ( out )
+            {
+                for ( size_t n = 0; n < ASCII_BLOCK_LEN; n++ )
+                    out[n] = static_cast<unsigned char>(p[n]);
+
+                out += ASCII_BLOCK_LEN;
+                dstLen -= ASCII_BLOCK_LEN;
+            }
+
+            p += ASCII_BLOCK_LEN;
+            srcLen -= ASCII_BLOCK_LEN;
+            written += ASCII_BLOCK_LEN;
+        }
+
         if ( (srcLen == wxNO_LEN ? !*p : !srcLen) )
         {
             // all done successfully, just add the trailing NULL if we are not
@@ -1080,6 +1125,26 @@ wxMBConvStrictUTF8::FromWChar(char *dst, size_t dstLen,
     const wchar_t* const end = srcLen == wxNO_LEN ? NULL : src + srcLen;
     for ( const wchar_t *wp = src; ; )
     {
+        // we can't check for the ASCII blocks without knowing where the
+        // string ends, but this is not a problem as the length is almost
+        // always given when converting wxStrings
+        while ( end && end - wp >= static_cast<ptrdiff_t>(ASCII_BLOCK_LEN) &&
+                    (!out || dstLen >= ASCII_BLOCK_LEN) &&
+                        IsASCIIBlock(wp) )
+        {
+            if ( out )
+            {
+                for ( size_t n = 0; n < ASCII_BLOCK_LEN; n++ )
+                    out[n] = static_cast<char>(wp[n]);
+
+                out += ASCII_BLOCK_LEN;
+                dstLen -= ASCII_BLOCK_LEN;
+            }
+
+            wp += ASCII_BLOCK_LEN;
+            written += ASCII_BLOCK_LEN;
+        }
+
         if ( end ? wp == end : !*wp )
         {
             // all done successfully, just add the trailing NULL if we are not
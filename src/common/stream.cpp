@@ -260,6 +260,40 @@ size_t wxStreamBuffer::GetDataLeft()
     return GetBytesLeft();
 }
 
+const void *wxStreamBuffer::PeekData(size_t *size)
+{
+    wxCHECK_MSG( size, NULL, wxT("NULL size pointer") );
+    wxCHECK_MSG( m_mode != write, NULL, wxT("can't read from this buffer") );
+
+    // lasterror is reset before all new IO calls
+    if ( m_stream )
+        m_stream->Reset();
+
+    size_t left = GetDataLeft();
+    if ( !left && HasBuffer() && FillBuffer() )
+        left = GetBytesLeft();
+
+    *size = left;
+    if ( !left )
+    {
+        SetError(wxSTREAM_EOF);
+        return NULL;
+    }
+
+    return m_buffer_pos;
+}
+
+void wxStreamBuffer::Consume(size_t size)
+{
+    wxCHECK_RET( size <= GetBytesLeft(),
+                 wxT("can't consume more data than available") );
+
+    m_buffer_pos += size;
+
+    if ( m_stream )
+        m_stream->m_lastcount = size;
+}
+
 // copy up to size bytes from our buffer into the provided one
 void wxStreamBuffer::GetFromBuffer(void *buffer, size_t size)
 {
@@ -730,6 +764,10 @@ wxInputStream::~wxInputStream()
 
 bool wxInputStream::CanRead() const
 {
+    // we can always read the data from the write back buffer
+    if ( m_wbacksize > m_wbackcur )
+        return true;
+
     // we don't know if there is anything to read or not and by default we
     // prefer to be optimistic and try to read data unless we know for sure
     // there is no more of it
@@ -877,6 +915,89 @@ wxInputStream& wxInputStream::Read(void *buf, size_t size)
     return *this;
 }
 
+const void *wxInputStream::PeekData(size_t *size)
+{
+    wxCHECK_MSG( size, NULL, wxT("NULL size pointer") );
+
+    // the data put back into the stream must be returned first
+    if ( m_wback && m_wbackcur < m_wbacksize )
+    {
+        *size = m_wbacksize - m_wbackcur;
+        return m_wback + m_wbackcur;
+    }
+
+    const void * const data = DoPeekData(size);
+    if ( !data )
+        *size = 0;
+
+    return data;
+}
+
+void wxInputStream::Consume(size_t size)
+{
+    if ( m_wback )
+    {
+        wxCHECK_RET( size <= m_wbacksize - m_wbackcur,
+                     wxT("can't consume more data than available") );
+
+        m_wbackcur += size;
+        if ( m_wbackcur == m_wbacksize )
+        {
+            free(m_wback);
+            m_wback = NULL;
+            m_wbacksize = 0;
+            m_wbackcur = 0;
+        }
+    }
+    else if ( size )
+    {
+        DoConsume(size);
+    }
+
+    m_lastcount = size;
+}
+
+const void *wxInputStream::DoPeekData(size_t *size)
+{
+    // we don't have any buffer to return the pointer to, so read the next
+    // chunk of data into the write back buffer and return it from there
+    //
+    // only do it for the seekable streams, i.e. normal files, however: for
+    // the others, such as pipes or sockets, reading ahead could block waiting
+    // for more data than is going to be sent to us and would make CanRead()
+    // of the streams not taking the write back buffer into account wrong, so
+    // read just a single byte from them, as GetC() does
+    const size_t chunkSize = IsSeekable() ? BUF_TEMP_SIZE : 1;
+
+    char * const buf = AllocSpaceWBack(chunkSize);
+    if ( !buf )
+        return NULL;
+
+    const size_t count = OnSysRead(buf, chunkSize);
+    if ( !count )
+    {
+        free(m_wback);
+        m_wback = NULL;
+        m_wbacksize = 0;
+        m_wbackcur = 0;
+
+        return NULL;
+    }
+
+    m_wbacksize = count;
+
+    *size = count;
+    return buf;
+}
+
+void wxInputStream::DoConsume(size_t WXUNUSED(size))
+{
+    // this is never called for the streams using the default DoPeekData(), as
+    // all the data is consumed from the write back buffer for them, so it
+    // must be overridden together with DoPeekData()
+    wxFAIL_MSG( wxT("must be overridden if DoPeekData() is") );
+}
+
 char wxInputStream::Peek()
 {
     char c;
@@ -1011,7 +1132,12 @@ wxFileOffset wxInputStream::SeekI(wxFileOffset pos, wxSeekMode mode)
 
     if (m_wback)
     {
-        wxLogDebug( wxT("Seeking in stream which has data written back to it.") );
+        // the underlying stream position is after the data in the write back
+        // buffer, which may have been read ahead by PeekData(), so take it
+        // into account when seeking relatively to the current position, as
+        // TellI() does
+        if (mode == wxFromCurrent)
+            pos -= (m_wbacksize - m_wbackcur);
 
         free(m_wback);
         m_wback = NULL;
@@ -1419,6 +1545,16 @@ size_t wxBufferedInputStream::OnSysRead(void *buffer, size_t bufsize)
     return m_parent_i_stream->Read(buffer, bufsize).LastRead();
 }
 
+const void *wxBufferedInputStream::DoPeekData(size_t *size)
+{
+    return m_i_streambuf->PeekData(size);
+}
+
+void wxBufferedInputStream::DoConsume(size_t size)
+{
+    m_i_streambuf->Consume(size);
+}
+
 wxFileOffset wxBufferedInputStream::OnSysSeek(wxFileOffset seek, wxSeekMode mode)
 {
     return m_parent_i_stream->SeekI(seek, mode);
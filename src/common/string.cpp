@@ -112,6 +112,34 @@ static wxStrCacheInitializer gs_stringCacheInit;
 
 #endif // wxHAS_COMPILER_TLS/!wxHAS_COMPILER_TLS
 
+#if wxUSE_STRING_POS_INDEX
+
+void wxString::FreeCacheIndices()
+{
+    Cache::Element * const cacheBegin = GetCacheBegin();
+#ifndef wxHAS_COMPILER_TLS
+    if ( cacheBegin == NULL )
+        return;
+#endif
+    Cache::Element * const cacheEnd = GetCacheEnd();
+    for ( Cache::Element *c = cacheBegin; c != cacheEnd; c++ )
+        c->index.Reset();
+}
+
+// the other threads free their indices when they terminate, but the main one
+// needs to do it on program exit
+struct wxStrCacheCleaner
+{
+    ~wxStrCacheCleaner()
+    {
+        wxString::FreeCacheIndices();
+    }
+};
+
+static wxStrCacheCleaner gs_stringCacheCleaner;
+
+#endif // wxUSE_STRING_POS_INDEX
+
 // gdb seems to be unable to display thread-local variables correctly, at least
 // not my 6.4.98 version under amd64, so provide this debugging helper to do it
 #if wxDEBUG_LEVEL >= 2
@@ -250,7 +278,9 @@ void wxString::PosLenToImpl(size_t pos, size_t len,
     }
     else // have valid start position
     {
-        const const_iterator b = GetIterForNthChar(pos);
+        // notice that we can't use GetIterForNthChar() here as it could index
+        // the string which is about to be modified by our caller
+        const const_iterator b(this, m_impl.begin() + PosToImpl(pos));
         *implPos = wxStringImpl::const_iterator(b.impl()) - m_impl.begin();
         if ( len == npos )
         {
@@ -258,6 +288,19 @@ void wxString::PosLenToImpl(size_t pos, size_t len,
         }
         else // have valid length too
         {
+#if wxUSE_STRING_POS_INDEX
+            // the index allows to find the end of the substring quickly too
+            const Cache::Element * const cache = FindCacheElement();
+            if ( cache && cache->index.state != PosIndex::State_None &&
+                    pos <= cache->index.len )
+            {
+                const size_t lenStr = cache->index.len;
+                const size_t posEnd = len < lenStr - pos ? pos + len : lenStr;
+                *implLen = PosToImpl(posEnd) - *implPos;
+                return;
+            }
+#endif // wxUSE_STRING_POS_INDEX
+
             // we need to handle the case of length specifying a substring
             // going beyond the end of the string, just as std::string does
             const const_iterator e(end());
@@ -273,6 +316,101 @@ void wxString::PosLenToImpl(size_t pos, size_t len,
     }
 }
 
+#if wxUSE_STRING_POS_INDEX
+
+void wxString::BuildPosIndex(PosIndex& index) const
+{
+    const size_t lenImpl = m_impl.length();
+    const unsigned char * const
+        p = reinterpret_cast<const unsigned char *>(m_impl.data());
+
+    // check if the string is pure ASCII first, this is the common case and we
+    // don't need to store anything but a flag for it
+    size_t ofs = 0;
+    while ( ofs < lenImpl && p[ofs] < 0x80 )
+        ofs++;
+
+    if ( ofs == lenImpl )
+    {
+        index.len = lenImpl;
+        index.state = PosIndex::State_ASCII;
+        return;
+    }
+
+    // there can't be more characters than bytes, so this is enough
+    size_t * const offsets = static_cast<size_t *>(
+            malloc((lenImpl / PosIndex::STEP + 1)*sizeof(size_t)));
+    if ( !offsets )
+        return;
+
+    // all characters of the ASCII prefix found above are single bytes
+    size_t n;
+    for ( n = 0; n < ofs; n += PosIndex::STEP )
+        offsets[n / PosIndex::STEP] = n;
+
+    // and for the rest we need to count the bytes starting new characters
+    for ( n = ofs; ofs < lenImpl; ofs++ )
+    {
+        if ( (p[ofs] & 0xC0) != 0x80 )
+        {
+            if ( n % PosIndex::STEP == 0 )
+                offsets[n / PosIndex::STEP] = ofs;
+
+            n++;
+        }
+    }
+
+    index.count = (n + PosIndex::STEP - 1) / PosIndex::STEP;
+    index.len = n;
+
+    // don't waste memory if the string uses multiple bytes per character
+    void * const offsetsShrunk = realloc(offsets, index.count*sizeof(size_t));
+    index.offsets = offsetsShrunk ? static_cast<size_t *>(offsetsShrunk)
+                                  : offsets;
+    index.state = PosIndex::State_Offsets;
+}
+
+size_t wxString::DoIndexedPosToImpl(const PosIndex& index, size_t pos) const
+{
+    // start from the closest indexed character preceding the given position
+    size_t n = pos / PosIndex::STEP;
+    if ( n >= index.count )
+        n = index.count - 1;
+
+    wxStringImpl::const_iterator i(m_impl.begin() + index.offsets[n]);
+    for ( n *= PosIndex::STEP; n < pos; n++ )
+        wxStringOperations::IncIter(i);
+
+    return i - m_impl.begin();
+}
+
+size_t wxString::DoIndexedPosFromImpl(const PosIndex& index, size_t impl) const
+{
+    // find the last indexed character not after the given offset
+    size_t lo = 0,
+           hi = index.count;
+    while ( hi - lo > 1 )
+    {
+        const size_t mid = (lo + hi) / 2;
+        if ( index.offsets[mid] <= impl )
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    // and count the characters between it and this offset
+    const wxStringImpl::const_iterator end(m_impl.begin() + impl);
+    wxStringImpl::const_iterator i(m_impl.begin() + index.offsets[lo]);
+
+    size_t pos;
+    for ( pos = lo*PosIndex::STEP; i < end; pos++ )
+        wxStringOperations::IncIter(i);
+
+    return pos;
+}
+
+#endif // wxUSE_STRING_POS_INDEX
+
 #endif // wxUSE_UNICODE_UTF8
 
 // ----------------------------------------------------------------------------
@@ -601,7 +739,10 @@ wxString operator+(const wxString& str1, const wxString& str2)
     wxASSERT( str2.IsValid() );
 #endif
 
-    wxString s = str1;
+    // reserve the space for the result to avoid reallocating it
+    wxString s;
+    s.reserve(str1.length() + str2.length());
+    s += str1;
     s += str2;
 
     return s;
@@ -2303,3 +2444,153 @@ int wxString::Freq(wxUniChar ch) const
     return count;
 }
 
+
+// ----------------------------------------------------------------------------
+// wxStringBuilder
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Append the decimal representation of the given number to the builder.
+template <typename T>
+void AppendDecimal(wxStringBuilder& builder, T n, bool negative)
+{
+    // enough for all digits of 64 bit numbers and the sign
+    wxChar buf[24];
+    wxChar* p = buf + WXSIZEOF(buf);
+
+    *--p = wxT('\0');
+    do
+    {
+        *--p = static_cast<wxChar>(wxT('0') + n % 10);
+        n /= 10;
+    } while ( n );
+
+    if ( negative )
+        *--p = wxT('-');
+
+    builder.Append(p);
+}
+
+} // anonymous namespace
+
+wxStringBuilder& wxStringBuilder::Append(const char *psz)
+{
+    // ASCII strings, which are by far the most common ones, are represented
+    // in the same way in all encodings, so we can avoid converting them
+    const char* end = psz;
+    while ( *end && !(*end & 0x80) )
+        end++;
+
+    if ( *end )
+        return Append(wxString(psz));
+
+    while ( psz != end )
+    {
+        wxStringCharType buf[64];
+
+        size_t len = 0;
+        for ( ; len < WXSIZEOF(buf) && psz != end; len++ )
+            buf[len] = *psz++;
+
+        DoAppend(buf, len);
+    }
+
+    return *this;
+}
+
+wxStringBuilder& wxStringBuilder::Append(wxUniChar ch)
+{
+    if ( wxStringOperations::IsSingleCodeUnitCharacter(ch) )
+    {
+        const wxStringCharType c = static_cast<wxStringCharType>(ch);
+        DoAppend(&c, 1);
+    }
+    else
+    {
+        Append(wxString(ch));
+    }
+
+    return *this;
+}
+
+wxStringBuilder& wxStringBuilder::Append(float f)
+{
+    wxChar buf[128];
+    wxSnprintf(buf, WXSIZEOF(buf), wxT("%f"), f);
+
+    return Append(buf);
+}
+
+wxStringBuilder& wxStringBuilder::Append(double d)
+{
+    wxChar buf[128];
+    wxSnprintf(buf, WXSIZEOF(buf), wxT("%g"), d);
+
+    return Append(buf);
+}
+
+void wxStringBuilder::DoAppendNumber(unsigned long n, bool negative)
+{
+    AppendDecimal(*this, n, negative);
+}
+
+#ifdef wxHAS_LONG_LONG_T_DIFFERENT_FROM_LONG
+void wxStringBuilder::DoAppendNumber(wxULongLong_t n, bool negative)
+{
+    AppendDecimal(*this, n, negative);
+}
+#endif // wxHAS_LONG_LONG_T_DIFFERENT_FROM_LONG
+
+void wxStringBuilder::Reserve(size_t len)
+{
+    if ( m_inBuf )
+    {
+        if ( len <= BUF_LEN )
+            return;
+
+        m_str.m_impl.reserve(len);
+        m_str.m_impl.assign(m_buf, m_len);
+        m_inBuf = false;
+    }
+    else
+    {
+        m_str.m_impl.reserve(len);
+    }
+}
+
+void wxStringBuilder::DoAppendToString(const wxStringCharType *p, size_t len)
+{
+    if ( m_inBuf )
+    {
+        // switch to using the string, reserving enough space in it to avoid
+        // having to reallocate it too soon
+        Reserve(2*(m_len + len));
+    }
+
+    m_str.m_impl.append(p, len);
+}
+
+wxString wxStringBuilder::ToString() const
+{
+    if ( !m_inBuf )
+        return m_str;
+
+    wxString str;
+    str.m_impl.assign(m_buf, m_len);
+    return str;
+}
+
+wxString wxStringBuilder::Release()
+{
+    wxString str;
+    if ( m_inBuf )
+        str.m_impl.assign(m_buf, m_len);
+    else
+        str.swap(m_str);
+
+    Clear();
+
+    return str;
+}
@@ -22,6 +22,7 @@
 #include "wx/thread.h"
 #include "wx/sharedptr.h"
 #include "wx/vector.h"
+#include "wx/string.h"
 
 namespace
 {
@@ -74,6 +75,11 @@ wxThreadSpecificInfo& wxThreadSpecificInfo::Get()
 
 void wxThreadSpecificInfo::ThreadCleanUp()
 {
+#if wxUSE_STRING_POS_INDEX
+    // this is not stored in this object, but must be freed at the same time
+    wxString::FreeCacheIndices();
+#endif // wxUSE_STRING_POS_INDEX
+
     if ( !wxTHIS_THREAD_INFO )
         return; // nothing to do, not used by this thread at all
 
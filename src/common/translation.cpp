@@ -48,6 +48,7 @@
 #include "wx/fontmap.h"
 #include "wx/scopedptr.h"
 #include "wx/stdpaths.h"
+#include "wx/thread.h"
 #include "wx/private/threadinfo.h"
 
 #ifdef __WINDOWS__
@@ -1034,6 +1035,21 @@ public:
     // fills the hash with string-translation pairs
     bool FillHash(wxStringToStringHashMap& hash, const wxString& domain) const;
 
+#if wxUSE_UNICODE
+    // map the catalog file into memory, InitLookup() must be called after it
+    // to use GetString()
+    bool MapFile(const wxString& filename,
+                 wxPluralFormsCalculatorPtr& rPluralFormsCalculator);
+
+    // prepare for looking up the strings directly in the catalog data,
+    // return false if this can't be done for this catalog
+    bool InitLookup();
+
+    // return the translation of the given string or NULL if not found, the
+    // index is that of the plural form to use
+    const wxString *GetString(const wxString& msgid, int index);
+#endif // wxUSE_UNICODE
+
     // return the charset of the strings in this catalog or empty string if
     // none/unknown
     wxString GetCharset() const { return m_charset; }
@@ -1070,6 +1086,29 @@ private:
 
     wxString m_charset;               // from the message catalog header
 
+#if wxUSE_UNICODE
+    // the file containing m_data if MapFile() was used
+    wxMappedFile m_mappedFile;
+
+    // the hash table from the catalog or NULL if it doesn't have it, in which
+    // case the original strings are looked up using binary search
+    const size_t32   *m_pHashTable;
+    size_t32          m_nHashSize;
+
+    // the conversion to use for the strings in the catalog or NULL to use
+    // wxConvCurrent
+    wxScopedPtr<wxMBConv> m_conv;
+
+    // the translations already returned by GetString(), indexed in the same
+    // way as wxMsgCatalog::m_messages, and the critical section protecting
+    // it as GetString() can be called from multiple threads
+    wxStringToStringHashMap m_translations;
+    wxCRIT_SECT_DECLARE_MEMBER(m_csTranslations);
+
+    // return the index of the original string or m_numStrings if not found
+    size_t32 FindOrigString(const char *str) const;
+#endif // wxUSE_UNICODE
+
 
     // swap the 2 halves of 32 bit integer if needed
     size_t32 Swap(size_t32 ui) const
@@ -1104,6 +1143,10 @@ private:
 
 wxMsgCatalogFile::wxMsgCatalogFile()
 {
+#if wxUSE_UNICODE
+    m_pHashTable = NULL;
+    m_nHashSize = 0;
+#endif // wxUSE_UNICODE
 }
 
 wxMsgCatalogFile::~wxMsgCatalogFile()
@@ -1340,14 +1383,218 @@ bool wxMsgCatalogFile::FillHash(wxStringToStringHashMap& hash,
     return true;
 }
 
+#if wxUSE_UNICODE
+
+namespace
+{
+
+// the hash function used by GNU gettext for the hash table in .mo files
+size_t32 GetMsgHash(const char *str)
+{
+    size_t32 hval = 0;
+    while ( *str )
+    {
+        hval <<= 4;
+        hval += static_cast<unsigned char>(*str++);
+
+        const size_t32 g = hval & (size_t32(0xf) << 28);
+        if ( g )
+        {
+            hval ^= g >> 24;
+            hval ^= g;
+        }
+    }
+
+    return hval;
+}
+
+} // anonymous namespace
+
+bool wxMsgCatalogFile::MapFile(const wxString& filename,
+                               wxPluralFormsCalculatorPtr& rPluralFormsCalculator)
+{
+    if ( !m_mappedFile.Open(filename) )
+        return false;
+
+    bool ok = LoadData
+              (
+                  DataBuffer::CreateNonOwned
+                  (
+                      static_cast<const char *>(m_mappedFile.GetData()),
+                      m_mappedFile.GetLength()
+                  ),
+                  rPluralFormsCalculator
+              );
+    if ( !ok )
+    {
+        wxLogWarning(_("'%s' is not a valid message catalog."), filename.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool wxMsgCatalogFile::InitLookup()
+{
+    const char * const data = m_data.data();
+    const size_t lenData = m_data.length();
+
+    // unlike FillHash(), we don't examine all the strings later, so check
+    // that the tables are valid now to be able to access them without any
+    // checks in GetString()
+    const wxMsgCatalogHeader * const
+        pHeader = reinterpret_cast<const wxMsgCatalogHeader *>(data);
+    const size_t maxStrings = lenData / sizeof(wxMsgTableEntry);
+    if ( m_numStrings > maxStrings ||
+            Swap(pHeader->ofsOrigTable) >
+                lenData - m_numStrings*sizeof(wxMsgTableEntry) ||
+            Swap(pHeader->ofsTransTable) >
+                lenData - m_numStrings*sizeof(wxMsgTableEntry) )
+        return false;
+
+    // the original strings must be NUL-terminated to be compared using
+    // strcmp() and the translations to be inside the data
+    for ( size_t32 n = 0; n < m_numStrings; n++ )
+    {
+        const size_t32 ofsOrig = Swap(m_pOrigTable[n].ofsString);
+        const size_t32 lenOrig = Swap(m_pOrigTable[n].nLen);
+        if ( ofsOrig >= lenData || lenOrig >= lenData - ofsOrig ||
+                data[ofsOrig + lenOrig] != '\0' )
+            return false;
+
+        if ( !StringAtOfs(m_pTransTable, n) )
+            return false;
+    }
+
+    const size_t32 nHashSize = Swap(pHeader->nHashSize);
+    const size_t32 ofsHashTable = Swap(pHeader->ofsHashTable);
+    if ( nHashSize > 2 && ofsHashTable <= lenData &&
+            nHashSize <= (lenData - ofsHashTable) / sizeof(size_t32) )
+    {
+        m_pHashTable = reinterpret_cast<const size_t32 *>(data + ofsHashTable);
+        m_nHashSize = nHashSize;
+    }
+    else // no hash table, we'll have to use binary search
+    {
+        // which is only possible if the strings are sorted, as they normally
+        // are in the catalogs created by msgfmt
+        for ( size_t32 n = 1; n < m_numStrings; n++ )
+        {
+            if ( strcmp(StringAtOfs(m_pOrigTable, n - 1),
+                        StringAtOfs(m_pOrigTable, n)) >= 0 )
+                return false;
+        }
+    }
+
+    if ( !m_charset.empty() )
+        m_conv.reset(new wxCSConv(m_charset));
+
+    return true;
+}
+
+size_t32 wxMsgCatalogFile::FindOrigString(const char *str) const
+{
+    if ( m_pHashTable )
+    {
+        const size_t32 hval = GetMsgHash(str);
+        const size_t32 incr = 1 + hval % (m_nHashSize - 2);
+        size_t32 idx = hval % m_nHashSize;
+
+        // don't loop forever if the hash table is full in a corrupt catalog
+        for ( size_t32 probe = 0; probe < m_nHashSize; probe++ )
+        {
+            const size_t32 n = Swap(m_pHashTable[idx]);
+            if ( n == 0 )
+                break;
+
+            if ( n <= m_numStrings &&
+                    strcmp(str, StringAtOfs(m_pOrigTable, n - 1)) == 0 )
+                return n - 1;
+
+            if ( idx >= m_nHashSize - incr )
+                idx -= m_nHashSize - incr;
+            else
+                idx += incr;
+        }
+    }
+    else // binary search in the sorted table
+    {
+        size_t32 lo = 0,
+                 hi = m_numStrings;
+        while ( lo < hi )
+        {
+            const size_t32 mid = lo + (hi - lo) / 2;
+            const int rc = strcmp(str, StringAtOfs(m_pOrigTable, mid));
+            if ( rc == 0 )
+                return mid;
+
+            if ( rc < 0 )
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+    }
+
+    return m_numStrings;
+}
+
+const wxString *wxMsgCatalogFile::GetString(const wxString& msgid, int index)
+{
+    const wxString key = index == 0 ? msgid : msgid + wxChar(index);
+
+    wxCRIT_SECT_LOCKER(lock, m_csTranslations);
+
+    wxStringToStringHashMap::const_iterator it = m_translations.find(key);
+    if ( it != m_translations.end() )
+        return &it->second;
+
+    const wxMBConv& conv = m_conv ? *m_conv : *wxConvCurrent;
+
+    const wxScopedCharBuffer buf(conv.IsUTF8() ? msgid.utf8_str()
+                                               : conv.cWC2MB(msgid.wc_str()));
+    if ( !buf.data() )
+        return NULL;
+
+    const size_t32 n = FindOrigString(buf.data());
+    if ( n == m_numStrings )
+        return NULL;
+
+    // find the plural form with the given index among the NUL-separated
+    // translations, see the comment in FillHash()
+    const char * const data = StringAtOfs(m_pTransTable, n);
+    const size_t length = Swap(m_pTransTable[n].nLen);
+    size_t offset = 0;
+    for ( int i = 0; offset < length; i++ )
+    {
+        const char * const str = data + offset;
+        const size_t len = wxStrnlen(str, length - offset);
+        if ( i == index )
+        {
+            if ( !len )
+                break;
+
+            wxString& msgstr = m_translations[key];
+            msgstr = wxString(str, conv, len);
+            return &msgstr;
+        }
+
+        offset += len + 1;
+    }
+
+    return NULL;
+}
+
+#endif // wxUSE_UNICODE
 
 // ----------------------------------------------------------------------------
 // wxMsgCatalog class
 // ----------------------------------------------------------------------------
 
-#if !wxUSE_UNICODE
 wxMsgCatalog::~wxMsgCatalog()
 {
+    delete m_file;
+
+#if !wxUSE_UNICODE
     if ( m_conv )
     {
         if ( wxConvUI == m_conv )
@@ -1359,21 +1606,41 @@ wxMsgCatalog::~wxMsgCatalog()
 
         delete m_conv;
     }
-}
 #endif // !wxUSE_UNICODE
+}
 
 /* static */
 wxMsgCatalog *wxMsgCatalog::CreateFromFile(const wxString& filename,
-                                           const wxString& domain)
+                                           const wxString& domain,
+                                           int flags)
 {
     wxScopedPtr<wxMsgCatalog> cat(new wxMsgCatalog(domain));
 
-    wxMsgCatalogFile file;
+    wxScopedPtr<wxMsgCatalogFile> file(new wxMsgCatalogFile);
 
-    if ( !file.LoadFile(filename, cat->m_pluralFormsCalculator) )
-        return NULL;
+#if wxUSE_UNICODE
+    if ( flags & Load_OnDemand )
+    {
+        if ( !file->MapFile(filename, cat->m_pluralFormsCalculator) )
+            return NULL;
 
-    if ( !file.FillHash(cat->m_messages, domain) )
+        if ( file->InitLookup() )
+        {
+            cat->m_file = file.release();
+            return cat.release();
+        }
+        //else: fall back to translating all the strings right now
+    }
+    else
+#else // !wxUSE_UNICODE
+    wxUnusedVar(flags);
+#endif // wxUSE_UNICODE/!wxUSE_UNICODE
+    {
+        if ( !file->LoadFile(filename, cat->m_pluralFormsCalculator) )
+            return NULL;
+    }
+
+    if ( !file->FillHash(cat->m_messages, domain) )
         return NULL;
 
     return cat.release();
@@ -1403,6 +1670,18 @@ const wxString *wxMsgCatalog::GetString(const wxString& str, unsigned n, const w
     {
         index = m_pluralFormsCalculator->evaluate(n);
     }
+
+#if wxUSE_UNICODE
+    if ( m_file )
+    {
+        // the strings are translated on demand, see CreateFromFile()
+        if ( context.IsEmpty() )
+            return m_file->GetString(str, index);
+
+        return m_file->GetString(wxString(context) + wxString('\x04') + wxString(str), index);
+    }
+#endif // wxUSE_UNICODE
+
     wxStringToStringHashMap::const_iterator i;
     if (index != 0)
     {
@@ -1944,7 +2223,7 @@ wxMsgCatalog *wxFileTranslationsLoader::LoadCatalog(const wxString& domain,
     wxLogVerbose(_("using catalog '%s' from '%s'."), domain, strFullName.c_str());
     wxLogTrace(TRACE_I18N, wxS("Using catalog \"%s\"."), strFullName.c_str());
 
-    return wxMsgCatalog::CreateFromFile(strFullName, domain);
+    return wxMsgCatalog::CreateFromFile(strFullName, domain, m_loadFlags);
 }
 
 
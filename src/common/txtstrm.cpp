@@ -25,6 +25,27 @@
 
 #include <ctype.h>
 
+// ----------------------------------------------------------------------------
+// helpers
+// ----------------------------------------------------------------------------
+
+// Read the next byte from the stream, returns false on EOF.
+//
+// This is equivalent to calling GetC() but is much faster as it doesn't copy
+// the data and, for unbuffered files, reads it in bigger chunks.
+static inline bool ReadByteFrom(wxInputStream& input, char& c)
+{
+    size_t size;
+    const void* const data = input.PeekData(&size);
+    if ( !data )
+        return false;
+
+    c = *static_cast<const char*>(data);
+    input.Consume(1);
+
+    return true;
+}
+
 // ----------------------------------------------------------------------------
 // wxTextInputStream
 // ----------------------------------------------------------------------------
@@ -106,9 +127,7 @@ wxChar wxTextInputStream::GetChar()
         if ( inlen >= m_validEnd )
         {
             // actually read the next character
-            m_lastBytes[inlen] = m_input.GetC();
-
-            if (m_input.LastRead() == 0)
+            if ( !ReadByteFrom(m_input, m_lastBytes[inlen]) )
                 return 0;
 
             m_validEnd++;
@@ -171,9 +190,7 @@ wxChar wxTextInputStream::GetChar()
 
     return 0;
 #else
-    m_lastBytes[0] = m_input.GetC();
-
-    if(m_input.LastRead() <= 0)
+    if ( !ReadByteFrom(m_input, m_lastBytes[0]) )
     {
         m_validEnd = 0;
         return 0;
@@ -236,6 +236,25 @@ bool wxFileStream::IsOk() const
     return wxFileOutputStream::IsOk() && wxFileInputStream::IsOk();
 }
 
+// ----------------------------------------------------------------------------
+// wxMappedFileInputStream
+// ----------------------------------------------------------------------------
+
+wxMappedFileInputStream::wxMappedFileInputStream(const wxString& fileName)
+                       : m_file(fileName)
+{
+    // the stream reads directly from the mapped memory, without copying it
+    InitFromData(m_file.GetData(), m_file.GetLength());
+
+    if ( !m_file.IsOpened() )
+        m_lasterror = wxSTREAM_READ_ERROR;
+}
+
+bool wxMappedFileInputStream::IsOk() const
+{
+    return wxMemoryInputStream::IsOk() && m_file.IsOpened();
+}
+
 #endif // wxUSE_FILE
 
 #if wxUSE_FFILE
@@ -28,6 +28,8 @@
 #include "wx/zstream.h"
 #include "wx/mstream.h"
 #include "wx/scopedptr.h"
+#include "wx/thread.h"
+#include "wx/vector.h"
 #include "wx/wfstream.h"
 #include "zlib.h"
 
@@ -73,6 +75,12 @@ enum {
     OUTPUT_LATENCY = 4096
 };
 
+// The maximal size of the central directory which is read into memory at
+// once instead of reading the entries from the archive one by one.
+enum {
+    CENTRAL_DIR_MAX_BUFFER = 64 * 1024 * 1024
+};
+
 // Some offsets into the local header
 enum {
     SUMS_OFFSET  = 14
@@ -609,6 +617,373 @@ bool wxZlibInputStream2::Open(wxInputStream& stream)
     return true;
 }
 
+#if wxUSE_THREADS
+
+/////////////////////////////////////////////////////////////////////////////
+// Parallel deflate stream
+//
+// Used instead of wxZlibOutputStream2 when wxZipOutputStream is allowed to
+// use more than one thread. The data is split into blocks which are
+// compressed by worker threads independently of each other and then written
+// out in their original order. Each block is compressed using the tail of the
+// preceding one as the preset dictionary and all of them except the last one
+// are terminated with a sync flush, so that they end on a byte boundary. This
+// way their concatenation is a single ordinary raw deflate stream, readable
+// by any unzip program, and the compression ratio is almost the same as when
+// compressing all the data at once.
+
+// The amount of data compressed by a worker thread at once.
+static const size_t DEFLATE_BLOCK_SIZE = 128 * 1024;
+
+// The amount of data from the end of a block used as the dictionary for
+// compressing the next one, this is the maximal deflate window size.
+static const size_t DEFLATE_DICT_SIZE = 32 * 1024;
+
+class wxZipDeflateJob
+{
+public:
+    wxZipDeflateJob()
+        : m_input(DEFLATE_BLOCK_SIZE), m_final(false), m_done(false), m_ok(false) { }
+
+    bool Compress(int level);
+
+    wxMemoryBuffer m_input;
+    wxMemoryBuffer m_dict;
+    wxMemoryBuffer m_output;
+    bool m_final;
+
+    // these are protected by the mutex of wxZipParallelDeflateStream
+    bool m_done;
+    bool m_ok;
+
+    wxDECLARE_NO_COPY_CLASS(wxZipDeflateJob);
+};
+
+bool wxZipDeflateJob::Compress(int level)
+{
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+
+    if (deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS,
+                     8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+
+    bool ok = true;
+
+    if (m_dict.GetDataLen())
+        ok = deflateSetDictionary(&zs, (Bytef*)m_dict.GetData(),
+                                  (uInt)m_dict.GetDataLen()) == Z_OK;
+
+    if (ok) {
+        // deflateBound() doesn't include the sync flush marker
+        const size_t size = deflateBound(&zs, (uLong)m_input.GetDataLen()) + 16;
+
+        zs.next_in = (Bytef*)m_input.GetData();
+        zs.avail_in = (uInt)m_input.GetDataLen();
+        zs.next_out = (Bytef*)m_output.GetWriteBuf(size);
+        zs.avail_out = (uInt)size;
+
+        int rc = deflate(&zs, m_final ? Z_FINISH : Z_SYNC_FLUSH);
+
+        if (m_final)
+            ok = rc == Z_STREAM_END;
+        else
+            ok = rc == Z_OK && zs.avail_in == 0 && zs.avail_out != 0;
+
+        m_output.UngetWriteBuf(size - zs.avail_out);
+    }
+
+    deflateEnd(&zs);
+    return ok;
+}
+
+class wxZipParallelDeflateStream : public wxFilterOutputStream
+{
+public:
+    wxZipParallelDeflateStream(wxOutputStream& stream, int level, int threads);
+    virtual ~wxZipParallelDeflateStream();
+
+    bool Open(wxOutputStream& stream);
+    bool Close() wxOVERRIDE;
+    void Sync() wxOVERRIDE;
+
+    int GetLevel() const { return m_level; }
+    int GetMaxThreads() const { return m_maxThreads; }
+
+    // Called by the worker threads to compress the next queued block,
+    // returns false when they should exit.
+    bool CompressNext();
+
+protected:
+    virtual size_t OnSysWrite(const void *buffer, size_t size) wxOVERRIDE;
+    virtual wxFileOffset OnSysTell() const wxOVERRIDE { return m_pos; }
+
+private:
+    void QueueCurrent();
+    void WriteCompressed(size_t maxPending);
+    void WriteJob(const wxZipDeflateJob& job);
+
+    int m_level;
+    int m_maxThreads;
+    wxFileOffset m_pos;
+
+    // the block currently being filled by OnSysWrite()
+    wxZipDeflateJob *m_current;
+
+    wxMutex m_mutex;
+    wxCondition m_jobQueued;
+    wxCondition m_jobDone;
+
+    // the queued blocks which haven't been written out yet, in order, and the
+    // index of the first one not taken by any worker thread yet
+    wxVector<wxZipDeflateJob*> m_jobs;
+    size_t m_nextJob;
+    bool m_exiting;
+
+    wxVector<wxThread*> m_threads;
+
+    wxDECLARE_NO_COPY_CLASS(wxZipParallelDeflateStream);
+};
+
+class wxZipDeflateThread : public wxThread
+{
+public:
+    explicit wxZipDeflateThread(wxZipParallelDeflateStream& stream)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_stream(stream)
+    {
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        while (m_stream.CompressNext())
+            ;
+
+        return 0;
+    }
+
+private:
+    wxZipParallelDeflateStream& m_stream;
+
+    wxDECLARE_NO_COPY_CLASS(wxZipDeflateThread);
+};
+
+wxZipParallelDeflateStream::wxZipParallelDeflateStream(wxOutputStream& stream,
+                                                       int level,
+                                                       int threads)
+  : wxFilterOutputStream(stream),
+    m_level(level),
+    m_maxThreads(threads),
+    m_pos(0),
+    m_current(new wxZipDeflateJob),
+    m_jobQueued(m_mutex),
+    m_jobDone(m_mutex),
+    m_nextJob(0),
+    m_exiting(false)
+{
+}
+
+wxZipParallelDeflateStream::~wxZipParallelDeflateStream()
+{
+    {
+        wxMutexLocker lock(m_mutex);
+        m_exiting = true;
+        m_jobQueued.Broadcast();
+    }
+
+    for (size_t n = 0; n < m_threads.size(); n++) {
+        m_threads[n]->Wait();
+        delete m_threads[n];
+    }
+
+    for (size_t n = 0; n < m_jobs.size(); n++)
+        delete m_jobs[n];
+
+    delete m_current;
+}
+
+bool wxZipParallelDeflateStream::Open(wxOutputStream& stream)
+{
+    wxCHECK(m_pos == wxInvalidOffset, false);
+
+    m_pos = 0;
+    m_lasterror = wxSTREAM_NO_ERROR;
+    m_parent_o_stream = &stream;
+
+    return true;
+}
+
+bool wxZipParallelDeflateStream::Close()
+{
+    // The last block is compressed by this thread itself as it would have to
+    // wait for the previous ones to be done anyhow. This also means that the
+    // entries smaller than a single block don't use any threads at all.
+    m_current->m_final = true;
+    bool ok = m_current->Compress(m_level);
+
+    WriteCompressed(0);
+
+    if (ok)
+        WriteJob(*m_current);
+    else
+        m_lasterror = wxSTREAM_WRITE_ERROR;
+
+    // reuse the same job object for the next entry
+    m_current->m_input.SetDataLen(0);
+    m_current->m_dict.SetDataLen(0);
+    m_current->m_output.SetDataLen(0);
+    m_current->m_final = false;
+
+    m_pos = wxInvalidOffset;
+    return IsOk();
+}
+
+void wxZipParallelDeflateStream::Sync()
+{
+    if (m_current->m_input.GetDataLen())
+        QueueCurrent();
+
+    WriteCompressed(0);
+
+    if (IsOk())
+        m_parent_o_stream->Sync();
+}
+
+size_t wxZipParallelDeflateStream::OnSysWrite(const void *buffer, size_t size)
+{
+    const char *data = static_cast<const char*>(buffer);
+    size_t left = size;
+
+    while (IsOk() && left) {
+        wxMemoryBuffer& input = m_current->m_input;
+        size_t count = wxMin(left, DEFLATE_BLOCK_SIZE - input.GetDataLen());
+
+        input.AppendData(data, count);
+        data += count;
+        left -= count;
+
+        if (input.GetDataLen() == DEFLATE_BLOCK_SIZE) {
+            QueueCurrent();
+
+            // write out what's ready and avoid accumulating too many blocks
+            // in memory if the threads can't keep up with the writer
+            WriteCompressed(2 * m_maxThreads);
+        }
+    }
+
+    if (!IsOk())
+        return 0;
+
+    m_pos += size;
+    return size;
+}
+
+void wxZipParallelDeflateStream::QueueCurrent()
+{
+    wxZipDeflateJob * const job = m_current;
+
+    m_current = new wxZipDeflateJob;
+
+    const wxMemoryBuffer& input = job->m_input;
+    const size_t dictSize = wxMin(input.GetDataLen(), DEFLATE_DICT_SIZE);
+    m_current->m_dict.AppendData(static_cast<const char*>(input.GetData()) +
+                                 input.GetDataLen() - dictSize, dictSize);
+
+    // start the threads when they're needed for the first time
+    while (m_threads.size() < (size_t)m_maxThreads) {
+        wxThread * const thread = new wxZipDeflateThread(*this);
+        if (thread->Run() != wxTHREAD_NO_ERROR) {
+            delete thread;
+            break;
+        }
+        m_threads.push_back(thread);
+    }
+
+    wxMutexLocker lock(m_mutex);
+
+    if (m_threads.empty()) {
+        // no threads could be created, so fall back to doing it ourselves
+        job->m_ok = job->Compress(m_level);
+        job->m_done = true;
+        m_nextJob++;
+    }
+
+    m_jobs.push_back(job);
+    m_jobQueued.Signal();
+}
+
+bool wxZipParallelDeflateStream::CompressNext()
+{
+    wxZipDeflateJob *job;
+
+    {
+        wxMutexLocker lock(m_mutex);
+
+        while (!m_exiting && m_nextJob == m_jobs.size())
+            m_jobQueued.Wait();
+
+        if (m_exiting)
+            return false;
+
+        job = m_jobs[m_nextJob++];
+    }
+
+    const bool ok = job->Compress(m_level);
+
+    wxMutexLocker lock(m_mutex);
+    job->m_ok = ok;
+    job->m_done = true;
+    m_jobDone.Signal();
+
+    return true;
+}
+
+void wxZipParallelDeflateStream::WriteCompressed(size_t maxPending)
+{
+    for (;;) {
+        wxZipDeflateJob *job;
+
+        {
+            wxMutexLocker lock(m_mutex);
+
+            if (m_jobs.empty())
+                return;
+
+            job = m_jobs[0];
+
+            if (!job->m_done) {
+                if (m_jobs.size() <= maxPending)
+                    return;
+
+                while (!job->m_done)
+                    m_jobDone.Wait();
+            }
+
+            if (!job->m_ok)
+                m_lasterror = wxSTREAM_WRITE_ERROR;
+
+            m_jobs.erase(m_jobs.begin());
+            m_nextJob--;
+        }
+
+        WriteJob(*job);
+        delete job;
+    }
+}
+
+void wxZipParallelDeflateStream::WriteJob(const wxZipDeflateJob& job)
+{
+    if (!IsOk())
+        return;
+
+    const size_t size = job.m_output.GetDataLen();
+    if (m_parent_o_stream->Write(job.m_output.GetData(), size).LastWrite() != size)
+        m_lasterror = wxSTREAM_WRITE_ERROR;
+}
+
+#endif // wxUSE_THREADS
+
 
 /////////////////////////////////////////////////////////////////////////////
 // Class to hold wxZipEntry's Extra and LocalExtra fields
@@ -749,6 +1124,8 @@ wxZipEntry::wxZipEntry(
     m_Flags(0),
     m_Method(wxZIP_METHOD_DEFAULT),
     m_DateTime(dt),
+    m_DosDateTime(0),
+    m_DosDateTimePending(false),
     m_Crc(0),
     m_CompressedSize(wxInvalidOffset),
     m_Size(size),
@@ -783,6 +1160,8 @@ wxZipEntry::wxZipEntry(const wxZipEntry& e)
     m_Flags(e.m_Flags),
     m_Method(e.m_Method),
     m_DateTime(e.m_DateTime),
+    m_DosDateTime(e.m_DosDateTime),
+    m_DosDateTimePending(e.m_DosDateTimePending),
     m_Crc(e.m_Crc),
     m_CompressedSize(e.m_CompressedSize),
     m_Size(e.m_Size),
@@ -810,6 +1189,8 @@ wxZipEntry& wxZipEntry::operator=(const wxZipEntry& e)
         m_Flags = e.m_Flags;
         m_Method = e.m_Method;
         m_DateTime = e.m_DateTime;
+        m_DosDateTime = e.m_DosDateTime;
+        m_DosDateTimePending = e.m_DosDateTimePending;
         m_Crc = e.m_Crc;
         m_CompressedSize = e.m_CompressedSize;
         m_Size = e.m_Size;
@@ -831,6 +1212,25 @@ wxZipEntry& wxZipEntry::operator=(const wxZipEntry& e)
     return *this;
 }
 
+// Converting the DOS date to wxDateTime is relatively expensive and is often
+// not needed at all, e.g. when just looking for an entry, so it's only done
+// when the date is asked for. The result isn't stored in the entry as this
+// would make using the same entry from several threads unsafe.
+//
+wxDateTime wxZipEntry::GetDateTime() const
+{
+    if (m_DosDateTimePending)
+        return wxDateTime().SetFromDOS(m_DosDateTime);
+
+    return m_DateTime;
+}
+
+wxUint32 wxZipEntry::GetDosDateTime() const
+{
+    return m_DosDateTimePending ? m_DosDateTime
+                                : (wxUint32)GetDateTime().GetAsDOS();
+}
+
 wxString wxZipEntry::GetName(wxPathFormat format /*=wxPATH_NATIVE*/) const
 {
     bool isDir = IsDir() && !m_Name.empty();
@@ -1089,7 +1489,7 @@ size_t wxZipEntry::ReadLocal(wxInputStream& stream, wxMBConv& conv)
         return 0;
 
     ds >> m_VersionNeeded >> m_Flags >> m_Method;
-    SetDateTime(wxDateTime().SetFromDOS(ds.Read32()));
+    SetDosDateTime(ds.Read32());
     ds >> crc >> compressedSize >> size >> nameLen >> extraLen;
 
     bool sumsValid = (m_Flags & wxZIP_SUMS_FOLLOW) == 0;
@@ -1145,7 +1545,7 @@ size_t wxZipEntry::WriteLocal(wxOutputStream& stream, wxMBConv& conv, wxZipArchi
     wxDataOutputStream ds(stream);
 
     ds << versionNeeded << GetInternalFlags(conv.IsUTF8()) << m_Method;
-    ds.Write32(GetDateTime().GetAsDOS());
+    ds.Write32(GetDosDateTime());
 
     ds.Write32(m_Crc);
     WriteLocalFileSizes(ds);
@@ -1178,7 +1578,7 @@ size_t wxZipEntry::ReadCentral(wxInputStream& stream, wxMBConv& conv)
     SetVersionNeeded(ds.Read16());
     SetFlags(ds.Read16());
     SetMethod(ds.Read16());
-    SetDateTime(wxDateTime().SetFromDOS(ds.Read32()));
+    SetDosDateTime(ds.Read32());
     SetCrc(ds.Read32());
     SetCompressedSize(ds.Read32());
     SetSize(ds.Read32());
@@ -1268,7 +1668,7 @@ size_t wxZipEntry::WriteCentral(wxOutputStream& stream, wxMBConv& conv) const
     ds.Write16(versionNeeded);
     ds.Write16(wx_truncate_cast(wxUint16, GetInternalFlags(conv.IsUTF8())));
     ds.Write16(wx_truncate_cast(wxUint16, GetMethod()));
-    ds.Write32(GetDateTime().GetAsDOS());
+    ds.Write32(GetDosDateTime());
     ds.Write32(GetCrc());
     ds.Write32(LimitUint32(GetCompressedSize()));
     ds.Write32(LimitUint32(GetSize()));
@@ -1623,6 +2023,8 @@ void wxZipInputStream::Init()
     m_streamlink = NULL;
     m_offsetAdjustment = 0;
     m_position = wxInvalidOffset;
+    m_centralDir = NULL;
+    m_centralDirOffset = 0;
     m_signature = 0;
     m_TotalEntries = 0;
     m_lasterror = m_parent_i_stream->GetLastError();
@@ -1635,6 +2037,7 @@ wxZipInputStream::~wxZipInputStream()
     delete m_store;
     delete m_inflate;
     delete m_rawin;
+    delete m_centralDir;
 
     m_weaklinks->Release(this);
 
@@ -1677,12 +2080,44 @@ wxZipStreamLink *wxZipInputStream::MakeLink(wxZipOutputStream *out)
     return link;
 }
 
+// Seeks the stream back to the position it had when this object was created
+// when it is destroyed, if asked to.
+//
+class wxZipPositionRestorer
+{
+public:
+    wxZipPositionRestorer(wxInputStream& stream, bool restore)
+      : m_stream(stream),
+        m_pos(restore ? stream.TellI() : wxInvalidOffset)
+    {
+    }
+
+    ~wxZipPositionRestorer()
+    {
+        if (m_pos != wxInvalidOffset)
+            QuietSeek(m_stream, m_pos);
+    }
+
+private:
+    wxInputStream& m_stream;
+    const wxFileOffset m_pos;
+
+    wxDECLARE_NO_COPY_CLASS(wxZipPositionRestorer);
+};
+
 bool wxZipInputStream::LoadEndRecord()
 {
     wxCHECK(m_position == wxInvalidOffset, false);
-    if (!IsOk())
+
+    // DoOpen() doesn't load the end record when opening an entry on a
+    // seekable stream, so an entry may be open here, possibly already read
+    // until its end: loading the record mustn't prevent reading it then.
+    const bool entryOpen = !AtHeader() && m_parentSeekable;
+    if (!IsOk() && !(entryOpen && m_lasterror == wxSTREAM_EOF))
         return false;
 
+    wxZipPositionRestorer restorePosition(*m_parent_i_stream, entryOpen);
+
     m_position = 0;
 
     // First find the end-of-central-directory record.
@@ -1730,6 +2165,7 @@ bool wxZipInputStream::LoadEndRecord()
         m_signature = magic;
         m_position = endrec.GetOffset();
         m_offsetAdjustment = 0;
+        LoadCentralDir(endrec.GetSize());
         return true;
     }
 
@@ -1745,6 +2181,7 @@ bool wxZipInputStream::LoadEndRecord()
         if ( endrec.GetOffset() >= 0 && endrec.GetOffset() < m_position )
         {
             m_offsetAdjustment = m_position - endrec.GetOffset();
+            LoadCentralDir(recSize);
             return true;
         }
     }
@@ -1754,6 +2191,29 @@ bool wxZipInputStream::LoadEndRecord()
     return false;
 }
 
+// Read the central directory starting at m_position into memory, together with
+// the signature of the record following it, as reading the entries from it is
+// much faster than reading them from the parent stream one by one. Does
+// nothing if it's too big or can't be read, ReadCentral() will read the
+// entries from the parent stream then.
+//
+void wxZipInputStream::LoadCentralDir(wxUint64 size)
+{
+    size += 4;
+    if (size > CENTRAL_DIR_MAX_BUFFER)
+        return;
+
+    if (QuietSeek(*m_parent_i_stream, m_position) != wxInvalidOffset) {
+        m_centralDir = new wxMemoryInputStream(*m_parent_i_stream,
+                                               (wxFileOffset)size);
+        if (m_centralDir->GetLength() != (wxFileOffset)size)
+            wxDELETE(m_centralDir);
+    }
+
+    m_centralDirOffset = m_position;
+    QuietSeek(*m_parent_i_stream, m_position + 4);
+}
+
 // Find the end-of-central-directory record.
 // If found the stream will be positioned just past the 4 signature bytes.
 //
@@ -1842,17 +2302,43 @@ wxStreamError wxZipInputStream::ReadCentral()
         return wxSTREAM_READ_ERROR;
     }
 
-    if (QuietSeek(*m_parent_i_stream, m_position + 4) == wxInvalidOffset)
-        return wxSTREAM_READ_ERROR;
+    size_t size = 0;
+
+    // Use the copy of the central directory in memory if there is one, but
+    // fall back to reading it from the archive if the entry isn't fully
+    // contained in it, which can happen if the end record is wrong.
+    if (m_centralDir) {
+        if (m_centralDir->SeekI(m_position + 4 - m_centralDirOffset)
+                != wxInvalidOffset)
+            size = m_entry.ReadCentral(*m_centralDir, GetConv());
+        if (size)
+            m_signature = ReadSignature(*m_centralDir);
+        // free the copy as soon as the last entry has been read from it, the
+        // signature is then read again from the parent stream below to leave
+        // it positioned after it, as when not using the copy at all
+        if (!size || m_signature != CENTRAL_MAGIC)
+            wxDELETE(m_centralDir);
+    }
+
+    if (!m_centralDir) {
+        // notice that the size of the entry includes its signature, so skip
+        // either just the signature or the whole entry if it was already read
+        if (QuietSeek(*m_parent_i_stream, m_position + (size ? size : 4))
+                == wxInvalidOffset)
+            return wxSTREAM_READ_ERROR;
 
-    size_t size = m_entry.ReadCentral(*m_parent_i_stream, GetConv());
-    if (!size) {
-        m_signature = 0;
-        return wxSTREAM_READ_ERROR;
+        if (!size) {
+            size = m_entry.ReadCentral(*m_parent_i_stream, GetConv());
+            if (!size) {
+                m_signature = 0;
+                return wxSTREAM_READ_ERROR;
+            }
+        }
+
+        m_signature = ReadSignature();
     }
 
     m_position += size;
-    m_signature = ReadSignature();
 
     if (m_offsetAdjustment)
         m_entry.SetOffset(m_entry.GetOffset() + m_offsetAdjustment);
@@ -1934,11 +2420,11 @@ wxStreamError wxZipInputStream::ReadLocal(bool readEndRec /*=false*/)
     return wxSTREAM_READ_ERROR;
 }
 
-wxUint32 wxZipInputStream::ReadSignature()
+wxUint32 wxZipInputStream::ReadSignature(wxInputStream& stream)
 {
     char magic[4];
-    m_parent_i_stream->Read(magic, 4);
-    return m_parent_i_stream->LastRead() == 4 ? CrackUint32(magic) : 0;
+    stream.Read(magic, 4);
+    return stream.LastRead() == 4 ? CrackUint32(magic) : 0;
 }
 
 bool wxZipInputStream::OpenEntry(wxArchiveEntry& entry)
@@ -1951,9 +2437,15 @@ bool wxZipInputStream::OpenEntry(wxArchiveEntry& entry)
 //
 bool wxZipInputStream::DoOpen(wxZipEntry *entry, bool raw)
 {
-    if (m_position == wxInvalidOffset)
-        if (!LoadEndRecord())
+    // Opening an entry already read from the central directory, possibly by
+    // another wxZipInputStream for the same archive, only requires seeking to
+    // its offset, so don't search for the end record unnecessarily then.
+    if (m_position == wxInvalidOffset) {
+        if (entry && m_parent_i_stream->IsSeekable())
+            m_parentSeekable = true;
+        else if (!LoadEndRecord())
             return false;
+    }
     if (m_lasterror == wxSTREAM_READ_ERROR)
         return false;
     if (IsOpened())
@@ -2184,6 +2676,7 @@ void wxZipOutputStream::Init(int level)
 {
     m_store = new wxStoredOutputStream(*m_parent_o_stream);
     m_deflate = NULL;
+    m_parallelDeflate = NULL;
     m_backlink = NULL;
     m_initialData = new char[OUTPUT_LATENCY];
     m_initialSize = 0;
@@ -2197,6 +2690,7 @@ void wxZipOutputStream::Init(int level)
     m_offsetAdjustment = wxInvalidOffset;
     m_endrecWritten = false;
     m_format = wxZIP_FORMAT_DEFAULT;
+    m_maxThreads = 1;
 }
 
 wxZipOutputStream::~wxZipOutputStream()
@@ -2205,6 +2699,9 @@ wxZipOutputStream::~wxZipOutputStream()
     WX_CLEAR_LIST(wxZipEntryList_, m_entries);
     delete m_store;
     delete m_deflate;
+#if wxUSE_THREADS
+    delete m_parallelDeflate;
+#endif // wxUSE_THREADS
     delete m_pending;
     delete [] m_initialData;
     if (m_backlink)
@@ -2284,6 +2781,13 @@ void wxZipOutputStream::SetLevel(int level)
     }
 }
 
+void wxZipOutputStream::SetMaxThreads(int count)
+{
+    wxCHECK_RET(count >= 0, wxT("invalid number of threads"));
+
+    m_maxThreads = count;
+}
+
 bool wxZipOutputStream::DoCreate(wxZipEntry *entry, bool raw /*=false*/)
 {
     CloseEntry();
@@ -2371,6 +2875,29 @@ wxOutputStream *wxZipOutputStream::OpenCompressor(
             entry.SetFlags((entry.GetFlags() & ~wxZIP_DEFLATE_MASK) |
                             defbits | wxZIP_SUMS_FOLLOW);
 
+#if wxUSE_THREADS
+            int threads = m_maxThreads;
+            if (threads == 0)
+                threads = wxThread::GetCPUCount();
+
+            if (threads > 1) {
+                // SetLevel() and SetMaxThreads() can be called while the
+                // stream is used for an entry, so they don't delete it and it
+                // is only recreated with the new parameters here
+                if (m_parallelDeflate
+                        && (m_parallelDeflate->GetLevel() != GetLevel()
+                            || m_parallelDeflate->GetMaxThreads() != threads))
+                    wxDELETE(m_parallelDeflate);
+
+                if (!m_parallelDeflate)
+                    m_parallelDeflate = new wxZipParallelDeflateStream(stream, GetLevel(), threads);
+                else
+                    m_parallelDeflate->Open(stream);
+
+                return m_parallelDeflate;
+            }
+#endif // wxUSE_THREADS
+
             if (!m_deflate)
                 m_deflate = new wxZlibOutputStream2(stream, GetLevel());
             else
@@ -2390,6 +2917,10 @@ bool wxZipOutputStream::CloseCompressor(wxOutputStream *comp)
 {
     if (comp == m_deflate)
         m_deflate->Close();
+#if wxUSE_THREADS
+    else if (comp == m_parallelDeflate)
+        m_parallelDeflate->Close();
+#endif // wxUSE_THREADS
     else if (comp != m_store)
         delete comp;
     return true;
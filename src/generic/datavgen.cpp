@@ -48,6 +48,7 @@
 #include "wx/listimpl.cpp"
 #include "wx/imaglist.h"
 #include "wx/headerctrl.h"
+#include "wx/hashmap.h"
 #include "wx/dnd.h"
 #include "wx/selstore.h"
 #include "wx/stopwatch.h"
@@ -451,6 +452,11 @@ class wxDataViewTreeNode;
 
 typedef wxVector<wxDataViewTreeNode*> wxDataViewTreeNodes;
 
+// Map from wxDataViewItem IDs to the nodes corresponding to them, used to
+// avoid walking the tree to find the node for the given item.
+WX_DECLARE_HASH_MAP(void*, wxDataViewTreeNode*, wxPointerHash, wxPointerEqual,
+                    wxDataViewItemToNodeMap);
+
 // Note: this class is not used at all for virtual list models, so all code
 // using it, i.e. any functions taking or returning objects of this type,
 // including wxDataViewMainWindow::m_root, can only be called after checking
@@ -462,6 +468,7 @@ public:
     wxDataViewTreeNode(wxDataViewTreeNode *parent, const wxDataViewItem& item)
         : m_parent(parent),
           m_item(item),
+          m_rowInParent(0),
           m_branchData(NULL)
     {
     }
@@ -537,6 +544,17 @@ public:
         return ret;
     }
 
+    // Returns the row of this node relative to the row of its parent, i.e. 1
+    // for its first child. Notice that this works for the children of closed
+    // nodes too, i.e. it is computed as if all the parents were open.
+    int GetRowInParent() const
+    {
+        wxCHECK_MSG( m_parent, 0, "root node doesn't have any row" );
+
+        m_parent->UpdateChildRows();
+        return m_rowInParent;
+    }
+
     bool IsOpen() const
     {
         return m_branchData && m_branchData->open;
@@ -612,7 +630,11 @@ public:
         wxASSERT( m_branchData->subTreeCount >= 0 );
 
         if( m_parent )
+        {
+            // The rows of our siblings following us have changed too.
+            m_parent->m_branchData->childRowsValid = false;
             m_parent->ChangeSubTreeCount(num);
+        }
     }
 
     void Resort(wxDataViewMainWindow* window);
@@ -634,29 +656,55 @@ private:
     void PutChildInSortOrder(wxDataViewMainWindow* window,
                              wxDataViewTreeNode* childNode);
 
+    // Recompute m_rowInParent of all children if they are out of date.
+    void UpdateChildRows()
+    {
+        if ( m_branchData->childRowsValid )
+            return;
+
+        int row = 1;
+
+        const wxDataViewTreeNodes& nodes = m_branchData->children;
+        const int len = nodes.size();
+        for ( int i = 0; i < len; i++ )
+        {
+            nodes[i]->m_rowInParent = row;
+            row += 1 + nodes[i]->GetSubTreeCount();
+        }
+
+        m_branchData->childRowsValid = true;
+    }
+
     wxDataViewTreeNode  *m_parent;
 
     // Corresponding model item.
     wxDataViewItem       m_item;
 
+    // Row relative to the parent one, only valid if the parent childRowsValid
+    // flag is set, see GetRowInParent().
+    int                  m_rowInParent;
+
     // Data specific to non-leaf (branch, inner) nodes. They are kept in a
     // separate struct in order to conserve memory.
     struct BranchNodeData
     {
         BranchNodeData()
             : open(false),
-              subTreeCount(0)
+              subTreeCount(0),
+              childRowsValid(false)
         {
         }
 
         void InsertChild(wxDataViewTreeNode* node, unsigned index)
         {
             children.insert(children.begin() + index, node);
+            childRowsValid = false;
         }
 
         void RemoveChild(unsigned index)
         {
             children.erase(children.begin() + index);
+            childRowsValid = false;
         }
 
         // Child nodes. Note that this may be empty even if m_hasChildren in
@@ -674,6 +722,10 @@ private:
         // 0 for leaves and is the number of rows the subtree occupies for
         // branch nodes.
         int                  subTreeCount;
+
+        // Is m_rowInParent of all children up to date? This is reset whenever
+        // the children or the number of rows in their subtrees change.
+        bool                 childRowsValid;
     };
 
     BranchNodeData *m_branchData;
@@ -841,6 +893,13 @@ public:
     // Methods for building the mapping tree
     void BuildTree( wxDataViewModel  * model );
     void DestroyTree();
+
+    // Must be called for every node added to the tree and for every node
+    // about to be deleted (together with all its children) respectively.
+    void RegisterNode(wxDataViewTreeNode *node)
+        { m_itemToNode[node->GetItem().GetID()] = node; }
+    void UnregisterNodes(wxDataViewTreeNode *node);
+
     void HitTest( const wxPoint & point, wxDataViewItem & item, wxDataViewColumn* &column );
     wxRect GetItemRect( const wxDataViewItem & item, const wxDataViewColumn* column );
 
@@ -941,6 +1000,9 @@ private:
     wxDataViewTreeNode * m_root;
     int m_count;
 
+    // All nodes of the tree except the root one, indexed by their items.
+    wxDataViewItemToNodeMap m_itemToNode;
+
     // This is the tree node under the cursor
     wxDataViewTreeNode * m_underMouse;
 
@@ -1802,6 +1864,7 @@ void wxDataViewTreeNode::Resort(wxDataViewMainWindow* window)
                       wxGenericTreeModelNodeCmp(window, sortOrder));
 
             m_branchData->sortOrder = sortOrder;
+            m_branchData->childRowsValid = false;
         }
 
         // There may be open child nodes that also need a resort.
@@ -2792,6 +2855,7 @@ bool wxDataViewMainWindow::ItemAdded(const wxDataViewItem & parent, const wxData
 
         wxDataViewTreeNode *itemNode = new wxDataViewTreeNode(parentNode, item);
         itemNode->SetHasChildren(GetModel()->IsContainer(item));
+        RegisterNode(itemNode);
 
         if ( GetSortOrder().IsNone() )
         {
@@ -2925,6 +2989,7 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
         const int itemsDeleted = 1 + itemNode->GetSubTreeCount();
 
         parentNode->RemoveChild(itemPosInNode);
+        UnregisterNodes(itemNode);
         delete itemNode;
         parentNode->ChangeSubTreeCount(-itemsDeleted);
 
@@ -3747,18 +3812,30 @@ wxDataViewTreeNode * wxDataViewMainWindow::FindNode( const wxDataViewItem & item
     if (!item.IsOk())
         return m_root;
 
-    // Compose the parent-chain for the item we are looking for
+    // Compose the parent-chain for the item we are looking for, stopping at
+    // the first (grand)parent which is already present in the tree: usually
+    // this is the item itself and we don't need to do anything else.
     wxVector<wxDataViewItem> parentChain;
+    wxDataViewTreeNode* node = m_root;
     wxDataViewItem it( item );
     while( it.IsOk() )
     {
+        wxDataViewItemToNodeMap::const_iterator i = m_itemToNode.find(it.GetID());
+        if ( i != m_itemToNode.end() )
+        {
+            node = i->second;
+            break;
+        }
+
         parentChain.push_back(it);
         it = model->GetParent(it);
     }
 
-    // Find the item along the parent-chain.
-    // This algorithm is designed to speed up the node-finding method
-    wxDataViewTreeNode* node = m_root;
+    if ( parentChain.empty() )
+        return node;
+
+    // Find the item along the rest of the parent-chain, realizing the
+    // subtrees containing it if necessary.
     for( unsigned iter = parentChain.size()-1; ; --iter )
     {
         if( node->HasChildren() )
@@ -3914,55 +3991,6 @@ int wxDataViewMainWindow::RecalculateCount() const
     }
 }
 
-class ItemToRowJob : public DoJob
-{
-public:
-    // As with RowToTreeNodeJob above, we initialize m_current to -1 because
-    // the first node passed to our operator() is the root node which is not
-    // visible on screen and so we should return 0 for its first child node and
-    // not for the root itself.
-    ItemToRowJob(const wxDataViewItem& item, wxVector<wxDataViewItem>::reverse_iterator iter)
-        : m_item(item), m_iter(iter), m_current(-1)
-    {
-    }
-
-    // Maybe binary search will help to speed up this process
-    virtual int operator() ( wxDataViewTreeNode * node) wxOVERRIDE
-    {
-        if( node->GetItem() == m_item )
-        {
-            return DoJob::DONE;
-        }
-
-        // Is this node the next (grand)parent of the item we're looking for?
-        if( node->GetItem() == *m_iter )
-        {
-            // Search for the next (grand)parent now and skip this item itself.
-            ++m_iter;
-            ++m_current;
-            return DoJob::CONTINUE;
-        }
-        else
-        {
-            // Skip this node and all its currently visible children.
-            m_current += node->GetSubTreeCount() + 1;
-            return DoJob::SKIP_SUBTREE;
-        }
-
-    }
-
-    int GetResult() const
-        { return m_current; }
-
-private:
-    const wxDataViewItem m_item;
-    wxVector<wxDataViewItem>::reverse_iterator m_iter;
-
-    // The row corresponding to the last node seen in our operator().
-    int m_current;
-
-};
-
 int wxDataViewMainWindow::GetRowByItem(const wxDataViewItem & item) const
 {
     const wxDataViewModel * model = GetModel();
@@ -3978,25 +4006,23 @@ int wxDataViewMainWindow::GetRowByItem(const wxDataViewItem & item) const
         if( !item.IsOk() )
             return -1;
 
-        // Compose the parent-chain of the item we are looking for
-        wxVector<wxDataViewItem> parentChain;
-        wxDataViewItem it( item );
-        while( it.IsOk() )
+        wxDataViewItemToNodeMap::const_iterator i = m_itemToNode.find(item.GetID());
+        if ( i == m_itemToNode.end() )
+            return -1;
+
+        // The row of the item is just the sum of the offsets of the item and
+        // all its (grand)parents from their parents rows, starting from -1 for
+        // the root node which is not shown on screen. Notice that the offsets
+        // are cached, so this is usually proportional to the item depth only.
+        int row = -1;
+        for ( const wxDataViewTreeNode* node = i->second;
+              node->GetParent();
+              node = node->GetParent() )
         {
-            parentChain.push_back(it);
-            it = model->GetParent(it);
+            row += node->GetRowInParent();
         }
 
-        // add an 'invalid' item to represent our 'invisible' root node
-        parentChain.push_back(wxDataViewItem());
-
-        // the parent chain was created by adding the deepest parent first.
-        // so if we want to start at the root node, we have to iterate backwards through the vector
-        ItemToRowJob job( item, parentChain.rbegin() );
-        if ( !Walker( m_root, job ) )
-            return -1;
-
-        return job.GetResult();
+        return row;
     }
 }
 
@@ -4016,6 +4042,8 @@ static void BuildTreeHelper( wxDataViewMainWindow *window, const wxDataViewModel
         if( model->IsContainer(children[index]) )
             n->SetHasChildren( true );
 
+        window->RegisterNode(n);
+
         node->InsertChild(window, n, index);
     }
 
@@ -4046,10 +4074,27 @@ void wxDataViewMainWindow::DestroyTree()
     if (!IsVirtualList())
     {
         wxDELETE(m_root);
+        m_itemToNode.clear();
         m_count = 0;
     }
 }
 
+void wxDataViewMainWindow::UnregisterNodes(wxDataViewTreeNode *node)
+{
+    m_itemToNode.erase(node->GetItem().GetID());
+
+    if ( node->HasChildren() )
+    {
+        const wxDataViewTreeNodes& nodes = node->GetChildNodes();
+        for ( wxDataViewTreeNodes::const_iterator i = nodes.begin();
+              i != nodes.end();
+              ++i )
+        {
+            UnregisterNodes(*i);
+        }
+    }
+}
+
 wxDataViewColumn*
 wxDataViewMainWindow::FindColumnForEditing(const wxDataViewItem& item, wxDataViewCellMode mode) const
 {
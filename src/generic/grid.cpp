@@ -116,7 +116,6 @@ const int DRAG_SENSITIVITY = 3;
 #include "wx/arrimpl.cpp"
 
 WX_DEFINE_OBJARRAY(wxGridCellCoordsArray)
-WX_DEFINE_OBJARRAY(wxGridCellWithAttrArray)
 
 // ----------------------------------------------------------------------------
 // events
@@ -599,18 +598,98 @@ wxGridCellEditor* wxGridCellAttr::GetEditor(const wxGrid* grid, int row, int col
 // wxGridCellAttrData
 // ----------------------------------------------------------------------------
 
+wxGridCellAttrData::~wxGridCellAttrData()
+{
+    RemoveRows(0, m_rows.size());
+}
+
+size_t wxGridCellAttrData::FindRow(int row) const
+{
+    size_t lo = 0,
+           hi = m_rows.size();
+    while ( lo < hi )
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if ( m_rows[mid]->row < row )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/* static */
+size_t wxGridCellAttrData::FindCol(const CellAttrs& cells, int col)
+{
+    size_t lo = 0,
+           hi = cells.size();
+    while ( lo < hi )
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if ( cells[mid].col < col )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/* static */
+void wxGridCellAttrData::RemoveCells(CellAttrs& cells, size_t from, size_t to)
+{
+    if ( from == to )
+        return;
+
+    for ( size_t n = from; n < to; n++ )
+        cells[n].attr->DecRef();
+
+    cells.erase(cells.begin() + from, cells.begin() + to);
+}
+
+void wxGridCellAttrData::RemoveRows(size_t from, size_t to)
+{
+    if ( from == to )
+        return;
+
+    for ( size_t n = from; n < to; n++ )
+    {
+        RemoveCells(m_rows[n]->cells, 0, m_rows[n]->cells.size());
+        delete m_rows[n];
+    }
+
+    m_rows.erase(m_rows.begin() + from, m_rows.begin() + to);
+}
+
 void wxGridCellAttrData::SetAttr(wxGridCellAttr *attr, int row, int col)
 {
-    // Note: contrary to wxGridRowOrColAttrData::SetAttr, we must not
-    //       touch attribute's reference counting explicitly, since this
-    //       is managed by class wxGridCellWithAttr
-    int n = FindIndex(row, col);
-    if ( n == wxNOT_FOUND )
+    // Note: contrary to wxGridRowOrColAttrData::SetAttr, we must not DecRef()
+    //       the attribute if it's the same as the one we already have, as
+    //       the ownership of its reference is just transferred to us
+    const size_t n = FindRow(row);
+    if ( n == m_rows.size() || m_rows[n]->row != row )
+    {
+        if ( attr )
+        {
+            // add the attribute for the first cell in this row
+            RowAttrs * const rowAttrs = new RowAttrs(row);
+            rowAttrs->cells.push_back(CellAttr(col, attr));
+            m_rows.insert(m_rows.begin() + n, rowAttrs);
+        }
+        //else: nothing to do
+
+        return;
+    }
+
+    CellAttrs& cells = m_rows[n]->cells;
+    const size_t i = FindCol(cells, col);
+    if ( i == cells.size() || cells[i].col != col )
     {
         if ( attr )
         {
             // add the attribute
-            m_attrs.Add(new wxGridCellWithAttr(row, col, attr));
+            cells.insert(cells.begin() + i, CellAttr(col, attr));
         }
         //else: nothing to do
     }
@@ -619,111 +698,86 @@ void wxGridCellAttrData::SetAttr(wxGridCellAttr *attr, int row, int col)
         if ( attr )
         {
             // change the attribute
-            m_attrs[(size_t)n].ChangeAttr(attr);
+            if ( cells[i].attr != attr )
+            {
+                cells[i].attr->DecRef();
+                cells[i].attr = attr;
+            }
         }
         else
         {
-            // remove this attribute
-            m_attrs.RemoveAt((size_t)n);
+            // remove this attribute and the entire row if it was the last one
+            RemoveCells(cells, i, i + 1);
+            if ( cells.empty() )
+                RemoveRows(n, n + 1);
         }
     }
 }
 
 wxGridCellAttr *wxGridCellAttrData::GetAttr(int row, int col) const
 {
-    wxGridCellAttr *attr = NULL;
+    const size_t n = FindRow(row);
+    if ( n == m_rows.size() || m_rows[n]->row != row )
+        return NULL;
 
-    int n = FindIndex(row, col);
-    if ( n != wxNOT_FOUND )
-    {
-        attr = m_attrs[(size_t)n].attr;
-        attr->IncRef();
-    }
+    const CellAttrs& cells = m_rows[n]->cells;
+    const size_t i = FindCol(cells, col);
+    if ( i == cells.size() || cells[i].col != col )
+        return NULL;
+
+    wxGridCellAttr * const attr = cells[i].attr;
+    attr->IncRef();
 
     return attr;
 }
 
 void wxGridCellAttrData::UpdateAttrRows( size_t pos, int numRows )
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+    size_t n = FindRow(pos);
+
+    // If rows deleted, remove the attributes of the cells in them
+    if ( numRows < 0 )
     {
-        wxGridCellCoords& coords = m_attrs[n].coords;
-        wxCoord row = coords.GetRow();
-        if ((size_t)row >= pos)
-        {
-            if (numRows > 0)
-            {
-                // If rows inserted, increment row counter where necessary
-                coords.SetRow(row + numRows);
-            }
-            else if (numRows < 0)
-            {
-                // If rows deleted ...
-                if ((size_t)row >= pos - numRows)
-                {
-                    // ...either decrement row counter (if row still exists)...
-                    coords.SetRow(row + numRows);
-                }
-                else
-                {
-                    // ...or remove the attribute
-                    m_attrs.RemoveAt(n);
-                    n--;
-                    count--;
-                }
-            }
-        }
+        const size_t end = FindRow(pos - numRows);
+        RemoveRows(n, end);
+    }
+
+    // and update the indices of all the following rows
+    const size_t count = m_rows.size();
+    for ( ; n < count; n++ )
+    {
+        m_rows[n]->row += numRows;
     }
 }
 
 void wxGridCellAttrData::UpdateAttrCols( size_t pos, int numCols )
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+    for ( size_t n = 0; n < m_rows.size(); )
     {
-        wxGridCellCoords& coords = m_attrs[n].coords;
-        wxCoord col = coords.GetCol();
-        if ( (size_t)col >= pos )
+        CellAttrs& cells = m_rows[n]->cells;
+        size_t i = FindCol(cells, pos);
+
+        // If cols deleted, remove the attributes of the cells in them
+        if ( numCols < 0 )
         {
-            if ( numCols > 0 )
-            {
-                // If cols inserted, increment col counter where necessary
-                coords.SetCol(col + numCols);
-            }
-            else if (numCols < 0)
+            RemoveCells(cells, i, FindCol(cells, pos - numCols));
+
+            if ( cells.empty() )
             {
-                // If cols deleted ...
-                if ((size_t)col >= pos - numCols)
-                {
-                    // ...either decrement col counter (if col still exists)...
-                    coords.SetCol(col + numCols);
-                }
-                else
-                {
-                    // ...or remove the attribute
-                    m_attrs.RemoveAt(n);
-                    n--;
-                    count--;
-                }
+                RemoveRows(n, n + 1);
+                continue;
             }
         }
-    }
-}
 
-int wxGridCellAttrData::FindIndex(int row, int col) const
-{
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
-    {
-        const wxGridCellCoords& coords = m_attrs[n].coords;
-        if ( (coords.GetRow() == row) && (coords.GetCol() == col) )
+        // and update the indices of all the following columns
+        const size_t count = cells.size();
+        for ( ; i < count; i++ )
         {
-            return n;
+            cells[i].col += numCols;
         }
-    }
 
-    return wxNOT_FOUND;
+        n++;
+    }
 }
 
 // ----------------------------------------------------------------------------
@@ -739,14 +793,30 @@ wxGridRowOrColAttrData::~wxGridRowOrColAttrData()
     }
 }
 
+size_t wxGridRowOrColAttrData::FindIndex(int rowOrCol) const
+{
+    size_t lo = 0,
+           hi = m_rowsOrCols.size();
+    while ( lo < hi )
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if ( m_rowsOrCols[mid] < rowOrCol )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
 wxGridCellAttr *wxGridRowOrColAttrData::GetAttr(int rowOrCol) const
 {
     wxGridCellAttr *attr = NULL;
 
-    int n = m_rowsOrCols.Index(rowOrCol);
-    if ( n != wxNOT_FOUND )
+    const size_t n = FindIndex(rowOrCol);
+    if ( n < m_rowsOrCols.size() && m_rowsOrCols[n] == rowOrCol )
     {
-        attr = m_attrs[(size_t)n];
+        attr = m_attrs[n];
         attr->IncRef();
     }
 
@@ -755,21 +825,19 @@ wxGridCellAttr *wxGridRowOrColAttrData::GetAttr(int rowOrCol) const
 
 void wxGridRowOrColAttrData::SetAttr(wxGridCellAttr *attr, int rowOrCol)
 {
-    int i = m_rowsOrCols.Index(rowOrCol);
-    if ( i == wxNOT_FOUND )
+    const size_t n = FindIndex(rowOrCol);
+    if ( n == m_rowsOrCols.size() || m_rowsOrCols[n] != rowOrCol )
     {
         if ( attr )
         {
             // store the new attribute, taking its ownership
-            m_rowsOrCols.Add(rowOrCol);
-            m_attrs.Add(attr);
+            m_rowsOrCols.Insert(rowOrCol, n);
+            m_attrs.Insert(attr, n);
         }
         // nothing to remove
     }
     else // we have an attribute for this row or column
     {
-        size_t n = (size_t)i;
-
         // notice that this code works correctly even when the old attribute is
         // the same as the new one: as we own of it, we must call DecRef() on
         // it in any case and this won't result in destruction of the new
@@ -792,33 +860,207 @@ void wxGridRowOrColAttrData::SetAttr(wxGridCellAttr *attr, int rowOrCol)
 
 void wxGridRowOrColAttrData::UpdateAttrRowsOrCols( size_t pos, int numRowsOrCols )
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+    size_t n = FindIndex(pos);
+
+    // If rows/cols deleted, remove the attributes of the deleted ones
+    if ( numRowsOrCols < 0 )
     {
-        int & rowOrCol = m_rowsOrCols[n];
-        if ( (size_t)rowOrCol >= pos )
+        const size_t end = FindIndex(pos - numRowsOrCols);
+        if ( end > n )
         {
-            if ( numRowsOrCols > 0 )
-            {
-                // If rows or cols inserted, increment row/col counter where necessary
-                rowOrCol += numRowsOrCols;
-            }
-            else if ( numRowsOrCols < 0)
+            for ( size_t i = n; i < end; i++ )
             {
-                // If rows/cols deleted, either decrement row/col counter (if row/col still exists)
-                if ((size_t)rowOrCol >= pos - numRowsOrCols)
-                    rowOrCol += numRowsOrCols;
-                else
-                {
-                    m_rowsOrCols.RemoveAt(n);
-                    m_attrs[n]->DecRef();
-                    m_attrs.RemoveAt(n);
-                    n--;
-                    count--;
-                }
+                m_attrs[i]->DecRef();
             }
+
+            m_rowsOrCols.RemoveAt(n, end - n);
+            m_attrs.RemoveAt(n, end - n);
+        }
+    }
+
+    // and update the indices of the following ones
+    const size_t count = m_rowsOrCols.size();
+    for ( ; n < count; n++ )
+    {
+        m_rowsOrCols[n] += numRowsOrCols;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// wxGridLineOffsets
+// ----------------------------------------------------------------------------
+
+void wxGridLineOffsets::Init(const wxArrayInt& sizes, const wxArrayInt* order)
+{
+    const size_t count = sizes.size();
+
+    if ( order && order->empty() )
+        order = NULL;
+
+    wxCHECK_RET( !order || order->size() == count,
+                 "order must have the same size as sizes" );
+
+    m_tree.clear();
+    m_tree.reserve(count);
+    for ( size_t pos = 0; pos < count; pos++ )
+    {
+        const int size = sizes[order ? (*order)[pos] : pos];
+        m_tree.push_back(size > 0 ? size : 0);
+    }
+
+    // build the tree in linear time by adding each partial sum, once it is
+    // complete, to the next element covering it
+    for ( size_t i = 0; i < count; i++ )
+    {
+        const size_t parent = i | (i + 1);
+        if ( parent < count )
+            m_tree[parent] += m_tree[i];
+    }
+}
+
+void wxGridLineOffsets::Append(int count, int size)
+{
+    if ( size < 0 )
+        size = 0;
+
+    m_tree.reserve(m_tree.size() + count);
+    for ( ; count > 0; count-- )
+    {
+        // the new element must also contain the sum of all the preceding ones
+        // it covers, which are conveniently given by the elements preceding it
+        const int i = GetCount();
+        const int first = i & (i + 1);
+
+        int sum = size;
+        for ( int j = i - 1; j >= first; j = (j & (j + 1)) - 1 )
+            sum += m_tree[j];
+
+        m_tree.push_back(sum);
+    }
+}
+
+void wxGridLineOffsets::Add(int pos, int diff)
+{
+    wxCHECK_RET( pos >= 0 && pos < GetCount(), "invalid line position" );
+
+    const size_t count = m_tree.size();
+    for ( size_t i = pos; i < count; i |= i + 1 )
+        m_tree[i] += diff;
+}
+
+int wxGridLineOffsets::GetEnd(int pos) const
+{
+    wxCHECK_MSG( pos >= 0 && pos < GetCount(), 0, "invalid line position" );
+
+    int end = 0;
+    for ( int i = pos; i >= 0; i = (i & (i + 1)) - 1 )
+        end += m_tree[i];
+
+    return end;
+}
+
+int wxGridLineOffsets::FindPos(int coord) const
+{
+    // descend the tree, skipping all the lines ending at or before coord
+    const size_t count = m_tree.size();
+
+    size_t step = 1;
+    while ( step * 2 <= count )
+        step *= 2;
+
+    size_t pos = 0;
+    for ( ; step; step /= 2 )
+    {
+        const size_t next = pos + step;
+        if ( next <= count && m_tree[next - 1] <= coord )
+        {
+            pos = next;
+            coord -= m_tree[next - 1];
         }
     }
+
+    return static_cast<int>(pos);
+}
+
+// ----------------------------------------------------------------------------
+// wxGridTextExtentCache
+// ----------------------------------------------------------------------------
+
+wxGridTextExtentCache *wxGridTextExtentCache::ms_current = NULL;
+
+wxGridTextExtentCache::wxGridTextExtentCache()
+{
+    m_count = 0;
+
+    if ( !ms_current )
+        ms_current = this;
+}
+
+wxGridTextExtentCache::~wxGridTextExtentCache()
+{
+    if ( ms_current == this )
+        ms_current = NULL;
+
+    for ( size_t n = 0; n < m_fonts.size(); n++ )
+        delete m_fonts[n];
+}
+
+wxGridTextExtentCache::FontExtents *
+wxGridTextExtentCache::FindFont(const wxFont& font) const
+{
+    // there are typically very few different fonts, so a linear search is
+    // good enough here
+    for ( size_t n = 0; n < m_fonts.size(); n++ )
+    {
+        if ( m_fonts[n]->font.GetRefData() == font.GetRefData() )
+            return m_fonts[n];
+    }
+
+    return NULL;
+}
+
+bool
+wxGridTextExtentCache::Find(const wxFont& font,
+                            const wxString& text,
+                            wxSize *size) const
+{
+    const FontExtents * const fe = FindFont(font);
+    if ( !fe )
+        return false;
+
+    const Extents::const_iterator it = fe->extents.find(text);
+    if ( it == fe->extents.end() )
+        return false;
+
+    *size = it->second;
+
+    return true;
+}
+
+void
+wxGridTextExtentCache::Store(const wxFont& font,
+                             const wxString& text,
+                             const wxSize& size)
+{
+    if ( m_count == MAX_ENTRIES )
+    {
+        // start afresh rather than letting the cache grow indefinitely, the
+        // strings which occur often will be quickly remembered again
+        for ( size_t n = 0; n < m_fonts.size(); n++ )
+            m_fonts[n]->extents.clear();
+
+        m_count = 0;
+    }
+
+    FontExtents *fe = FindFont(font);
+    if ( !fe )
+    {
+        fe = new FontExtents(font);
+        m_fonts.push_back(fe);
+    }
+
+    fe->extents[text] = size;
+    m_count++;
 }
 
 // ----------------------------------------------------------------------------
@@ -2198,6 +2440,9 @@ wxGrid::~wxGrid()
 
     delete m_setFixedRows;
     delete m_setFixedCols;
+
+    delete m_rowOffsets;
+    delete m_colOffsets;
 }
 
 //
@@ -2366,9 +2611,9 @@ wxGrid::SetTable(wxGridTableBase *table,
 
         // kill row and column size arrays
         m_colWidths.Empty();
-        m_colRights.Empty();
+        m_colOffsets->Clear();
         m_rowHeights.Empty();
-        m_rowBottoms.Empty();
+        m_rowOffsets->Clear();
     }
 
     if (table)
@@ -2440,6 +2685,11 @@ void wxGrid::Init()
     m_setFixedRows =
     m_setFixedCols = NULL;
 
+    m_autoSizeSampleCount = 0;
+
+    m_rowOffsets = new wxGridLineOffsets;
+    m_colOffsets = new wxGridLineOffsets;
+
     // init attr cache
     m_attrCache.row = -1;
     m_attrCache.col = -1;
@@ -2537,36 +2787,26 @@ void wxGrid::Init()
 void wxGrid::InitRowHeights()
 {
     m_rowHeights.Empty();
-    m_rowBottoms.Empty();
 
     m_rowHeights.Alloc( m_numRows );
-    m_rowBottoms.Alloc( m_numRows );
-
     m_rowHeights.Add( m_defaultRowHeight, m_numRows );
 
-    int rowBottom = 0;
-    for ( int i = 0; i < m_numRows; i++ )
-    {
-        rowBottom += m_defaultRowHeight;
-        m_rowBottoms.Add( rowBottom );
-    }
+    m_rowOffsets->Init( m_rowHeights );
 }
 
 void wxGrid::InitColWidths()
 {
     m_colWidths.Empty();
-    m_colRights.Empty();
 
     m_colWidths.Alloc( m_numCols );
-    m_colRights.Alloc( m_numCols );
-
     m_colWidths.Add( m_defaultColWidth, m_numCols );
 
-    for ( int i = 0; i < m_numCols; i++ )
-    {
-        int colRight = ( GetColPos( i ) + 1 ) * m_defaultColWidth;
-        m_colRights.Add( colRight );
-    }
+    UpdateColRights();
+}
+
+void wxGrid::UpdateColRights()
+{
+    m_colOffsets->Init( m_colWidths, &m_colAt );
 }
 
 int wxGrid::GetColWidth(int col) const
@@ -2580,16 +2820,16 @@ int wxGrid::GetColWidth(int col) const
 
 int wxGrid::GetColLeft(int col) const
 {
-    if ( m_colRights.IsEmpty() )
+    if ( m_colOffsets->IsEmpty() )
         return GetColPos( col ) * m_defaultColWidth;
 
-    return m_colRights[col] - GetColWidth(col);
+    return m_colOffsets->GetEnd(GetColPos(col)) - GetColWidth(col);
 }
 
 int wxGrid::GetColRight(int col) const
 {
-    return m_colRights.IsEmpty() ? (GetColPos( col ) + 1) * m_defaultColWidth
-                                 : m_colRights[col];
+    return m_colOffsets->IsEmpty() ? (GetColPos( col ) + 1) * m_defaultColWidth
+                                   : m_colOffsets->GetEnd(GetColPos(col));
 }
 
 int wxGrid::GetRowHeight(int row) const
@@ -2604,16 +2844,16 @@ int wxGrid::GetRowHeight(int row) const
 
 int wxGrid::GetRowTop(int row) const
 {
-    if ( m_rowBottoms.IsEmpty() )
+    if ( m_rowOffsets->IsEmpty() )
         return row * m_defaultRowHeight;
 
-    return m_rowBottoms[row] - GetRowHeight(row);
+    return m_rowOffsets->GetEnd(row) - GetRowHeight(row);
 }
 
 int wxGrid::GetRowBottom(int row) const
 {
-    return m_rowBottoms.IsEmpty() ? (row + 1) * m_defaultRowHeight
-                                  : m_rowBottoms[row];
+    return m_rowOffsets->IsEmpty() ? (row + 1) * m_defaultRowHeight
+                                   : m_rowOffsets->GetEnd(row);
 }
 
 void wxGrid::CalcDimensions()
@@ -2740,17 +2980,7 @@ bool wxGrid::Redimension( wxGridTableMessage& msg )
             if ( !m_rowHeights.IsEmpty() )
             {
                 m_rowHeights.Insert( m_defaultRowHeight, pos, numRows );
-                m_rowBottoms.Insert( 0, pos, numRows );
-
-                int bottom = 0;
-                if ( pos > 0 )
-                    bottom = m_rowBottoms[pos - 1];
-
-                for ( i = pos; i < m_numRows; i++ )
-                {
-                    bottom += GetRowHeight(i);
-                    m_rowBottoms[i] = bottom;
-                }
+                m_rowOffsets->Init( m_rowHeights );
             }
 
             if ( m_currentCellCoords == wxGridNoCellCoords )
@@ -2779,23 +3009,12 @@ bool wxGrid::Redimension( wxGridTableMessage& msg )
         case wxGRIDTABLE_NOTIFY_ROWS_APPENDED:
         {
             int numRows = msg.GetCommandInt();
-            int oldNumRows = m_numRows;
             m_numRows += numRows;
 
             if ( !m_rowHeights.IsEmpty() )
             {
                 m_rowHeights.Add( m_defaultRowHeight, numRows );
-                m_rowBottoms.Add( 0, numRows );
-
-                int bottom = 0;
-                if ( oldNumRows > 0 )
-                    bottom = m_rowBottoms[oldNumRows - 1];
-
-                for ( i = oldNumRows; i < m_numRows; i++ )
-                {
-                    bottom += GetRowHeight(i);
-                    m_rowBottoms[i] = bottom;
-                }
+                m_rowOffsets->Append( numRows, m_defaultRowHeight );
             }
 
             if ( m_currentCellCoords == wxGridNoCellCoords )
@@ -2824,14 +3043,7 @@ bool wxGrid::Redimension( wxGridTableMessage& msg )
             if ( !m_rowHeights.IsEmpty() )
             {
                 m_rowHeights.RemoveAt( pos, numRows );
-                m_rowBottoms.RemoveAt( pos, numRows );
-
-                int h = 0;
-                for ( i = 0; i < m_numRows; i++ )
-                {
-                    h += GetRowHeight(i);
-                    m_rowBottoms[i] = h;
-                }
+                m_rowOffsets->Init( m_rowHeights );
             }
 
             if ( !m_numRows )
@@ -2902,20 +3114,7 @@ bool wxGrid::Redimension( wxGridTableMessage& msg )
             if ( !m_colWidths.IsEmpty() )
             {
                 m_colWidths.Insert( m_defaultColWidth, pos, numCols );
-                m_colRights.Insert( 0, pos, numCols );
-
-                int right = 0;
-                if ( pos > 0 )
-                    right = m_colRights[GetColAt( pos - 1 )];
-
-                int colPos;
-                for ( colPos = pos; colPos < m_numCols; colPos++ )
-                {
-                    i = GetColAt( colPos );
-
-                    right += GetColWidth(i);
-                    m_colRights[i] = right;
-                }
+                UpdateColRights();
             }
 
             if ( m_currentCellCoords == wxGridNoCellCoords )
@@ -2960,20 +3159,7 @@ bool wxGrid::Redimension( wxGridTableMessage& msg )
             if ( !m_colWidths.IsEmpty() )
             {
                 m_colWidths.Add( m_defaultColWidth, numCols );
-                m_colRights.Add( 0, numCols );
-
-                int right = 0;
-                if ( oldNumCols > 0 )
-                    right = m_colRights[GetColAt( oldNumCols - 1 )];
-
-                int colPos;
-                for ( colPos = oldNumCols; colPos < m_numCols; colPos++ )
-                {
-                    i = GetColAt( colPos );
-
-                    right += GetColWidth(i);
-                    m_colRights[i] = right;
-                }
+                m_colOffsets->Append( numCols, m_defaultColWidth );
             }
 
             // Notice that this must be called after updating m_colWidths above
@@ -3024,17 +3210,7 @@ bool wxGrid::Redimension( wxGridTableMessage& msg )
             if ( !m_colWidths.IsEmpty() )
             {
                 m_colWidths.RemoveAt( pos, numCols );
-                m_colRights.RemoveAt( pos, numCols );
-
-                int w = 0;
-                int colPos;
-                for ( colPos = 0; colPos < m_numCols; colPos++ )
-                {
-                    i = GetColAt( colPos );
-
-                    w += GetColWidth(i);
-                    m_colRights[i] = w;
-                }
+                UpdateColRights();
             }
 
             if ( !m_numCols )
@@ -4496,20 +4672,7 @@ void wxGrid::RefreshAfterColPosChange()
     // unless we calculate them dynamically because all columns widths are the
     // same and it's easy to do
     if ( !m_colWidths.empty() )
-    {
-        int colRight = 0;
-        for ( int colPos = 0; colPos < m_numCols; colPos++ )
-        {
-            int colID = GetColAt( colPos );
-
-            // Ignore the currently hidden columns.
-            const int width = m_colWidths[colID];
-            if ( width > 0 )
-                colRight += width;
-
-            m_colRights[colID] = colRight;
-        }
-    }
+        UpdateColRights();
 
     // and make the changes visible
     if ( m_useNativeHeader )
@@ -6559,9 +6722,8 @@ wxGridCellCoords wxGrid::XYToCell(int x, int y) const
 }
 
 // compute row or column from some (unscrolled) coordinate value, using either
-// m_defaultRowHeight/m_defaultColWidth or binary search on array of
-// m_rowBottoms/m_colRights to do it quickly in O(log n) time.
-// NOTE: This may not work correctly for reordered columns.
+// m_defaultRowHeight/m_defaultColWidth or searching in m_rowOffsets or
+// m_colOffsets to do it quickly in O(log n) time.
 int wxGrid::PosToLinePos(int coord,
                          bool clipToMinMax,
                          const wxGridOperations& oper) const
@@ -6574,13 +6736,12 @@ int wxGrid::PosToLinePos(int coord,
     const int defaultLineSize = oper.GetDefaultLineSize(this);
     wxCHECK_MSG( defaultLineSize, -1, "can't have 0 default line size" );
 
-    int maxPos = coord / defaultLineSize,
-        minPos = 0;
+    const int maxPos = coord / defaultLineSize;
 
     // check for the simplest case: if we have no explicit line sizes
     // configured, then we already know the line this position falls in
-    const wxArrayInt& lineEnds = oper.GetLineEnds(this);
-    if ( lineEnds.empty() )
+    const wxGridLineOffsets& lineEnds = oper.GetLineOffsets(this);
+    if ( lineEnds.IsEmpty() )
     {
         if ( maxPos < numLines )
             return maxPos;
@@ -6588,45 +6749,12 @@ int wxGrid::PosToLinePos(int coord,
         return clipToMinMax ? numLines - 1 : -1;
     }
 
+    // otherwise find the first line ending after this position
+    const int pos = lineEnds.FindPos(coord);
+    if ( pos < numLines )
+        return pos;
 
-    // binary search is quite efficient and we can't really make any assumptions
-    // on where to start here since row and columns could be of size 0 if they are
-    // hidden. While this could be made more efficient, some profiling will be
-    // necessary to determine if it really is a performance bottleneck
-    maxPos = numLines  - 1;
-
-    // check if the position is beyond the last column
-    const int lineAtMaxPos = oper.GetLineAt(this, maxPos);
-    if ( coord >= lineEnds[lineAtMaxPos] )
-        return clipToMinMax ? maxPos : -1;
-
-    // or before the first one
-    const int lineAt0 = oper.GetLineAt(this, 0);
-    if ( coord < lineEnds[lineAt0] )
-        return 0;
-
-
-    // finally do perform the binary search
-    while ( minPos < maxPos )
-    {
-        wxCHECK_MSG( lineEnds[oper.GetLineAt(this, minPos)] <= coord &&
-                        coord < lineEnds[oper.GetLineAt(this, maxPos)],
-                     -1,
-                     "wxGrid: internal error in PosToLinePos()" );
-
-        if ( coord >= lineEnds[oper.GetLineAt(this, maxPos - 1)] )
-            return maxPos;
-        else
-            maxPos--;
-
-        const int median = minPos + (maxPos - minPos + 1) / 2;
-        if ( coord < lineEnds[oper.GetLineAt(this, median)] )
-            maxPos = median;
-        else
-            minPos = median;
-    }
-
-    return maxPos;
+    return clipToMinMax ? numLines - 1 : -1;
 }
 
 int
@@ -8179,7 +8307,7 @@ void wxGrid::SetDefaultRowSize( int height, bool resizeExistingRows )
         // arrays (which also allows us to take advantage of
         // some speed optimisations)
         m_rowHeights.Empty();
-        m_rowBottoms.Empty();
+        m_rowOffsets->Clear();
         if ( !GetBatchCount() )
             CalcDimensions();
     }
@@ -8281,10 +8409,7 @@ void wxGrid::DoSetRowSize( int row, int height )
     if ( !diff )
         return;
 
-    for ( int i = row; i < m_numRows; i++ )
-    {
-        m_rowBottoms[i] += diff;
-    }
+    m_rowOffsets->Add(row, diff);
 
     InvalidateBestSize();
 
@@ -8307,7 +8432,7 @@ void wxGrid::SetDefaultColSize( int width, bool resizeExistingCols )
         // arrays (which also allows us to take advantage of
         // some speed optimisations)
         m_colWidths.Empty();
-        m_colRights.Empty();
+        m_colOffsets->Clear();
         if ( !GetBatchCount() )
             CalcDimensions();
     }
@@ -8372,10 +8497,7 @@ void wxGrid::DoSetColSize( int col, int width )
         GetGridColHeader()->UpdateColumn(col);
     //else: will be refreshed when the header is redrawn
 
-    for ( int colPos = GetColPos(col); colPos < m_numCols; colPos++ )
-    {
-        m_colRights[GetColAt(colPos)] += diff;
-    }
+    m_colOffsets->Add(GetColPos(col), diff);
 
     InvalidateBestSize();
 
@@ -8474,6 +8596,14 @@ wxGrid::AutoSizeColOrRow(int colOrRow, bool setAsMin, wxGridDirection direction)
     HideCellEditControl();
     SaveEditControlValue();
 
+    // reuse the extents of identical strings (if we're called from
+    // AutoSizeColumns() or AutoSizeRows(), their cache is used instead)
+    wxGridTextExtentCache extentCache;
+
+    // only examine some of the cells of a big grid if requested
+    wxArrayInt sample;
+    GetAutoSizeSample(direction, sample);
+
     // initialize both of them just to avoid compiler warnings even if only
     // really needs to be initialized here
     int row,
@@ -8490,9 +8620,12 @@ wxGrid::AutoSizeColOrRow(int colOrRow, bool setAsMin, wxGridDirection direction)
     }
 
     wxCoord extent, extentMax = 0;
-    int max = column ? m_numRows : m_numCols;
-    for ( int rowOrCol = 0; rowOrCol < max; rowOrCol++ )
+    int max = sample.empty() ? (column ? m_numRows : m_numCols)
+                             : static_cast<int>(sample.size());
+    for ( int n = 0; n < max; n++ )
     {
+        const int rowOrCol = sample.empty() ? n : sample[n];
+
         if ( column )
         {
             if ( !IsRowShown(rowOrCol) )
@@ -8649,6 +8782,64 @@ wxGrid::AutoSizeColOrRow(int colOrRow, bool setAsMin, wxGridDirection direction)
     }
 }
 
+void wxGrid::SetAutoSizeSampleCount(int count)
+{
+    wxCHECK_RET( count >= 0, "invalid number of auto-sizing samples" );
+
+    m_autoSizeSampleCount = count;
+}
+
+void
+wxGrid::GetAutoSizeSample(wxGridDirection direction, wxArrayInt& lines) const
+{
+    const bool column = direction == wxGRID_COLUMN;
+
+    // we examine the rows when auto-sizing a column and vice versa
+    const int numLines = column ? m_numRows : m_numCols;
+    if ( !m_autoSizeSampleCount || numLines <= m_autoSizeSampleCount )
+        return;
+
+    // always use the currently visible lines, as the user would notice if
+    // their contents didn't fit
+    if ( m_gridWin )
+    {
+        int cw, ch;
+        m_gridWin->GetClientSize(&cw, &ch);
+
+        int x, y;
+        CalcUnscrolledPosition(0, 0, &x, &y);
+
+        if ( column )
+        {
+            const int last = internalYToRow(y + ch);
+            for ( int row = internalYToRow(y); row <= last; row++ )
+                lines.push_back(row);
+        }
+        else
+        {
+            const int last = XToPos(x + cw);
+            for ( int pos = XToPos(x); pos <= last; pos++ )
+                lines.push_back(GetColAt(pos));
+        }
+    }
+
+    // and take a pseudo-random line from each of the equal parts of the grid
+    // for the rest: use a fixed seed to make the result reproducible
+    const double step = static_cast<double>(numLines) / m_autoSizeSampleCount;
+
+    wxUint32 seed = 1;
+    for ( int n = 0; n < m_autoSizeSampleCount; n++ )
+    {
+        const int start = static_cast<int>(step*n);
+        const int end = n == m_autoSizeSampleCount - 1
+                            ? numLines
+                            : static_cast<int>(step*(n + 1));
+
+        seed = seed*1103515245 + 12345;
+        lines.push_back(start + static_cast<int>((seed >> 16) % (end - start)));
+    }
+}
+
 wxCoord wxGrid::CalcColOrRowLabelAreaMinSize(wxGridDirection direction)
 {
     // calculate size for the rows or columns?
@@ -8710,6 +8901,8 @@ int wxGrid::SetOrCalcColumnSizes(bool calcOnly, bool setAsMin)
     if(!calcOnly)
         locker.Create(this);
 
+    wxGridTextExtentCache extentCache;
+
     for ( int col = 0; col < m_numCols; col++ )
     {
         if ( !calcOnly )
@@ -8729,6 +8922,8 @@ int wxGrid::SetOrCalcRowSizes(bool calcOnly, bool setAsMin)
     if(!calcOnly)
         locker.Create(this);
 
+    wxGridTextExtentCache extentCache;
+
     for ( int row = 0; row < m_numRows; row++ )
     {
         if ( !calcOnly )
@@ -8969,7 +9164,7 @@ wxGridCellCoordsArray wxGrid::GetSelectedCells() const
         return a;
     }
 
-    return m_selection->m_cellSelection;
+    return m_selection->GetCellSelection();
 }
 
 wxGridCellCoordsArray wxGrid::GetSelectionBlockTopLeft() const
@@ -8980,7 +9175,7 @@ wxGridCellCoordsArray wxGrid::GetSelectionBlockTopLeft() const
         return a;
     }
 
-    return m_selection->m_blockSelectionTopLeft;
+    return m_selection->GetBlockSelectionTopLeft();
 }
 
 wxGridCellCoordsArray wxGrid::GetSelectionBlockBottomRight() const
@@ -8991,7 +9186,7 @@ wxGridCellCoordsArray wxGrid::GetSelectionBlockBottomRight() const
         return a;
     }
 
-    return m_selection->m_blockSelectionBottomRight;
+    return m_selection->GetBlockSelectionBottomRight();
 }
 
 wxArrayInt wxGrid::GetSelectedRows() const
@@ -9002,7 +9197,7 @@ wxArrayInt wxGrid::GetSelectedRows() const
         return a;
     }
 
-    return m_selection->m_rowSelection;
+    return m_selection->GetRowSelection();
 }
 
 wxArrayInt wxGrid::GetSelectedCols() const
@@ -9013,7 +9208,12 @@ wxArrayInt wxGrid::GetSelectedCols() const
         return a;
     }
 
-    return m_selection->m_colSelection;
+    return m_selection->GetColSelection();
+}
+
+wxGridBlocks wxGrid::GetSelectedBlocks() const
+{
+    return wxGridBlocks(m_selection);
 }
 
 void wxGrid::ClearSelection()
@@ -30,6 +30,9 @@
 
 #include "wx/tokenzr.h"
 #include "wx/renderer.h"
+#include "wx/headerctrl.h"
+
+#include "wx/generic/private/grid.h"
 
 
 // ----------------------------------------------------------------------------
@@ -559,8 +562,17 @@ wxSize wxGridCellStringRenderer::DoGetBestSize(const wxGridCellAttr& attr,
                                                wxDC& dc,
                                                const wxString& text)
 {
+    const wxFont& font = attr.GetFont();
+
+    // measuring the text is slow, so reuse the result for the same text if
+    // we're called during auto-sizing
+    wxGridTextExtentCache * const cache = wxGridTextExtentCache::Get();
+    wxSize size;
+    if ( cache && cache->Find(font, text, &size) )
+        return size;
+
     wxCoord x = 0, y = 0, max_x = 0;
-    dc.SetFont(attr.GetFont());
+    dc.SetFont(font);
     wxStringTokenizer tk(text, wxT('\n'));
     while ( tk.HasMoreTokens() )
     {
@@ -570,7 +582,11 @@ wxSize wxGridCellStringRenderer::DoGetBestSize(const wxGridCellAttr& attr,
 
     y *= 1 + text.Freq(wxT('\n')); // multiply by the number of lines.
 
-    return wxSize(max_x, y);
+    size = wxSize(max_x, y);
+    if ( cache )
+        cache->Store(font, text, size);
+
+    return size;
 }
 
 wxSize wxGridCellStringRenderer::GetBestSize(wxGrid& grid,
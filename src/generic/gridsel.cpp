@@ -28,346 +28,550 @@
 #include "wx/generic/gridsel.h"
 
 
-// Some explanation for the members of the class:
-// m_cellSelection stores individual selected cells
-//   -- this is only used if m_selectionMode == wxGridSelectCells
-// m_blockSelectionTopLeft and m_blockSelectionBottomRight
-//   store the upper left and lower right corner of selected Blocks
-// m_rowSelection and m_colSelection store individual selected
-//   rows and columns; maybe those are superfluous and should be
-//   treated as blocks?
+// The selection is stored as a list of row bands with the selected columns of
+// each band, see the comment near m_bands declaration. Notice that rows and
+// columns are not stored separately: a selected row is just a band containing
+// all the columns and a selected column is a range present in all bands.
 
-wxGridSelection::wxGridSelection( wxGrid * grid,
-                                  wxGrid::wxGridSelectionModes sel )
+// ============================================================================
+// wxGridSelection implementation
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// helpers for working with ranges and bands
+// ----------------------------------------------------------------------------
+
+/* static */
+size_t wxGridSelection::FindRange(const Ranges& ranges, int n)
 {
-    m_grid = grid;
-    m_selectionMode = sel;
+    size_t lo = 0,
+           hi = ranges.size();
+    while ( lo < hi )
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if ( ranges[mid].last < n )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
 }
 
-bool wxGridSelection::IsSelection()
+/* static */
+bool wxGridSelection::RangesContain(const Ranges& ranges, int n)
 {
-  return ( m_cellSelection.GetCount() || m_blockSelectionTopLeft.GetCount() ||
-           m_rowSelection.GetCount() || m_colSelection.GetCount() );
+    const size_t i = FindRange(ranges, n);
+
+    return i < ranges.size() && ranges[i].first <= n;
 }
 
-bool wxGridSelection::IsInSelection( int row, int col )
+/* static */
+void wxGridSelection::AddRange(Ranges& ranges, int first, int last)
 {
-    size_t count;
-
-    // First check whether the given cell is individually selected
-    // (if m_selectionMode is wxGridSelectCells).
-    if ( m_selectionMode == wxGrid::wxGridSelectCells )
+    // Replace all the ranges overlapping or adjacent to the new one with a
+    // single range covering all of them.
+    const size_t start = FindRange(ranges, first - 1);
+    size_t end = start;
+    for ( ; end < ranges.size() && ranges[end].first <= last + 1; end++ )
     {
-        count = m_cellSelection.GetCount();
-        for ( size_t n = 0; n < count; n++ )
-        {
-            wxGridCellCoords& coords = m_cellSelection[n];
-            if ( row == coords.GetRow() && col == coords.GetCol() )
-                return true;
-        }
+        if ( ranges[end].first < first )
+            first = ranges[end].first;
+        if ( ranges[end].last > last )
+            last = ranges[end].last;
     }
 
-    // Now check whether the given cell is
-    // contained in one of the selected blocks.
-    count = m_blockSelectionTopLeft.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+    if ( end == start )
+    {
+        ranges.insert(ranges.begin() + start, Range(first, last));
+    }
+    else
     {
-        wxGridCellCoords& coords1 = m_blockSelectionTopLeft[n];
-        wxGridCellCoords& coords2 = m_blockSelectionBottomRight[n];
-        if ( BlockContainsCell(coords1.GetRow(), coords1.GetCol(),
-                               coords2.GetRow(), coords2.GetCol(),
-                               row, col ) )
-            return true;
+        ranges[start] = Range(first, last);
+        if ( end > start + 1 )
+            ranges.erase(ranges.begin() + start + 1, ranges.begin() + end);
     }
+}
+
+/* static */
+void wxGridSelection::RemoveRange(Ranges& ranges, int first, int last)
+{
+    size_t start = FindRange(ranges, first);
+    if ( start == ranges.size() || ranges[start].first > last )
+        return;
 
-    // Now check whether the given cell is
-    // contained in one of the selected rows
-    // (unless we are in column selection mode).
-    if ( m_selectionMode != wxGrid::wxGridSelectColumns )
+    if ( ranges[start].first < first )
     {
-        count = m_rowSelection.GetCount();
-        for ( size_t n = 0; n < count; n++ )
+        // The part of the first range before the removed one remains.
+        if ( ranges[start].last > last )
         {
-            if ( row == m_rowSelection[n] )
-              return true;
+            // And so does the part after it, split the range in two.
+            const Range after(last + 1, ranges[start].last);
+            ranges[start].last = first - 1;
+            ranges.insert(ranges.begin() + start + 1, after);
+            return;
         }
+
+        ranges[start].last = first - 1;
+        start++;
+    }
+
+    size_t end = start;
+    while ( end < ranges.size() && ranges[end].last <= last )
+        end++;
+
+    // The part of the last range after the removed one remains.
+    if ( end < ranges.size() && ranges[end].first <= last )
+        ranges[end].first = last + 1;
+
+    if ( end > start )
+        ranges.erase(ranges.begin() + start, ranges.begin() + end);
+}
+
+/* static */
+void wxGridSelection::AppendRange(Ranges& ranges, int first, int last)
+{
+    if ( !ranges.empty() && ranges.back().last + 1 >= first )
+    {
+        if ( last > ranges.back().last )
+            ranges.back().last = last;
+    }
+    else
+    {
+        ranges.push_back(Range(first, last));
     }
+}
 
-    // Now check whether the given cell is
-    // contained in one of the selected columns
-    // (unless we are in row selection mode).
-    if ( m_selectionMode != wxGrid::wxGridSelectRows )
+size_t wxGridSelection::FindBand(int row) const
+{
+    size_t lo = 0,
+           hi = m_bands.size();
+    while ( lo < hi )
     {
-        count = m_colSelection.GetCount();
-        for ( size_t n = 0; n < count; n++ )
-        {
-            if ( col == m_colSelection[n] )
-              return true;
-        }
+        const size_t mid = lo + (hi - lo) / 2;
+        if ( m_bands[mid]->bottomRow < row )
+            lo = mid + 1;
+        else
+            hi = mid;
     }
 
-    return false;
+    return lo;
 }
 
-// Change the selection mode
-void wxGridSelection::SetSelectionMode( wxGrid::wxGridSelectionModes selmode )
+/* static */
+void wxGridSelection::AppendBand(RowBands& bands, RowBand *band)
 {
-    // if selection mode is unchanged return immediately
-    if (selmode == m_selectionMode)
+    if ( band->cols.empty() )
+    {
+        delete band;
         return;
+    }
 
-    if ( m_selectionMode != wxGrid::wxGridSelectCells )
+    if ( !bands.empty() )
     {
-        // if changing form row to column selection
-        // or vice versa, clear the selection.
-        if ( selmode != wxGrid::wxGridSelectCells )
-            ClearSelection();
-
-        m_selectionMode = selmode;
+        RowBand * const prev = bands.back();
+        if ( prev->bottomRow + 1 == band->topRow && prev->cols == band->cols )
+        {
+            prev->bottomRow = band->bottomRow;
+            delete band;
+            return;
+        }
     }
-    else
+
+    bands.push_back(band);
+}
+
+void wxGridSelection::ReplaceBands(size_t first, size_t last, RowBands& bands)
+{
+    // Merge the first new band with the band preceding it if possible.
+    if ( first > 0 && !bands.empty() )
     {
-        // if changing from cell selection to something else,
-        // promote selected cells/blocks to whole rows/columns.
-        size_t n;
-        while ( ( n = m_cellSelection.GetCount() ) > 0 )
+        RowBand * const prev = m_bands[first - 1];
+        RowBand * const band = bands[0];
+        if ( prev->bottomRow + 1 == band->topRow && prev->cols == band->cols )
         {
-            n--;
-            wxGridCellCoords& coords = m_cellSelection[n];
-            int row = coords.GetRow();
-            int col = coords.GetCol();
-            m_cellSelection.RemoveAt(n);
-            if (selmode == wxGrid::wxGridSelectRows)
-                SelectRow( row );
-            else // selmode == wxGridSelectColumns)
-                SelectCol( col );
+            prev->bottomRow = band->bottomRow;
+            delete band;
+            bands.erase(bands.begin());
         }
+    }
 
-        // Note that m_blockSelectionTopLeft's size may be changing!
-        for ( n = m_blockSelectionTopLeft.GetCount(); n > 0; )
+    // And the band following them with the last new one, or with the band
+    // preceding them if there are no new bands left.
+    RowBand * const tail = !bands.empty() ? bands.back()
+                                          : first > 0 ? m_bands[first - 1]
+                                                      : NULL;
+    if ( tail && last < m_bands.size() )
+    {
+        RowBand * const next = m_bands[last];
+        if ( tail->bottomRow + 1 == next->topRow && tail->cols == next->cols )
         {
-            n--;
-            wxGridCellCoords& coords = m_blockSelectionTopLeft[n];
-            int topRow = coords.GetRow();
-            int leftCol = coords.GetCol();
-            wxGridCellCoords& coords2 = m_blockSelectionBottomRight[n];
-            int bottomRow = coords2.GetRow();
-            int rightCol = coords2.GetCol();
-
-            if (selmode == wxGrid::wxGridSelectRows)
-            {
-                if (leftCol != 0 || rightCol != m_grid->GetNumberCols() - 1 )
-                {
-                    m_blockSelectionTopLeft.RemoveAt(n);
-                    m_blockSelectionBottomRight.RemoveAt(n);
-                    SelectBlockNoEvent( topRow, 0,
-                                 bottomRow, m_grid->GetNumberCols() - 1);
-                }
-            }
-            else // selmode == wxGridSelectColumns)
-            {
-                if (topRow != 0 || bottomRow != m_grid->GetNumberRows() - 1 )
-                {
-                    m_blockSelectionTopLeft.RemoveAt(n);
-                    m_blockSelectionBottomRight.RemoveAt(n);
-                    SelectBlockNoEvent(0, leftCol,
-                                 m_grid->GetNumberRows() - 1, rightCol);
-                }
-            }
+            tail->bottomRow = next->bottomRow;
+            delete next;
+            last++;
         }
+    }
 
-        m_selectionMode = selmode;
+    const size_t count = bands.size(),
+                 old = last - first;
+    if ( count > old )
+    {
+        m_bands.insert(m_bands.begin() + last, count - old,
+                       static_cast<RowBand *>(NULL));
     }
+    else if ( count < old )
+    {
+        m_bands.erase(m_bands.begin() + first + count,
+                      m_bands.begin() + last);
+    }
+
+    for ( size_t n = 0; n < count; n++ )
+        m_bands[first + n] = bands[n];
 }
 
-void wxGridSelection::SelectRow(int row, const wxKeyboardState& kbd)
+void wxGridSelection::DeleteBands()
 {
-    if ( m_selectionMode == wxGrid::wxGridSelectColumns )
+    for ( size_t n = 0; n < m_bands.size(); n++ )
+        delete m_bands[n];
+
+    m_bands.clear();
+}
+
+void wxGridSelection::DoChangeBlock(int topRow, int leftCol,
+                                    int bottomRow, int rightCol,
+                                    bool select)
+{
+    if ( topRow > bottomRow || leftCol > rightCol )
         return;
 
-    size_t count, n;
+    // Build the new bands for all the rows of the block: the existing bands
+    // are split at the block boundaries and the gaps between them are filled
+    // with new bands when selecting.
+    const size_t first = FindBand(topRow);
+    size_t last = first;
 
-    // Remove single cells contained in newly selected block.
-    if ( m_selectionMode == wxGrid::wxGridSelectCells )
+    RowBands bands;
+    int row = topRow;
+    for ( ; last < m_bands.size() && m_bands[last]->topRow <= bottomRow; last++ )
     {
-        count = m_cellSelection.GetCount();
-        for ( n = 0; n < count; n++ )
+        RowBand * const band = m_bands[last];
+
+        if ( select && band->topRow > row )
         {
-            wxGridCellCoords& coords = m_cellSelection[n];
-            if ( BlockContainsCell( row, 0, row, m_grid->GetNumberCols() - 1,
-                                    coords.GetRow(), coords.GetCol() ) )
-            {
-                m_cellSelection.RemoveAt(n);
-                n--;
-                count--;
-            }
+            RowBand * const gap = new RowBand(row, band->topRow - 1);
+            gap->cols.push_back(Range(leftCol, rightCol));
+            AppendBand(bands, gap);
         }
-    }
-
-    // Simplify list of selected blocks (if possible)
-    count = m_blockSelectionTopLeft.GetCount();
-    bool done = false;
-
-    for ( n = 0; n < count; n++ )
-    {
-        wxGridCellCoords& coords1 = m_blockSelectionTopLeft[n];
-        wxGridCellCoords& coords2 = m_blockSelectionBottomRight[n];
 
-        // Remove block if it is a subset of the row
-        if ( coords1.GetRow() == row && row == coords2.GetRow() )
+        if ( band->topRow < topRow )
         {
-            m_blockSelectionTopLeft.RemoveAt(n);
-            m_blockSelectionBottomRight.RemoveAt(n);
-            n--;
-            count--;
+            RowBand * const before = new RowBand(band->topRow, topRow - 1);
+            before->cols = band->cols;
+            AppendBand(bands, before);
+
+            band->topRow = topRow;
         }
-        else if ( coords1.GetCol() == 0  &&
-                  coords2.GetCol() == m_grid->GetNumberCols() - 1 )
+
+        RowBand *after = NULL;
+        if ( band->bottomRow > bottomRow )
         {
-            // silently return, if row is contained in block
-            if ( coords1.GetRow() <= row && row <= coords2.GetRow() )
-                return;
-            // expand block, if it touched row
-            else if ( coords1.GetRow() == row + 1)
-            {
-                coords1.SetRow(row);
-                done = true;
-            }
-            else if ( coords2.GetRow() == row - 1)
-            {
-                coords2.SetRow(row);
-                done = true;
-            }
+            after = new RowBand(bottomRow + 1, band->bottomRow);
+            after->cols = band->cols;
+
+            band->bottomRow = bottomRow;
         }
+
+        row = band->bottomRow + 1;
+
+        if ( select )
+            AddRange(band->cols, leftCol, rightCol);
+        else
+            RemoveRange(band->cols, leftCol, rightCol);
+
+        AppendBand(bands, band);
+
+        if ( after )
+            AppendBand(bands, after);
+    }
+
+    if ( select && row <= bottomRow )
+    {
+        RowBand * const gap = new RowBand(row, bottomRow);
+        gap->cols.push_back(Range(leftCol, rightCol));
+        AppendBand(bands, gap);
+    }
+
+    ReplaceBands(first, last, bands);
+}
+
+bool wxGridSelection::IsBlockSelected(int topRow, int leftCol,
+                                      int bottomRow, int rightCol) const
+{
+    size_t n = FindBand(topRow);
+    for ( int row = topRow; row <= bottomRow; n++ )
+    {
+        if ( n == m_bands.size() || m_bands[n]->topRow > row )
+            return false;
+
+        const Ranges& cols = m_bands[n]->cols;
+        const size_t i = FindRange(cols, leftCol);
+        if ( i == cols.size() ||
+                cols[i].first > leftCol || cols[i].last < rightCol )
+            return false;
+
+        row = m_bands[n]->bottomRow + 1;
+    }
+
+    return true;
+}
+
+bool wxGridSelection::IsRowSelected(int row) const
+{
+    const size_t n = FindBand(row);
+    if ( n == m_bands.size() || m_bands[n]->topRow > row )
+        return false;
+
+    const Range& cols = m_bands[n]->cols[0];
+
+    return cols.first <= 0 && cols.last >= m_grid->GetNumberCols() - 1;
+}
+
+void wxGridSelection::GetFullRows(Ranges& rows, int numCols) const
+{
+    rows.clear();
+
+    if ( numCols <= 0 )
+        return;
+
+    for ( size_t n = 0; n < m_bands.size(); n++ )
+    {
+        const RowBand * const band = m_bands[n];
+        if ( band->cols[0].first <= 0 && band->cols[0].last >= numCols - 1 )
+            AppendRange(rows, band->topRow, band->bottomRow);
     }
+}
+
+void wxGridSelection::GetFullCols(Ranges& cols, int numRows) const
+{
+    cols.clear();
 
-    // Unless we successfully handled the row,
-    // check whether row is already selected.
-    if ( !done )
+    if ( numRows <= 0 || m_bands.empty() || m_bands[0]->topRow > 0 )
+        return;
+
+    // Intersect the columns of all bands, which must cover all rows.
+    cols = m_bands[0]->cols;
+
+    int row = m_bands[0]->bottomRow + 1;
+    for ( size_t n = 1; n < m_bands.size() && row < numRows; n++ )
     {
-        count = m_rowSelection.GetCount();
-        for ( n = 0; n < count; n++ )
+        const RowBand * const band = m_bands[n];
+        if ( band->topRow != row )
+        {
+            cols.clear();
+            return;
+        }
+
+        Ranges common;
+        const Ranges& other = band->cols;
+        for ( size_t i = 0, j = 0; i < cols.size() && j < other.size(); )
         {
-            if ( row == m_rowSelection[n] )
-                return;
+            const int first = wxMax(cols[i].first, other[j].first),
+                      last = wxMin(cols[i].last, other[j].last);
+            if ( first <= last )
+                common.push_back(Range(first, last));
+
+            if ( cols[i].last < other[j].last )
+                i++;
+            else
+                j++;
         }
 
-        // Add row to selection
-        m_rowSelection.Add(row);
+        cols.swap(common);
+        if ( cols.empty() )
+            return;
+
+        row = band->bottomRow + 1;
     }
 
-    // Update View:
+    if ( row < numRows )
+        cols.clear();
+}
+
+void wxGridSelection::RefreshBlock(int topRow, int leftCol,
+                                   int bottomRow, int rightCol)
+{
     if ( !m_grid->GetBatchCount() )
     {
-        wxRect r = m_grid->BlockToDeviceRect( wxGridCellCoords( row, 0 ),
-                                              wxGridCellCoords( row, m_grid->GetNumberCols() - 1 ) );
+        wxRect r = m_grid->BlockToDeviceRect( wxGridCellCoords( topRow, leftCol ),
+                                              wxGridCellCoords( bottomRow, rightCol ) );
         ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
     }
+}
 
-    // Send Event
+void wxGridSelection::SendRangeSelectEvent(int topRow, int leftCol,
+                                           int bottomRow, int rightCol,
+                                           bool selecting,
+                                           const wxKeyboardState& kbd)
+{
     wxGridRangeSelectEvent gridEvt( m_grid->GetId(),
                                     wxEVT_GRID_RANGE_SELECT,
                                     m_grid,
-                                    wxGridCellCoords( row, 0 ),
-                                    wxGridCellCoords( row, m_grid->GetNumberCols() - 1 ),
-                                    true,
-                                    kbd);
+                                    wxGridCellCoords( topRow, leftCol ),
+                                    wxGridCellCoords( bottomRow, rightCol ),
+                                    selecting,
+                                    kbd );
 
     m_grid->GetEventHandler()->ProcessEvent( gridEvt );
 }
 
-void wxGridSelection::SelectCol(int col, const wxKeyboardState& kbd)
+// ----------------------------------------------------------------------------
+// public API
+// ----------------------------------------------------------------------------
+
+wxGridSelection::wxGridSelection( wxGrid * grid,
+                                  wxGrid::wxGridSelectionModes sel )
 {
-    if ( m_selectionMode == wxGrid::wxGridSelectRows )
+    m_grid = grid;
+    m_selectionMode = sel;
+}
+
+wxGridSelection::~wxGridSelection()
+{
+    DeleteBands();
+}
+
+bool wxGridSelection::IsInSelection( int row, int col ) const
+{
+    const size_t n = FindBand(row);
+
+    return n < m_bands.size() && m_bands[n]->topRow <= row &&
+            RangesContain(m_bands[n]->cols, col);
+}
+
+// Change the selection mode
+void wxGridSelection::SetSelectionMode( wxGrid::wxGridSelectionModes selmode )
+{
+    // if selection mode is unchanged return immediately
+    if (selmode == m_selectionMode)
+        return;
+
+    if ( m_selectionMode != wxGrid::wxGridSelectCells )
+    {
+        // if changing form row to column selection
+        // or vice versa, clear the selection.
+        if ( selmode != wxGrid::wxGridSelectCells )
+            ClearSelection();
+
+        m_selectionMode = selmode;
         return;
-    size_t count, n;
+    }
 
-    // Remove single cells contained in newly selected block.
-    if ( m_selectionMode == wxGrid::wxGridSelectCells )
+    // if changing from cell selection to something else,
+    // promote selected cells/blocks to whole rows/columns.
+    const int numRows = m_grid->GetNumberRows(),
+              numCols = m_grid->GetNumberCols();
+
+    if ( selmode == wxGrid::wxGridSelectRows )
     {
-        count = m_cellSelection.GetCount();
-        for ( n = 0; n < count; n++ )
+        // Selected columns can't be promoted to rows, drop them.
+        Ranges fullCols;
+        GetFullCols(fullCols, numRows);
+
+        RowBands bands;
+        for ( size_t n = 0; n < m_bands.size(); n++ )
         {
-            wxGridCellCoords& coords = m_cellSelection[n];
-            if ( BlockContainsCell( 0, col, m_grid->GetNumberRows() - 1, col,
-                                    coords.GetRow(), coords.GetCol() ) )
+            RowBand * const band = m_bands[n];
+            for ( size_t i = 0; i < fullCols.size(); i++ )
+                RemoveRange(band->cols, fullCols[i].first, fullCols[i].last);
+
+            if ( !band->cols.empty() )
             {
-                m_cellSelection.RemoveAt(n);
-                n--;
-                count--;
+                band->cols.clear();
+                band->cols.push_back(Range(0, numCols - 1));
             }
+
+            AppendBand(bands, band);
         }
-    }
 
-    // Simplify list of selected blocks (if possible)
-    count = m_blockSelectionTopLeft.GetCount();
-    bool done = false;
-    for ( n = 0; n < count; n++ )
+        m_bands.swap(bands);
+    }
+    else // selmode == wxGridSelectColumns or wxGridSelectRowsOrColumns
     {
-        wxGridCellCoords& coords1 = m_blockSelectionTopLeft[n];
-        wxGridCellCoords& coords2 = m_blockSelectionBottomRight[n];
+        // Selected rows can't be promoted to columns, drop them unless rows
+        // can be selected in the new mode too.
+        Ranges fullRows;
+        GetFullRows(fullRows, numCols);
+
+        Ranges cols;
+        for ( size_t n = 0; n < m_bands.size(); n++ )
+        {
+            const RowBand * const band = m_bands[n];
+            if ( RangesContain(fullRows, band->topRow) )
+                continue;
 
-        // Remove block if it is a subset of the column
-        if ( coords1.GetCol() == col && col == coords2.GetCol() )
+            for ( size_t i = 0; i < band->cols.size(); i++ )
+                AddRange(cols, band->cols[i].first, band->cols[i].last);
+        }
+
+        DeleteBands();
+
+        if ( !cols.empty() && numRows > 0 )
         {
-            m_blockSelectionTopLeft.RemoveAt(n);
-            m_blockSelectionBottomRight.RemoveAt(n);
-            n--;
-            count--;
+            RowBand * const band = new RowBand(0, numRows - 1);
+            band->cols = cols;
+            m_bands.push_back(band);
         }
-        else if ( coords1.GetRow() == 0  &&
-                  coords2.GetRow() == m_grid->GetNumberRows() - 1 )
+
+        if ( selmode == wxGrid::wxGridSelectRowsOrColumns )
         {
-            // silently return, if row is contained in block
-            if ( coords1.GetCol() <= col && col <= coords2.GetCol() )
-                return;
-            // expand block, if it touched col
-            else if ( coords1.GetCol() == col + 1)
+            for ( size_t n = 0; n < fullRows.size(); n++ )
             {
-                coords1.SetCol(col);
-                done = true;
-            }
-            else if ( coords2.GetCol() == col - 1)
-            {
-                coords2.SetCol(col);
-                done = true;
+                DoChangeBlock(fullRows[n].first, 0,
+                              fullRows[n].last, numCols - 1, true);
             }
         }
     }
 
-    // Unless we successfully handled the column,
-    // Check whether col is already selected.
-    if ( !done )
-    {
-        count = m_colSelection.GetCount();
-        for ( n = 0; n < count; n++ )
-        {
-            if ( col == m_colSelection[n] )
-                return;
-        }
-
-        // Add col to selection
-        m_colSelection.Add(col);
-    }
+    m_selectionMode = selmode;
 
-    // Update View:
     if ( !m_grid->GetBatchCount() )
-    {
-        wxRect r = m_grid->BlockToDeviceRect( wxGridCellCoords( 0, col ),
-                                              wxGridCellCoords( m_grid->GetNumberRows() - 1, col ) );
-        ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
-    }
+        ((wxWindow *)m_grid->m_gridWin)->Refresh( false );
+}
 
-    // Send Event
-    wxGridRangeSelectEvent gridEvt( m_grid->GetId(),
-                                    wxEVT_GRID_RANGE_SELECT,
-                                    m_grid,
-                                    wxGridCellCoords( 0, col ),
-                                    wxGridCellCoords( m_grid->GetNumberRows() - 1, col ),
-                                    true,
-                                    kbd );
+void wxGridSelection::SelectRow(int row, const wxKeyboardState& kbd)
+{
+    if ( m_selectionMode == wxGrid::wxGridSelectColumns )
+        return;
 
-    m_grid->GetEventHandler()->ProcessEvent( gridEvt );
+    // silently return, if row is already selected
+    if ( IsRowSelected(row) )
+        return;
+
+    const int lastCol = m_grid->GetNumberCols() - 1;
+
+    DoChangeBlock(row, 0, row, lastCol, true);
+
+    RefreshBlock(row, 0, row, lastCol);
+
+    SendRangeSelectEvent(row, 0, row, lastCol, true, kbd);
+}
+
+void wxGridSelection::SelectCol(int col, const wxKeyboardState& kbd)
+{
+    if ( m_selectionMode == wxGrid::wxGridSelectRows )
+        return;
+
+    const int lastRow = m_grid->GetNumberRows() - 1;
+
+    // silently return, if column is already selected
+    if ( IsBlockSelected(0, col, lastRow, col) )
+        return;
+
+    DoChangeBlock(0, col, lastRow, col, true);
+
+    RefreshBlock(0, col, lastRow, col);
+
+    SendRangeSelectEvent(0, col, lastRow, col, true, kbd);
 }
 
 void wxGridSelection::SelectBlock( int topRow, int leftCol,
@@ -416,229 +620,52 @@ void wxGridSelection::SelectBlock( int topRow, int leftCol,
         rightCol = temp;
     }
 
-    // Handle single cell selection in SelectCell.
-    // (MB: added check for selection mode here to prevent
-    //  crashes if, for example, we are select rows and the
-    //  grid only has 1 col)
+    // If the block is already selected, return.
     if ( m_selectionMode == wxGrid::wxGridSelectCells &&
-         topRow == bottomRow && leftCol == rightCol )
-    {
-        SelectCell( topRow, leftCol, kbd, sendEvent );
-    }
+            IsBlockSelected(topRow, leftCol, bottomRow, rightCol) )
+        return;
+
+    DoChangeBlock(topRow, leftCol, bottomRow, rightCol, true);
+
+    // Update View:
+    RefreshBlock(topRow, leftCol, bottomRow, rightCol);
 
-    size_t count, n;
+    // Send Event, if not disabled.
+    if ( sendEvent )
+        SendRangeSelectEvent(topRow, leftCol, bottomRow, rightCol, true, kbd);
+}
+
+void wxGridSelection::SelectCell( int row, int col,
+                                  const wxKeyboardState& kbd,
+                                  bool sendEvent )
+{
+    if ( IsInSelection ( row, col ) )
+        return;
+
+    int topRow = row,
+        leftCol = col,
+        bottomRow = row,
+        rightCol = col;
 
     if ( m_selectionMode == wxGrid::wxGridSelectRows )
     {
-        // find out which rows are already selected:
-        wxArrayInt alreadyselected;
-        alreadyselected.Add(0,bottomRow-topRow+1);
-        for( n = 0; n < m_rowSelection.GetCount(); n++)
-        {
-            int row = m_rowSelection[n];
-            if( (row >= topRow) && (row <= bottomRow) )
-            {
-                alreadyselected[ row - topRow ]=1;
-            }
-        }
-
-        // add the newly selected rows:
-        for ( int row = topRow; row <= bottomRow; row++ )
-        {
-            if ( alreadyselected[ row - topRow ] == 0 )
-            {
-                m_rowSelection.Add( row );
-            }
-        }
+        leftCol = 0;
+        rightCol = m_grid->GetNumberCols() - 1;
     }
     else if ( m_selectionMode == wxGrid::wxGridSelectColumns )
     {
-        // find out which columns are already selected:
-        wxArrayInt alreadyselected;
-        alreadyselected.Add(0,rightCol-leftCol+1);
-        for( n = 0; n < m_colSelection.GetCount(); n++)
-        {
-            int col = m_colSelection[n];
-            if( (col >= leftCol) && (col <= rightCol) )
-            {
-                alreadyselected[ col - leftCol ]=1;
-            }
-        }
-
-        // add the newly selected columns:
-        for ( int col = leftCol; col <= rightCol; col++ )
-        {
-            if ( alreadyselected[ col - leftCol ] == 0 )
-            {
-                m_colSelection.Add( col );
-            }
-        }
+        topRow = 0;
+        bottomRow = m_grid->GetNumberRows() - 1;
     }
-    else
-    {
-        // Remove single cells contained in newly selected block.
-        if ( m_selectionMode == wxGrid::wxGridSelectCells )
-        {
-            count = m_cellSelection.GetCount();
-            for ( n = 0; n < count; n++ )
-            {
-                wxGridCellCoords& coords = m_cellSelection[n];
-                if ( BlockContainsCell( topRow, leftCol, bottomRow, rightCol,
-                                        coords.GetRow(), coords.GetCol() ) )
-                {
-                    m_cellSelection.RemoveAt(n);
-                    n--;
-                    count--;
-                }
-            }
-        }
-
-        // If a block containing the selection is already selected, return,
-        // if a block contained in the selection is found, remove it.
-
-        count = m_blockSelectionTopLeft.GetCount();
-        for ( n = 0; n < count; n++ )
-        {
-            wxGridCellCoords& coords1 = m_blockSelectionTopLeft[n];
-            wxGridCellCoords& coords2 = m_blockSelectionBottomRight[n];
 
-            switch ( BlockContain( coords1.GetRow(), coords1.GetCol(),
-                                   coords2.GetRow(), coords2.GetCol(),
-                                   topRow, leftCol, bottomRow, rightCol ) )
-            {
-                case 1:
-                    return;
-
-                case -1:
-                    m_blockSelectionTopLeft.RemoveAt(n);
-                    m_blockSelectionBottomRight.RemoveAt(n);
-                    n--;
-                    count--;
-                    break;
-
-                default:
-                    break;
-            }
-        }
-
-        // If a row containing the selection is already selected, return,
-        // if a row contained in newly selected block is found, remove it.
-        count = m_rowSelection.GetCount();
-        for ( n = 0; n < count; n++ )
-        {
-            switch ( BlockContain( m_rowSelection[n], 0,
-                                   m_rowSelection[n], m_grid->GetNumberCols() - 1,
-                                   topRow, leftCol, bottomRow, rightCol ) )
-            {
-                case 1:
-                    return;
-
-                case -1:
-                    m_rowSelection.RemoveAt(n);
-                    n--;
-                    count--;
-                    break;
-
-                default:
-                    break;
-            }
-        }
-
-        // Same for columns.
-        count = m_colSelection.GetCount();
-        for ( n = 0; n < count; n++ )
-        {
-            switch ( BlockContain( 0, m_colSelection[n],
-                                   m_grid->GetNumberRows() - 1, m_colSelection[n],
-                                   topRow, leftCol, bottomRow, rightCol ) )
-            {
-                case 1:
-                    return;
-
-                case -1:
-                    m_colSelection.RemoveAt(n);
-                    n--;
-                    count--;
-                    break;
-
-                default:
-                    break;
-            }
-        }
-
-        m_blockSelectionTopLeft.Add( wxGridCellCoords( topRow, leftCol ) );
-        m_blockSelectionBottomRight.Add( wxGridCellCoords( bottomRow, rightCol ) );
-    }
-    // Update View:
-    if ( !m_grid->GetBatchCount() )
-    {
-        wxRect r = m_grid->BlockToDeviceRect( wxGridCellCoords( topRow, leftCol ),
-                                              wxGridCellCoords( bottomRow, rightCol ) );
-        ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
-    }
-
-    // Send Event, if not disabled.
-    if ( sendEvent )
-    {
-        wxGridRangeSelectEvent gridEvt( m_grid->GetId(),
-            wxEVT_GRID_RANGE_SELECT,
-            m_grid,
-            wxGridCellCoords( topRow, leftCol ),
-            wxGridCellCoords( bottomRow, rightCol ),
-            true,
-            kbd);
-        m_grid->GetEventHandler()->ProcessEvent( gridEvt );
-    }
-}
-
-void wxGridSelection::SelectCell( int row, int col,
-                                  const wxKeyboardState& kbd,
-                                  bool sendEvent )
-{
-    if ( IsInSelection ( row, col ) )
-        return;
-
-    wxGridCellCoords selectedTopLeft, selectedBottomRight;
-    if ( m_selectionMode == wxGrid::wxGridSelectRows )
-    {
-        m_rowSelection.Add( row );
-        selectedTopLeft = wxGridCellCoords( row, 0 );
-        selectedBottomRight = wxGridCellCoords( row, m_grid->GetNumberCols() - 1 );
-    }
-    else if ( m_selectionMode == wxGrid::wxGridSelectColumns )
-    {
-        m_colSelection.Add( col );
-        selectedTopLeft = wxGridCellCoords( 0, col );
-        selectedBottomRight = wxGridCellCoords( m_grid->GetNumberRows() - 1, col );
-    }
-    else
-    {
-        m_cellSelection.Add( wxGridCellCoords( row, col ) );
-        selectedTopLeft = wxGridCellCoords( row, col );
-        selectedBottomRight = wxGridCellCoords( row, col );
-    }
+    DoChangeBlock(topRow, leftCol, bottomRow, rightCol, true);
 
     // Update View:
-    if ( !m_grid->GetBatchCount() )
-    {
-        wxRect r = m_grid->BlockToDeviceRect(
-            selectedTopLeft,
-            selectedBottomRight );
-        ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
-    }
+    RefreshBlock(topRow, leftCol, bottomRow, rightCol);
 
     // Send event
-    if (sendEvent)
-    {
-        wxGridRangeSelectEvent gridEvt( m_grid->GetId(),
-            wxEVT_GRID_RANGE_SELECT,
-            m_grid,
-            selectedTopLeft,
-            selectedBottomRight,
-            true,
-            kbd);
-        m_grid->GetEventHandler()->ProcessEvent( gridEvt );
-    }
+    if ( sendEvent )
+        SendRangeSelectEvent(topRow, leftCol, bottomRow, rightCol, true, kbd);
 }
 
 void
@@ -653,587 +680,423 @@ wxGridSelection::ToggleCellSelection(int row, int col,
         return;
     }
 
-    // otherwise deselect it. This can be simple or more or
-    // less difficult, depending on how the cell is selected.
-    size_t count, n;
-
-    // The simplest case: The cell is contained in m_cellSelection
-    // Then it can't be contained in rows/cols/block (since those
-    // would remove the cell from m_cellSelection on creation), so
-    // we just have to remove it from m_cellSelection.
+    // otherwise deselect it: depending on the selection mode, this means
+    // deselecting just the cell or the entire row and/or column containing it
+    const int lastRow = m_grid->GetNumberRows() - 1,
+              lastCol = m_grid->GetNumberCols() - 1;
 
-    if ( m_selectionMode == wxGrid::wxGridSelectCells )
+    switch ( m_selectionMode )
     {
-        count = m_cellSelection.GetCount();
-        for ( n = 0; n < count; n++ )
-        {
-            const wxGridCellCoords& sel = m_cellSelection[n];
-            if ( row == sel.GetRow() && col == sel.GetCol() )
-            {
-                wxGridCellCoords coords = m_cellSelection[n];
-                m_cellSelection.RemoveAt(n);
-                if ( !m_grid->GetBatchCount() )
-                {
-                    wxRect r = m_grid->BlockToDeviceRect( coords, coords );
-                    ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
-                }
+        default:
+            wxFAIL_MSG( "unknown selection mode" );
+            wxFALLTHROUGH;
 
-                // Send event
-                wxGridRangeSelectEvent gridEvt( m_grid->GetId(),
-                                                wxEVT_GRID_RANGE_SELECT,
-                                                m_grid,
-                                                wxGridCellCoords( row, col ),
-                                                wxGridCellCoords( row, col ),
-                                                false,
-                                                kbd );
-                m_grid->GetEventHandler()->ProcessEvent( gridEvt );
-
-                return;
-            }
-        }
-    }
+        case wxGrid::wxGridSelectCells:
+            DoChangeBlock(row, col, row, col, false);
+            RefreshBlock(row, col, row, col);
+            SendRangeSelectEvent(row, col, row, col, false, kbd);
+            break;
 
-    // The most difficult case: The cell is member of one or even several
-    // blocks. Split each such block in up to 4 new parts, that don't
-    // contain the cell to be selected, like this:
-    // |---------------------------|
-    // |                           |
-    // |           part 1          |
-    // |                           |
-    // |---------------------------|
-    // |   part 3   |x|   part 4   |
-    // |---------------------------|
-    // |                           |
-    // |           part 2          |
-    // |                           |
-    // |---------------------------|
-    //   (The x marks the newly deselected cell).
-    // Note: in row selection mode, we only need part1 and part2;
-    //       in column selection mode, we only need part 3 and part4,
-    //          which are expanded to whole columns automatically!
-
-    count = m_blockSelectionTopLeft.GetCount();
-    for ( n = 0; n < count; n++ )
-    {
-        wxGridCellCoords& coords1 = m_blockSelectionTopLeft[n];
-        wxGridCellCoords& coords2 = m_blockSelectionBottomRight[n];
-        int topRow = coords1.GetRow();
-        int leftCol = coords1.GetCol();
-        int bottomRow = coords2.GetRow();
-        int rightCol = coords2.GetCol();
-
-        if ( BlockContainsCell( topRow, leftCol, bottomRow, rightCol, row, col ) )
-        {
-            // remove the block
-            m_blockSelectionTopLeft.RemoveAt(n);
-            m_blockSelectionBottomRight.RemoveAt(n);
-            n--;
-            count--;
-
-            // add up to 4 smaller blocks and set update region
-            if ( m_selectionMode != wxGrid::wxGridSelectColumns )
-            {
-                if ( topRow < row )
-                    SelectBlockNoEvent(topRow, leftCol, row - 1, rightCol);
-                if ( bottomRow > row )
-                    SelectBlockNoEvent(row + 1, leftCol, bottomRow, rightCol);
-            }
+        case wxGrid::wxGridSelectRows:
+            DoChangeBlock(row, 0, row, lastCol, false);
+            RefreshBlock(row, 0, row, lastCol);
+            SendRangeSelectEvent(row, 0, row, lastCol, false, kbd);
+            break;
 
-            if ( m_selectionMode != wxGrid::wxGridSelectRows )
-            {
-                if ( leftCol < col )
-                    SelectBlockNoEvent(row, leftCol, row, col - 1);
-                if ( rightCol > col )
-                    SelectBlockNoEvent(row, col + 1, row, rightCol);
-            }
-        }
-    }
+        case wxGrid::wxGridSelectColumns:
+            DoChangeBlock(0, col, lastRow, col, false);
+            RefreshBlock(0, col, lastRow, col);
+            SendRangeSelectEvent(0, col, lastRow, col, false, kbd);
+            break;
 
-    bool rowSelectionWasChanged = false;
-    // remove a cell from a row, adding up to two new blocks
-    if ( m_selectionMode != wxGrid::wxGridSelectColumns )
-    {
-        count = m_rowSelection.GetCount();
-        for ( n = 0; n < count; n++ )
-        {
-            if ( m_rowSelection[n] == row )
+        case wxGrid::wxGridSelectRowsOrColumns:
             {
-                m_rowSelection.RemoveAt(n);
-                n--;
-                count--;
+                // Deselect the row and the column containing the cell, but
+                // keep the other cells of this row selected if they're in the
+                // selected columns and vice versa.
+                Ranges rows, cols;
+                GetFullRows(rows, lastCol + 1);
+                GetFullCols(cols, lastRow + 1);
 
-                rowSelectionWasChanged = true;
+                const bool rowWasSelected = RangesContain(rows, row),
+                           colWasSelected = RangesContain(cols, col);
 
-                if (m_selectionMode == wxGrid::wxGridSelectCells)
+                if ( !rowWasSelected && !colWasSelected )
                 {
-                    if ( col > 0 )
-                        SelectBlockNoEvent(row, 0, row, col - 1);
-                    if ( col < m_grid->GetNumberCols() - 1 )
-                        SelectBlockNoEvent( row, col + 1,
-                                     row, m_grid->GetNumberCols() - 1);
+                    DoChangeBlock(row, col, row, col, false);
+                    RefreshBlock(row, col, row, col);
+                    SendRangeSelectEvent(row, col, row, col, false, kbd);
+                    break;
                 }
-            }
-        }
-    }
 
-    bool colSelectionWasChanged = false;
-    // remove a cell from a column, adding up to two new blocks
-    if ( m_selectionMode != wxGrid::wxGridSelectRows )
-    {
-        count = m_colSelection.GetCount();
-        for ( n = 0; n < count; n++ )
-        {
-            if ( m_colSelection[n] == col )
-            {
-                m_colSelection.RemoveAt(n);
-                n--;
-                count--;
+                RemoveRange(rows, row, row);
+                RemoveRange(cols, col, col);
 
-                colSelectionWasChanged = true;
-
-                if (m_selectionMode == wxGrid::wxGridSelectCells)
+                if ( rowWasSelected )
                 {
-                    if ( row > 0 )
-                        SelectBlockNoEvent(0, col, row - 1, col);
-                    if ( row < m_grid->GetNumberRows() - 1 )
-                        SelectBlockNoEvent(row + 1, col,
-                                     m_grid->GetNumberRows() - 1, col);
-                }
-            }
-        }
-    }
-
-    // Refresh the screen and send the event; according to m_selectionMode,
-    // we need to either update only the cell, or the whole row/column.
-    wxRect r;
-    if ( m_selectionMode == wxGrid::wxGridSelectCells )
-    {
-        if ( !m_grid->GetBatchCount() )
-        {
-            r = m_grid->BlockToDeviceRect(
-                wxGridCellCoords( row, col ),
-                wxGridCellCoords( row, col ) );
-            ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
-        }
+                    DoChangeBlock(row, 0, row, lastCol, false);
 
-        wxGridRangeSelectEvent gridEvt( m_grid->GetId(),
-            wxEVT_GRID_RANGE_SELECT,
-            m_grid,
-            wxGridCellCoords( row, col ),
-            wxGridCellCoords( row, col ),
-            false,
-            kbd );
-        m_grid->GetEventHandler()->ProcessEvent( gridEvt );
-    }
-    else  // rows/columns selection mode
-    {
-        if ( m_selectionMode != wxGrid::wxGridSelectColumns &&
-                rowSelectionWasChanged )
-        {
-            int numCols = m_grid->GetNumberCols();
-            for ( int colFrom = 0, colTo = 0; colTo <= numCols; ++colTo )
-            {
-                if ( m_colSelection.Index(colTo) >= 0 || colTo == numCols )
-                {
-                    if ( colFrom < colTo )
+                    int colFrom = 0;
+                    for ( size_t n = 0; n <= cols.size(); n++ )
                     {
-                        if ( !m_grid->GetBatchCount() )
+                        const int colTo = n < cols.size() ? cols[n].first
+                                                          : lastCol + 1;
+                        if ( colFrom < colTo )
                         {
-                            r = m_grid->BlockToDeviceRect(
-                                wxGridCellCoords( row, colFrom ),
-                                wxGridCellCoords( row, colTo-1 ) );
-                            ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
+                            RefreshBlock(row, colFrom, row, colTo - 1);
+                            SendRangeSelectEvent(row, colFrom, row, colTo - 1,
+                                                 false, kbd);
                         }
 
-                        wxGridRangeSelectEvent gridEvt( m_grid->GetId(),
-                            wxEVT_GRID_RANGE_SELECT,
-                            m_grid,
-                            wxGridCellCoords( row, colFrom ),
-                            wxGridCellCoords( row, colTo - 1 ),
-                            false,
-                            kbd );
-                        m_grid->GetEventHandler()->ProcessEvent( gridEvt );
+                        if ( n < cols.size() )
+                        {
+                            DoChangeBlock(row, cols[n].first,
+                                          row, cols[n].last, true);
+                            colFrom = cols[n].last + 1;
+                        }
                     }
-
-                    colFrom = colTo + 1;
                 }
-            }
-        }
 
-        if ( m_selectionMode != wxGrid::wxGridSelectRows &&
-                colSelectionWasChanged )
-        {
-            int numRows = m_grid->GetNumberRows();
-            for ( int rowFrom = 0, rowTo = 0; rowTo <= numRows; ++rowTo )
-            {
-                if ( m_rowSelection.Index(rowTo) >= 0 || rowTo == numRows )
+                if ( colWasSelected )
                 {
-                    if (rowFrom < rowTo)
+                    DoChangeBlock(0, col, lastRow, col, false);
+
+                    int rowFrom = 0;
+                    for ( size_t n = 0; n <= rows.size(); n++ )
                     {
-                        if ( !m_grid->GetBatchCount() )
+                        const int rowTo = n < rows.size() ? rows[n].first
+                                                          : lastRow + 1;
+                        if ( rowFrom < rowTo )
                         {
-                            r = m_grid->BlockToDeviceRect(
-                                wxGridCellCoords( rowFrom, col ),
-                                wxGridCellCoords( rowTo - 1, col ) );
-                          ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
+                            RefreshBlock(rowFrom, col, rowTo - 1, col);
+                            SendRangeSelectEvent(rowFrom, col, rowTo - 1, col,
+                                                 false, kbd);
                         }
 
-                        wxGridRangeSelectEvent gridEvt( m_grid->GetId(),
-                            wxEVT_GRID_RANGE_SELECT,
-                            m_grid,
-                            wxGridCellCoords( rowFrom, col ),
-                            wxGridCellCoords( rowTo - 1, col ),
-                            false,
-                            kbd );
-                        m_grid->GetEventHandler()->ProcessEvent( gridEvt );
+                        if ( n < rows.size() )
+                        {
+                            DoChangeBlock(rows[n].first, col,
+                                          rows[n].last, col, true);
+                            rowFrom = rows[n].last + 1;
+                        }
                     }
-
-                    rowFrom = rowTo + 1;
                 }
             }
-        }
+            break;
     }
 }
 
 void wxGridSelection::ClearSelection()
 {
-    size_t n;
-    wxRect r;
-    wxGridCellCoords coords1, coords2;
-
-    // deselect all individual cells and update the screen
-    if ( m_selectionMode == wxGrid::wxGridSelectCells )
+    // deselect everything and update the screen
+    if ( !m_grid->GetBatchCount() )
     {
-        while ( ( n = m_cellSelection.GetCount() ) > 0)
+        for ( size_t n = 0; n < m_bands.size(); n++ )
         {
-            n--;
-            coords1 = m_cellSelection[n];
-            m_cellSelection.RemoveAt(n);
-            if ( !m_grid->GetBatchCount() )
-            {
-                r = m_grid->BlockToDeviceRect( coords1, coords1 );
-                ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
+            const RowBand * const band = m_bands[n];
+            RefreshBlock(band->topRow, band->cols.front().first,
+                         band->bottomRow, band->cols.back().last);
+        }
 
 #ifdef __WXMAC__
-                ((wxWindow *)m_grid->m_gridWin)->Update();
+        if ( !m_bands.empty() )
+            ((wxWindow *)m_grid->m_gridWin)->Update();
 #endif
-            }
-        }
     }
 
-    // deselect all blocks and update the screen
-    while ( ( n = m_blockSelectionTopLeft.GetCount() ) > 0)
+    DeleteBands();
+
+    // One deselection event, indicating deselection of _all_ cells.
+    // (No finer grained events for each of the smaller regions
+    //  deselected above!)
+    SendRangeSelectEvent(0, 0,
+                         m_grid->GetNumberRows() - 1,
+                         m_grid->GetNumberCols() - 1,
+                         false);
+}
+
+
+void wxGridSelection::UpdateRows( size_t pos, int numRows )
+{
+    const int first = static_cast<int>(pos);
+
+    if ( numRows > 0 )
     {
-        n--;
-        coords1 = m_blockSelectionTopLeft[n];
-        coords2 = m_blockSelectionBottomRight[n];
-        m_blockSelectionTopLeft.RemoveAt(n);
-        m_blockSelectionBottomRight.RemoveAt(n);
-        if ( !m_grid->GetBatchCount() )
-        {
-            r = m_grid->BlockToDeviceRect( coords1, coords2 );
-            ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
+        // Columns which were entirely selected must remain so, notice that
+        // the number of rows in the grid has been already updated here.
+        Ranges fullCols;
+        GetFullCols(fullCols, m_grid->GetNumberRows() - numRows);
 
-#ifdef __WXMAC__
-            ((wxWindow *)m_grid->m_gridWin)->Update();
-#endif
+        size_t n = FindBand(first);
+
+        // If rows are inserted inside a band, it grows to contain them...
+        if ( n < m_bands.size() && m_bands[n]->topRow < first )
+        {
+            m_bands[n]->bottomRow += numRows;
+            n++;
         }
-    }
 
-    // deselect all rows and update the screen
-    if ( m_selectionMode != wxGrid::wxGridSelectColumns )
-    {
-        while ( ( n = m_rowSelection.GetCount() ) > 0)
+        // ...while all the following ones are just shifted.
+        for ( ; n < m_bands.size(); n++ )
         {
-            n--;
-            int row = m_rowSelection[n];
-            m_rowSelection.RemoveAt(n);
-            if ( !m_grid->GetBatchCount() )
-            {
-                r = m_grid->BlockToDeviceRect( wxGridCellCoords( row, 0 ),
-                                               wxGridCellCoords( row, m_grid->GetNumberCols() - 1 ) );
-                ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
+            m_bands[n]->topRow += numRows;
+            m_bands[n]->bottomRow += numRows;
+        }
 
-#ifdef __WXMAC__
-                ((wxWindow *)m_grid->m_gridWin)->Update();
-#endif
-            }
+        for ( n = 0; n < fullCols.size(); n++ )
+        {
+            DoChangeBlock(first, fullCols[n].first,
+                          first + numRows - 1, fullCols[n].last, true);
         }
     }
-
-    // deselect all columns and update the screen
-    if ( m_selectionMode != wxGrid::wxGridSelectRows )
+    else if ( numRows < 0 )
     {
-        while ( ( n = m_colSelection.GetCount() ) > 0)
+        // Remove the deleted rows from all the bands containing them...
+        const int end = first - numRows;
+
+        const size_t start = FindBand(first);
+        size_t n = start;
+
+        RowBands bands;
+        for ( ; n < m_bands.size() && m_bands[n]->topRow < end; n++ )
         {
-            n--;
-            int col = m_colSelection[n];
-            m_colSelection.RemoveAt(n);
-            if ( !m_grid->GetBatchCount() )
-            {
-                r = m_grid->BlockToDeviceRect( wxGridCellCoords( 0, col ),
-                                               wxGridCellCoords( m_grid->GetNumberRows() - 1, col ) );
-                ((wxWindow *)m_grid->m_gridWin)->Refresh( false, &r );
+            RowBand * const band = m_bands[n];
 
-#ifdef __WXMAC__
-                ((wxWindow *)m_grid->m_gridWin)->Update();
-#endif
+            const int top = band->topRow < first ? band->topRow : first;
+            const int bottom = band->bottomRow >= end ? band->bottomRow + numRows
+                                                      : first - 1;
+            if ( top > bottom )
+            {
+                delete band;
+                continue;
             }
+
+            band->topRow = top;
+            band->bottomRow = bottom;
+            AppendBand(bands, band);
         }
-    }
 
-    // One deselection event, indicating deselection of _all_ cells.
-    // (No finer grained events for each of the smaller regions
-    //  deselected above!)
-    wxGridRangeSelectEvent gridEvt( m_grid->GetId(),
-                                    wxEVT_GRID_RANGE_SELECT,
-                                    m_grid,
-                                    wxGridCellCoords( 0, 0 ),
-                                    wxGridCellCoords(
-                                        m_grid->GetNumberRows() - 1,
-                                        m_grid->GetNumberCols() - 1 ),
-                                    false );
+        // ...shift the following ones...
+        for ( size_t i = n; i < m_bands.size(); i++ )
+        {
+            m_bands[i]->topRow += numRows;
+            m_bands[i]->bottomRow += numRows;
+        }
 
-    m_grid->GetEventHandler()->ProcessEvent(gridEvt);
+        // ...and merge the bands which became adjacent.
+        ReplaceBands(start, n, bands);
+    }
 }
 
 
-void wxGridSelection::UpdateRows( size_t pos, int numRows )
+void wxGridSelection::UpdateCols( size_t pos, int numCols )
 {
-    size_t count = m_cellSelection.GetCount();
-    size_t n;
-    for ( n = 0; n < count; n++ )
+    const int first = static_cast<int>(pos);
+
+    if ( numCols > 0 )
     {
-        wxGridCellCoords& coords = m_cellSelection[n];
-        wxCoord row = coords.GetRow();
-        if ((size_t)row >= pos)
+        // Rows which were entirely selected must remain so, notice that the
+        // number of columns in the grid has been already updated here.
+        Ranges fullRows;
+        GetFullRows(fullRows, m_grid->GetNumberCols() - numCols);
+
+        for ( size_t n = 0; n < m_bands.size(); n++ )
         {
-            if (numRows > 0)
+            Ranges& cols = m_bands[n]->cols;
+            for ( size_t i = FindRange(cols, first); i < cols.size(); i++ )
             {
-                // If rows inserted, increase row counter where necessary
-                coords.SetRow(row + numRows);
-            }
-            else if (numRows < 0)
-            {
-                // If rows deleted ...
-                if ((size_t)row >= pos - numRows)
-                {
-                    // ...either decrement row counter (if row still exists)...
-                    coords.SetRow(row + numRows);
-                }
-                else
-                {
-                    // ...or remove the attribute
-                    m_cellSelection.RemoveAt(n);
-                    n--;
-                    count--;
-                }
+                // If columns are inserted inside a range, it grows to contain
+                // them, otherwise it's just shifted.
+                if ( cols[i].first >= first )
+                    cols[i].first += numCols;
+                cols[i].last += numCols;
             }
         }
-    }
 
-    count = m_blockSelectionTopLeft.GetCount();
-    for ( n = 0; n < count; n++ )
+        for ( size_t n = 0; n < fullRows.size(); n++ )
+        {
+            DoChangeBlock(fullRows[n].first, first,
+                          fullRows[n].last, first + numCols - 1, true);
+        }
+    }
+    else if ( numCols < 0 )
     {
-        wxGridCellCoords& coords1 = m_blockSelectionTopLeft[n];
-        wxGridCellCoords& coords2 = m_blockSelectionBottomRight[n];
-        wxCoord row1 = coords1.GetRow();
-        wxCoord row2 = coords2.GetRow();
+        // Remove the deleted columns from all bands and merge the bands which
+        // have the same columns now.
+        const int end = first - numCols;
 
-        if ((size_t)row2 >= pos)
+        RowBands bands;
+        for ( size_t n = 0; n < m_bands.size(); n++ )
         {
-            if (numRows > 0)
+            RowBand * const band = m_bands[n];
+
+            Ranges cols;
+            for ( size_t i = 0; i < band->cols.size(); i++ )
             {
-                // If rows inserted, increase row counter where necessary
-                coords2.SetRow( row2 + numRows );
-                if ((size_t)row1 >= pos)
-                    coords1.SetRow( row1 + numRows );
+                const Range& r = band->cols[i];
+                if ( r.first < first )
+                    AppendRange(cols, r.first, wxMin(r.last, first - 1));
+                if ( r.last >= end )
+                    AppendRange(cols, wxMax(r.first, end) + numCols,
+                                r.last + numCols);
             }
-            else if (numRows < 0)
-            {
-                // If rows deleted ...
-                if ((size_t)row2 >= pos - numRows)
-                {
-                    // ...either decrement row counter (if row still exists)...
-                    coords2.SetRow( row2 + numRows );
-                    if ((size_t)row1 >= pos)
-                        coords1.SetRow( wxMax(row1 + numRows, (int)pos) );
 
-                }
-                else
-                {
-                    if ((size_t)row1 >= pos)
-                    {
-                        // ...or remove the attribute
-                        m_blockSelectionTopLeft.RemoveAt(n);
-                        m_blockSelectionBottomRight.RemoveAt(n);
-                        n--;
-                        count--;
-                    }
-                    else
-                        coords2.SetRow( pos );
-                }
-            }
+            band->cols.swap(cols);
+            AppendBand(bands, band);
         }
+
+        m_bands.swap(bands);
     }
+}
+
+// ----------------------------------------------------------------------------
+// selection in the old format
+// ----------------------------------------------------------------------------
+
+wxGridCellCoordsArray wxGridSelection::GetCellSelection() const
+{
+    wxGridCellCoordsArray cells;
+    if ( m_selectionMode != wxGrid::wxGridSelectCells )
+        return cells;
 
-    count = m_rowSelection.GetCount();
-    for ( n = 0; n < count; n++ )
+    for ( size_t n = 0; n < m_bands.size(); n++ )
     {
-    int  rowOrCol_ = m_rowSelection[n];
-
-      if ((size_t) rowOrCol_ >= pos)
-      {
-          if ( numRows > 0 )
-          {
-              m_rowSelection[n] += numRows;
-          }
-          else if ( numRows < 0 )
-          {
-              if ((size_t)rowOrCol_ >= (pos - numRows))
-                  m_rowSelection[n] += numRows;
-              else
-              {
-                  m_rowSelection.RemoveAt( n );
-                  n--;
-                  count--;
-              }
-          }
-      }
+        const RowBand * const band = m_bands[n];
+        if ( band->topRow != band->bottomRow )
+            continue;
+
+        for ( size_t i = 0; i < band->cols.size(); i++ )
+        {
+            if ( band->cols[i].first == band->cols[i].last )
+                cells.Add(wxGridCellCoords(band->topRow, band->cols[i].first));
+        }
     }
-    // No need to touch selected columns, unless we removed _all_
-    // rows, in this case, we remove all columns from the selection.
 
-    if ( !m_grid->GetNumberRows() )
-        m_colSelection.Clear();
+    return cells;
 }
 
+wxGridCellCoordsArray wxGridSelection::GetBlockSelectionTopLeft() const
+{
+    wxGridCellCoordsArray coords;
+    if ( m_selectionMode != wxGrid::wxGridSelectCells )
+        return coords;
 
-void wxGridSelection::UpdateCols( size_t pos, int numCols )
+    for ( size_t n = 0; n < m_bands.size(); n++ )
+    {
+        const RowBand * const band = m_bands[n];
+        for ( size_t i = 0; i < band->cols.size(); i++ )
+        {
+            if ( band->topRow != band->bottomRow ||
+                    band->cols[i].first != band->cols[i].last )
+                coords.Add(wxGridCellCoords(band->topRow, band->cols[i].first));
+        }
+    }
+
+    return coords;
+}
+
+wxGridCellCoordsArray wxGridSelection::GetBlockSelectionBottomRight() const
 {
-    size_t count = m_cellSelection.GetCount();
-    size_t n;
+    wxGridCellCoordsArray coords;
+    if ( m_selectionMode != wxGrid::wxGridSelectCells )
+        return coords;
 
-    for ( n = 0; n < count; n++ )
+    for ( size_t n = 0; n < m_bands.size(); n++ )
     {
-        wxGridCellCoords& coords = m_cellSelection[n];
-        wxCoord col = coords.GetCol();
-        if ((size_t)col >= pos)
+        const RowBand * const band = m_bands[n];
+        for ( size_t i = 0; i < band->cols.size(); i++ )
         {
-            if (numCols > 0)
-            {
-                // If rows inserted, increase row counter where necessary
-                coords.SetCol(col + numCols);
-            }
-            else if (numCols < 0)
-            {
-                // If rows deleted ...
-                if ((size_t)col >= pos - numCols)
-                {
-                    // ...either decrement row counter (if row still exists)...
-                    coords.SetCol(col + numCols);
-                }
-                else
-                {
-                    // ...or remove the attribute
-                    m_cellSelection.RemoveAt(n);
-                    n--;
-                    count--;
-                }
-            }
+            if ( band->topRow != band->bottomRow ||
+                    band->cols[i].first != band->cols[i].last )
+                coords.Add(wxGridCellCoords(band->bottomRow, band->cols[i].last));
         }
     }
 
-    count = m_blockSelectionTopLeft.GetCount();
-    for ( n = 0; n < count; n++ )
+    return coords;
+}
+
+wxArrayInt wxGridSelection::GetRowSelection() const
+{
+    wxArrayInt rows;
+    if ( m_selectionMode == wxGrid::wxGridSelectColumns )
+        return rows;
+
+    Ranges fullRows;
+    GetFullRows(fullRows, m_grid->GetNumberCols());
+    for ( size_t n = 0; n < fullRows.size(); n++ )
     {
-        wxGridCellCoords& coords1 = m_blockSelectionTopLeft[n];
-        wxGridCellCoords& coords2 = m_blockSelectionBottomRight[n];
-        wxCoord col1 = coords1.GetCol();
-        wxCoord col2 = coords2.GetCol();
+        for ( int row = fullRows[n].first; row <= fullRows[n].last; row++ )
+            rows.Add(row);
+    }
 
-        if ((size_t)col2 >= pos)
-        {
-            if (numCols > 0)
-            {
-                // If rows inserted, increase row counter where necessary
-                coords2.SetCol(col2 + numCols);
-                if ((size_t)col1 >= pos)
-                    coords1.SetCol(col1 + numCols);
-            }
-            else if (numCols < 0)
-            {
-                // If cols deleted ...
-                if ((size_t)col2 >= pos - numCols)
-                {
-                    // ...either decrement col counter (if col still exists)...
-                    coords2.SetCol(col2 + numCols);
-                    if ( (size_t) col1 >= pos)
-                        coords1.SetCol( wxMax(col1 + numCols, (int)pos) );
+    return rows;
+}
 
-                }
-                else
-                {
-                    if ((size_t)col1 >= pos)
-                    {
-                        // ...or remove the attribute
-                        m_blockSelectionTopLeft.RemoveAt(n);
-                        m_blockSelectionBottomRight.RemoveAt(n);
-                        n--;
-                        count--;
-                    }
-                    else
-                        coords2.SetCol(pos);
-                }
-            }
-        }
+wxArrayInt wxGridSelection::GetColSelection() const
+{
+    wxArrayInt cols;
+    if ( m_selectionMode == wxGrid::wxGridSelectRows )
+        return cols;
+
+    Ranges fullCols;
+    GetFullCols(fullCols, m_grid->GetNumberRows());
+    for ( size_t n = 0; n < fullCols.size(); n++ )
+    {
+        for ( int col = fullCols[n].first; col <= fullCols[n].last; col++ )
+            cols.Add(col);
     }
 
-    count = m_colSelection.GetCount();
-    for ( n = 0; n < count; n++ )
+    return cols;
+}
+
+// ============================================================================
+// wxGridBlocks implementation
+// ============================================================================
+
+wxGridBlocks::iterator::iterator(const wxGridSelection* selection, size_t band)
+    : m_selection(selection),
+      m_band(band),
+      m_range(0)
+{
+    UpdateBlock();
+}
+
+void wxGridBlocks::iterator::UpdateBlock()
+{
+    if ( m_selection && m_band < m_selection->m_bands.size() )
     {
-        int   rowOrCol = m_colSelection[n];
+        const wxGridSelection::RowBand * const
+            band = m_selection->m_bands[m_band];
+        const wxGridSelection::Range& cols = band->cols[m_range];
 
-        if ((size_t)rowOrCol >= pos)
-        {
-            if ( numCols > 0 )
-                m_colSelection[n] += numCols;
-            else if ( numCols < 0 )
-            {
-                if ((size_t)rowOrCol >= (pos - numCols))
-                    m_colSelection[n] += numCols;
-                else
-                {
-                    m_colSelection.RemoveAt( n );
-                    n--;
-                    count--;
-                }
-            }
-        }
+        m_block = wxGridBlockCoords(band->topRow, cols.first,
+                                    band->bottomRow, cols.last);
+    }
+    else
+    {
+        m_block = wxGridBlockCoords();
     }
+}
+
+wxGridBlocks::iterator& wxGridBlocks::iterator::operator++()
+{
+    wxCHECK_MSG( m_selection && m_band < m_selection->m_bands.size(), *this,
+                 "can't increment the end iterator" );
+
+    if ( ++m_range == m_selection->m_bands[m_band]->cols.size() )
+    {
+        m_range = 0;
+        m_band++;
+    }
+
+    UpdateBlock();
 
-    // No need to touch selected rows, unless we removed _all_
-    // columns, in this case, we remove all rows from the selection.
-    if ( !m_grid->GetNumberCols() )
-        m_rowSelection.Clear();
+    return *this;
 }
 
-int wxGridSelection::BlockContain( int topRow1, int leftCol1,
-                                   int bottomRow1, int rightCol1,
-                                   int topRow2, int leftCol2,
-                                   int bottomRow2, int rightCol2 )
-// returns 1, if Block1 contains Block2,
-//        -1, if Block2 contains Block1,
-//         0, otherwise
+wxGridBlocks::iterator wxGridBlocks::end() const
 {
-    if ( topRow1 <= topRow2 && bottomRow2 <= bottomRow1 &&
-         leftCol1 <= leftCol2 && rightCol2 <= rightCol1 )
-        return 1;
-    else if ( topRow2 <= topRow1 && bottomRow1 <= bottomRow2 &&
-              leftCol2 <= leftCol1 && rightCol1 <= rightCol2 )
-        return -1;
-
-    return 0;
+    return iterator(m_selection, m_selection ? m_selection->m_bands.size() : 0);
 }
 
 #endif
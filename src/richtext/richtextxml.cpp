@@ -89,7 +89,7 @@ bool wxRichTextXMLHandler::DoLoadFile(wxRichTextBuffer *buffer, wxInputStream& s
     encoding = wxLocale::GetSystemEncodingName();
 #endif
 
-    if (!xmlDoc->Load(stream, encoding))
+    if (!xmlDoc->Load(stream, encoding, wxXMLDOC_USE_ARENA))
     {
         buffer->ResetAndClearCommands();
         success = false;
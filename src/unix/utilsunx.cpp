@@ -285,6 +285,11 @@ bool wxShutdown(int flags)
 
 bool wxPipeInputStream::CanRead() const
 {
+    // we can read if there's something in the put back buffer, e.g. left
+    // there by PeekData(), even if the pipe itself is empty
+    if ( m_wbacksize > m_wbackcur )
+        return true;
+
     if ( m_lasterror == wxSTREAM_EOF )
         return false;
 
@@ -30,6 +30,8 @@
 #include "wx/strconv.h"
 #include "wx/scopedptr.h"
 #include "wx/versioninfo.h"
+#include "wx/vector.h"
+#include "wx/hashmap.h"
 
 #include "expat.h" // from Expat
 
@@ -51,7 +53,7 @@ static bool wxIsWhiteOnly(const wxString& buf);
 wxXmlNode::wxXmlNode(wxXmlNode *parent,wxXmlNodeType type,
                      const wxString& name, const wxString& content,
                      wxXmlAttribute *attrs, wxXmlNode *next, int lineNo)
-    : m_type(type), m_name(name), m_content(content),
+    : m_type(type), m_name(name), m_internedName(NULL), m_content(content),
       m_attrs(attrs), m_parent(parent),
       m_children(NULL), m_next(next),
       m_lineNo(lineNo),
@@ -74,7 +76,7 @@ wxXmlNode::wxXmlNode(wxXmlNode *parent,wxXmlNodeType type,
 wxXmlNode::wxXmlNode(wxXmlNodeType type, const wxString& name,
                      const wxString& content,
                      int lineNo)
-    : m_type(type), m_name(name), m_content(content),
+    : m_type(type), m_name(name), m_internedName(NULL), m_content(content),
       m_attrs(NULL), m_parent(NULL),
       m_children(NULL), m_next(NULL),
       m_lineNo(lineNo), m_noConversion(false)
@@ -125,7 +127,8 @@ void wxXmlNode::DoFree()
 void wxXmlNode::DoCopy(const wxXmlNode& node)
 {
     m_type = node.m_type;
-    m_name = node.m_name;
+    m_name = node.GetName();
+    m_internedName = NULL;
     m_content = node.m_content;
     m_lineNo = node.m_lineNo;
     m_noConversion = node.m_noConversion;
@@ -665,6 +668,304 @@ bool wxIsWhiteOnly(const wxString& buf)
 }
 
 
+//-----------------------------------------------------------------------------
+//  wxXmlArena
+//-----------------------------------------------------------------------------
+
+// The placement new used below can't be used if new is redefined to
+// WXDEBUG_NEW.
+#if wxUSE_MEMORY_TRACING && defined( new )
+    #undef new
+#endif
+
+namespace
+{
+
+// All wxXmlNode and wxXmlAttribute objects are preceded by this header which
+// contains the arena they were allocated from or NULL if they were allocated
+// on the heap. The other union members are only used to ensure that the
+// object following the header is suitably aligned.
+union wxXmlAllocHeader
+{
+    wxXmlArena *arena;
+    void *alignPtr;
+    double alignDouble;
+};
+
+} // anonymous namespace
+
+typedef const char *wxXmlNameKey;
+WX_DECLARE_HASH_MAP(wxXmlNameKey, wxString, wxStringHash, wxStringEqual,
+                    wxXmlInternedNames);
+
+// The arena used by wxXmlDocument::Load() with wxXMLDOC_USE_ARENA: all nodes
+// and attributes of the document are allocated from big memory chunks which
+// are freed all at once when the last of them is deleted, and the element and
+// attribute names are stored only once.
+//
+// The arena is reference counted: each object allocated from it holds a
+// reference to it, as does the document being loaded while it is parsed.
+class wxXmlArena
+{
+public:
+    wxXmlArena() : m_chunks(NULL), m_ptr(NULL), m_end(NULL), m_refCount(1) { }
+
+    void IncRef() { m_refCount++; }
+    void DecRef()
+    {
+        if ( !--m_refCount )
+            delete this;
+    }
+
+    // Return the name, converted to wxString, which remains valid for as long
+    // as the arena itself is alive.
+    const wxString *Intern(wxMBConv *conv, const char *name);
+
+    wxXmlNode *CreateNode(wxMBConv *conv,
+                          wxXmlNodeType type,
+                          const char *name,
+                          const wxString& content,
+                          int lineNo);
+    wxXmlAttribute *CreateAttribute(wxMBConv *conv,
+                                    const char *name,
+                                    const wxString& value);
+
+    // Allocate memory for an object from the given arena or from the heap if
+    // it's NULL and free it, used by the operators new and delete.
+    static void *AllocObject(wxXmlArena *arena, size_t size);
+    static void FreeObject(void *buf);
+
+    // Allocate memory for an object from the heap, returning NULL on failure.
+    static void *AllocObjectNoThrow(size_t size);
+
+private:
+    ~wxXmlArena();
+
+    // Allocate memory from the current chunk, allocating a new one if needed.
+    void *Alloc(size_t size);
+
+    enum
+    {
+        // Alignment of all the allocated blocks.
+        Align = sizeof(wxXmlAllocHeader),
+
+        // Size of a single chunk, bigger blocks get a chunk of their own.
+        ChunkSize = 32*1024
+    };
+
+    // The chunks form a linked list, the pointer to the previous one is
+    // stored in the beginning of each of them.
+    char *m_chunks;
+
+    // The free space in the current chunk.
+    char *m_ptr,
+         *m_end;
+
+    size_t m_refCount;
+
+    wxXmlInternedNames m_names;
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlArena);
+};
+
+wxXmlArena::~wxXmlArena()
+{
+    // Don't bother erasing the names from the map, just make sure they're
+    // destroyed before freeing the memory used by the keys.
+    m_names.clear();
+
+    while ( m_chunks )
+    {
+        char * const prev = *reinterpret_cast<char **>(m_chunks);
+        ::operator delete(m_chunks);
+        m_chunks = prev;
+    }
+}
+
+void *wxXmlArena::Alloc(size_t size)
+{
+    size = (size + Align - 1) & ~(size_t(Align) - 1);
+
+    if ( size > static_cast<size_t>(m_end - m_ptr) )
+    {
+        size_t chunkSize = Align + size;
+        if ( chunkSize < ChunkSize )
+            chunkSize = ChunkSize;
+
+        char * const chunk = static_cast<char *>(::operator new(chunkSize));
+        *reinterpret_cast<char **>(chunk) = m_chunks;
+        m_chunks = chunk;
+
+        m_ptr = chunk + Align;
+        m_end = chunk + chunkSize;
+    }
+
+    void * const buf = m_ptr;
+    m_ptr += size;
+    return buf;
+}
+
+const wxString *wxXmlArena::Intern(wxMBConv *conv, const char *name)
+{
+    wxXmlInternedNames::iterator it = m_names.find(name);
+    if ( it == m_names.end() )
+    {
+        const size_t len = strlen(name) + 1;
+        char * const key = static_cast<char *>(Alloc(len));
+        memcpy(key, name, len);
+
+        it = m_names.insert(
+                wxXmlInternedNames::value_type(key, CharToString(conv, name))
+             ).first;
+    }
+
+    return &it->second;
+}
+
+wxXmlNode *wxXmlArena::CreateNode(wxMBConv *conv,
+                                  wxXmlNodeType type,
+                                  const char *name,
+                                  const wxString& content,
+                                  int lineNo)
+{
+    wxXmlNode * const
+        node = new(AllocObject(this, sizeof(wxXmlNode)))
+                    wxXmlNode(type, wxString(), content, lineNo);
+    node->m_internedName = Intern(conv, name);
+
+    return node;
+}
+
+wxXmlAttribute *wxXmlArena::CreateAttribute(wxMBConv *conv,
+                                            const char *name,
+                                            const wxString& value)
+{
+    wxXmlAttribute * const
+        attr = new(AllocObject(this, sizeof(wxXmlAttribute)))
+                    wxXmlAttribute(wxString(), value);
+    attr->m_internedName = Intern(conv, name);
+
+    return attr;
+}
+
+/* static */
+void *wxXmlArena::AllocObject(wxXmlArena *arena, size_t size)
+{
+    size += sizeof(wxXmlAllocHeader);
+
+    wxXmlAllocHeader * const header = static_cast<wxXmlAllocHeader *>
+        (
+            arena ? arena->Alloc(size) : ::operator new(size)
+        );
+
+    header->arena = arena;
+    if ( arena )
+        arena->IncRef();
+
+    return header + 1;
+}
+
+/* static */
+void *wxXmlArena::AllocObjectNoThrow(size_t size)
+{
+    wxXmlAllocHeader * const header = static_cast<wxXmlAllocHeader *>
+        (
+            ::operator new(size + sizeof(wxXmlAllocHeader), std::nothrow)
+        );
+    if ( !header )
+        return NULL;
+
+    header->arena = NULL;
+
+    return header + 1;
+}
+
+/* static */
+void wxXmlArena::FreeObject(void *buf)
+{
+    if ( !buf )
+        return;
+
+    wxXmlAllocHeader * const header = static_cast<wxXmlAllocHeader *>(buf) - 1;
+    if ( header->arena )
+        header->arena->DecRef();
+    else
+        ::operator delete(header);
+}
+
+void *wxXmlNode::operator new(size_t size)
+{
+    return wxXmlArena::AllocObject(NULL, size);
+}
+
+void wxXmlNode::operator delete(void *buf)
+{
+    wxXmlArena::FreeObject(buf);
+}
+
+void *wxXmlNode::operator new(size_t size, const std::nothrow_t&) throw()
+{
+    return wxXmlArena::AllocObjectNoThrow(size);
+}
+
+void wxXmlNode::operator delete(void *buf, const std::nothrow_t&) throw()
+{
+    wxXmlArena::FreeObject(buf);
+}
+
+#ifdef _WX_WANT_NEW_SIZET_WXCHAR_INT
+void *wxXmlNode::operator new(size_t size,
+                              const wxChar *WXUNUSED(fileName),
+                              int WXUNUSED(lineNum))
+{
+    return wxXmlArena::AllocObject(NULL, size);
+}
+
+void wxXmlNode::operator delete(void *buf,
+                                const wxChar *WXUNUSED(fileName),
+                                int WXUNUSED(lineNum))
+{
+    wxXmlArena::FreeObject(buf);
+}
+#endif // _WX_WANT_NEW_SIZET_WXCHAR_INT
+
+void *wxXmlAttribute::operator new(size_t size)
+{
+    return wxXmlArena::AllocObject(NULL, size);
+}
+
+void wxXmlAttribute::operator delete(void *buf)
+{
+    wxXmlArena::FreeObject(buf);
+}
+
+void *wxXmlAttribute::operator new(size_t size, const std::nothrow_t&) throw()
+{
+    return wxXmlArena::AllocObjectNoThrow(size);
+}
+
+void wxXmlAttribute::operator delete(void *buf, const std::nothrow_t&) throw()
+{
+    wxXmlArena::FreeObject(buf);
+}
+
+#ifdef _WX_WANT_NEW_SIZET_WXCHAR_INT
+void *wxXmlAttribute::operator new(size_t size,
+                                   const wxChar *WXUNUSED(fileName),
+                                   int WXUNUSED(lineNum))
+{
+    return wxXmlArena::AllocObject(NULL, size);
+}
+
+void wxXmlAttribute::operator delete(void *buf,
+                                     const wxChar *WXUNUSED(fileName),
+                                     int WXUNUSED(lineNum))
+{
+    wxXmlArena::FreeObject(buf);
+}
+#endif // _WX_WANT_NEW_SIZET_WXCHAR_INT
+
+
 struct wxXmlParsingContext
 {
     wxXmlParsingContext()
@@ -673,6 +974,7 @@ struct wxXmlParsingContext
           lastChild(NULL),
           lastAsText(NULL),
           doctype(NULL),
+          arena(NULL),
           removeWhiteOnlyNodes(false)
     {}
 
@@ -684,9 +986,24 @@ struct wxXmlParsingContext
     wxString   encoding;
     wxString   version;
     wxXmlDoctype *doctype;
+    wxXmlArena *arena;                  // the arena to use or NULL
     bool       removeWhiteOnlyNodes;
 };
 
+// creates a new node either on the heap or in the arena if we use one
+static wxXmlNode *CreateNode(wxXmlParsingContext *ctx,
+                             wxXmlNodeType type,
+                             const char *name,
+                             const wxString& content = wxString())
+{
+    const int lineNo = XML_GetCurrentLineNumber(ctx->parser);
+
+    if ( ctx->arena )
+        return ctx->arena->CreateNode(ctx->conv, type, name, content, lineNo);
+
+    return new wxXmlNode(type, CharToString(ctx->conv, name), content, lineNo);
+}
+
 // checks that ctx->lastChild is in consistent state
 #define ASSERT_LAST_CHILD_OK(ctx)                                   \
     wxASSERT( ctx->lastChild == NULL ||                             \
@@ -698,16 +1015,25 @@ extern "C" {
 static void StartElementHnd(void *userData, const char *name, const char **atts)
 {
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
-    wxXmlNode *node = new wxXmlNode(wxXML_ELEMENT_NODE,
-                                    CharToString(ctx->conv, name),
-                                    wxEmptyString,
-                                    XML_GetCurrentLineNumber(ctx->parser));
+    wxXmlNode *node = CreateNode(ctx, wxXML_ELEMENT_NODE, name);
     const char **a = atts;
 
     // add node attributes
     while (*a)
     {
-        node->AddAttribute(CharToString(ctx->conv, a[0]), CharToString(ctx->conv, a[1]));
+        if ( ctx->arena )
+        {
+            node->AddAttribute(ctx->arena->CreateAttribute
+                               (
+                                ctx->conv,
+                                a[0],
+                                CharToString(ctx->conv, a[1])
+                               ));
+        }
+        else
+        {
+            node->AddAttribute(CharToString(ctx->conv, a[0]), CharToString(ctx->conv, a[1]));
+        }
         a += 2;
     }
 
@@ -750,8 +1076,7 @@ static void TextHnd(void *userData, const char *s, int len)
         if (!whiteOnly)
         {
             wxXmlNode *textnode =
-                new wxXmlNode(wxXML_TEXT_NODE, wxS("text"), str,
-                              XML_GetCurrentLineNumber(ctx->parser));
+                CreateNode(ctx, wxXML_TEXT_NODE, "text", str);
 
             ASSERT_LAST_CHILD_OK(ctx);
             ctx->node->InsertChildAfter(textnode, ctx->lastChild);
@@ -765,8 +1090,7 @@ static void StartCdataHnd(void *userData)
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
 
     wxXmlNode *textnode =
-        new wxXmlNode(wxXML_CDATA_SECTION_NODE, wxS("cdata"), wxS(""),
-                      XML_GetCurrentLineNumber(ctx->parser));
+        CreateNode(ctx, wxXML_CDATA_SECTION_NODE, "cdata");
 
     ASSERT_LAST_CHILD_OK(ctx);
     ctx->node->InsertChildAfter(textnode, ctx->lastChild);
@@ -789,9 +1113,8 @@ static void CommentHnd(void *userData, const char *data)
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
 
     wxXmlNode *commentnode =
-        new wxXmlNode(wxXML_COMMENT_NODE,
-                      wxS("comment"), CharToString(ctx->conv, data),
-                      XML_GetCurrentLineNumber(ctx->parser));
+        CreateNode(ctx, wxXML_COMMENT_NODE, "comment",
+                   CharToString(ctx->conv, data));
 
     ASSERT_LAST_CHILD_OK(ctx);
     ctx->node->InsertChildAfter(commentnode, ctx->lastChild);
@@ -804,9 +1127,7 @@ static void PIHnd(void *userData, const char *target, const char *data)
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
 
     wxXmlNode *pinode =
-        new wxXmlNode(wxXML_PI_NODE, CharToString(ctx->conv, target),
-                      CharToString(ctx->conv, data),
-                      XML_GetCurrentLineNumber(ctx->parser));
+        CreateNode(ctx, wxXML_PI_NODE, target, CharToString(ctx->conv, data));
 
     ASSERT_LAST_CHILD_OK(ctx);
     ctx->node->InsertChildAfter(pinode, ctx->lastChild);
@@ -893,7 +1214,17 @@ bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int fl
     wxXmlParsingContext ctx;
     bool done;
     XML_Parser parser = XML_ParserCreate(NULL);
-    wxXmlNode *root = new wxXmlNode(wxXML_DOCUMENT_NODE, wxEmptyString);
+
+    wxXmlNode *root;
+    if ( flags & wxXMLDOC_USE_ARENA )
+    {
+        ctx.arena = new wxXmlArena;
+        root = ctx.arena->CreateNode(NULL, wxXML_DOCUMENT_NODE, "", wxString(), -1);
+    }
+    else
+    {
+        root = new wxXmlNode(wxXML_DOCUMENT_NODE, wxEmptyString);
+    }
 
     ctx.encoding = wxS("UTF-8"); // default in absence of encoding=""
     ctx.conv = NULL;
@@ -946,6 +1277,10 @@ bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int fl
         delete root;
     }
 
+    // the arena is now kept alive by the nodes allocated from it
+    if ( ctx.arena )
+        ctx.arena->DecRef();
+
     XML_ParserFree(parser);
 #if !wxUSE_UNICODE
     if ( ctx.conv )
@@ -959,290 +1294,1148 @@ bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int fl
 
 
 //-----------------------------------------------------------------------------
-//  wxXmlDocument saving routines
+//  wxXmlReader
 //-----------------------------------------------------------------------------
 
-// helpers for XML generation
-namespace
+struct wxXmlReaderContext
 {
+    wxXmlReaderContext(wxXmlReader *reader_, XML_Parser parser_, int flags)
+        : reader(reader_),
+          parser(parser_),
+          atts(NULL),
+          depth(0),
+          removeWhiteOnlyNodes((flags & wxXMLDOC_KEEP_WHITESPACE_NODES) == 0),
+          readSubtree(false),
+          stopped(false),
+          subtreeDepth(0),
+          subtreeRoot(NULL)
+    {}
 
-// write string to output:
-bool OutputString(wxOutputStream& stream,
-                  const wxString& str,
-                  wxMBConv *convMem,
-                  wxMBConv *convFile)
-{
-    if (str.empty())
-        return true;
+    ~wxXmlReaderContext() { delete subtreeRoot; }
 
-#if wxUSE_UNICODE
-    wxUnusedVar(convMem);
-    if ( !convFile )
-        convFile = &wxConvUTF8;
+    void StartElement(const char *name, const char **attrs);
+    void EndElement(const char *name);
+    void Text(const char *s, int len);
+    void StartCdata();
+    void EndCdata();
+    void Comment(const char *data);
+    void PI(const char *target, const char *data);
 
-    const wxScopedCharBuffer buf(str.mb_str(*convFile));
-    if ( !buf.length() )
-    {
-        // conversion failed, can't write this string in an XML file in this
-        // (presumably non-UTF-8) encoding
-        return false;
-    }
+    // passes the text collected since the last callback to the reader
+    void FlushText();
 
-    stream.Write(buf, buf.length());
-#else // !wxUSE_UNICODE
-    if ( convFile && convMem )
+    // the names of the last elements seen at each depth: element names are
+    // typically repeated many times and are converted only once this way
+    struct ElementName
     {
-        wxString str2(str.wc_str(*convMem), *convFile);
-        stream.Write(str2.mb_str(), str2.length());
-    }
-    else // no conversions to do
-    {
-        stream.Write(str.mb_str(), str.length());
-    }
-#endif // wxUSE_UNICODE/!wxUSE_UNICODE
-
-    return stream.IsOk();
-}
-
-enum EscapingMode
-{
-    Escape_Text,
-    Escape_Attribute
+        wxCharBuffer utf8;
+        wxString     name;
+    };
+    wxVector<ElementName> names;
+
+    wxXmlReader *reader;
+    XML_Parser   parser;
+    const char **atts;                  // only non-NULL in OnStartElement()
+    wxMemoryBuffer text;                // UTF-8 text not passed to the reader
+    int          depth;
+    bool         removeWhiteOnlyNodes;
+    bool         readSubtree;           // set by ReadSubtree()
+    bool         stopped;               // set by Stop()
+
+    // when reading a subtree, all the events are forwarded to the handlers
+    // used by wxXmlDocument::Load() until we get back to subtreeDepth
+    int          subtreeDepth;
+    wxXmlNode   *subtreeRoot;           // the parent of the subtree or NULL
+    wxXmlParsingContext subtreeCtx;
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlReaderContext);
 };
 
-// Same as above, but create entities first.
-// Translates '<' to "&lt;", '>' to "&gt;" and so on, according to the spec:
-// http://www.w3.org/TR/2000/WD-xml-c14n-20000119.html#charescaping
-bool OutputEscapedString(wxOutputStream& stream,
-                         const wxString& str,
-                         wxMBConv *convMem,
-                         wxMBConv *convFile,
-                         EscapingMode mode)
+void wxXmlReaderContext::FlushText()
 {
-    wxString escaped;
-    escaped.reserve(str.length());
+    const size_t len = text.GetDataLen();
+    if ( !len )
+        return;
 
-    for ( wxString::const_iterator i = str.begin(); i != str.end(); ++i )
-    {
-        const wxChar c = *i;
+    const char * const s = static_cast<const char *>(text.GetData());
 
-        switch ( c )
+    // check for whitespace before converting the text as it is often skipped
+    bool skip = removeWhiteOnlyNodes;
+    for ( size_t n = 0; skip && n < len; n++ )
+    {
+        switch ( s[n] )
         {
-            case wxS('<'):
-                escaped.append(wxS("&lt;"));
-                break;
-            case wxS('>'):
-                escaped.append(wxS("&gt;"));
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
                 break;
-            case wxS('&'):
-                escaped.append(wxS("&amp;"));
-                break;
-            case wxS('\r'):
-                escaped.append(wxS("&#xD;"));
-                break;
-            default:
-                if ( mode == Escape_Attribute )
-                {
-                    switch ( c )
-                    {
-                        case wxS('"'):
-                            escaped.append(wxS("&quot;"));
-                            break;
-                        case wxS('\t'):
-                            escaped.append(wxS("&#x9;"));
-                            break;
-                        case wxS('\n'):
-                            escaped.append(wxS("&#xA;"));
-                            break;
-                        default:
-                            escaped.append(c);
-                    }
 
-                }
-                else
-                {
-                    escaped.append(c);
-                }
+            default:
+                skip = false;
         }
     }
 
-    return OutputString(stream, escaped, convMem, convFile);
-}
+    if ( !skip )
+        reader->OnText(CharToString(NULL, s, len));
 
-bool OutputIndentation(wxOutputStream& stream,
-                       int indent,
-                       wxMBConv *convMem,
-                       wxMBConv *convFile,
-                       const wxString& eol)
-{
-    wxString str(eol);
-    str += wxString(indent, wxS(' '));
-    return OutputString(stream, str, convMem, convFile);
+    text.Clear();
 }
 
-bool OutputNode(wxOutputStream& stream,
-                wxXmlNode *node,
-                int indent,
-                wxMBConv *convMem,
-                wxMBConv *convFile,
-                int indentstep,
-                const wxString& eol)
+void wxXmlReaderContext::StartElement(const char *name, const char **attrs)
 {
-    bool rc;
-    switch (node->GetType())
+    depth++;
+
+    if ( subtreeRoot )
     {
-        case wxXML_CDATA_SECTION_NODE:
-            rc = OutputString(stream, wxS("<![CDATA["), convMem, convFile) &&
-                 OutputString(stream, node->GetContent(), convMem, convFile) &&
-                 OutputString(stream, wxS("]]>"), convMem, convFile);
-            break;
+        StartElementHnd(&subtreeCtx, name, attrs);
+        return;
+    }
 
-        case wxXML_TEXT_NODE:
-            if (node->GetNoConversion())
-            {
-                stream.Write(node->GetContent().c_str(), node->GetContent().Length());
-                rc = true;
-            }
-            else
-                rc = OutputEscapedString(stream, node->GetContent(),
-                                     convMem, convFile,
-                                     Escape_Text);
-            break;
+    FlushText();
 
-        case wxXML_ELEMENT_NODE:
-            rc = OutputString(stream, wxS("<"), convMem, convFile) &&
-                 OutputString(stream, node->GetName(), convMem, convFile);
+    if ( names.size() < (size_t)depth )
+        names.push_back(ElementName());
 
-            if ( rc )
-            {
-                for ( wxXmlAttribute *attr = node->GetAttributes();
-                      attr && rc;
-                      attr = attr->GetNext() )
-                {
-                    rc = OutputString(stream,
-                                      wxS(" ") + attr->GetName() +  wxS("=\""),
-                                      convMem, convFile) &&
-                         OutputEscapedString(stream, attr->GetValue(),
-                                             convMem, convFile,
-                                             Escape_Attribute) &&
-                         OutputString(stream, wxS("\""), convMem, convFile);
-                }
-            }
+    ElementName& elementName = names[depth - 1];
+    if ( !elementName.utf8.data() || strcmp(elementName.utf8, name) != 0 )
+    {
+        elementName.utf8 = wxCharBuffer(name);
+        elementName.name = CharToString(NULL, name);
+    }
 
-            if ( node->GetChildren() )
-            {
-                rc = OutputString(stream, wxS(">"), convMem, convFile);
+    atts = attrs;
+    reader->OnStartElement(elementName.name);
+    atts = NULL;
 
-                wxXmlNode *prev = NULL;
-                for ( wxXmlNode *n = node->GetChildren();
-                      n && rc;
-                      n = n->GetNext() )
-                {
-                    if ( indentstep >= 0 && n->GetType() != wxXML_TEXT_NODE )
-                    {
-                        rc = OutputIndentation(stream, indent + indentstep,
-                                               convMem, convFile, eol);
-                    }
+    if ( readSubtree )
+    {
+        readSubtree = false;
 
-                    if ( rc )
-                        rc = OutputNode(stream, n, indent + indentstep,
-                                        convMem, convFile, indentstep, eol);
+        subtreeDepth = depth;
+        subtreeRoot = new wxXmlNode(wxXML_DOCUMENT_NODE, wxEmptyString);
 
-                    prev = n;
-                }
+        subtreeCtx.parser = parser;
+        subtreeCtx.node = subtreeRoot;
+        subtreeCtx.lastChild =
+        subtreeCtx.lastAsText = NULL;
+        subtreeCtx.removeWhiteOnlyNodes = removeWhiteOnlyNodes;
 
-                if ( rc && indentstep >= 0 &&
-                        prev && prev->GetType() != wxXML_TEXT_NODE )
-                {
-                    rc = OutputIndentation(stream, indent, convMem, convFile,
-                                           eol);
-                }
+        StartElementHnd(&subtreeCtx, name, attrs);
+    }
+}
 
-                if ( rc )
-                {
-                    rc = OutputString(stream, wxS("</"), convMem, convFile) &&
-                         OutputString(stream, node->GetName(),
-                                      convMem, convFile) &&
-                         OutputString(stream, wxS(">"), convMem, convFile);
-                }
-            }
-            else // no children, output "<foo/>"
-            {
-                rc = OutputString(stream, wxS("/>"), convMem, convFile);
-            }
-            break;
+void wxXmlReaderContext::EndElement(const char *name)
+{
+    if ( subtreeRoot )
+    {
+        EndElementHnd(&subtreeCtx, name);
 
-        case wxXML_COMMENT_NODE:
-            rc = OutputString(stream, wxS("<!--"), convMem, convFile) &&
-                 OutputString(stream, node->GetContent(), convMem, convFile) &&
-                 OutputString(stream, wxS("-->"), convMem, convFile);
-            break;
+        if ( depth-- == subtreeDepth )
+        {
+            wxXmlNode * const node = subtreeRoot->GetChildren();
+            subtreeRoot->SetChildren(NULL);
+            wxDELETE(subtreeRoot);
 
-        case wxXML_PI_NODE:
-            rc = OutputString(stream, wxS("<?"), convMem, convFile) &&
-                 OutputString(stream, node->GetName(), convMem, convFile) &&
-                 OutputString(stream, wxS(" "), convMem, convFile) &&
-                 OutputString(stream, node->GetContent(), convMem, convFile) &&
-                 OutputString(stream, wxS("?>"), convMem, convFile);
-            break;
+            node->SetParent(NULL);
+            reader->OnSubtree(node);
+        }
 
-        default:
-            wxFAIL_MSG("unsupported node type");
-            rc = false;
+        return;
     }
 
-    return rc;
+    FlushText();
+
+    // names[depth - 1] is the name of this element as it was last set by
+    // StartElement() at this depth
+    wxUnusedVar(name);
+    reader->OnEndElement(names[depth - 1].name);
+
+    depth--;
 }
 
-} // anonymous namespace
+void wxXmlReaderContext::Text(const char *s, int len)
+{
+    if ( subtreeRoot )
+    {
+        TextHnd(&subtreeCtx, s, len);
+        return;
+    }
 
-bool wxXmlDocument::Save(wxOutputStream& stream, int indentstep) const
+    // expat may split the text in several chunks, collect all of them before
+    // passing it to the reader
+    text.AppendData(s, len);
+}
+
+void wxXmlReaderContext::StartCdata()
 {
-    if ( !IsOk() )
-        return false;
+    if ( subtreeRoot )
+    {
+        StartCdataHnd(&subtreeCtx);
+        return;
+    }
 
-    wxScopedPtr<wxMBConv> convMem, convFile;
+    FlushText();
+}
 
-#if wxUSE_UNICODE
-    convFile.reset(new wxCSConv(GetFileEncoding()));
-#else
-    if ( GetFileEncoding().CmpNoCase(GetEncoding()) != 0 )
+void wxXmlReaderContext::EndCdata()
+{
+    if ( subtreeRoot )
     {
-        convFile.reset(new wxCSConv(GetFileEncoding()));
-        convMem.reset(new wxCSConv(GetEncoding()));
+        EndCdataHnd(&subtreeCtx);
+        return;
     }
-    //else: file and in-memory encodings are the same, no conversion needed
-#endif
 
-    wxString dec = wxString::Format(
-                                    wxS("<?xml version=\"%s\" encoding=\"%s\"?>") + m_eol,
-                                    GetVersion(), GetFileEncoding()
-                                   );
-    bool rc = OutputString(stream, dec, convMem.get(), convFile.get());
+    // unlike normal text, CDATA sections are never ignored
+    reader->OnCData(CharToString(NULL, static_cast<const char *>(text.GetData()),
+                                 text.GetDataLen()));
+    text.Clear();
+}
 
-    if ( rc )
+void wxXmlReaderContext::Comment(const char *data)
+{
+    if ( subtreeRoot )
     {
-        const wxString doctype = m_doctype.GetFullString();
-        if ( !doctype.empty() )
-        {
-            rc = OutputString(stream,
-                              wxS("<!DOCTYPE ") + doctype + wxS(">") + m_eol,
-                              convMem.get(), convFile.get());
-        }
+        CommentHnd(&subtreeCtx, data);
+        return;
     }
 
-    wxXmlNode *node = GetDocumentNode();
-    if ( node )
-        node = node->GetChildren();
+    FlushText();
 
-    while( rc && node )
+    reader->OnComment(CharToString(NULL, data));
+}
+
+void wxXmlReaderContext::PI(const char *target, const char *data)
+{
+    if ( subtreeRoot )
     {
-        rc = OutputNode(stream, node, 0, convMem.get(),
-                        convFile.get(), indentstep, m_eol) &&
-             OutputString(stream, m_eol, convMem.get(), convFile.get());
-        node = node->GetNext();
+        PIHnd(&subtreeCtx, target, data);
+        return;
     }
-    return rc;
+
+    FlushText();
+
+    reader->OnProcessingInstruction(CharToString(NULL, target),
+                                    CharToString(NULL, data));
+}
+
+extern "C" {
+static void ReaderStartElementHnd(void *userData, const char *name, const char **atts)
+{
+    static_cast<wxXmlReaderContext *>(userData)->StartElement(name, atts);
+}
+
+static void ReaderEndElementHnd(void *userData, const char *name)
+{
+    static_cast<wxXmlReaderContext *>(userData)->EndElement(name);
+}
+
+static void ReaderTextHnd(void *userData, const char *s, int len)
+{
+    static_cast<wxXmlReaderContext *>(userData)->Text(s, len);
+}
+
+static void ReaderStartCdataHnd(void *userData)
+{
+    static_cast<wxXmlReaderContext *>(userData)->StartCdata();
+}
+
+static void ReaderEndCdataHnd(void *userData)
+{
+    static_cast<wxXmlReaderContext *>(userData)->EndCdata();
+}
+
+static void ReaderCommentHnd(void *userData, const char *data)
+{
+    static_cast<wxXmlReaderContext *>(userData)->Comment(data);
+}
+
+static void ReaderPIHnd(void *userData, const char *target, const char *data)
+{
+    static_cast<wxXmlReaderContext *>(userData)->PI(target, data);
+}
+} // extern "C"
+
+bool wxXmlReader::Parse(const wxString& filename, int flags)
+{
+    wxFileInputStream stream(filename);
+    if (!stream.IsOk())
+        return false;
+    return Parse(stream, flags);
+}
+
+bool wxXmlReader::Parse(wxInputStream& stream, int flags)
+{
+    wxCHECK_MSG( !m_ctx, false, wxS("Parse() can't be called recursively") );
+
+    // use a bigger buffer than Load() as we parse the data directly in it and
+    // don't allocate anything else for it
+    const int BUFSIZE = 65536;
+
+    XML_Parser parser = XML_ParserCreate(NULL);
+    wxXmlReaderContext ctx(this, parser, flags);
+    m_ctx = &ctx;
+
+    XML_SetUserData(parser, &ctx);
+    XML_SetElementHandler(parser, ReaderStartElementHnd, ReaderEndElementHnd);
+    XML_SetCharacterDataHandler(parser, ReaderTextHnd);
+    XML_SetCdataSectionHandler(parser, ReaderStartCdataHnd, ReaderEndCdataHnd);
+    XML_SetCommentHandler(parser, ReaderCommentHnd);
+    XML_SetProcessingInstructionHandler(parser, ReaderPIHnd);
+    XML_SetUnknownEncodingHandler(parser, UnknownEncodingHnd, NULL);
+
+    bool ok = true;
+    bool done;
+    do
+    {
+        void * const buf = XML_GetBuffer(parser, BUFSIZE);
+        if ( !buf )
+        {
+            ok = false;
+            break;
+        }
+
+        const size_t len = stream.Read(buf, BUFSIZE).LastRead();
+        done = len < (size_t)BUFSIZE;
+        if ( !XML_ParseBuffer(parser, (int)len, done) )
+        {
+            // this is not an error if we were asked to stop
+            if ( ctx.stopped )
+                break;
+
+            wxString error(XML_ErrorString(XML_GetErrorCode(parser)),
+                           *wxConvCurrent);
+            wxLogError(_("XML parsing error: '%s' at line %d"),
+                       error.c_str(),
+                       (int)XML_GetCurrentLineNumber(parser));
+            ok = false;
+            break;
+        }
+    } while (!done);
+
+    m_ctx = NULL;
+    XML_ParserFree(parser);
+
+    return ok;
+}
+
+void wxXmlReader::Stop()
+{
+    wxCHECK_RET( m_ctx, wxS("can only be called during Parse()") );
+
+    m_ctx->stopped = true;
+    XML_StopParser(m_ctx->parser, XML_FALSE);
+}
+
+int wxXmlReader::GetLineNumber() const
+{
+    wxCHECK_MSG( m_ctx, -1, wxS("can only be called during Parse()") );
+
+    return (int)XML_GetCurrentLineNumber(m_ctx->parser);
+}
+
+int wxXmlReader::GetDepth() const
+{
+    wxCHECK_MSG( m_ctx, 0, wxS("can only be called during Parse()") );
+
+    return m_ctx->depth;
+}
+
+size_t wxXmlReader::GetAttributeCount() const
+{
+    wxCHECK_MSG( m_ctx && m_ctx->atts, 0,
+                 wxS("can only be called from OnStartElement()") );
+
+    size_t n = 0;
+    while ( m_ctx->atts[2*n] )
+        n++;
+
+    return n;
+}
+
+wxString wxXmlReader::GetAttributeName(size_t n) const
+{
+    wxCHECK_MSG( m_ctx && m_ctx->atts, wxString(),
+                 wxS("can only be called from OnStartElement()") );
+
+    return CharToString(NULL, m_ctx->atts[2*n]);
+}
+
+wxString wxXmlReader::GetAttributeValue(size_t n) const
+{
+    wxCHECK_MSG( m_ctx && m_ctx->atts, wxString(),
+                 wxS("can only be called from OnStartElement()") );
+
+    return CharToString(NULL, m_ctx->atts[2*n + 1]);
+}
+
+bool wxXmlReader::GetAttribute(const wxString& attrName, wxString *value) const
+{
+    wxCHECK_MSG( m_ctx && m_ctx->atts, false,
+                 wxS("can only be called from OnStartElement()") );
+
+    // compare the names in UTF-8 to avoid converting all of them
+    const wxScopedCharBuffer name(attrName.utf8_str());
+    for ( const char **a = m_ctx->atts; *a; a += 2 )
+    {
+        if ( strcmp(*a, name) == 0 )
+        {
+            if ( value )
+                *value = CharToString(NULL, a[1]);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+wxString wxXmlReader::GetAttribute(const wxString& attrName,
+                                   const wxString& defaultVal) const
+{
+    wxString tmp;
+    if ( GetAttribute(attrName, &tmp) )
+        return tmp;
+
+    return defaultVal;
+}
+
+void wxXmlReader::ReadSubtree()
+{
+    wxCHECK_RET( m_ctx && m_ctx->atts,
+                 wxS("can only be called from OnStartElement()") );
+
+    m_ctx->readSubtree = true;
+}
+
+//-----------------------------------------------------------------------------
+//  wxXmlWriter
+//-----------------------------------------------------------------------------
+
+// helpers for XML generation
+namespace
+{
+
+// Masks of the characters which need to be replaced with entities when
+// escaping the text and the attribute values, according to the spec:
+// http://www.w3.org/TR/2000/WD-xml-c14n-20000119.html#charescaping
+//
+// All of these characters are less than 64, so a single bit mask is enough.
+const wxUint64 Escape_None = 0;
+const wxUint64 Escape_Text = (wxULL(1) << '<') |
+                             (wxULL(1) << '>') |
+                             (wxULL(1) << '&') |
+                             (wxULL(1) << '\r');
+const wxUint64 Escape_Attribute = Escape_Text |
+                                  (wxULL(1) << '"') |
+                                  (wxULL(1) << '\t') |
+                                  (wxULL(1) << '\n');
+
+inline bool NeedsEscaping(wxUint64 mask, wxUint32 ch)
+{
+    return ch < 64 && ((mask >> ch) & 1);
+}
+
+// Returns the entity for a character for which NeedsEscaping() is true.
+const char *GetEntity(wxUint32 ch)
+{
+    switch ( ch )
+    {
+        case '<':   return "&lt;";
+        case '>':   return "&gt;";
+        case '&':   return "&amp;";
+        case '\r':  return "&#xD;";
+        case '"':   return "&quot;";
+        case '\t':  return "&#x9;";
+        case '\n':  return "&#xA;";
+    }
+
+    wxFAIL_MSG( "unexpected character to escape" );
+    return "";
+}
+
+// Translates '<' to "&lt;", '>' to "&gt;" and so on, only used when the
+// output needs to be converted.
+wxString EscapeString(const wxString& str, wxUint64 mask)
+{
+    wxString escaped;
+    escaped.reserve(str.length());
+
+    for ( wxString::const_iterator i = str.begin(); i != str.end(); ++i )
+    {
+        const wxChar c = *i;
+        if ( NeedsEscaping(mask, static_cast<wxUint32>(c)) )
+            escaped.append(GetEntity(c));
+        else
+            escaped.append(c);
+    }
+
+    return escaped;
+}
+
+} // anonymous namespace
+
+class wxXmlWriterImpl
+{
+public:
+    wxXmlWriterImpl(wxOutputStream& stream, int indentstep)
+        : m_stream(stream),
+          m_indentstep(indentstep),
+          m_eol(wxS("\n")),
+#if !wxUSE_UNICODE
+          m_encoding(wxS("UTF-8")),
+#endif
+          m_started(false),
+          m_startTagOpen(false),
+          m_ok(true),
+          m_len(0)
+    {
+    }
+
+    ~wxXmlWriterImpl() { Flush(); }
+
+    void SetFileEncoding(const wxString& encoding);
+
+    // Called before writing a child of the current element, or a top level
+    // node if there is none.
+    void BeginChild(bool isText);
+
+    // Called after writing a node completely.
+    void EndChild()
+    {
+        if ( m_open.empty() )
+            PutString(m_eol);
+    }
+
+    void PutNode(const wxXmlNode *node, int indent);
+
+    void PutString(const wxString& str, wxUint64 mask = Escape_None);
+    void PutMarkup(const char *s);
+    void PutIndentation(int indent);
+
+    bool Flush();
+
+
+    struct OpenElement
+    {
+        OpenElement() : lastIsText(false) { }
+
+        wxString name;
+        bool     lastIsText;
+    };
+
+    wxVector<OpenElement> m_open;
+
+    wxOutputStream& m_stream;
+    const int m_indentstep;
+    wxString m_eol;
+
+    // Both conversions are NULL if the strings can be written out directly,
+    // which is the case for UTF-8 output in Unicode build.
+    wxScopedPtr<wxMBConv> m_convMem,
+                          m_convFile;
+#if !wxUSE_UNICODE
+    wxString m_encoding;
+#endif
+
+    bool m_started;         // anything was written
+    bool m_startTagOpen;    // the start tag of the last open element isn't
+                            // closed yet, i.e. attributes can still be added
+    bool m_ok;
+
+private:
+    // Writes the data to the buffer, flushing it if necessary.
+    void Put(const char *s, size_t len);
+
+    // Writes the string data directly when no conversion is needed.
+    void PutBytes(const char *s, size_t len, wxUint64 mask);
+#if wxUSE_UNICODE_WCHAR
+    void PutWide(const wchar_t *s, size_t len, wxUint64 mask);
+    void PutASCII(const wchar_t *s, size_t len);
+    void PutNonASCII(const wchar_t *s, size_t len);
+#endif
+
+    // Writes the string using the conversions.
+    void PutConverted(const wxString& str);
+
+    enum { BufSize = 16384 };
+    char m_buf[BufSize];
+    size_t m_len;
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlWriterImpl);
+};
+
+void wxXmlWriterImpl::SetFileEncoding(const wxString& encoding)
+{
+#if wxUSE_UNICODE
+    if ( encoding.CmpNoCase(wxS("UTF-8")) == 0 ||
+            encoding.CmpNoCase(wxS("UTF8")) == 0 )
+        m_convFile.reset();
+    else
+        m_convFile.reset(new wxCSConv(encoding));
+#else
+    if ( encoding.CmpNoCase(m_encoding) != 0 )
+    {
+        m_convFile.reset(new wxCSConv(encoding));
+        m_convMem.reset(new wxCSConv(m_encoding));
+    }
+    else // file and in-memory encodings are the same, no conversion needed
+    {
+        m_convFile.reset();
+        m_convMem.reset();
+    }
+#endif
+}
+
+bool wxXmlWriterImpl::Flush()
+{
+    if ( m_len )
+    {
+        m_stream.Write(m_buf, m_len);
+        if ( !m_stream.IsOk() )
+            m_ok = false;
+
+        m_len = 0;
+    }
+
+    return m_ok;
+}
+
+void wxXmlWriterImpl::Put(const char *s, size_t len)
+{
+    // Don't write anything more after an error.
+    if ( !m_ok )
+        return;
+
+    if ( len > BufSize - m_len )
+    {
+        Flush();
+
+        if ( len >= BufSize )
+        {
+            m_stream.Write(s, len);
+            if ( !m_stream.IsOk() )
+                m_ok = false;
+            return;
+        }
+    }
+
+    memcpy(m_buf + m_len, s, len);
+    m_len += len;
+}
+
+void wxXmlWriterImpl::PutMarkup(const char *s)
+{
+    if ( m_convFile )
+        PutConverted(wxString::FromAscii(s));
+    else
+        Put(s, strlen(s));
+}
+
+void wxXmlWriterImpl::PutString(const wxString& str, wxUint64 mask)
+{
+    if ( str.empty() )
+        return;
+
+    if ( m_convFile )
+    {
+        PutConverted(mask == Escape_None ? str : EscapeString(str, mask));
+        return;
+    }
+
+#if wxUSE_UNICODE_WCHAR
+    PutWide(str.wc_str(), str.length(), mask);
+#elif wxUSE_UNICODE_UTF8
+    const wxScopedCharBuffer buf(str.utf8_str());
+    PutBytes(buf.data(), buf.length(), mask);
+#else // !wxUSE_UNICODE
+    PutBytes(str.wx_str(), str.length(), mask);
+#endif
+}
+
+void wxXmlWriterImpl::PutBytes(const char *s, size_t len, wxUint64 mask)
+{
+    const char * const end = s + len;
+    while ( s != end )
+    {
+        // Find the longest run of characters not needing escaping: this can be
+        // done byte by byte as all bytes of multibyte UTF-8 sequences are
+        // non-ASCII and so never need to be escaped.
+        const char * const start = s;
+        while ( s != end && !NeedsEscaping(mask, static_cast<unsigned char>(*s)) )
+            ++s;
+
+        Put(start, s - start);
+
+        if ( s == end )
+            break;
+
+        PutMarkup(GetEntity(static_cast<unsigned char>(*s++)));
+    }
+}
+
+#if wxUSE_UNICODE_WCHAR
+
+void wxXmlWriterImpl::PutWide(const wchar_t *s, size_t len, wxUint64 mask)
+{
+    const wchar_t * const end = s + len;
+    while ( s != end )
+    {
+        // ASCII characters not needing escaping are just copied.
+        const wchar_t *start = s;
+        while ( s != end )
+        {
+            const wxUint32 ch = static_cast<wxUint32>(*s);
+            if ( ch >= 0x80 || NeedsEscaping(mask, ch) )
+                break;
+            ++s;
+        }
+
+        PutASCII(start, s - start);
+
+        if ( s == end )
+            break;
+
+        if ( static_cast<wxUint32>(*s) < 0x80 )
+        {
+            PutMarkup(GetEntity(static_cast<wxUint32>(*s++)));
+            continue;
+        }
+
+        // And the other ones are converted to UTF-8 as a whole.
+        start = s;
+        while ( s != end && static_cast<wxUint32>(*s) >= 0x80 )
+            ++s;
+
+        PutNonASCII(start, s - start);
+    }
+}
+
+void wxXmlWriterImpl::PutASCII(const wchar_t *s, size_t len)
+{
+    while ( len )
+    {
+        if ( m_len == BufSize )
+            Flush();
+
+        size_t n = BufSize - m_len;
+        if ( n > len )
+            n = len;
+
+        // This simple loop can be vectorized by the compiler.
+        char * const dst = m_buf + m_len;
+        for ( size_t i = 0; i < n; i++ )
+            dst[i] = static_cast<char>(s[i]);
+
+        m_len += n;
+        s += n;
+        len -= n;
+    }
+}
+
+void wxXmlWriterImpl::PutNonASCII(const wchar_t *s, size_t len)
+{
+    // A single wchar_t never takes more than 4 bytes in UTF-8.
+    static const size_t MAX_UTF8_LEN = 4;
+
+    while ( len )
+    {
+        size_t n = (BufSize - m_len) / MAX_UTF8_LEN;
+        if ( n < 2 )
+        {
+            Flush();
+            continue;
+        }
+
+        if ( n >= len )
+        {
+            n = len;
+        }
+        else if ( sizeof(wchar_t) == 2 && (s[n - 1] & 0xfc00) == 0xd800 )
+        {
+            // Don't split the surrogate pair.
+            n--;
+        }
+
+        const size_t
+            written = wxConvUTF8.FromWChar(m_buf + m_len, BufSize - m_len, s, n);
+        if ( written == wxCONV_FAILED )
+        {
+            // This string can't be represented in UTF-8.
+            m_ok = false;
+            return;
+        }
+
+        m_len += written;
+        s += n;
+        len -= n;
+    }
+}
+
+#endif // wxUSE_UNICODE_WCHAR
+
+void wxXmlWriterImpl::PutConverted(const wxString& str)
+{
+    if ( str.empty() )
+        return;
+
+#if wxUSE_UNICODE
+    const wxScopedCharBuffer buf(str.mb_str(*m_convFile));
+    if ( !buf.length() )
+    {
+        // conversion failed, can't write this string in an XML file in this
+        // (presumably non-UTF-8) encoding
+        m_ok = false;
+        return;
+    }
+
+    Put(buf, buf.length());
+#else // !wxUSE_UNICODE
+    wxString str2(str.wc_str(*m_convMem), *m_convFile);
+    Put(str2.mb_str(), str2.length());
+#endif // wxUSE_UNICODE/!wxUSE_UNICODE
+}
+
+void wxXmlWriterImpl::PutIndentation(int indent)
+{
+    if ( m_convFile )
+    {
+        PutConverted(m_eol + wxString(indent, wxS(' ')));
+        return;
+    }
+
+    PutString(m_eol);
+
+    static const char spaces[] = "                                ";
+    static const int MAX_SPACES = WXSIZEOF(spaces) - 1;
+    for ( ; indent > MAX_SPACES; indent -= MAX_SPACES )
+        Put(spaces, MAX_SPACES);
+    Put(spaces, indent);
+}
+
+void wxXmlWriterImpl::BeginChild(bool isText)
+{
+    m_started = true;
+
+    if ( m_open.empty() )
+        return;
+
+    if ( m_startTagOpen )
+    {
+        PutMarkup(">");
+        m_startTagOpen = false;
+    }
+
+    m_open.back().lastIsText = isText;
+
+    if ( !isText && m_indentstep >= 0 )
+        PutIndentation(static_cast<int>(m_open.size()) * m_indentstep);
+}
+
+void wxXmlWriterImpl::PutNode(const wxXmlNode *node, int indent)
+{
+    switch (node->GetType())
+    {
+        case wxXML_CDATA_SECTION_NODE:
+            PutMarkup("<![CDATA[");
+            PutString(node->GetContent());
+            PutMarkup("]]>");
+            break;
+
+        case wxXML_TEXT_NODE:
+            if (node->GetNoConversion())
+            {
+                Flush();
+                m_stream.Write(node->GetContent().c_str(), node->GetContent().Length());
+            }
+            else
+                PutString(node->GetContent(), Escape_Text);
+            break;
+
+        case wxXML_ELEMENT_NODE:
+            PutMarkup("<");
+            PutString(node->GetName());
+
+            for ( const wxXmlAttribute *attr = node->GetAttributes();
+                  attr;
+                  attr = attr->GetNext() )
+            {
+                PutMarkup(" ");
+                PutString(attr->GetName());
+                PutMarkup("=\"");
+                PutString(attr->GetValue(), Escape_Attribute);
+                PutMarkup("\"");
+            }
+
+            if ( node->GetChildren() )
+            {
+                PutMarkup(">");
+
+                const wxXmlNode *prev = NULL;
+                for ( const wxXmlNode *n = node->GetChildren();
+                      n && m_ok;
+                      n = n->GetNext() )
+                {
+                    if ( m_indentstep >= 0 && n->GetType() != wxXML_TEXT_NODE )
+                        PutIndentation(indent + m_indentstep);
+
+                    PutNode(n, indent + m_indentstep);
+
+                    prev = n;
+                }
+
+                if ( m_indentstep >= 0 &&
+                        prev && prev->GetType() != wxXML_TEXT_NODE )
+                {
+                    PutIndentation(indent);
+                }
+
+                PutMarkup("</");
+                PutString(node->GetName());
+                PutMarkup(">");
+            }
+            else // no children, output "<foo/>"
+            {
+                PutMarkup("/>");
+            }
+            break;
+
+        case wxXML_COMMENT_NODE:
+            PutMarkup("<!--");
+            PutString(node->GetContent());
+            PutMarkup("-->");
+            break;
+
+        case wxXML_PI_NODE:
+            PutMarkup("<?");
+            PutString(node->GetName());
+            PutMarkup(" ");
+            PutString(node->GetContent());
+            PutMarkup("?>");
+            break;
+
+        default:
+            wxFAIL_MSG("unsupported node type");
+            m_ok = false;
+    }
+}
+
+wxXmlWriter::wxXmlWriter(wxOutputStream& stream, int indentstep)
+    : m_impl(new wxXmlWriterImpl(stream, indentstep))
+{
+}
+
+wxXmlWriter::~wxXmlWriter()
+{
+    delete m_impl;
+}
+
+void wxXmlWriter::SetFileType(wxTextFileType fileType)
+{
+    m_impl->m_eol = wxTextBuffer::GetEOL(fileType);
+}
+
+#if !wxUSE_UNICODE
+void wxXmlWriter::SetEncoding(const wxString& enc)
+{
+    m_impl->m_encoding = enc;
+}
+#endif // !wxUSE_UNICODE
+
+bool wxXmlWriter::WriteDeclaration(const wxString& version,
+                                   const wxString& encoding)
+{
+    wxCHECK_MSG( !m_impl->m_started, false,
+                 "XML declaration must be written first" );
+
+    m_impl->SetFileEncoding(encoding);
+    m_impl->m_started = true;
+
+    m_impl->PutString(wxString::Format
+                      (
+                        wxS("<?xml version=\"%s\" encoding=\"%s\"?>"),
+                        version, encoding
+                      ));
+    m_impl->PutString(m_impl->m_eol);
+
+    return m_impl->m_ok;
+}
+
+bool wxXmlWriter::WriteDoctype(const wxXmlDoctype& doctype)
+{
+    wxCHECK_MSG( m_impl->m_open.empty(), false,
+                 "DOCTYPE can't be written inside an element" );
+
+    m_impl->m_started = true;
+
+    const wxString str = doctype.GetFullString();
+    if ( !str.empty() )
+    {
+        m_impl->PutString(wxS("<!DOCTYPE ") + str + wxS(">"));
+        m_impl->PutString(m_impl->m_eol);
+    }
+
+    return m_impl->m_ok;
+}
+
+bool wxXmlWriter::StartElement(const wxString& name)
+{
+    m_impl->BeginChild(false);
+
+    m_impl->PutMarkup("<");
+    m_impl->PutString(name);
+
+    m_impl->m_open.push_back(wxXmlWriterImpl::OpenElement());
+    m_impl->m_open.back().name = name;
+    m_impl->m_startTagOpen = true;
+
+    return m_impl->m_ok;
+}
+
+bool wxXmlWriter::WriteAttribute(const wxString& name, const wxString& value)
+{
+    wxCHECK_MSG( m_impl->m_startTagOpen, false,
+                 "attributes can only be written right after StartElement()" );
+
+    m_impl->PutMarkup(" ");
+    m_impl->PutString(name);
+    m_impl->PutMarkup("=\"");
+    m_impl->PutString(value, Escape_Attribute);
+    m_impl->PutMarkup("\"");
+
+    return m_impl->m_ok;
+}
+
+bool wxXmlWriter::EndElement()
+{
+    wxCHECK_MSG( !m_impl->m_open.empty(), false, "no element to end" );
+
+    if ( m_impl->m_startTagOpen )
+    {
+        m_impl->PutMarkup("/>");
+        m_impl->m_startTagOpen = false;
+    }
+    else // element has children
+    {
+        const wxXmlWriterImpl::OpenElement& element = m_impl->m_open.back();
+
+        if ( m_impl->m_indentstep >= 0 && !element.lastIsText )
+        {
+            m_impl->PutIndentation(static_cast<int>(m_impl->m_open.size() - 1)
+                                    * m_impl->m_indentstep);
+        }
+
+        m_impl->PutMarkup("</");
+        m_impl->PutString(element.name);
+        m_impl->PutMarkup(">");
+    }
+
+    m_impl->m_open.pop_back();
+    m_impl->EndChild();
+
+    return m_impl->m_ok;
+}
+
+bool wxXmlWriter::WriteText(const wxString& text)
+{
+    m_impl->BeginChild(true);
+    m_impl->PutString(text, Escape_Text);
+    m_impl->EndChild();
+
+    return m_impl->m_ok;
+}
+
+bool wxXmlWriter::WriteCData(const wxString& text)
+{
+    m_impl->BeginChild(false);
+    m_impl->PutMarkup("<![CDATA[");
+    m_impl->PutString(text);
+    m_impl->PutMarkup("]]>");
+    m_impl->EndChild();
+
+    return m_impl->m_ok;
+}
+
+bool wxXmlWriter::WriteComment(const wxString& comment)
+{
+    m_impl->BeginChild(false);
+    m_impl->PutMarkup("<!--");
+    m_impl->PutString(comment);
+    m_impl->PutMarkup("-->");
+    m_impl->EndChild();
+
+    return m_impl->m_ok;
+}
+
+bool wxXmlWriter::WriteProcessingInstruction(const wxString& target,
+                                             const wxString& data)
+{
+    m_impl->BeginChild(false);
+    m_impl->PutMarkup("<?");
+    m_impl->PutString(target);
+    m_impl->PutMarkup(" ");
+    m_impl->PutString(data);
+    m_impl->PutMarkup("?>");
+    m_impl->EndChild();
+
+    return m_impl->m_ok;
+}
+
+bool wxXmlWriter::WriteNode(const wxXmlNode *node)
+{
+    wxCHECK_MSG( node, false, "can't write NULL node" );
+
+    m_impl->BeginChild(node->GetType() == wxXML_TEXT_NODE);
+    m_impl->PutNode(node,
+                    static_cast<int>(m_impl->m_open.size()) * m_impl->m_indentstep);
+    m_impl->EndChild();
+
+    return m_impl->m_ok;
+}
+
+int wxXmlWriter::GetDepth() const
+{
+    return static_cast<int>(m_impl->m_open.size());
+}
+
+bool wxXmlWriter::Flush()
+{
+    return m_impl->Flush();
+}
+
+bool wxXmlWriter::IsOk() const
+{
+    return m_impl->m_ok;
+}
+
+//-----------------------------------------------------------------------------
+//  wxXmlDocument saving routines
+//-----------------------------------------------------------------------------
+
+bool wxXmlDocument::Save(wxOutputStream& stream, int indentstep) const
+{
+    if ( !IsOk() )
+        return false;
+
+    wxXmlWriter writer(stream, indentstep);
+    writer.SetFileType(m_fileType);
+#if !wxUSE_UNICODE
+    writer.SetEncoding(GetEncoding());
+#endif
+
+    bool rc = writer.WriteDeclaration(GetVersion(), GetFileEncoding()) &&
+              writer.WriteDoctype(m_doctype);
+
+    wxXmlNode *node = GetDocumentNode();
+    if ( node )
+        node = node->GetChildren();
+
+    while( rc && node )
+    {
+        rc = writer.WriteNode(node);
+        node = node->GetNext();
+    }
+
+    return writer.Flush() && rc;
 }
 
 /*static*/ wxVersionInfo wxXmlDocument::GetLibraryVersionInfo()
@@ -737,7 +737,7 @@ wxXmlDocument *wxXmlResource::DoLoadFile(const wxString& filename)
 #endif
 
     wxScopedPtr<wxXmlDocument> doc(new wxXmlDocument);
-    if (!doc->Load(*stream, encoding))
+    if (!doc->Load(*stream, encoding, wxXMLDOC_USE_ARENA))
     {
         wxLogError(_("Cannot load resources from file '%s'."), filename);
         return NULL;
@@ -20,6 +20,9 @@
 
 #include "archivetest.h"
 #include "wx/zipstrm.h"
+#include "wx/mstream.h"
+#include "wx/scopedptr.h"
+#include "wx/vector.h"
 
 using std::string;
 
@@ -252,4 +255,204 @@ CppUnit::Test *ziptest::makeTest(
 CPPUNIT_TEST_SUITE_REGISTRATION(ziptest);
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ziptest, "archive/zip");
 
+///////////////////////////////////////////////////////////////////////////////
+// Compressing using several threads must produce a normal zip file.
+
+TEST_CASE("wxZipOutputStream::SetMaxThreads", "[zip][threads]")
+{
+    // make the data large enough to be split into many blocks
+    wxString text;
+    for ( int n = 0; text.length() < 1500000; n++ )
+        text << "Line " << n << ": " << (n * 7919) % 1000 << " some text\n";
+
+    const wxCharBuffer data = text.utf8_str();
+
+    wxMemoryOutputStream mos;
+    {
+        wxZipOutputStream zip(mos);
+        zip.SetMaxThreads(4);
+        CHECK( zip.GetMaxThreads() == 4 );
+
+        REQUIRE( zip.PutNextEntry("big.txt") );
+        zip.Write(data, data.length());
+
+        REQUIRE( zip.PutNextEntry("small.txt") );
+        zip.Write("small", 5);
+
+        REQUIRE( zip.Close() );
+    }
+
+    wxMemoryInputStream mis(mos);
+    wxZipInputStream zip(mis);
+
+    wxScopedPtr<wxZipEntry> entry(zip.GetNextEntry());
+    REQUIRE( entry.get() );
+    CHECK( entry->GetName() == "big.txt" );
+    CHECK( entry->GetMethod() == wxZIP_METHOD_DEFLATE );
+    CHECK( entry->GetCompressedSize() < entry->GetSize() / 2 );
+
+    wxMemoryOutputStream unzipped;
+    zip.Read(unzipped);
+    CHECK( zip.Eof() );
+    REQUIRE( unzipped.GetSize() == data.length() );
+
+    wxCharBuffer buf(data.length());
+    unzipped.CopyTo(buf.data(), data.length());
+    CHECK( memcmp(buf, data, data.length()) == 0 );
+
+    entry.reset(zip.GetNextEntry());
+    REQUIRE( entry.get() );
+    CHECK( entry->GetName() == "small.txt" );
+
+    char small[10];
+    CHECK( zip.Read(small, sizeof(small)).LastRead() == 5 );
+    CHECK( memcmp(small, "small", 5) == 0 );
+
+    entry.reset(zip.GetNextEntry());
+    CHECK( !entry.get() );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Changing the compression parameters while writing an entry must not lose
+// any of its data and only take effect for the next entries.
+
+TEST_CASE("wxZipOutputStream::SetMaxThreadsInEntry", "[zip][threads]")
+{
+    wxString text;
+    for ( int n = 0; text.length() < 500000; n++ )
+        text << "Line " << n << ": " << (n * 7919) % 1000 << " some text\n";
+
+    const wxCharBuffer data = text.utf8_str();
+    const size_t half = data.length() / 2;
+
+    wxMemoryOutputStream mos;
+    {
+        wxZipOutputStream zip(mos);
+        zip.SetMaxThreads(4);
+
+        REQUIRE( zip.PutNextEntry("first.txt") );
+        zip.Write(data, half);
+        zip.SetLevel(9);
+        zip.Write(data.data() + half, data.length() - half);
+
+        REQUIRE( zip.PutNextEntry("second.txt") );
+        zip.Write(data, half);
+        zip.SetMaxThreads(2);
+        zip.Write(data.data() + half, data.length() - half);
+
+        REQUIRE( zip.Close() );
+    }
+
+    wxMemoryInputStream mis(mos);
+    wxZipInputStream zip(mis);
+
+    for ( int n = 0; n < 2; n++ )
+    {
+        wxScopedPtr<wxZipEntry> entry(zip.GetNextEntry());
+        REQUIRE( entry.get() );
+
+        wxMemoryOutputStream unzipped;
+        zip.Read(unzipped);
+        CHECK( zip.Eof() );
+        REQUIRE( unzipped.GetSize() == data.length() );
+
+        wxCharBuffer buf(data.length());
+        unzipped.CopyTo(buf.data(), data.length());
+        CHECK( memcmp(buf, data, data.length()) == 0 );
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Entries read from the central directory can be opened by another stream.
+
+TEST_CASE("wxZipInputStream::OpenEntry", "[zip]")
+{
+    static const int NUM_ENTRIES = 50;
+
+    const wxDateTime dt(1, wxDateTime::Feb, 2019, 12, 34, 56);
+
+    // prepend some data to the archive, as done by self-extracting archives
+    wxMemoryOutputStream mos;
+    mos.Write("Not a part of the archive", 25);
+    {
+        wxZipOutputStream zip(mos);
+        for ( int n = 0; n < NUM_ENTRIES; n++ )
+        {
+            REQUIRE( zip.PutNextEntry(wxString::Format("dir/file%d.txt", n),
+                                      dt + wxTimeSpan::Days(n)) );
+            const wxString data = wxString::Format("Contents of the file %d", n);
+            zip.Write(data.mb_str(), data.length());
+        }
+    }
+
+    wxMemoryInputStream catalog(mos);
+    wxZipInputStream zipCatalog(catalog);
+    CHECK( zipCatalog.GetTotalEntries() == NUM_ENTRIES );
+
+    wxVector<wxZipEntry*> entries;
+    for ( wxZipEntry* entry; (entry = zipCatalog.GetNextEntry()) != NULL; )
+        entries.push_back(entry);
+
+    REQUIRE( entries.size() == NUM_ENTRIES );
+    CHECK( zipCatalog.GetNextEntry() == NULL );
+
+    // the stream used for reading the catalog can be used to read the entries
+    // too once it's done
+    {
+        REQUIRE( zipCatalog.OpenEntry(*entries[2]) );
+
+        char buf[64];
+        const size_t len = zipCatalog.Read(buf, sizeof(buf)).LastRead();
+        CHECK( wxString(buf, len) == "Contents of the file 2" );
+    }
+
+    // open the entries in the reverse order
+    for ( int n = NUM_ENTRIES - 1; n >= 0; n-- )
+    {
+        wxZipEntry& entry = *entries[n];
+        CHECK( entry.GetName(wxPATH_UNIX) == wxString::Format("dir/file%d.txt", n) );
+        CHECK( entry.GetDateTime() == dt + wxTimeSpan::Days(n) );
+
+        wxMemoryInputStream mis(mos);
+        wxZipInputStream zip(mis);
+        REQUIRE( zip.OpenEntry(entry) );
+
+        char buf[64];
+        const size_t len = zip.Read(buf, sizeof(buf)).LastRead();
+        CHECK( wxString(buf, len) == wxString::Format("Contents of the file %d", n) );
+    }
+
+    // the functions using the end record must still work after opening an
+    // entry in this way, without affecting reading it
+    {
+        wxMemoryInputStream mis(mos);
+        wxZipInputStream zip(mis);
+        REQUIRE( zip.OpenEntry(*entries[1]) );
+
+        CHECK( zip.GetTotalEntries() == NUM_ENTRIES );
+        CHECK( zip.GetComment().empty() );
+
+        char buf[64];
+        const size_t len = zip.Read(buf, sizeof(buf)).LastRead();
+        CHECK( wxString(buf, len) == "Contents of the file 1" );
+    }
+
+    {
+        wxMemoryInputStream mis(mos);
+        wxZipInputStream zip(mis);
+        REQUIRE( zip.OpenEntry(*entries[1]) );
+
+        char buf[64];
+        const size_t len = zip.Read(buf, sizeof(buf)).LastRead();
+        CHECK( wxString(buf, len) == "Contents of the file 1" );
+
+        wxScopedPtr<wxZipEntry> entry(zip.GetNextEntry());
+        REQUIRE( entry.get() );
+        CHECK( entry->GetName(wxPATH_UNIX) == "dir/file0.txt" );
+    }
+
+    for ( size_t n = 0; n < entries.size(); n++ )
+        delete entries[n];
+}
+
 #endif // wxUSE_STREAMS && wxUSE_ZIPSTREAM
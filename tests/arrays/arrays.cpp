@@ -780,3 +780,40 @@ void ArraysTestCase::IndexFromEnd()
     CPPUNIT_ASSERT_EQUAL( 1, a.Index(1, /*bFromEnd=*/true) );
     CPPUNIT_ASSERT_EQUAL( 2, a.Index(42, /*bFromEnd=*/true) );
 }
+
+#ifdef wxHAS_RVALUE_REF
+
+TEST_CASE("wxArrayString::Move", "[array][move]")
+{
+    wxArrayString a1;
+    a1.push_back("foo");
+    a1.push_back("bar");
+    a1.push_back("baz");
+    const wxString* const data = &a1[0];
+
+    wxArrayString a2(std::move(a1));
+    REQUIRE( a2.size() == 3 );
+    CHECK( a2[1] == "bar" );
+    CHECK( &a2[0] == data );
+    CHECK( a1.empty() );
+
+    a1.push_back("to be freed");
+    a1 = std::move(a2);
+    REQUIRE( a1.size() == 3 );
+    CHECK( a1[2] == "baz" );
+    CHECK( &a1[0] == data );
+    CHECK( a2.empty() );
+
+#if !wxUSE_STD_CONTAINERS
+    // moving unsorted array into a sorted one must still sort it
+    wxSortedArrayString sorted;
+    wxArrayString& base = sorted;
+    base = std::move(a1);
+    REQUIRE( sorted.size() == 3 );
+    CHECK( sorted[0] == "bar" );
+    CHECK( sorted[1] == "baz" );
+    CHECK( sorted[2] == "foo" );
+#endif // !wxUSE_STD_CONTAINERS
+}
+
+#endif // wxHAS_RVALUE_REF
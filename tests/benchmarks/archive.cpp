@@ -0,0 +1,352 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/archive.cpp
+// Purpose:     Compression and archive streams benchmarks
+// Author:      wxWidgets team
+// Created:     2019-09-16
+// Copyright:   (c) 2019 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+
+#include "wx/mstream.h"
+#include "wx/tarstrm.h"
+#include "wx/utils.h"
+#include "wx/zipstrm.h"
+#include "wx/zstream.h"
+
+// ----------------------------------------------------------------------------
+// test data
+// ----------------------------------------------------------------------------
+
+// Default size of the data to compress, can be changed with -p option.
+static const size_t DEFAULT_DATA_SIZE = 1024*1024;
+
+// Size of each file in the archives.
+static const size_t FILE_SIZE = 16*1024;
+
+// Return the size of the data to use.
+static size_t GetDataSize()
+{
+    const long size = Bench::GetNumericParameter();
+    return size > 0 ? static_cast<size_t>(size) : DEFAULT_DATA_SIZE;
+}
+
+// Return the text-like data which compresses reasonably well but not too well.
+static const wxCharBuffer& GetTestData()
+{
+    static wxCharBuffer s_data;
+    if ( !s_data.length() )
+    {
+        static const char* const words[] =
+        {
+            "lorem", "ipsum", "dolor", "sit", "amet", "consectetur",
+            "adipiscing", "elit", "sed", "do", "eiusmod", "tempor",
+            "incididunt", "ut", "labore", "et", "dolore", "magna", "aliqua",
+        };
+
+        const size_t size = GetDataSize();
+        s_data.extend(size);
+
+        char* p = s_data.data();
+        char* const end = p + size;
+
+        // use a simple LCG to have reproducible data
+        unsigned seed = 17;
+        while ( p < end )
+        {
+            seed = seed*1103515245 + 12345;
+            const char* word = words[(seed >> 16) % WXSIZEOF(words)];
+            while ( *word && p < end )
+                *p++ = *word++;
+
+            if ( p < end )
+                *p++ = (seed >> 8) % 16 ? ' ' : '\n';
+        }
+    }
+
+    return s_data;
+}
+
+// Get the contents of the memory output stream as a buffer.
+static wxCharBuffer GetStreamData(wxMemoryOutputStream& mos)
+{
+    const size_t size = mos.GetSize();
+
+    wxCharBuffer buf(size);
+    mos.CopyTo(buf.data(), size);
+
+    return buf;
+}
+
+// Read everything from the stream and return the number of bytes read.
+static size_t ReadAll(wxInputStream& is)
+{
+    char buf[8192];
+
+    size_t total = 0;
+    while ( is.Read(buf, sizeof(buf)).LastRead() )
+        total += is.LastRead();
+
+    return total;
+}
+
+// Return the name of the n-th entry in the archive.
+static wxString GetEntryName(int n)
+{
+    return wxString::Format("dir%d/file%d.txt", n % 10, n);
+}
+
+// Write the test data into the given archive as a number of files.
+static bool WriteArchive(wxArchiveOutputStream& arc)
+{
+    const wxCharBuffer& data = GetTestData();
+
+    int n = 0;
+    for ( size_t pos = 0; pos < data.length(); pos += FILE_SIZE, n++ )
+    {
+        if ( !arc.PutNextEntry(GetEntryName(n)) )
+            return false;
+
+        const size_t size = wxMin(FILE_SIZE, data.length() - pos);
+        if ( !arc.Write(data.data() + pos, size).IsOk() )
+            return false;
+    }
+
+    return arc.Close();
+}
+
+// Read all entries from the archive and return the total size of the data.
+static size_t ReadArchive(wxArchiveInputStream& arc)
+{
+    size_t total = 0;
+    for ( wxArchiveEntry* entry = arc.GetNextEntry();
+          entry;
+          entry = arc.GetNextEntry() )
+    {
+        total += ReadAll(arc);
+        delete entry;
+    }
+
+    return total;
+}
+
+// ----------------------------------------------------------------------------
+// zlib benchmarks
+// ----------------------------------------------------------------------------
+
+#if wxUSE_ZLIB
+
+static wxCharBuffer gs_zlibData;
+
+static bool ZlibCompressData(wxCharBuffer& compressed)
+{
+    wxMemoryOutputStream mos;
+    {
+        wxZlibOutputStream zos(mos);
+        const wxCharBuffer& data = GetTestData();
+        if ( !zos.Write(data.data(), data.length()).IsOk() || !zos.Close() )
+            return false;
+    }
+
+    compressed = GetStreamData(mos);
+
+    return true;
+}
+
+static bool ZlibInit()
+{
+    return ZlibCompressData(gs_zlibData);
+}
+
+static void ZlibDone()
+{
+    gs_zlibData.reset();
+}
+
+BENCHMARK_FUNC(ZlibCompress)
+{
+    wxCharBuffer compressed;
+    return ZlibCompressData(compressed);
+}
+
+BENCHMARK_FUNC_WITH_INIT(ZlibDecompress, ZlibInit, ZlibDone)
+{
+    wxMemoryInputStream mis(gs_zlibData.data(), gs_zlibData.length());
+    wxZlibInputStream zis(mis);
+
+    return ReadAll(zis) == GetTestData().length();
+}
+
+#endif // wxUSE_ZLIB
+
+// ----------------------------------------------------------------------------
+// ZIP benchmarks
+// ----------------------------------------------------------------------------
+
+#if wxUSE_ZIPSTREAM
+
+static wxCharBuffer gs_zipData;
+
+static bool ZipWriteData(wxCharBuffer& zip)
+{
+    wxMemoryOutputStream mos;
+    {
+        wxZipOutputStream zos(mos);
+        if ( !WriteArchive(zos) )
+            return false;
+    }
+
+    zip = GetStreamData(mos);
+
+    return true;
+}
+
+static bool ZipInit()
+{
+    return ZipWriteData(gs_zipData);
+}
+
+static void ZipDone()
+{
+    gs_zipData.reset();
+}
+
+BENCHMARK_FUNC(ZipWrite)
+{
+    wxCharBuffer zip;
+    return ZipWriteData(zip);
+}
+
+// Write all the test data as a single big entry using the given number of
+// threads for compressing it.
+static bool ZipWriteSingleEntry(int threads)
+{
+    wxMemoryOutputStream mos;
+    wxZipOutputStream zos(mos);
+    zos.SetMaxThreads(threads);
+
+    const wxCharBuffer& data = GetTestData();
+
+    return zos.PutNextEntry("data.txt") &&
+            zos.Write(data.data(), data.length()).IsOk() &&
+                zos.Close();
+}
+
+BENCHMARK_FUNC(ZipWriteSingle)
+{
+    return ZipWriteSingleEntry(1);
+}
+
+BENCHMARK_FUNC(ZipWriteParallel)
+{
+    // use as many threads as there are CPUs
+    return ZipWriteSingleEntry(0);
+}
+
+BENCHMARK_FUNC_WITH_INIT(ZipRead, ZipInit, ZipDone)
+{
+    wxMemoryInputStream mis(gs_zipData.data(), gs_zipData.length());
+    wxZipInputStream zis(mis);
+
+    return ReadArchive(zis) == GetTestData().length();
+}
+
+BENCHMARK_FUNC_WITH_INIT(ZipFindEntry, ZipInit, ZipDone)
+{
+    // find and read an entry in the middle of the archive
+    wxMemoryInputStream mis(gs_zipData.data(), gs_zipData.length());
+    wxZipInputStream zis(mis);
+
+    const wxString name = GetEntryName(zis.GetTotalEntries() / 2);
+
+    wxZipEntry* entry;
+    while ( (entry = zis.GetNextEntry()) != NULL )
+    {
+        const bool found = entry->GetInternalName() == name;
+        delete entry;
+
+        if ( found )
+            return ReadAll(zis) != 0;
+    }
+
+    return false;
+}
+
+// Entry in the middle of gs_zipData, as read from its central directory.
+static wxZipEntry* gs_zipEntry = NULL;
+
+static bool ZipCatalogInit()
+{
+    if ( !ZipInit() )
+        return false;
+
+    wxMemoryInputStream mis(gs_zipData.data(), gs_zipData.length());
+    wxZipInputStream zis(mis);
+
+    const int middle = zis.GetTotalEntries() / 2;
+    for ( int n = 0; n <= middle; n++ )
+    {
+        delete gs_zipEntry;
+        gs_zipEntry = zis.GetNextEntry();
+        if ( !gs_zipEntry )
+            return false;
+    }
+
+    return true;
+}
+
+static void ZipCatalogDone()
+{
+    wxDELETE(gs_zipEntry);
+    ZipDone();
+}
+
+BENCHMARK_FUNC_WITH_INIT(ZipOpenEntry, ZipCatalogInit, ZipCatalogDone)
+{
+    // open an already known entry using a new stream, as wxArchiveFSHandler
+    // does it
+    wxMemoryInputStream mis(gs_zipData.data(), gs_zipData.length());
+    wxZipInputStream zis(mis);
+
+    return zis.OpenEntry(*gs_zipEntry) && ReadAll(zis) == FILE_SIZE;
+}
+
+#endif // wxUSE_ZIPSTREAM
+
+// ----------------------------------------------------------------------------
+// TAR benchmarks
+// ----------------------------------------------------------------------------
+
+#if wxUSE_TARSTREAM
+
+static wxCharBuffer gs_tarData;
+
+static bool TarInit()
+{
+    wxMemoryOutputStream mos;
+    {
+        wxTarOutputStream tos(mos);
+        if ( !WriteArchive(tos) )
+            return false;
+    }
+
+    gs_tarData = GetStreamData(mos);
+
+    return true;
+}
+
+static void TarDone()
+{
+    gs_tarData.reset();
+}
+
+BENCHMARK_FUNC_WITH_INIT(TarRead, TarInit, TarDone)
+{
+    wxMemoryInputStream mis(gs_tarData.data(), gs_tarData.length());
+    wxTarInputStream tis(mis);
+
+    return ReadArchive(tis) == GetTestData().length();
+}
+
+#endif // wxUSE_TARSTREAM
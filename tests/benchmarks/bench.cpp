@@ -17,7 +17,11 @@
 
 #include "wx/app.h"
 #include "wx/cmdline.h"
+#include "wx/ffile.h"
 #include "wx/stopwatch.h"
+#include "wx/textfile.h"
+#include "wx/tokenzr.h"
+#include "wx/vector.h"
 
 #if wxUSE_GUI
     #include "wx/frame.h"
@@ -25,6 +29,18 @@
 
 #include "bench.h"
 
+#include <math.h>
+#include <algorithm>
+
+// use the CPU time stamp counter to count cycles if we can
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    #include <x86intrin.h>
+    #define HAVE_CYCLE_COUNTER
+#elif defined(__VISUALC__) && (defined(_M_IX86) || defined(_M_X64))
+    #include <intrin.h>
+    #define HAVE_CYCLE_COUNTER
+#endif
+
 // ----------------------------------------------------------------------------
 // constants
 // ----------------------------------------------------------------------------
@@ -34,9 +50,194 @@ static const char OPTION_SINGLE = '1';
 
 static const char OPTION_AVG_COUNT = 'a';
 static const char OPTION_NUM_RUNS = 'n';
+static const char OPTION_WARMUP_COUNT = 'w';
 static const char OPTION_NUMERIC_PARAM = 'p';
 static const char OPTION_STRING_PARAM = 's';
 
+static const char OPTION_COMPARE = 'c';
+static const char OPTION_THRESHOLD = 't';
+
+// these options don't have short names
+static const char* const OPTION_CSV = "csv";
+static const char* const OPTION_JSON = "json";
+
+// ----------------------------------------------------------------------------
+// helper classes and functions
+// ----------------------------------------------------------------------------
+
+// Results of running a single benchmark.
+struct BenchResult
+{
+    BenchResult() { cycles = 0; bytes = 0; }
+
+    wxString name;
+
+    // the time taken by a single call of the benchmark function in
+    // nanoseconds for each of the runs of the benchmarking loop
+    wxVector<double> samples;
+
+    // the median number of CPU cycles per call or 0 if not available
+    double cycles;
+
+    // the number of bytes processed by a single call or 0 if unknown
+    size_t bytes;
+};
+
+// Summary statistics of the samples.
+struct BenchStats
+{
+    explicit BenchStats(const wxVector<double>& samples);
+
+    double min,
+           max,
+           mean,
+           median,
+           p95,
+           stddev;
+};
+
+// Return the given percentile of the sorted, non-empty, vector.
+static double GetPercentile(const wxVector<double>& sorted, double percentile)
+{
+    const double pos = (sorted.size() - 1)*percentile/100;
+    const size_t n = static_cast<size_t>(pos);
+    if ( n + 1 >= sorted.size() )
+        return sorted.back();
+
+    return sorted[n] + (sorted[n + 1] - sorted[n])*(pos - n);
+}
+
+BenchStats::BenchStats(const wxVector<double>& samples)
+{
+    min =
+    max =
+    mean =
+    median =
+    p95 =
+    stddev = 0;
+
+    const size_t count = samples.size();
+    if ( !count )
+        return;
+
+    wxVector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+
+    min = sorted.front();
+    max = sorted.back();
+    median = GetPercentile(sorted, 50);
+    p95 = GetPercentile(sorted, 95);
+
+    double sum = 0;
+    for ( size_t n = 0; n < count; n++ )
+        sum += sorted[n];
+    mean = sum / count;
+
+    if ( count > 1 )
+    {
+        double sumSq = 0;
+        for ( size_t n = 0; n < count; n++ )
+            sumSq += (sorted[n] - mean)*(sorted[n] - mean);
+        stddev = sqrt(sumSq / (count - 1));
+    }
+}
+
+// Format the time given in nanoseconds using the appropriate unit.
+static wxString FormatTime(double ns)
+{
+    if ( ns < 1e3 )
+        return wxString::Format("%.1fns", ns);
+    if ( ns < 1e6 )
+        return wxString::Format("%.2fus", ns / 1e3);
+    if ( ns < 1e9 )
+        return wxString::Format("%.2fms", ns / 1e6);
+
+    return wxString::Format("%.2fs", ns / 1e9);
+}
+
+// Return the number of CPU cycles elapsed since some unspecified moment.
+static inline wxUint64 GetCycles()
+{
+#ifdef HAVE_CYCLE_COUNTER
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Compute the z-score of Mann-Whitney U test for the two samples: its
+// absolute value greater than 1.96 means that the difference between them is
+// significant with 95% confidence, and positive values mean that the values
+// in the second sample are greater than in the first one.
+static double MannWhitneyZ(const wxVector<double>& x, const wxVector<double>& y)
+{
+    const size_t nx = x.size(),
+                 ny = y.size();
+    if ( !nx || !ny )
+        return 0;
+
+    // U statistic is the number of pairs in which the value from y is greater
+    // than the value from x, with ties counting as half.
+    double u = 0;
+    for ( size_t i = 0; i < nx; i++ )
+    {
+        for ( size_t j = 0; j < ny; j++ )
+        {
+            if ( y[j] > x[i] )
+                u += 1;
+            else if ( y[j] == x[i] )
+                u += 0.5;
+        }
+    }
+
+    const double mean = nx*ny / 2.,
+                 sigma = sqrt(nx*ny*(nx + ny + 1) / 12.);
+
+    return (u - mean) / sigma;
+}
+
+// Read the results from a file previously created using --csv option.
+static bool ReadResultsFromCSV(const wxString& filename,
+                               wxVector<BenchResult>& results)
+{
+    wxTextFile file;
+    if ( !file.Open(filename) )
+        return false;
+
+    for ( wxString line = file.GetFirstLine();
+          !file.Eof();
+          line = file.GetNextLine() )
+    {
+        // skip the header and any empty lines
+        if ( line.empty() || line.StartsWith("name,") )
+            continue;
+
+        const wxArrayString fields = wxSplit(line, ',', '\0');
+        if ( fields.size() != 9 )
+        {
+            wxFprintf(stderr, "Invalid line \"%s\" in \"%s\".\n",
+                      line, filename);
+            return false;
+        }
+
+        BenchResult result;
+        result.name = fields[0];
+        fields[7].ToCDouble(&result.cycles);
+
+        wxStringTokenizer tk(fields[8], " ");
+        while ( tk.HasMoreTokens() )
+        {
+            double sample;
+            if ( tk.GetNextToken().ToCDouble(&sample) )
+                result.samples.push_back(sample);
+        }
+
+        results.push_back(result);
+    }
+
+    return true;
+}
+
 // ----------------------------------------------------------------------------
 // BenchApp declaration
 // ----------------------------------------------------------------------------
@@ -63,16 +264,42 @@ public:
     int GetNumericParameter() const { return m_numParam; }
     const wxString& GetStringParameter() const { return m_strParam; }
 
+    void SetBytesProcessed(size_t bytes) { m_bytesProcessed = bytes; }
+
 private:
     // list all registered benchmarks
     void ListBenchmarks();
 
+    // run the benchmark and fill in the result, return false on failure
+    bool RunBenchmark(Bench::Function* func, BenchResult& result);
+
+    // write m_results to the file in the corresponding format
+    bool WriteCSV(const wxString& filename) const;
+    bool WriteJSON(const wxString& filename) const;
+
+    // compare the results in the two CSV files, return the exit code
+    int CompareResults(const wxString& oldFile, const wxString& newFile) const;
+
     // command lines options/parameters
     wxSortedArrayString m_toRun;
     long m_numRuns,
          m_avgCount,
+         m_warmupCount,
          m_numParam;
     wxString m_strParam;
+    size_t m_bytesProcessed;
+    wxString m_csvFile,
+             m_jsonFile;
+
+    // files to compare if not empty, benchmarks are not run in this case
+    wxString m_compareOld,
+             m_compareNew;
+
+    // the change in percents considered to be significant when comparing
+    double m_threshold;
+
+    // the results of all benchmarks which have been run
+    wxVector<BenchResult> m_results;
 };
 
 wxIMPLEMENT_APP_CONSOLE(BenchApp);
@@ -93,6 +320,11 @@ wxString Bench::GetStringParameter()
     return wxGetApp().GetStringParameter();
 }
 
+void Bench::SetBytesProcessed(size_t bytes)
+{
+    wxGetApp().SetBytesProcessed(bytes);
+}
+
 // ============================================================================
 // BenchApp implementation
 // ============================================================================
@@ -101,7 +333,10 @@ BenchApp::BenchApp()
 {
     m_avgCount = 10;
     m_numRuns = 10000; // just some default (TODO: switch to time-based one)
+    m_warmupCount = 1;
     m_numParam = 0;
+    m_bytesProcessed = 0;
+    m_threshold = 1.;
 }
 
 bool BenchApp::OnInit()
@@ -149,6 +384,15 @@ void BenchApp::OnInitCmdLine(wxCmdLineParser& parser)
                          m_numRuns
                      ),
                      wxCMD_LINE_VAL_NUMBER);
+    parser.AddOption(OPTION_WARMUP_COUNT,
+                     "warmup",
+                     wxString::Format
+                     (
+                         "number of times to run the benchmarking loop "
+                         "without measuring it first (default: %ld)",
+                         m_warmupCount
+                     ),
+                     wxCMD_LINE_VAL_NUMBER);
     parser.AddOption(OPTION_NUMERIC_PARAM,
                      "num-param",
                      wxString::Format
@@ -164,6 +408,27 @@ void BenchApp::OnInitCmdLine(wxCmdLineParser& parser)
                      "(default: empty)",
                      wxCMD_LINE_VAL_STRING);
 
+    parser.AddLongOption(OPTION_CSV,
+                         "also write the results to the given CSV file",
+                         wxCMD_LINE_VAL_STRING);
+    parser.AddLongOption(OPTION_JSON,
+                         "also write the results to the given JSON file",
+                         wxCMD_LINE_VAL_STRING);
+
+    parser.AddSwitch(OPTION_COMPARE,
+                     "compare",
+                     "compare the results in two CSV files given instead "
+                     "of the benchmark names");
+    parser.AddOption(OPTION_THRESHOLD,
+                     "threshold",
+                     wxString::Format
+                     (
+                         "minimal change in percents reported when comparing "
+                         "(default: %g)",
+                         m_threshold
+                     ),
+                     wxCMD_LINE_VAL_DOUBLE);
+
     parser.AddParam("benchmark name",
                     wxCMD_LINE_VAL_STRING,
                     wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE);
@@ -188,13 +453,33 @@ bool BenchApp::OnCmdLineParsed(wxCmdLineParser& parser)
         return false;
     }
 
+    parser.Found(OPTION_THRESHOLD, &m_threshold);
+    if ( parser.Found(OPTION_COMPARE) )
+    {
+        if ( count != 2 )
+        {
+            wxFprintf(stderr, "Exactly two files must be given to compare.\n");
+
+            return false;
+        }
+
+        m_compareOld = parser.GetParam(0);
+        m_compareNew = parser.GetParam(1);
+
+        return BenchAppBase::OnCmdLineParsed(parser);
+    }
+
     bool numRunsSpecified = false;
     if ( parser.Found(OPTION_AVG_COUNT, &m_avgCount) )
         numRunsSpecified = true;
     if ( parser.Found(OPTION_NUM_RUNS, &m_numRuns) )
         numRunsSpecified = true;
+    if ( parser.Found(OPTION_WARMUP_COUNT, &m_warmupCount) )
+        numRunsSpecified = true;
     parser.Found(OPTION_NUMERIC_PARAM, &m_numParam);
     parser.Found(OPTION_STRING_PARAM, &m_strParam);
+    parser.Found(OPTION_CSV, &m_csvFile);
+    parser.Found(OPTION_JSON, &m_jsonFile);
     if ( parser.Found(OPTION_SINGLE) )
     {
         if ( numRunsSpecified )
@@ -206,6 +491,14 @@ bool BenchApp::OnCmdLineParsed(wxCmdLineParser& parser)
 
         m_avgCount =
         m_numRuns = 1;
+        m_warmupCount = 0;
+    }
+
+    if ( m_avgCount < 1 || m_numRuns < 1 || m_warmupCount < 0 )
+    {
+        wxFprintf(stderr, "Invalid number of runs specified.\n");
+
+        return false;
     }
 
     // construct sorted array for quick verification of benchmark names
@@ -232,8 +525,57 @@ bool BenchApp::OnCmdLineParsed(wxCmdLineParser& parser)
     return BenchAppBase::OnCmdLineParsed(parser);
 }
 
+bool BenchApp::RunBenchmark(Bench::Function* func, BenchResult& result)
+{
+    result.name = func->GetName();
+
+    m_bytesProcessed = 0;
+
+    bool ok = func->Init();
+
+    // run the benchmark a few times first to fill the caches, let the CPU
+    // frequency stabilize and so on
+    for ( long w = 0; ok && w < m_warmupCount; w++ )
+    {
+        for ( long n = 0; n < m_numRuns && ok; n++ )
+        {
+            ok = func->Run();
+        }
+    }
+
+    wxVector<double> cycles;
+    for ( long a = 0; ok && a < m_avgCount; a++ )
+    {
+        const wxUint64 cyclesStart = GetCycles();
+        wxStopWatch sw;
+        for ( long n = 0; n < m_numRuns && ok; n++ )
+        {
+            ok = func->Run();
+        }
+
+        const wxLongLong usec = sw.TimeInMicro();
+        const wxUint64 cyclesEnd = GetCycles();
+
+        result.samples.push_back(usec.ToDouble()*1000 / m_numRuns);
+        cycles.push_back(static_cast<double>(cyclesEnd - cyclesStart) / m_numRuns);
+    }
+
+    func->Done();
+
+    result.bytes = m_bytesProcessed;
+
+#ifdef HAVE_CYCLE_COUNTER
+    result.cycles = BenchStats(cycles).median;
+#endif
+
+    return ok;
+}
+
 int BenchApp::OnRun()
 {
+    if ( !m_compareOld.empty() )
+        return CompareResults(m_compareOld, m_compareNew);
+
     int rc = EXIT_SUCCESS;
     for ( Bench::Function *func = Bench::Function::GetFirst();
           func;
@@ -253,55 +595,218 @@ int BenchApp::OnRun()
         }
 
         wxPrintf("Benchmarking %s%s: ", func->GetName(), params);
+        fflush(stdout);
 
-        long timeMin = LONG_MAX,
-             timeMax = 0,
-             timeTotal = 0;
-        bool ok = func->Init();
-        for ( long a = 0; ok && a < m_avgCount; a++ )
+        BenchResult result;
+        if ( !RunBenchmark(func, result) )
         {
-            wxStopWatch sw;
-            for ( long n = 0; n < m_numRuns && ok; n++ )
+            wxPrintf("ERROR\n");
+            rc = EXIT_FAILURE;
+        }
+        else
+        {
+            const BenchStats stats(result.samples);
+
+            wxPrintf("%s median, %s avg, %s p95, %s stddev "
+                     "(min=%s, max=%s",
+                     FormatTime(stats.median),
+                     FormatTime(stats.mean),
+                     FormatTime(stats.p95),
+                     FormatTime(stats.stddev),
+                     FormatTime(stats.min),
+                     FormatTime(stats.max));
+            if ( result.cycles )
+                wxPrintf(", %.0f cycles", result.cycles);
+            if ( result.bytes && stats.median > 0 )
             {
-                ok = func->Run();
+                // bytes per nanosecond is the same as 1000 MB/s
+                wxPrintf(", %.1f MB/s", result.bytes*1000/stats.median);
             }
+            wxPrintf(")\n");
 
-            sw.Pause();
-
-            const long t = sw.Time();
-            if ( t < timeMin )
-                timeMin = t;
-            if ( t > timeMax )
-                timeMax = t;
-            timeTotal += t;
+            m_results.push_back(result);
         }
 
-        func->Done();
+        fflush(stdout);
+    }
+
+    if ( !m_csvFile.empty() && !WriteCSV(m_csvFile) )
+        rc = EXIT_FAILURE;
+    if ( !m_jsonFile.empty() && !WriteJSON(m_jsonFile) )
+        rc = EXIT_FAILURE;
 
-        if ( !ok )
+    return rc;
+}
+
+bool BenchApp::WriteCSV(const wxString& filename) const
+{
+    wxFFile file(filename, "w");
+    if ( !file.IsOpened() )
+        return false;
+
+    // all times are in nanoseconds
+    wxString csv = "name,median,mean,stddev,p95,min,max,cycles,samples\n";
+    for ( size_t n = 0; n < m_results.size(); n++ )
+    {
+        const BenchResult& result = m_results[n];
+        const BenchStats stats(result.samples);
+
+        csv += wxString::Format("%s,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.0f,",
+                                result.name,
+                                stats.median,
+                                stats.mean,
+                                stats.stddev,
+                                stats.p95,
+                                stats.min,
+                                stats.max,
+                                result.cycles);
+
+        for ( size_t i = 0; i < result.samples.size(); i++ )
         {
-            wxPrintf("ERROR\n");
-            rc = EXIT_FAILURE;
+            if ( i )
+                csv += ' ';
+            csv += wxString::FromCDouble(result.samples[i], 3);
         }
-        else
+
+        csv += '\n';
+    }
+
+    return file.Write(csv) && file.Close();
+}
+
+bool BenchApp::WriteJSON(const wxString& filename) const
+{
+    wxFFile file(filename, "w");
+    if ( !file.IsOpened() )
+        return false;
+
+    wxString strParam(m_strParam);
+    strParam.Replace("\\", "\\\\");
+    strParam.Replace("\"", "\\\"");
+
+    wxString json;
+    json << "{\n"
+         << "  \"build\": \"" << WX_BUILD_OPTIONS_SIGNATURE << "\",\n"
+         << "  \"runs\": " << m_numRuns << ",\n"
+         << "  \"numParam\": " << m_numParam << ",\n"
+         << "  \"strParam\": \"" << strParam << "\",\n"
+         << "  \"unit\": \"ns\",\n"
+         << "  \"benchmarks\": [\n";
+
+    for ( size_t n = 0; n < m_results.size(); n++ )
+    {
+        const BenchResult& result = m_results[n];
+        const BenchStats stats(result.samples);
+
+        json << "    {\n"
+             << "      \"name\": \"" << result.name << "\",\n"
+             << wxString::Format("      \"median\": %s,\n"
+                                 "      \"mean\": %s,\n"
+                                 "      \"stddev\": %s,\n"
+                                 "      \"p95\": %s,\n"
+                                 "      \"min\": %s,\n"
+                                 "      \"max\": %s,\n"
+                                 "      \"cycles\": %s,\n",
+                                 wxString::FromCDouble(stats.median, 3),
+                                 wxString::FromCDouble(stats.mean, 3),
+                                 wxString::FromCDouble(stats.stddev, 3),
+                                 wxString::FromCDouble(stats.p95, 3),
+                                 wxString::FromCDouble(stats.min, 3),
+                                 wxString::FromCDouble(stats.max, 3),
+                                 wxString::FromCDouble(result.cycles, 0))
+             << "      \"samples\": [";
+
+        for ( size_t i = 0; i < result.samples.size(); i++ )
         {
-            wxPrintf("%ldms total, ", timeTotal);
+            if ( i )
+                json << ", ";
+            json << wxString::FromCDouble(result.samples[i], 3);
+        }
+
+        json << "]\n"
+             << "    }" << (n + 1 < m_results.size() ? "," : "") << "\n";
+    }
+
+    json << "  ]\n"
+         << "}\n";
+
+    return file.Write(json) && file.Close();
+}
+
+int
+BenchApp::CompareResults(const wxString& oldFile, const wxString& newFile) const
+{
+    wxVector<BenchResult> oldResults,
+                          newResults;
+    if ( !ReadResultsFromCSV(oldFile, oldResults) ||
+            !ReadResultsFromCSV(newFile, newResults) )
+    {
+        return EXIT_FAILURE;
+    }
+
+    wxPrintf("%-30s %12s %12s %9s\n", "Benchmark", "Old", "New", "Change");
+
+    int regressions = 0;
+    for ( size_t n = 0; n < newResults.size(); n++ )
+    {
+        const BenchResult& resNew = newResults[n];
 
-            long times = m_avgCount;
-            if ( m_avgCount > 2 )
+        const BenchResult* resOld = NULL;
+        for ( size_t i = 0; i < oldResults.size(); i++ )
+        {
+            if ( oldResults[i].name == resNew.name )
             {
-                timeTotal -= timeMin + timeMax;
-                times -= 2;
+                resOld = &oldResults[i];
+                break;
             }
+        }
 
-            wxPrintf("%.2f avg (min=%ld, max=%ld)\n",
-                     (float)timeTotal / times, timeMin, timeMax);
+        const double medianNew = BenchStats(resNew.samples).median;
+        if ( !resOld )
+        {
+            wxPrintf("%-30s %12s %12s\n",
+                     resNew.name, "-", FormatTime(medianNew));
+            continue;
         }
 
-        fflush(stdout);
+        const double medianOld = BenchStats(resOld->samples).median;
+        const double change = medianOld ? (medianNew - medianOld)*100 / medianOld
+                                        : 0;
+
+        // only report the changes which are both big enough to matter and
+        // are statistically significant
+        const char* verdict = "";
+        if ( fabs(change) >= m_threshold &&
+                fabs(MannWhitneyZ(resOld->samples, resNew.samples)) > 1.96 )
+        {
+            if ( change > 0 )
+            {
+                verdict = "REGRESSION";
+                regressions++;
+            }
+            else
+            {
+                verdict = "improvement";
+            }
+        }
+
+        wxString line = wxString::Format("%-30s %12s %12s %+8.1f%% %s",
+                                         resNew.name,
+                                         FormatTime(medianOld),
+                                         FormatTime(medianNew),
+                                         change,
+                                         verdict);
+        line.Trim();
+        wxPrintf("%s\n", line);
     }
 
-    return rc;
+    if ( regressions )
+    {
+        wxPrintf("%d significant regression(s) found.\n", regressions);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
 }
 
 int BenchApp::OnExit()
@@ -93,6 +93,14 @@ long GetNumericParameter();
  */
 wxString GetStringParameter();
 
+/**
+    Set the number of bytes processed by a single call of the benchmark.
+
+    This is typically called from the benchmark initialization function and,
+    if it is, the throughput in MB/s is shown in addition to the timings.
+ */
+void SetBytesProcessed(size_t bytes);
+
 } // namespace Bench
 
 /**
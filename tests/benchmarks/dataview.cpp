@@ -0,0 +1,171 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/dataview.cpp
+// Purpose:     wxDataViewCtrl items lookup benchmarks
+// Author:      wxWidgets team
+// Created:     2019-09-24
+// Copyright:   (c) 2019 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+
+#if wxUSE_DATAVIEWCTRL
+
+#include "wx/app.h"
+#include "wx/dataview.h"
+
+// Default number of items in the tree, can be changed with -p option.
+static const int DEFAULT_NUM_ITEMS = 100000;
+
+// Number of the top level items, all the other ones are their children.
+static const int NUM_CONTAINERS = 100;
+
+// Number of items looked up by a single benchmark iteration.
+static const int NUM_LOOKUPS = 40;
+
+static int GetNumChildren()
+{
+    const long num = Bench::GetNumericParameter();
+    return (num > 0 ? static_cast<int>(num) : DEFAULT_NUM_ITEMS) / NUM_CONTAINERS;
+}
+
+// Two level tree model which doesn't store anything: the items IDs are just
+// their indices, starting from 1, with the containers coming first.
+class BenchDataViewModel : public wxDataViewModel
+{
+public:
+    explicit BenchDataViewModel(int numChildren) : m_numChildren(numChildren) { }
+
+    wxDataViewItem GetChild(int container, int n) const
+    {
+        return GetItem(NUM_CONTAINERS + container*m_numChildren + n);
+    }
+
+    virtual unsigned int GetColumnCount() const wxOVERRIDE { return 1; }
+    virtual wxString GetColumnType(unsigned int) const wxOVERRIDE
+        { return "string"; }
+
+    virtual void GetValue(wxVariant& variant,
+                          const wxDataViewItem& item,
+                          unsigned int) const wxOVERRIDE
+    {
+        variant = wxString::Format("Item %d", GetIndex(item));
+    }
+
+    virtual bool SetValue(const wxVariant&,
+                          const wxDataViewItem&,
+                          unsigned int) wxOVERRIDE
+    {
+        return false;
+    }
+
+    virtual wxDataViewItem GetParent(const wxDataViewItem& item) const wxOVERRIDE
+    {
+        if ( IsContainer(item) )
+            return wxDataViewItem();
+
+        return GetItem((GetIndex(item) - NUM_CONTAINERS) / m_numChildren);
+    }
+
+    virtual bool IsContainer(const wxDataViewItem& item) const wxOVERRIDE
+    {
+        return !item.IsOk() || GetIndex(item) < NUM_CONTAINERS;
+    }
+
+    virtual unsigned int GetChildren(const wxDataViewItem& item,
+                                     wxDataViewItemArray& children) const wxOVERRIDE
+    {
+        if ( !item.IsOk() )
+        {
+            for ( int n = 0; n < NUM_CONTAINERS; n++ )
+                children.push_back(GetItem(n));
+        }
+        else if ( IsContainer(item) )
+        {
+            for ( int n = 0; n < m_numChildren; n++ )
+                children.push_back(GetChild(GetIndex(item), n));
+        }
+
+        return children.size();
+    }
+
+private:
+    static wxDataViewItem GetItem(int n)
+        { return wxDataViewItem(wxUIntToPtr(n + 1)); }
+    static int GetIndex(const wxDataViewItem& item)
+        { return static_cast<int>(wxPtrToUInt(item.GetID())) - 1; }
+
+    const int m_numChildren;
+};
+
+static BenchDataViewModel* gs_model = NULL;
+static wxDataViewCtrl* gs_dvc = NULL;
+
+static bool DataViewInit()
+{
+    gs_dvc = new wxDataViewCtrl(wxTheApp->GetTopWindow(), wxID_ANY);
+    gs_model = new BenchDataViewModel(GetNumChildren());
+    gs_dvc->AssociateModel(gs_model);
+    gs_dvc->AppendTextColumn("Text", 0);
+
+    wxDataViewItemArray containers;
+    gs_model->GetChildren(wxDataViewItem(), containers);
+    for ( size_t n = 0; n < containers.size(); n++ )
+        gs_dvc->Expand(containers[n]);
+
+    return true;
+}
+
+static void DataViewDone()
+{
+    delete gs_dvc;
+    gs_dvc = NULL;
+
+    gs_model->DecRef();
+    gs_model = NULL;
+}
+
+// Return one of the items spread over the entire tree.
+static wxDataViewItem GetLookupItem(int n)
+{
+    const int numChildren = GetNumChildren();
+    const int index = (n*(NUM_CONTAINERS*numChildren - 1)) / (NUM_LOOKUPS - 1);
+
+    return gs_model->GetChild(index / numChildren, index % numChildren);
+}
+
+// Select and unselect items, which requires finding their rows.
+BENCHMARK_FUNC_WITH_INIT(DataViewSelect, DataViewInit, DataViewDone)
+{
+    for ( int n = 0; n < NUM_LOOKUPS; n++ )
+        gs_dvc->Select(GetLookupItem(n));
+
+    const bool ok = gs_dvc->IsSelected(GetLookupItem(NUM_LOOKUPS - 1));
+
+    gs_dvc->UnselectAll();
+
+    return ok;
+}
+
+// Notify the control about changes to the items, as the model would do.
+BENCHMARK_FUNC_WITH_INIT(DataViewItemChanged, DataViewInit, DataViewDone)
+{
+    for ( int n = 0; n < NUM_LOOKUPS; n++ )
+    {
+        if ( !gs_model->ItemChanged(GetLookupItem(n)) )
+            return false;
+    }
+
+    return true;
+}
+
+// Scroll to the items, which requires finding their rows too.
+BENCHMARK_FUNC_WITH_INIT(DataViewEnsureVisible, DataViewInit, DataViewDone)
+{
+    for ( int n = 0; n < NUM_LOOKUPS; n++ )
+        gs_dvc->EnsureVisible(GetLookupItem(n));
+
+    return true;
+}
+
+#endif // wxUSE_DATAVIEWCTRL
@@ -0,0 +1,214 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/events.cpp
+// Purpose:     Events-related benchmarks
+// Author:      wxWidgets team
+// Created:     2019-09-14
+// Copyright:   (c) 2019 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+
+#include "wx/app.h"
+#include "wx/event.h"
+#include "wx/thread.h"
+
+// ----------------------------------------------------------------------------
+// dynamic event handlers dispatch
+// ----------------------------------------------------------------------------
+
+// Event handler with the given number of dynamically bound handlers, each for
+// a different event type, and with the handler for the event used by the
+// benchmark bound first, which is the worst case for the dispatching code.
+class ManyBindingsHandler : public wxEvtHandler
+{
+public:
+    explicit ManyBindingsHandler(int count)
+    {
+        m_handled = 0;
+
+        Bind(ms_eventType, &ManyBindingsHandler::OnEvent, this);
+
+        while ( --count > 0 )
+            Bind(wxNewEventType(), &ManyBindingsHandler::OnOtherEvent, this);
+    }
+
+    static wxEventType GetEventType() { return ms_eventType; }
+
+    int GetHandledCount() const { return m_handled; }
+
+private:
+    void OnEvent(wxEvent& WXUNUSED(event)) { m_handled++; }
+    void OnOtherEvent(wxEvent& WXUNUSED(event)) { }
+
+    static const wxEventType ms_eventType;
+
+    int m_handled;
+};
+
+const wxEventType ManyBindingsHandler::ms_eventType = wxNewEventType();
+
+static ManyBindingsHandler* gs_manyBindingsHandler = NULL;
+
+static bool DoBindMany(int count)
+{
+    gs_manyBindingsHandler = new ManyBindingsHandler(count);
+
+    return true;
+}
+
+static bool Bind10() { return DoBindMany(10); }
+static bool Bind100() { return DoBindMany(100); }
+static bool Bind1000() { return DoBindMany(1000); }
+
+static void UnbindMany()
+{
+    wxDELETE(gs_manyBindingsHandler);
+}
+
+static bool DispatchToManyBindings()
+{
+    wxThreadEvent event(ManyBindingsHandler::GetEventType());
+
+    const int handled = gs_manyBindingsHandler->GetHandledCount();
+    gs_manyBindingsHandler->ProcessEvent(event);
+
+    return gs_manyBindingsHandler->GetHandledCount() == handled + 1;
+}
+
+BENCHMARK_FUNC_WITH_INIT(DispatchDynamic10, Bind10, UnbindMany)
+{
+    return DispatchToManyBindings();
+}
+
+BENCHMARK_FUNC_WITH_INIT(DispatchDynamic100, Bind100, UnbindMany)
+{
+    return DispatchToManyBindings();
+}
+
+BENCHMARK_FUNC_WITH_INIT(DispatchDynamic1000, Bind1000, UnbindMany)
+{
+    return DispatchToManyBindings();
+}
+
+// ----------------------------------------------------------------------------
+// events posted from worker threads
+// ----------------------------------------------------------------------------
+
+#if wxUSE_THREADS
+
+// number of events posted by the worker thread for each benchmark run
+static const int NUM_EVENTS = 1000;
+
+// Event handler receiving the events posted from the worker thread and
+// counting them.
+class EventReceiver : public wxEvtHandler
+{
+public:
+    EventReceiver()
+    {
+        m_received = 0;
+
+        Bind(wxEVT_THREAD, &EventReceiver::OnThreadEvent, this);
+    }
+
+    // Process the pending events until the given number of them is received.
+    void WaitFor(int count)
+    {
+        while ( m_received < count )
+            wxTheApp->ProcessPendingEvents();
+
+        m_received = 0;
+    }
+
+private:
+    void OnThreadEvent(wxEvent& WXUNUSED(event))
+    {
+        m_received++;
+    }
+
+    int m_received;
+};
+
+// Worker thread posting events to the receiver whenever it's told to do it.
+class EventPoster : public wxThread
+{
+public:
+    explicit EventPoster(wxEvtHandler* handler)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_handler(handler)
+    {
+        m_count = 0;
+    }
+
+    // Tell the thread to post the given number of events, or to exit if it's
+    // 0, and return immediately.
+    void Post(int count)
+    {
+        m_count = count;
+        m_go.Post();
+    }
+
+protected:
+    virtual void* Entry() wxOVERRIDE
+    {
+        for ( ;; )
+        {
+            m_go.Wait();
+            if ( !m_count )
+                break;
+
+            for ( int n = 0; n < m_count; n++ )
+                m_handler->QueueEvent(new wxThreadEvent());
+        }
+
+        return NULL;
+    }
+
+private:
+    wxEvtHandler* const m_handler;
+    wxSemaphore m_go;
+    int m_count;
+};
+
+static EventReceiver* gs_receiver = NULL;
+static EventPoster* gs_poster = NULL;
+
+static bool StartPoster()
+{
+    gs_receiver = new EventReceiver;
+    gs_poster = new EventPoster(gs_receiver);
+
+    return gs_poster->Run() == wxTHREAD_NO_ERROR;
+}
+
+static void StopPoster()
+{
+    gs_poster->Post(0);
+    gs_poster->Wait();
+
+    wxDELETE(gs_poster);
+    wxDELETE(gs_receiver);
+}
+
+// Measure the throughput of events posted from another thread: this is the
+// time needed to queue and dispatch NUM_EVENTS events.
+BENCHMARK_FUNC_WITH_INIT(QueueEventThroughput, StartPoster, StopPoster)
+{
+    gs_poster->Post(NUM_EVENTS);
+    gs_receiver->WaitFor(NUM_EVENTS);
+
+    return true;
+}
+
+// Measure the latency of a single event posted from another thread, i.e. the
+// time between the moment it is posted and the moment it is handled.
+BENCHMARK_FUNC_WITH_INIT(QueueEventLatency, StartPoster, StopPoster)
+{
+    gs_poster->Post(1);
+    gs_receiver->WaitFor(1);
+
+    return true;
+}
+
+#endif // wxUSE_THREADS
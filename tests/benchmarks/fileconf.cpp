@@ -0,0 +1,204 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/fileconf.cpp
+// Purpose:     wxFileConfig benchmarks
+// Author:      wxWidgets team
+// Created:     2019-09-16
+// Copyright:   (c) 2019 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+
+#if wxUSE_CONFIG && wxUSE_FILECONFIG
+
+#include "wx/fileconf.h"
+#include "wx/file.h"
+#include "wx/filename.h"
+#include "wx/mstream.h"
+#include "wx/sstream.h"
+
+// Default number of groups in the test file, can be changed with -p option.
+static const int DEFAULT_NUM_GROUPS = 500;
+
+// Number of entries in each group.
+static const int NUM_ENTRIES = 20;
+
+static int GetNumGroups()
+{
+    const long num = Bench::GetNumericParameter();
+    return num > 0 ? static_cast<int>(num) : DEFAULT_NUM_GROUPS;
+}
+
+static wxString GetEntryPath(int group, int entry)
+{
+    return wxString::Format("/Group%d/Entry%d", group, entry);
+}
+
+// Return the contents of a config file with the given number of groups.
+static wxString CreateConfigText(int numGroups)
+{
+    wxString text;
+    text << "; Generated file used by the benchmarks\n"
+            "RootEntry=value\n";
+
+    for ( int g = 0; g < numGroups; g++ )
+    {
+        text << "\n[Group" << g << "]\n";
+        for ( int e = 0; e < NUM_ENTRIES; e++ )
+            text << "Entry" << e << "=Value of the entry " << e << '\n';
+    }
+
+    return text;
+}
+
+// Return the contents of a config file with the same number of entries as
+// above, but all of them in the root group.
+static wxString CreateFlatConfigText(int numGroups)
+{
+    wxString text;
+    for ( int n = numGroups*NUM_ENTRIES - 1; n >= 0; n-- )
+        text << "Entry" << n << "=Value of the entry " << n << '\n';
+
+    return text;
+}
+
+static wxString gs_configText;
+static wxFileConfig* gs_config = NULL;
+
+static bool FileConfigInit()
+{
+    gs_configText = CreateConfigText(GetNumGroups());
+
+    wxStringInputStream sis(gs_configText);
+    gs_config = new wxFileConfig(sis);
+
+    return true;
+}
+
+static void FileConfigDone()
+{
+    wxDELETE(gs_config);
+    gs_configText.clear();
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileConfigLoad, FileConfigInit, FileConfigDone)
+{
+    wxStringInputStream sis(gs_configText);
+    wxFileConfig config(sis);
+
+    return config.GetNumberOfGroups() == static_cast<size_t>(GetNumGroups());
+}
+
+// The same config saved to a temporary file and the config object using it.
+static wxString gs_configFile;
+static wxFileConfig* gs_fileConfig = NULL;
+
+static bool FileConfigFileInit()
+{
+    FileConfigInit();
+
+    gs_configFile = wxFileName::CreateTempFileName("benchconf");
+
+    {
+        wxFile file(gs_configFile, wxFile::write);
+        if ( !file.Write(gs_configText) )
+            return false;
+    }
+
+    gs_fileConfig = new wxFileConfig(wxString(), wxString(), gs_configFile,
+                                     wxString(), wxCONFIG_USE_LOCAL_FILE);
+
+    return true;
+}
+
+static void FileConfigFileDone()
+{
+    wxDELETE(gs_fileConfig);
+    wxRemoveFile(gs_configFile);
+    gs_configFile.clear();
+
+    FileConfigDone();
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileConfigLoadFile, FileConfigFileInit, FileConfigFileDone)
+{
+    wxFileConfig config(wxString(), wxString(), gs_configFile, wxString(),
+                        wxCONFIG_USE_LOCAL_FILE);
+
+    return config.GetNumberOfGroups() == static_cast<size_t>(GetNumGroups());
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileConfigFlush, FileConfigFileInit, FileConfigFileDone)
+{
+    // modify the config to make it dirty, otherwise it wouldn't be written
+    return gs_fileConfig->Write("/RootEntry", "new value") &&
+                gs_fileConfig->Flush();
+}
+
+static wxString gs_flatConfigText;
+
+static bool FileConfigFlatInit()
+{
+    gs_flatConfigText = CreateFlatConfigText(GetNumGroups());
+
+    return true;
+}
+
+static void FileConfigFlatDone()
+{
+    gs_flatConfigText.clear();
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileConfigLoadFlat, FileConfigFlatInit, FileConfigFlatDone)
+{
+    // this checks how long does it take to load many entries in the same group
+    // and also to enumerate them
+    wxStringInputStream sis(gs_flatConfigText);
+    wxFileConfig config(sis);
+
+    wxString name;
+    long cookie;
+    return config.GetFirstEntry(name, cookie) && name == "Entry0";
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileConfigSave, FileConfigInit, FileConfigDone)
+{
+    wxMemoryOutputStream mos;
+    return gs_config->Save(mos);
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileConfigRead, FileConfigInit, FileConfigDone)
+{
+    // read the entries from the groups in the end of the file, which is the
+    // worst case when looking them up sequentially
+    static int s_entry = 0;
+    if ( ++s_entry == NUM_ENTRIES )
+        s_entry = 0;
+
+    wxString value;
+    return gs_config->Read(GetEntryPath(GetNumGroups() - 1, s_entry), &value);
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileConfigLookup, FileConfigInit, FileConfigDone)
+{
+    // look up entries in different groups, as is typically done when reading
+    // the configuration during the program startup
+    static int s_group = 0;
+    if ( ++s_group == GetNumGroups() )
+        s_group = 0;
+
+    return gs_config->HasEntry(GetEntryPath(s_group, s_group % NUM_ENTRIES)) &&
+                !gs_config->HasEntry(GetEntryPath(s_group, NUM_ENTRIES));
+}
+
+BENCHMARK_FUNC_WITH_INIT(FileConfigWrite, FileConfigInit, FileConfigDone)
+{
+    static int s_entry = 0;
+    if ( ++s_entry == NUM_ENTRIES )
+        s_entry = 0;
+
+    return gs_config->Write(GetEntryPath(GetNumGroups() / 2, s_entry),
+                            "New value");
+}
+
+#endif // wxUSE_CONFIG && wxUSE_FILECONFIG
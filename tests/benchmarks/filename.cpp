@@ -0,0 +1,54 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/filename.cpp
+// Purpose:     wxFileName benchmarks
+// Author:      wxWidgets team
+// Created:     2019-09-16
+// Copyright:   (c) 2019 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+
+#include "wx/filename.h"
+
+static const char* const UNIX_PATH = "/usr/local/share/wx/../doc/./wxwidgets/html/index.html";
+static const char* const WIN_PATH = "C:\\Program Files\\wxWidgets\\..\\Samples\\.\\minimal\\minimal.exe";
+
+BENCHMARK_FUNC(FileNameParseUnix)
+{
+    wxFileName fn(UNIX_PATH, wxPATH_UNIX);
+    return fn.GetExt() == "html";
+}
+
+BENCHMARK_FUNC(FileNameParseWindows)
+{
+    wxFileName fn(WIN_PATH, wxPATH_WIN);
+    return fn.GetExt() == "exe";
+}
+
+BENCHMARK_FUNC(FileNameGetFullPath)
+{
+    static const wxFileName fn(UNIX_PATH, wxPATH_UNIX);
+    return !fn.GetFullPath(wxPATH_UNIX).empty();
+}
+
+BENCHMARK_FUNC(FileNameNormalizeDots)
+{
+    wxFileName fn(UNIX_PATH, wxPATH_UNIX);
+    return fn.Normalize(wxPATH_NORM_DOTS, wxString(), wxPATH_UNIX) &&
+            fn.GetDirCount() == 6;
+}
+
+BENCHMARK_FUNC(FileNameMakeRelative)
+{
+    wxFileName fn("/usr/local/share/doc/wxwidgets/html/index.html", wxPATH_UNIX);
+    return fn.MakeRelativeTo("/usr/local/lib/wx", wxPATH_UNIX);
+}
+
+BENCHMARK_FUNC(FileNameSplitPath)
+{
+    wxString path, name, ext;
+    wxFileName::SplitPath(UNIX_PATH, &path, &name, &ext, wxPATH_UNIX);
+
+    return name == "index";
+}
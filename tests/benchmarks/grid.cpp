@@ -0,0 +1,200 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/grid.cpp
+// Purpose:     wxGrid attributes and sizes benchmarks
+// Author:      wxWidgets team
+// Created:     2019-09-20
+// Copyright:   (c) 2019 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+
+#if wxUSE_GRID
+
+#include "wx/app.h"
+#include "wx/grid.h"
+
+// Default number of rows with attributes, can be changed with -p option.
+static const int DEFAULT_NUM_ROWS = 20000;
+
+// Number of attributed columns in each of these rows.
+static const int NUM_ATTR_COLS = 10;
+
+// Size of the area drawn by a single repaint.
+static const int VISIBLE_ROWS = 40;
+static const int VISIBLE_COLS = 20;
+
+static int GetNumRows()
+{
+    const long num = Bench::GetNumericParameter();
+    return num > 0 ? static_cast<int>(num) : DEFAULT_NUM_ROWS;
+}
+
+static wxGridCellAttrProvider* gs_provider = NULL;
+
+static bool GridAttrInit()
+{
+    gs_provider = new wxGridCellAttrProvider;
+
+    // Every other column of the first NUM_ATTR_COLS*2 ones has its own
+    // attribute, as it happens when highlighting cells of a big table.
+    const int numRows = GetNumRows();
+    for ( int row = 0; row < numRows; row++ )
+    {
+        for ( int col = 0; col < NUM_ATTR_COLS; col++ )
+        {
+            wxGridCellAttr* const attr = new wxGridCellAttr;
+            attr->SetAlignment(wxALIGN_RIGHT, wxALIGN_CENTRE);
+            gs_provider->SetAttr(attr, row, 2*col);
+        }
+    }
+
+    return true;
+}
+
+static void GridAttrDone()
+{
+    delete gs_provider;
+    gs_provider = NULL;
+}
+
+// Retrieve the attributes of all cells of the visible area, as done when
+// repainting the grid, scrolling it down on each call.
+BENCHMARK_FUNC_WITH_INIT(GridAttrPaint, GridAttrInit, GridAttrDone)
+{
+    static int s_firstRow = 0;
+
+    const int numRows = GetNumRows();
+    if ( s_firstRow + VISIBLE_ROWS > numRows )
+        s_firstRow = 0;
+
+    int found = 0;
+    for ( int row = s_firstRow; row < s_firstRow + VISIBLE_ROWS; row++ )
+    {
+        for ( int col = 0; col < VISIBLE_COLS; col++ )
+        {
+            wxGridCellAttr* const
+                attr = gs_provider->GetAttr(row, col, wxGridCellAttr::Cell);
+            if ( attr )
+            {
+                found++;
+                attr->DecRef();
+            }
+        }
+    }
+
+    s_firstRow += VISIBLE_ROWS;
+
+    return found == VISIBLE_ROWS*VISIBLE_COLS/2;
+}
+
+// Insert a row in the middle of the grid and delete it again.
+BENCHMARK_FUNC_WITH_INIT(GridAttrInsertRow, GridAttrInit, GridAttrDone)
+{
+    const size_t pos = GetNumRows() / 2;
+    gs_provider->UpdateAttrRows(pos, 1);
+    gs_provider->UpdateAttrRows(pos, -1);
+
+    return true;
+}
+
+// Insert a column without attributes and delete it again.
+BENCHMARK_FUNC_WITH_INIT(GridAttrDeleteCol, GridAttrInit, GridAttrDone)
+{
+    gs_provider->UpdateAttrCols(1, 1);
+    gs_provider->UpdateAttrCols(1, -1);
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// Rows sizes benchmarks
+// ----------------------------------------------------------------------------
+
+// Table with the given number of rows, which doesn't store anything and just
+// returns a few different values for the cells.
+class BenchGridTable : public wxGridTableBase
+{
+public:
+    explicit BenchGridTable(int numRows) : m_numRows(numRows) { }
+
+    virtual int GetNumberRows() wxOVERRIDE { return m_numRows; }
+    virtual int GetNumberCols() wxOVERRIDE { return VISIBLE_COLS; }
+    virtual wxString GetValue(int row, int col) wxOVERRIDE
+        { return wxString::Format("Value %d", (row + col) % 100); }
+    virtual void SetValue(int, int, const wxString&) wxOVERRIDE { }
+
+private:
+    const int m_numRows;
+};
+
+static wxGrid* gs_grid = NULL;
+
+static bool GridSizesInit()
+{
+    gs_grid = new wxGrid(wxTheApp->GetTopWindow(), wxID_ANY);
+    gs_grid->SetTable(new BenchGridTable(GetNumRows()), true);
+
+    // Give a custom height to every tenth row, as auto-sizing would do.
+    gs_grid->BeginBatch();
+    const int numRows = GetNumRows();
+    for ( int row = 0; row < numRows; row += 10 )
+        gs_grid->SetRowSize(row, 2*gs_grid->GetDefaultRowSize());
+    gs_grid->EndBatch();
+
+    return true;
+}
+
+static void GridSizesDone()
+{
+    delete gs_grid;
+    gs_grid = NULL;
+}
+
+// Change the height of the first row, which affects positions of all others.
+BENCHMARK_FUNC_WITH_INIT(GridRowResize, GridSizesInit, GridSizesDone)
+{
+    static bool s_taller = false;
+    s_taller = !s_taller;
+
+    const int height = gs_grid->GetDefaultRowSize();
+    gs_grid->SetRowSize(0, s_taller ? 3*height : 2*height);
+
+    return gs_grid->CellToRect(GetNumRows() - 1, 0).y > 0;
+}
+
+// Find the rows at positions spread over the entire grid.
+BENCHMARK_FUNC_WITH_INIT(GridYToRow, GridSizesInit, GridSizesDone)
+{
+    const int numRows = GetNumRows();
+    const int height = gs_grid->CellToRect(numRows - 1, 0).GetBottom();
+
+    for ( int n = 0; n < VISIBLE_ROWS; n++ )
+    {
+        const int row = gs_grid->YToRow((height / VISIBLE_ROWS)*n);
+        if ( row == wxNOT_FOUND )
+            return false;
+    }
+
+    return true;
+}
+
+// Auto-size a column examining all of its cells.
+BENCHMARK_FUNC_WITH_INIT(GridAutoSizeColumn, GridSizesInit, GridSizesDone)
+{
+    gs_grid->AutoSizeColumn(1, false);
+
+    return gs_grid->GetColSize(1) > 0;
+}
+
+// Auto-size a column examining only some of its cells.
+BENCHMARK_FUNC_WITH_INIT(GridAutoSizeColumnSample, GridSizesInit, GridSizesDone)
+{
+    gs_grid->SetAutoSizeSampleCount(1000);
+    gs_grid->AutoSizeColumn(1, false);
+    gs_grid->SetAutoSizeSampleCount(0);
+
+    return gs_grid->GetColSize(1) > 0;
+}
+
+#endif // wxUSE_GRID
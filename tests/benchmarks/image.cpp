@@ -88,3 +88,13 @@ BENCHMARK_FUNC(ShrinkHighQuality)
 {
     return GetTestImage().Scale(50, 50, wxIMAGE_QUALITY_HIGH).IsOk();
 }
+
+BENCHMARK_FUNC(EnlargeBicubic)
+{
+    return GetTestImage().Scale(300, 300, wxIMAGE_QUALITY_BICUBIC).IsOk();
+}
+
+BENCHMARK_FUNC(ShrinkLanczos)
+{
+    return GetTestImage().Scale(50, 50, wxIMAGE_QUALITY_LANCZOS).IsOk();
+}
@@ -7,6 +7,7 @@
 // Licence:     wxWindows licence
 /////////////////////////////////////////////////////////////////////////////
 
+#include "wx/buffer.h"
 #include "wx/strconv.h"
 #include "wx/string.h"
 
@@ -76,3 +77,149 @@ BENCHMARK_FUNC(UTF16Sys)
     return ConvertToMB(wxCSConv("UTF-16LE"));
 }
 
+
+// ----------------------------------------------------------------------------
+// UTF-8 conversions of texts in different scripts
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+const wchar_t *TEXT_ENGLISH =
+    L"The quick brown fox jumps over the lazy dog, again and again. ";
+
+const wchar_t *TEXT_FRENCH =
+    L"Le c\u0153ur d\u00e9\u00e7u mais l'\u00e2me plut\u00f4t na\u00efve, "
+    L"Lou\u00ffs r\u00eava de crapa\u00fcter en cano\u00eb au del\u00e0 "
+    L"des \u00eeles. ";
+
+const wchar_t *TEXT_RUSSIAN =
+    L"\u0421\u044a\u0435\u0448\u044c \u0436\u0435 \u0435\u0449\u0451 "
+    L"\u044d\u0442\u0438\u0445 \u043c\u044f\u0433\u043a\u0438\u0445 "
+    L"\u0444\u0440\u0430\u043d\u0446\u0443\u0437\u0441\u043a\u0438\u0445 "
+    L"\u0431\u0443\u043b\u043e\u043a, \u0434\u0430 \u0432\u044b\u043f"
+    L"\u0435\u0439 \u0447\u0430\u044e. ";
+
+const wchar_t *TEXT_JAPANESE =
+    L"\u3044\u308d\u306f\u306b\u307b\u3078\u3068 \u3061\u308a\u306c\u308b"
+    L"\u3092 \u308f\u304b\u3088\u305f\u308c\u305d \u3064\u306d\u306a\u3089"
+    L"\u3080\u3002";
+
+// The texts are repeated until they have at least this many characters.
+const size_t UTF8_TEXT_LEN = 65536;
+
+wxCharBuffer gs_utf8;
+wxWCharBuffer gs_wide;
+
+// output buffers for the conversions
+wxCharBuffer gs_utf8Out;
+wxWCharBuffer gs_wideOut;
+
+bool InitUTF8Text(const wxString& sample)
+{
+    wxString text;
+    while ( text.length() < UTF8_TEXT_LEN )
+        text += sample;
+
+    gs_utf8 = text.utf8_str();
+    gs_wide = text.wc_str();
+
+    gs_utf8Out = wxCharBuffer(gs_utf8.length());
+    gs_wideOut = wxWCharBuffer(gs_wide.length());
+
+    // throughput is measured in terms of UTF-8 data for both directions
+    Bench::SetBytesProcessed(gs_utf8.length());
+
+    return gs_utf8.length() && gs_wide.length();
+}
+
+bool InitEnglish() { return InitUTF8Text(TEXT_ENGLISH); }
+bool InitFrench() { return InitUTF8Text(TEXT_FRENCH); }
+bool InitRussian() { return InitUTF8Text(TEXT_RUSSIAN); }
+bool InitJapanese() { return InitUTF8Text(TEXT_JAPANESE); }
+
+bool InitMixed()
+{
+    // mostly English text with some words in the other languages and a
+    // character outside of the BMP
+    wxString text;
+    text << TEXT_ENGLISH << TEXT_ENGLISH << TEXT_ENGLISH
+         << TEXT_FRENCH << TEXT_RUSSIAN << TEXT_JAPANESE
+         << wxString::FromUTF8("\xf0\x9f\x98\x80 ");
+
+    return InitUTF8Text(text);
+}
+
+void DoneUTF8Text()
+{
+    gs_utf8.reset();
+    gs_wide.reset();
+    gs_utf8Out.reset();
+    gs_wideOut.reset();
+}
+
+bool DecodeUTF8()
+{
+    return wxConvUTF8.ToWChar(gs_wideOut.data(), gs_wideOut.length(),
+                              gs_utf8.data(), gs_utf8.length())
+            == gs_wide.length();
+}
+
+bool EncodeUTF8()
+{
+    return wxConvUTF8.FromWChar(gs_utf8Out.data(), gs_utf8Out.length(),
+                                gs_wide.data(), gs_wide.length())
+            == gs_utf8.length();
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(UTF8DecodeEnglish, InitEnglish, DoneUTF8Text)
+{
+    return DecodeUTF8();
+}
+
+BENCHMARK_FUNC_WITH_INIT(UTF8DecodeFrench, InitFrench, DoneUTF8Text)
+{
+    return DecodeUTF8();
+}
+
+BENCHMARK_FUNC_WITH_INIT(UTF8DecodeRussian, InitRussian, DoneUTF8Text)
+{
+    return DecodeUTF8();
+}
+
+BENCHMARK_FUNC_WITH_INIT(UTF8DecodeJapanese, InitJapanese, DoneUTF8Text)
+{
+    return DecodeUTF8();
+}
+
+BENCHMARK_FUNC_WITH_INIT(UTF8DecodeMixed, InitMixed, DoneUTF8Text)
+{
+    return DecodeUTF8();
+}
+
+BENCHMARK_FUNC_WITH_INIT(UTF8EncodeEnglish, InitEnglish, DoneUTF8Text)
+{
+    return EncodeUTF8();
+}
+
+BENCHMARK_FUNC_WITH_INIT(UTF8EncodeFrench, InitFrench, DoneUTF8Text)
+{
+    return EncodeUTF8();
+}
+
+BENCHMARK_FUNC_WITH_INIT(UTF8EncodeRussian, InitRussian, DoneUTF8Text)
+{
+    return EncodeUTF8();
+}
+
+BENCHMARK_FUNC_WITH_INIT(UTF8EncodeJapanese, InitJapanese, DoneUTF8Text)
+{
+    return EncodeUTF8();
+}
+
+BENCHMARK_FUNC_WITH_INIT(UTF8EncodeMixed, InitMixed, DoneUTF8Text)
+{
+    return EncodeUTF8();
+}
@@ -0,0 +1,156 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/regex.cpp
+// Purpose:     wxRegEx benchmarks
+// Author:      wxWidgets team
+// Created:     2019-09-16
+// Copyright:   (c) 2019 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+
+#if wxUSE_REGEX
+
+#include "wx/arrstr.h"
+#include "wx/regex.h"
+
+// Default number of lines in the test text, can be changed with -p option.
+static const int DEFAULT_NUM_LINES = 1000;
+
+static int GetNumLines()
+{
+    const long num = Bench::GetNumericParameter();
+    return num > 0 ? static_cast<int>(num) : DEFAULT_NUM_LINES;
+}
+
+// Return log-like text with an e-mail address in every 10th line.
+static const wxString& GetTestText()
+{
+    static wxString s_text;
+    if ( s_text.empty() )
+    {
+        const int numLines = GetNumLines();
+        for ( int n = 0; n < numLines; n++ )
+        {
+            s_text << "2019-09-16 12:34:56 Line " << n
+                   << ": the quick brown fox jumps over the lazy dog";
+            if ( n % 10 == 9 )
+                s_text << " <user" << n << "@example.com>";
+            s_text << '\n';
+        }
+    }
+
+    return s_text;
+}
+
+static const char* const EMAIL_PATTERN = "[a-z0-9]+@[a-z]+\\.com";
+
+BENCHMARK_FUNC(RegExCompile)
+{
+    wxRegEx re(EMAIL_PATTERN);
+    return re.IsValid();
+}
+
+static wxRegEx* gs_re = NULL;
+
+static bool RegExInit()
+{
+    GetTestText();
+
+    gs_re = new wxRegEx(EMAIL_PATTERN);
+
+    return gs_re->IsValid();
+}
+
+static void RegExDone()
+{
+    wxDELETE(gs_re);
+}
+
+BENCHMARK_FUNC_WITH_INIT(RegExMatchesLine, RegExInit, RegExDone)
+{
+    return !gs_re->Matches("a line of text without any addresses in it");
+}
+
+BENCHMARK_FUNC_WITH_INIT(RegExFindAll, RegExInit, RegExDone)
+{
+    const wxString& text = GetTestText();
+
+    int count = 0;
+    size_t start, len;
+    for ( wxString::const_iterator it = text.begin();
+          gs_re->Matches(wxString(it, text.end())) && gs_re->GetMatch(&start, &len);
+          it += start + len )
+    {
+        count++;
+    }
+
+    return count == GetNumLines() / 10;
+}
+
+BENCHMARK_FUNC_WITH_INIT(RegExIterateAll, RegExInit, RegExDone)
+{
+    wxRegExIterator it(*gs_re, GetTestText());
+
+    int count = 0;
+    while ( it.FindNext() )
+    {
+        count++;
+    }
+
+    return count == GetNumLines() / 10;
+}
+
+BENCHMARK_FUNC_WITH_INIT(RegExReplaceAll, RegExInit, RegExDone)
+{
+    wxString text = GetTestText();
+    return gs_re->ReplaceAll(&text, "<hidden>") == GetNumLines() / 10;
+}
+
+// Apply a number of patterns to every line of the text, as a log filter would.
+static const char* const FILTER_PATTERNS[] =
+{
+    "error: .*",
+    "warning: [a-z]+",
+    "Line [0-9]+: the slow",
+    "connection (refused|reset)",
+    "timeout after [0-9]+ ms",
+    "@example\\.org",
+    "fox jumps over the lazy cat",
+    "[0-9]{4}-[0-9]{2}-[0-9]{2} 23:",
+};
+
+static wxArrayString gs_lines;
+
+static bool RegExFilterInit()
+{
+    gs_lines = wxSplit(GetTestText(), '\n', '\0');
+
+    return true;
+}
+
+static void RegExFilterDone()
+{
+    gs_lines.clear();
+}
+
+BENCHMARK_FUNC_WITH_INIT(RegExFilterLines, RegExFilterInit, RegExFilterDone)
+{
+    wxRegEx re[WXSIZEOF(FILTER_PATTERNS)];
+    for ( size_t n = 0; n < WXSIZEOF(FILTER_PATTERNS); n++ )
+        re[n].Compile(FILTER_PATTERNS[n], wxRE_NOSUB);
+
+    int count = 0;
+    for ( size_t i = 0; i < gs_lines.size(); i++ )
+    {
+        for ( size_t n = 0; n < WXSIZEOF(FILTER_PATTERNS); n++ )
+        {
+            if ( re[n].Matches(gs_lines[i]) )
+                count++;
+        }
+    }
+
+    return count == 0;
+}
+
+#endif // wxUSE_REGEX
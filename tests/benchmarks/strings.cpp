@@ -416,6 +416,122 @@ BENCHMARK_FUNC(CharBuffer)
            wxStrlen(str.wc_str()) == ASCIISTR_LEN;
 }
 
+// ----------------------------------------------------------------------------
+// building strings from many parts
+// ----------------------------------------------------------------------------
+
+static const wxString gs_dir("/usr/local/share");
+static const wxString gs_name("wxwidgets");
+static const wxString gs_ext("html");
+
+BENCHMARK_FUNC(ConcatOperatorPlus)
+{
+    const wxString s = gs_dir + "/doc/" + gs_name + "/index" + '.' + gs_ext;
+    return s.length() == 41;
+}
+
+BENCHMARK_FUNC(ConcatBuilder)
+{
+    wxStringBuilder builder;
+    builder << gs_dir << "/doc/" << gs_name << "/index" << '.' << gs_ext;
+    return builder.Release().length() == 41;
+}
+
+// number of lines in the strings built by the benchmarks below
+static const int BUILD_NUM_LINES = 100;
+
+BENCHMARK_FUNC(BuildStringAppend)
+{
+    wxString s;
+    for ( int n = 0; n < BUILD_NUM_LINES; n++ )
+        s << "Item " << n << ": " << gs_name << '\n';
+    return !s.empty();
+}
+
+BENCHMARK_FUNC(BuildStringBuilder)
+{
+    wxStringBuilder builder;
+    for ( int n = 0; n < BUILD_NUM_LINES; n++ )
+        builder << "Item " << n << ": " << gs_name << '\n';
+    return !builder.Release().empty();
+}
+
+BENCHMARK_FUNC(BuildShortStringAppend)
+{
+    wxString s;
+    s << gs_name << " version " << 3 << '.' << 1 << '.' << 3;
+    return !s.empty();
+}
+
+BENCHMARK_FUNC(BuildShortStringBuilder)
+{
+    wxStringBuilder builder;
+    builder << gs_name << " version " << 3 << '.' << 1 << '.' << 3;
+    return !builder.Release().empty();
+}
+
+// ----------------------------------------------------------------------------
+// wxString::operator[] - random access to long strings
+// ----------------------------------------------------------------------------
+
+// minimal length of the strings used by the benchmarks below, in characters
+static const size_t INDEX_STRING_LEN = 1024*1024;
+
+// number of characters accessed during each benchmark iteration
+static const int INDEX_NUM_ACCESSES = 100;
+
+static wxString gs_indexStr;
+
+static void IndexInit(const wxString& part)
+{
+    gs_indexStr.reserve(INDEX_STRING_LEN + part.length());
+    while ( gs_indexStr.length() < INDEX_STRING_LEN )
+        gs_indexStr += part;
+}
+
+static bool IndexASCIIInit()
+{
+    IndexInit(asciistr);
+    return true;
+}
+
+static bool IndexUTF8Init()
+{
+    IndexInit(wxString::FromUTF8(utf8str));
+    return true;
+}
+
+static void IndexDone()
+{
+    gs_indexStr = wxString();
+}
+
+static bool IndexRandomly()
+{
+    const wxString& str = gs_indexStr;
+    const size_t len = str.length();
+
+    // use a simple LCG to generate pseudo-random positions in the string
+    static wxUint32 s_seed = 0;
+    for ( int n = 0; n < INDEX_NUM_ACCESSES; n++ )
+    {
+        s_seed = s_seed*1103515245 + 12345;
+        if ( str[s_seed % len].GetValue() == 0 )
+            return false;
+    }
+
+    return true;
+}
+
+BENCHMARK_FUNC_WITH_INIT(IndexRandomASCII, IndexASCIIInit, IndexDone)
+{
+    return IndexRandomly();
+}
+
+BENCHMARK_FUNC_WITH_INIT(IndexRandomUTF8, IndexUTF8Init, IndexDone)
+{
+    return IndexRandomly();
+}
 
 // ----------------------------------------------------------------------------
 // wxString::operator[] - parse large HTML page
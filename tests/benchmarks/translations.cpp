@@ -0,0 +1,379 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/translations.cpp
+// Purpose:     Message catalogs loading and lookup benchmarks
+// Author:      wxWidgets team
+// Created:     2019-09-16
+// Copyright:   (c) 2019 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+
+#if wxUSE_INTL
+
+#include "wx/arrstr.h"
+#include "wx/buffer.h"
+#include "wx/file.h"
+#include "wx/filename.h"
+#include "wx/translation.h"
+#include "wx/vector.h"
+
+#include <algorithm>
+
+// Default number of messages in the catalog, can be changed with -p option.
+static const int DEFAULT_NUM_MESSAGES = 5000;
+
+static const char* const DOMAIN_NAME = "bench";
+
+static int GetNumMessages()
+{
+    const long num = Bench::GetNumericParameter();
+    return num > 0 ? static_cast<int>(num) : DEFAULT_NUM_MESSAGES;
+}
+
+static wxString GetMessage(int n)
+{
+    return wxString::Format("Message number %d to translate", n);
+}
+
+// ----------------------------------------------------------------------------
+// in-memory .mo file
+// ----------------------------------------------------------------------------
+
+// Append a 32 bit value in the native byte order to the buffer.
+static void AppendUint32(wxMemoryBuffer& buf, wxUint32 value)
+{
+    buf.AppendData(&value, sizeof(value));
+}
+
+static void SetUint32(wxMemoryBuffer& buf, size_t ofs, wxUint32 value)
+{
+    memcpy(static_cast<char*>(buf.GetData()) + ofs, &value, sizeof(value));
+}
+
+// The hash function used for the hash table in .mo files.
+static wxUint32 GetMsgHash(const char* str)
+{
+    wxUint32 hval = 0;
+    while ( *str )
+    {
+        hval = (hval << 4) + static_cast<unsigned char>(*str++);
+
+        const wxUint32 g = hval & 0xf0000000;
+        if ( g )
+            hval ^= (g >> 24) ^ g;
+    }
+
+    return hval;
+}
+
+static bool IsPrime(wxUint32 n)
+{
+    for ( wxUint32 d = 2; d*d <= n; d++ )
+    {
+        if ( n % d == 0 )
+            return false;
+    }
+
+    return true;
+}
+
+struct Message
+{
+    explicit Message(int n)
+        : orig(GetMessage(n).utf8_str()),
+          trans(wxString::Format("Traduction du message %d", n).utf8_str())
+    {
+    }
+
+    bool operator<(const Message& other) const
+    {
+        return strcmp(orig, other.orig) < 0;
+    }
+
+    wxCharBuffer orig,
+                 trans;
+};
+
+// Create the contents of a .mo file containing the catalog header and the
+// translations for all GetMessage() strings, see the description of this
+// format in gettext documentation. As msgfmt does, sort the strings and
+// create the hash table for them.
+static wxCharBuffer CreateCatalogData(int numMessages)
+{
+    wxVector<wxCharBuffer> orig,
+                           trans;
+
+    orig.push_back(wxCharBuffer(""));
+    trans.push_back(wxCharBuffer("Content-Type: text/plain; charset=UTF-8\n"
+                                 "Plural-Forms: nplurals=2; plural=(n > 1);\n"));
+
+    wxVector<Message> messages;
+    for ( int n = 0; n < numMessages; n++ )
+        messages.push_back(Message(n));
+    std::sort(messages.begin(), messages.end());
+
+    for ( int n = 0; n < numMessages; n++ )
+    {
+        orig.push_back(messages[n].orig);
+        trans.push_back(messages[n].trans);
+    }
+
+    const wxUint32 numStrings = orig.size();
+
+    // use the same hash table size as msgfmt
+    wxUint32 hashSize = numStrings*4/3;
+    if ( hashSize < 3 )
+        hashSize = 3;
+    while ( !IsPrime(hashSize) )
+        hashSize++;
+
+    wxVector<wxUint32> hashTable(hashSize, 0);
+    for ( wxUint32 n = 0; n < numStrings; n++ )
+    {
+        const wxUint32 hval = GetMsgHash(orig[n]);
+        const wxUint32 incr = 1 + hval % (hashSize - 2);
+        wxUint32 idx = hval % hashSize;
+        while ( hashTable[idx] )
+        {
+            if ( idx >= hashSize - incr )
+                idx -= hashSize - incr;
+            else
+                idx += incr;
+        }
+
+        hashTable[idx] = n + 1;
+    }
+
+    // header is followed by the original and translated strings tables and
+    // the hash table
+    static const size_t HEADER_SIZE = 7*sizeof(wxUint32);
+    const size_t ofsOrigTable = HEADER_SIZE;
+    const size_t ofsTransTable = ofsOrigTable + numStrings*2*sizeof(wxUint32);
+    const size_t ofsHashTable = ofsTransTable + numStrings*2*sizeof(wxUint32);
+    const size_t ofsStrings = ofsHashTable + hashSize*sizeof(wxUint32);
+
+    wxMemoryBuffer buf;
+    AppendUint32(buf, 0x950412de);          // magic
+    AppendUint32(buf, 0);                   // revision
+    AppendUint32(buf, numStrings);
+    AppendUint32(buf, ofsOrigTable);
+    AppendUint32(buf, ofsTransTable);
+    AppendUint32(buf, hashSize);
+    AppendUint32(buf, ofsHashTable);
+
+    // the tables themselves are filled in below
+    memset(buf.GetAppendBuf(ofsStrings - HEADER_SIZE), 0, ofsStrings - HEADER_SIZE);
+    buf.UngetAppendBuf(ofsStrings - HEADER_SIZE);
+
+    for ( wxUint32 n = 0; n < hashSize; n++ )
+        SetUint32(buf, ofsHashTable + n*sizeof(wxUint32), hashTable[n]);
+
+    for ( int table = 0; table < 2; table++ )
+    {
+        const wxVector<wxCharBuffer>& strings = table ? trans : orig;
+        size_t ofsEntry = table ? ofsTransTable : ofsOrigTable;
+
+        for ( wxUint32 n = 0; n < numStrings; n++ )
+        {
+            const wxCharBuffer& str = strings[n];
+
+            SetUint32(buf, ofsEntry, str.length());
+            SetUint32(buf, ofsEntry + sizeof(wxUint32), buf.GetDataLen());
+            ofsEntry += 2*sizeof(wxUint32);
+
+            // include the trailing NUL too
+            buf.AppendData(str.data(), str.length() + 1);
+        }
+    }
+
+    wxCharBuffer data(buf.GetDataLen());
+    memcpy(data.data(), buf.GetData(), buf.GetDataLen());
+
+    return data;
+}
+
+static wxCharBuffer gs_catalogData;
+
+static bool CatalogInit()
+{
+    gs_catalogData = CreateCatalogData(GetNumMessages());
+
+    return true;
+}
+
+static void CatalogDone()
+{
+    gs_catalogData.reset();
+}
+
+BENCHMARK_FUNC_WITH_INIT(TranslationsLoadCatalog, CatalogInit, CatalogDone)
+{
+    wxMsgCatalog* const
+        cat = wxMsgCatalog::CreateFromData(gs_catalogData, DOMAIN_NAME);
+    if ( !cat )
+        return false;
+
+    delete cat;
+
+    return true;
+}
+
+// The same catalog saved to a temporary file.
+static wxString gs_catalogFile;
+
+static bool CatalogFileInit()
+{
+    CatalogInit();
+
+    gs_catalogFile = wxFileName::CreateTempFileName("benchmo");
+
+    wxFile file(gs_catalogFile, wxFile::write);
+    return file.Write(gs_catalogData.data(), gs_catalogData.length())
+            == gs_catalogData.length();
+}
+
+static void CatalogFileDone()
+{
+    wxRemoveFile(gs_catalogFile);
+    gs_catalogFile.clear();
+
+    CatalogDone();
+}
+
+BENCHMARK_FUNC_WITH_INIT(TranslationsLoadCatalogFile, CatalogFileInit, CatalogFileDone)
+{
+    wxMsgCatalog* const
+        cat = wxMsgCatalog::CreateFromFile(gs_catalogFile, DOMAIN_NAME);
+    if ( !cat )
+        return false;
+
+    delete cat;
+
+    return true;
+}
+
+BENCHMARK_FUNC_WITH_INIT(TranslationsLoadCatalogOnDemand, CatalogFileInit, CatalogFileDone)
+{
+    wxMsgCatalog* const
+        cat = wxMsgCatalog::CreateFromFile(gs_catalogFile, DOMAIN_NAME,
+                                           wxMsgCatalog::Load_OnDemand);
+    if ( !cat )
+        return false;
+
+    delete cat;
+
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// translations lookup
+// ----------------------------------------------------------------------------
+
+// Loader returning the catalog created from gs_catalogData, or from
+// gs_catalogFile if it's not empty, for any language.
+class MemoryTranslationsLoader : public wxTranslationsLoader
+{
+public:
+    MemoryTranslationsLoader() { }
+
+    virtual wxMsgCatalog *LoadCatalog(const wxString& domain,
+                                      const wxString& WXUNUSED(lang)) wxOVERRIDE
+    {
+        if ( !gs_catalogFile.empty() )
+        {
+            return wxMsgCatalog::CreateFromFile(gs_catalogFile, domain,
+                                                wxMsgCatalog::Load_OnDemand);
+        }
+
+        return wxMsgCatalog::CreateFromData(gs_catalogData, domain);
+    }
+
+    virtual wxArrayString
+    GetAvailableTranslations(const wxString& WXUNUSED(domain)) const wxOVERRIDE
+    {
+        wxArrayString langs;
+        langs.push_back("fr");
+        return langs;
+    }
+};
+
+static wxTranslations* gs_translations = NULL;
+static wxVector<wxString> gs_messages;
+
+static bool DoTranslationsInit()
+{
+    gs_translations = new wxTranslations;
+    gs_translations->SetLoader(new MemoryTranslationsLoader);
+    gs_translations->SetLanguage("fr");
+
+    if ( !gs_translations->AddCatalog(DOMAIN_NAME) )
+        return false;
+
+    const int numMessages = GetNumMessages();
+    gs_messages.reserve(numMessages);
+    for ( int n = 0; n < numMessages; n++ )
+        gs_messages.push_back(GetMessage(n));
+
+    return true;
+}
+
+static bool TranslationsInit()
+{
+    CatalogInit();
+
+    return DoTranslationsInit();
+}
+
+static void TranslationsDone()
+{
+    gs_messages.clear();
+    wxDELETE(gs_translations);
+
+    CatalogDone();
+}
+
+static bool TranslationsOnDemandInit()
+{
+    return CatalogFileInit() && DoTranslationsInit();
+}
+
+static void TranslationsOnDemandDone()
+{
+    gs_messages.clear();
+    wxDELETE(gs_translations);
+
+    CatalogFileDone();
+}
+
+BENCHMARK_FUNC_WITH_INIT(TranslationsLookup, TranslationsInit, TranslationsDone)
+{
+    static size_t s_n = 0;
+    if ( ++s_n == gs_messages.size() )
+        s_n = 0;
+
+    return gs_translations->GetTranslatedString(gs_messages[s_n]) != NULL;
+}
+
+BENCHMARK_FUNC_WITH_INIT(TranslationsLookupMissing, TranslationsInit, TranslationsDone)
+{
+    return gs_translations->GetTranslatedString("Untranslated string") == NULL;
+}
+
+BENCHMARK_FUNC_WITH_INIT(TranslationsLookupOnDemand,
+                         TranslationsOnDemandInit, TranslationsOnDemandDone)
+{
+    static size_t s_n = 0;
+    if ( ++s_n == gs_messages.size() )
+        s_n = 0;
+
+    return gs_translations->GetTranslatedString(gs_messages[s_n]) != NULL;
+}
+
+BENCHMARK_FUNC_WITH_INIT(TranslationsLookupMissingOnDemand,
+                         TranslationsOnDemandInit, TranslationsOnDemandDone)
+{
+    return gs_translations->GetTranslatedString("Untranslated string") == NULL;
+}
+
+#endif // wxUSE_INTL
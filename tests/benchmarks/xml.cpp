@@ -0,0 +1,224 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/xml.cpp
+// Purpose:     XML-related benchmarks
+// Author:      wxWidgets team
+// Created:     2019-09-16
+// Copyright:   (c) 2019 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+
+#if wxUSE_XML
+
+#include "wx/mstream.h"
+#include "wx/xml/xml.h"
+
+// Default number of the elements in the test document, can be changed with
+// -p option.
+static const int DEFAULT_NUM_ELEMENTS = 10000;
+
+static int GetNumElements()
+{
+    const long num = Bench::GetNumericParameter();
+    return num > 0 ? static_cast<int>(num) : DEFAULT_NUM_ELEMENTS;
+}
+
+// Create a document with the given number of "item" elements, each with a few
+// attributes, a child element and some text, similar to a typical XRC or
+// configuration file.
+static wxXmlDocument* CreateTestDocument(int numElements)
+{
+    wxXmlNode* const root = new wxXmlNode(wxXML_ELEMENT_NODE, "items");
+
+    // wxXmlNode::AddChild() appends the child to the end of the list which
+    // requires walking the entire list, so insert them in the reverse order
+    // at the beginning instead
+    for ( int n = numElements - 1; n >= 0; n-- )
+    {
+        wxXmlNode* const item = new wxXmlNode(wxXML_ELEMENT_NODE, "item");
+        item->AddAttribute("id", wxString::Format("%d", n));
+        item->AddAttribute("name", wxString::Format("Item number %d", n));
+        item->AddAttribute("class", n % 2 ? "odd" : "even");
+
+        wxXmlNode* const label = new wxXmlNode(wxXML_ELEMENT_NODE, "label");
+        label->AddChild(new wxXmlNode(wxXML_TEXT_NODE, wxString(),
+                                      wxString::Format("Label <%d> & text", n)));
+        item->AddChild(label);
+
+        root->InsertChild(item, root->GetChildren());
+    }
+
+    wxXmlDocument* const doc = new wxXmlDocument;
+    doc->SetRoot(root);
+
+    return doc;
+}
+
+static wxXmlDocument* gs_doc = NULL;
+static wxXmlDocument* gs_docArena = NULL;
+static wxCharBuffer gs_xmlData;
+
+static bool XmlInit()
+{
+    gs_doc = CreateTestDocument(GetNumElements());
+
+    wxMemoryOutputStream mos;
+    if ( !gs_doc->Save(mos) )
+        return false;
+
+    gs_xmlData = wxCharBuffer(mos.GetSize());
+    mos.CopyTo(gs_xmlData.data(), gs_xmlData.length());
+
+    return true;
+}
+
+static void XmlDone()
+{
+    wxDELETE(gs_docArena);
+    wxDELETE(gs_doc);
+    gs_xmlData.reset();
+}
+
+// Also load the saved document using the arena.
+static bool XmlArenaInit()
+{
+    if ( !XmlInit() )
+        return false;
+
+    wxMemoryInputStream mis(gs_xmlData.data(), gs_xmlData.length());
+
+    gs_docArena = new wxXmlDocument;
+    return gs_docArena->Load(mis, "UTF-8", wxXMLDOC_USE_ARENA);
+}
+
+BENCHMARK_FUNC_WITH_INIT(XmlLoad, XmlInit, XmlDone)
+{
+    wxMemoryInputStream mis(gs_xmlData.data(), gs_xmlData.length());
+
+    wxXmlDocument doc;
+    return doc.Load(mis);
+}
+
+BENCHMARK_FUNC_WITH_INIT(XmlLoadArena, XmlInit, XmlDone)
+{
+    wxMemoryInputStream mis(gs_xmlData.data(), gs_xmlData.length());
+
+    wxXmlDocument doc;
+    return doc.Load(mis, "UTF-8", wxXMLDOC_USE_ARENA);
+}
+
+BENCHMARK_FUNC_WITH_INIT(XmlSave, XmlInit, XmlDone)
+{
+    wxMemoryOutputStream mos;
+    return gs_doc->Save(mos) && mos.GetSize() == gs_xmlData.length();
+}
+
+// Write the same document as CreateTestDocument() creates directly.
+BENCHMARK_FUNC_WITH_INIT(XmlWriter, XmlInit, XmlDone)
+{
+    wxMemoryOutputStream mos;
+
+    wxXmlWriter writer(mos);
+    writer.WriteDeclaration();
+    writer.StartElement("items");
+
+    const int numElements = GetNumElements();
+    for ( int n = 0; n < numElements; n++ )
+    {
+        writer.StartElement("item");
+        writer.WriteAttribute("id", wxString::Format("%d", n));
+        writer.WriteAttribute("name", wxString::Format("Item number %d", n));
+        writer.WriteAttribute("class", n % 2 ? "odd" : "even");
+
+        writer.StartElement("label");
+        writer.WriteText(wxString::Format("Label <%d> & text", n));
+        writer.EndElement();
+
+        writer.EndElement();
+    }
+
+    writer.EndElement();
+
+    return writer.Flush() && mos.GetSize() == gs_xmlData.length();
+}
+
+static bool CountOddItems(const wxXmlDocument* doc)
+{
+    int count = 0;
+    for ( wxXmlNode* node = doc->GetRoot()->GetChildren();
+          node;
+          node = node->GetNext() )
+    {
+        if ( node->GetAttribute("class") == "odd" )
+            count++;
+    }
+
+    return count == GetNumElements() / 2;
+}
+
+BENCHMARK_FUNC_WITH_INIT(XmlTraverse, XmlInit, XmlDone)
+{
+    return CountOddItems(gs_doc);
+}
+
+BENCHMARK_FUNC_WITH_INIT(XmlTraverseArena, XmlArenaInit, XmlDone)
+{
+    return CountOddItems(gs_docArena);
+}
+
+// Reader counting the "odd" items, either directly or by reading each of them
+// as wxXmlNode, which is the streaming equivalent of XmlLoad + XmlTraverse.
+class CountingXmlReader : public wxXmlReader
+{
+public:
+    explicit CountingXmlReader(bool readSubtrees)
+        : m_readSubtrees(readSubtrees),
+          m_count(0)
+    {
+    }
+
+    int GetCount() const { return m_count; }
+
+protected:
+    virtual void OnStartElement(const wxString& name) wxOVERRIDE
+    {
+        if ( name != "item" )
+            return;
+
+        if ( m_readSubtrees )
+            ReadSubtree();
+        else if ( GetAttribute("class") == "odd" )
+            m_count++;
+    }
+
+    virtual void OnSubtree(wxXmlNode* node) wxOVERRIDE
+    {
+        if ( node->GetAttribute("class") == "odd" )
+            m_count++;
+
+        delete node;
+    }
+
+private:
+    const bool m_readSubtrees;
+    int m_count;
+};
+
+BENCHMARK_FUNC_WITH_INIT(XmlReader, XmlInit, XmlDone)
+{
+    wxMemoryInputStream mis(gs_xmlData.data(), gs_xmlData.length());
+
+    CountingXmlReader reader(false);
+    return reader.Parse(mis) && reader.GetCount() == GetNumElements() / 2;
+}
+
+BENCHMARK_FUNC_WITH_INIT(XmlReaderSubtrees, XmlInit, XmlDone)
+{
+    wxMemoryInputStream mis(gs_xmlData.data(), gs_xmlData.length());
+
+    CountingXmlReader reader(true);
+    return reader.Parse(mis) && reader.GetCount() == GetNumElements() / 2;
+}
+
+#endif // wxUSE_XML
@@ -699,5 +699,101 @@ void FileConfigTestCase::ReadFloat()
     CPPUNIT_ASSERT_EQUAL( -9876.5432f, f );
 }
 
+TEST_CASE("wxFileConfig::ManyEntries", "[fileconfig]")
+{
+    // create a config with the entries and groups in reverse order
+    wxString text;
+    for ( int n = 99; n >= 0; n-- )
+        text << wxString::Format("Key%02d=%d\n", n, n);
+    for ( int n = 9; n >= 0; n-- )
+        text << wxString::Format("[Group%d]\n", n);
+
+    wxStringInputStream sis(text);
+    wxFileConfig fc(sis);
+
+    SECTION("Enumerate")
+    {
+        // entries and groups are still enumerated in alphabetical order
+        wxString name;
+        long cookie;
+        REQUIRE( fc.GetFirstEntry(name, cookie) );
+        CHECK( name == "Key00" );
+        for ( int n = 1; n < 100; n++ )
+        {
+            REQUIRE( fc.GetNextEntry(name, cookie) );
+            CHECK( name == wxString::Format("Key%02d", n) );
+        }
+        CHECK( !fc.GetNextEntry(name, cookie) );
+
+        REQUIRE( fc.GetFirstGroup(name, cookie) );
+        CHECK( name == "Group0" );
+        REQUIRE( fc.GetNextGroup(name, cookie) );
+        CHECK( name == "Group1" );
+
+        // and this remains true after adding new ones
+        fc.Write("/Group/Key", 1);
+        fc.Write("/Key", 1);
+
+        REQUIRE( fc.GetFirstEntry(name, cookie) );
+        CHECK( name == "Key" );
+        REQUIRE( fc.GetFirstGroup(name, cookie) );
+        CHECK( name == "Group" );
+    }
+
+    SECTION("Lookup")
+    {
+        CHECK( fc.ReadLong("Key42", 0) == 42 );
+        CHECK( fc.ReadLong("/Key99", 0) == 99 );
+
+        // names are not case-sensitive
+        CHECK( fc.ReadLong("KEY17", 0) == 17 );
+        CHECK( fc.HasGroup("group5") );
+
+        CHECK( !fc.HasEntry("Key100") );
+        CHECK( !fc.HasGroup("Group10") );
+        CHECK( fc.GetPath() == "" );
+
+        CHECK( fc.DeleteEntry("key42") );
+        CHECK( !fc.HasEntry("Key42") );
+        CHECK( fc.DeleteGroup("Group5") );
+        CHECK( !fc.HasGroup("Group5") );
+        CHECK( fc.GetNumberOfEntries() == 99 );
+        CHECK( fc.GetNumberOfGroups() == 9 );
+    }
+
+    SECTION("Rename")
+    {
+        CHECK( fc.RenameGroup("Group9", "Group") );
+        CHECK( !fc.HasGroup("Group9") );
+        CHECK( fc.HasGroup("Group") );
+        CHECK( !fc.RenameGroup("Group8", "group0") );
+
+        wxString name;
+        long cookie;
+        REQUIRE( fc.GetFirstGroup(name, cookie) );
+        CHECK( name == "Group" );
+    }
+}
+
+TEST_CASE("wxFileConfig::LineEndings", "[fileconfig]")
+{
+    wxStringInputStream sis("[Dos]\r\ndos=1\r\n"
+                            "[Mac]\rmac=2\r"
+                            "[Unix]\nunix=3");
+    wxFileConfig fc(sis);
+
+    CHECK( fc.ReadLong("/Dos/dos", 0) == 1 );
+    CHECK( fc.ReadLong("/Mac/mac", 0) == 2 );
+    CHECK( fc.ReadLong("/Unix/unix", 0) == 3 );
+
+    wxVERIFY_FILECONFIG( "[Dos]\n"
+                         "dos=1\n"
+                         "[Mac]\n"
+                         "mac=2\n"
+                         "[Unix]\n"
+                         "unix=3\n",
+                         fc );
+}
+
 #endif // wxUSE_FILECONFIG
 
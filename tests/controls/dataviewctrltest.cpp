@@ -262,4 +262,41 @@ TEST_CASE_METHOD(SingleSelectDataViewCtrlTestCase,
     CHECK( rectRoot == wxRect() );
 }
 
+TEST_CASE_METHOD(SingleSelectDataViewCtrlTestCase,
+                 "wxDVC::GetItemRectAfterChanges",
+                 "[wxDataViewCtrl][item]")
+{
+#ifdef __WXGTK__
+    wxYield();
+#endif // __WXGTK__
+
+    const wxRect rect1 = m_dvc->GetItemRect(m_child1);
+    const wxRect rect2 = m_dvc->GetItemRect(m_child2);
+    const int step = rect2.y - rect1.y;
+    REQUIRE( step > 0 );
+
+    // Expanding an item should move the items below it down.
+    m_dvc->Expand(m_child1);
+
+#ifdef __WXGTK__
+    wxYield();
+#endif // __WXGTK__
+
+    CHECK( m_dvc->GetItemRect(m_grandchild).y == rect2.y );
+    CHECK( m_dvc->GetItemRect(m_child2).y == rect2.y + step );
+
+    // And deleting it should move them up again.
+    m_dvc->DeleteItem(m_child1);
+
+#ifdef __WXGTK__
+    wxYield();
+#endif // __WXGTK__
+
+    CHECK( m_dvc->GetItemRect(m_child2).y == rect1.y );
+
+    // Check that the items added after the existing ones are found too.
+    const wxDataViewItem last = m_dvc->AppendItem(m_root, "last");
+    CHECK( m_dvc->GetItemRect(last).y == rect2.y );
+}
+
 #endif //wxUSE_DATAVIEWCTRL
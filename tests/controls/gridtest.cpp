@@ -56,6 +56,8 @@ private:
         NONGTK_TEST( RangeSelect );
         CPPUNIT_TEST( Cursor );
         CPPUNIT_TEST( Selection );
+        CPPUNIT_TEST( SelectedBlocks );
+        CPPUNIT_TEST( LegacySelection );
         CPPUNIT_TEST( AddRowCol );
         CPPUNIT_TEST( ColumnOrder );
         CPPUNIT_TEST( ColumnVisibility );
@@ -64,6 +66,9 @@ private:
         CPPUNIT_TEST( Labels );
         CPPUNIT_TEST( SelectionMode );
         CPPUNIT_TEST( CellFormatting );
+        CPPUNIT_TEST( CellAttributes );
+        CPPUNIT_TEST( LineSizes );
+        CPPUNIT_TEST( AutoSizeSample );
         WXUISIM_TEST( Editable );
         WXUISIM_TEST( ReadOnly );
         CPPUNIT_TEST( PseudoTest_NativeHeader );
@@ -85,6 +90,8 @@ private:
     void RangeSelect();
     void Cursor();
     void Selection();
+    void SelectedBlocks();
+    void LegacySelection();
     void AddRowCol();
     void ColumnOrder();
     void ColumnVisibility();
@@ -93,6 +100,9 @@ private:
     void Labels();
     void SelectionMode();
     void CellFormatting();
+    void CellAttributes();
+    void LineSizes();
+    void AutoSizeSample();
     void Editable();
     void ReadOnly();
     void PseudoTest_NativeHeader() { ms_nativeheader = true; }
@@ -477,6 +487,125 @@ void GridTestCase::Selection()
     CPPUNIT_ASSERT(!m_grid->IsInSelection(3, 0));
 }
 
+void GridTestCase::SelectedBlocks()
+{
+    m_grid->AppendCols(3);
+
+    // Overlapping blocks must be merged into non-overlapping ones covering
+    // exactly the same cells.
+    m_grid->SelectBlock(1, 1, 3, 2);
+    m_grid->SelectBlock(2, 2, 4, 3, true);
+
+    int count = 0;
+    int cells = 0;
+    const wxGridBlocks blocks = m_grid->GetSelectedBlocks();
+    for ( wxGridBlocks::iterator it = blocks.begin(); it != blocks.end(); ++it )
+    {
+        const wxGridBlockCoords& block = *it;
+
+        CPPUNIT_ASSERT( block.GetTopRow() <= block.GetBottomRow() );
+        CPPUNIT_ASSERT( block.GetLeftCol() <= block.GetRightCol() );
+
+        for ( wxGridBlocks::iterator it2 = blocks.begin(); it2 != it; ++it2 )
+            CPPUNIT_ASSERT( !block.Intersects(*it2) );
+
+        count++;
+        cells += (block.GetBottomRow() - block.GetTopRow() + 1)*
+                    (block.GetRightCol() - block.GetLeftCol() + 1);
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 3, count );
+    CPPUNIT_ASSERT_EQUAL( 10, cells );
+
+    CPPUNIT_ASSERT( m_grid->IsInSelection(3, 3) );
+    CPPUNIT_ASSERT( !m_grid->IsInSelection(1, 3) );
+    CPPUNIT_ASSERT( !m_grid->IsInSelection(4, 1) );
+
+    // Deleting rows inside and at the end of a block must shrink it.
+    m_grid->DeleteRows(3, 2);
+    CPPUNIT_ASSERT( m_grid->IsInSelection(2, 3) );
+    CPPUNIT_ASSERT( !m_grid->IsInSelection(3, 2) );
+
+    // Deselecting a cell splits the block containing it.
+    m_grid->DeselectCell(2, 2);
+    CPPUNIT_ASSERT( !m_grid->IsInSelection(2, 2) );
+    CPPUNIT_ASSERT( m_grid->IsInSelection(2, 1) );
+    CPPUNIT_ASSERT( m_grid->IsInSelection(2, 3) );
+
+    // Selecting full rows must be reflected by the legacy accessors too.
+    m_grid->ClearSelection();
+    CPPUNIT_ASSERT( m_grid->GetSelectedBlocks().begin() ==
+                        m_grid->GetSelectedBlocks().end() );
+
+    m_grid->SelectRow(5);
+    m_grid->SelectRow(6, true);
+    const wxArrayInt rows = m_grid->GetSelectedRows();
+    CPPUNIT_ASSERT_EQUAL( 2, rows.size() );
+    CPPUNIT_ASSERT_EQUAL( 5, rows[0] );
+    CPPUNIT_ASSERT_EQUAL( 6, rows[1] );
+}
+
+void GridTestCase::LegacySelection()
+{
+    // The blocks returned by the legacy accessors don't depend on how the
+    // cells were selected.
+    m_grid->SelectBlock(1, 0, 1, 0);
+    m_grid->SelectBlock(1, 1, 1, 1, true);
+    m_grid->SelectBlock(5, 0, 5, 0, true);
+
+    wxGridCellCoordsArray cells = m_grid->GetSelectedCells();
+    CPPUNIT_ASSERT_EQUAL( 1, cells.Count() );
+    CPPUNIT_ASSERT( cells[0] == wxGridCellCoords(5, 0) );
+
+    wxGridCellCoordsArray topleft = m_grid->GetSelectionBlockTopLeft();
+    wxGridCellCoordsArray bottomright = m_grid->GetSelectionBlockBottomRight();
+    CPPUNIT_ASSERT_EQUAL( 1, topleft.Count() );
+    CPPUNIT_ASSERT_EQUAL( 1, bottomright.Count() );
+    CPPUNIT_ASSERT( topleft[0] == wxGridCellCoords(1, 0) );
+    CPPUNIT_ASSERT( bottomright[0] == wxGridCellCoords(1, 1) );
+
+    // Cells selected in all the columns form an entirely selected row, which
+    // is still returned as a block too.
+    CPPUNIT_ASSERT_EQUAL( 1, m_grid->GetSelectedRows().Count() );
+    CPPUNIT_ASSERT_EQUAL( 1, m_grid->GetSelectedRows()[0] );
+    CPPUNIT_ASSERT_EQUAL( 0, m_grid->GetSelectedCols().Count() );
+
+    // Overlapping blocks are split into non-overlapping ones.
+    m_grid->ClearSelection();
+    m_grid->AppendCols(2);
+    m_grid->SelectBlock(1, 1, 3, 2);
+    m_grid->SelectBlock(2, 2, 4, 3, true);
+
+    topleft = m_grid->GetSelectionBlockTopLeft();
+    bottomright = m_grid->GetSelectionBlockBottomRight();
+    CPPUNIT_ASSERT_EQUAL( 3, topleft.Count() );
+    CPPUNIT_ASSERT( topleft[0] == wxGridCellCoords(1, 1) );
+    CPPUNIT_ASSERT( bottomright[0] == wxGridCellCoords(1, 2) );
+    CPPUNIT_ASSERT( topleft[1] == wxGridCellCoords(2, 1) );
+    CPPUNIT_ASSERT( bottomright[1] == wxGridCellCoords(3, 3) );
+    CPPUNIT_ASSERT( topleft[2] == wxGridCellCoords(4, 2) );
+    CPPUNIT_ASSERT( bottomright[2] == wxGridCellCoords(4, 3) );
+
+    // All rows and columns are returned when everything is selected.
+    m_grid->SelectAll();
+    CPPUNIT_ASSERT_EQUAL( 10, m_grid->GetSelectedRows().Count() );
+    CPPUNIT_ASSERT_EQUAL( 4, m_grid->GetSelectedCols().Count() );
+    CPPUNIT_ASSERT_EQUAL( 1, m_grid->GetSelectionBlockTopLeft().Count() );
+    CPPUNIT_ASSERT_EQUAL( 0, m_grid->GetSelectedCells().Count() );
+
+    // Only rows are returned in the rows selection mode.
+    m_grid->ClearSelection();
+    m_grid->SetSelectionMode(wxGrid::wxGridSelectRows);
+    m_grid->SelectBlock(2, 0, 3, 0);
+
+    const wxArrayInt rows = m_grid->GetSelectedRows();
+    CPPUNIT_ASSERT_EQUAL( 2, rows.Count() );
+    CPPUNIT_ASSERT_EQUAL( 2, rows[0] );
+    CPPUNIT_ASSERT_EQUAL( 3, rows[1] );
+    CPPUNIT_ASSERT_EQUAL( 0, m_grid->GetSelectionBlockTopLeft().Count() );
+    CPPUNIT_ASSERT_EQUAL( 0, m_grid->GetSelectedCells().Count() );
+}
+
 void GridTestCase::AddRowCol()
 {
     CPPUNIT_ASSERT_EQUAL(10, m_grid->GetNumberRows());
@@ -683,6 +812,111 @@ void GridTestCase::CellFormatting()
     CPPUNIT_ASSERT_EQUAL(*wxGREEN, m_grid->GetCellTextColour(0, 0));
 }
 
+void GridTestCase::CellAttributes()
+{
+    m_grid->AppendCols(3);
+
+    // Set attributes for a few cells out of order and check that they are
+    // kept when inserting and deleting rows and columns around them.
+    m_grid->SetCellTextColour(5, 3, *wxRED);
+    m_grid->SetCellTextColour(1, 4, *wxGREEN);
+    m_grid->SetCellTextColour(5, 1, *wxBLUE);
+    m_grid->SetCellTextColour(1, 0, *wxCYAN);
+
+    const wxColour def = m_grid->GetDefaultCellTextColour();
+
+    m_grid->InsertRows(2, 3);
+    CPPUNIT_ASSERT_EQUAL( *wxRED, m_grid->GetCellTextColour(8, 3) );
+    CPPUNIT_ASSERT_EQUAL( *wxGREEN, m_grid->GetCellTextColour(1, 4) );
+    CPPUNIT_ASSERT_EQUAL( *wxBLUE, m_grid->GetCellTextColour(8, 1) );
+    CPPUNIT_ASSERT_EQUAL( *wxCYAN, m_grid->GetCellTextColour(1, 0) );
+    CPPUNIT_ASSERT_EQUAL( def, m_grid->GetCellTextColour(5, 3) );
+
+    m_grid->DeleteCols(1, 2);
+    CPPUNIT_ASSERT_EQUAL( *wxRED, m_grid->GetCellTextColour(8, 1) );
+    CPPUNIT_ASSERT_EQUAL( *wxGREEN, m_grid->GetCellTextColour(1, 2) );
+    CPPUNIT_ASSERT_EQUAL( *wxCYAN, m_grid->GetCellTextColour(1, 0) );
+    CPPUNIT_ASSERT_EQUAL( def, m_grid->GetCellTextColour(8, 0) );
+
+    m_grid->DeleteRows(0, 2);
+    CPPUNIT_ASSERT_EQUAL( *wxRED, m_grid->GetCellTextColour(6, 1) );
+    CPPUNIT_ASSERT_EQUAL( def, m_grid->GetCellTextColour(1, 2) );
+    CPPUNIT_ASSERT_EQUAL( def, m_grid->GetCellTextColour(1, 0) );
+
+    // Resetting the attribute must restore the default value.
+    m_grid->SetAttr(6, 1, NULL);
+    CPPUNIT_ASSERT_EQUAL( def, m_grid->GetCellTextColour(6, 1) );
+}
+
+void GridTestCase::LineSizes()
+{
+    const int h = m_grid->GetDefaultRowSize();
+
+    // Changing the size of a row must move all the following ones.
+    m_grid->SetRowSize(0, 2*h);
+    CPPUNIT_ASSERT_EQUAL( 2*h, m_grid->CellToRect(1, 0).y );
+    CPPUNIT_ASSERT_EQUAL( 0, m_grid->YToRow(2*h - 1) );
+    CPPUNIT_ASSERT_EQUAL( 1, m_grid->YToRow(2*h) );
+
+    // Hidden rows must be skipped.
+    m_grid->HideRow(1);
+    CPPUNIT_ASSERT_EQUAL( 2, m_grid->YToRow(2*h) );
+
+    // And the sizes must be preserved when inserting and deleting rows.
+    m_grid->InsertRows(0, 1);
+    CPPUNIT_ASSERT_EQUAL( 3*h, m_grid->CellToRect(3, 0).y );
+    CPPUNIT_ASSERT_EQUAL( 3, m_grid->YToRow(3*h) );
+
+    m_grid->DeleteRows(1, 1);
+    CPPUNIT_ASSERT_EQUAL( 2, m_grid->YToRow(h) );
+
+    m_grid->AppendRows(2);
+    CPPUNIT_ASSERT_EQUAL( 11, m_grid->YToRow(10*h) );
+    CPPUNIT_ASSERT_EQUAL( -1, m_grid->YToRow(11*h) );
+    CPPUNIT_ASSERT_EQUAL( 11, m_grid->YToRow(11*h, true) );
+
+    // Check that the columns positions take their order into account.
+    const int w = m_grid->GetDefaultColSize();
+
+    m_grid->AppendCols(2);
+    m_grid->SetColSize(0, 2*w);
+    m_grid->SetColPos(3, 0);
+    CPPUNIT_ASSERT_EQUAL( 3, m_grid->XToCol(0) );
+    CPPUNIT_ASSERT_EQUAL( 0, m_grid->XToCol(w) );
+    CPPUNIT_ASSERT_EQUAL( 1, m_grid->XToCol(3*w) );
+    CPPUNIT_ASSERT_EQUAL( 3*w, m_grid->CellToRect(0, 1).x );
+
+    m_grid->AppendCols(1);
+    CPPUNIT_ASSERT_EQUAL( 5*w, m_grid->CellToRect(0, 4).x );
+}
+
+void GridTestCase::AutoSizeSample()
+{
+    m_grid->AppendRows(1000);
+    for ( int row = 0; row < m_grid->GetNumberRows(); row += 2 )
+        m_grid->SetCellValue(row, 0, "Same text in many cells");
+
+    m_grid->SetCellValue(0, 0, "Longer text in the first visible row");
+
+    m_grid->AutoSizeColumn(0, false);
+    const int width = m_grid->GetColSize(0);
+
+    // The visible rows must always be taken into account.
+    m_grid->SetAutoSizeSampleCount(10);
+    CPPUNIT_ASSERT_EQUAL( 10, m_grid->GetAutoSizeSampleCount() );
+
+    m_grid->SetColSize(0, m_grid->GetDefaultColSize());
+    m_grid->AutoSizeColumn(0, false);
+    CPPUNIT_ASSERT_EQUAL( width, m_grid->GetColSize(0) );
+
+    // But all the rows are examined if sampling is disabled.
+    m_grid->SetCellValue(999, 0, "Even longer text in one of the last rows");
+
+    m_grid->SetAutoSizeSampleCount(0);
+    m_grid->AutoSizeColumn(0, false);
+    CPPUNIT_ASSERT( m_grid->GetColSize(0) > width );
+}
+
 void GridTestCase::Editable()
 {
 #if wxUSE_UIACTIONSIMULATOR
@@ -534,3 +534,277 @@ public:
     void OnIdle(wxIdleEvent&) { }
 };
 #endif // C++11
+
+// Helper for the QueueEvent test below: handler recording the values of the
+// events it receives and, optionally, destroying itself when it gets the
+// event with the given value.
+class QueueHandler : public wxEvtHandler
+{
+public:
+    explicit QueueHandler(wxVector<int>& received, int deleteOn = -1)
+        : m_received(received),
+          m_deleteOn(deleteOn)
+    {
+        Bind(wxEVT_THREAD, &QueueHandler::OnThreadEvent, this);
+    }
+
+private:
+    void OnThreadEvent(wxThreadEvent& event)
+    {
+        m_received.push_back(event.GetInt());
+
+        if ( event.GetInt() == m_deleteOn )
+            delete this;
+    }
+
+    wxVector<int>& m_received;
+    const int m_deleteOn;
+
+    wxDECLARE_NO_COPY_CLASS(QueueHandler);
+};
+
+TEST_CASE("wxEvtHandler::QueueEvent", "[event][queue]")
+{
+    // use enough events to exceed the number of events processed at once
+    const int NUM_EVENTS = 1000;
+
+    wxVector<int> received;
+
+    SECTION("Order")
+    {
+        QueueHandler handler(received);
+        for ( int n = 0; n < NUM_EVENTS; n++ )
+        {
+            wxThreadEvent* const event = new wxThreadEvent();
+            event->SetInt(n);
+            handler.QueueEvent(event);
+        }
+
+        wxTheApp->ProcessPendingEvents();
+
+        REQUIRE( received.size() == static_cast<size_t>(NUM_EVENTS) );
+        for ( int n = 0; n < NUM_EVENTS; n++ )
+            CHECK( received[n] == n );
+    }
+
+    SECTION("DeleteWhileProcessing")
+    {
+        QueueHandler* const handler = new QueueHandler(received, 10);
+        for ( int n = 0; n < NUM_EVENTS; n++ )
+        {
+            wxThreadEvent* const event = new wxThreadEvent();
+            event->SetInt(n);
+            handler->QueueEvent(event);
+        }
+
+        // the remaining events must be discarded when the handler is deleted
+        wxTheApp->ProcessPendingEvents();
+
+        CHECK( received.size() == 11 );
+    }
+}
+
+// Helper for the BindMany test below: records the order in which its
+// handlers are called.
+class OrderRecorder
+{
+public:
+    OrderRecorder(wxVector<int>& called, int n)
+        : m_called(called),
+          m_n(n)
+    {
+    }
+
+    void OnEvent(wxEvent& event)
+    {
+        m_called.push_back(m_n);
+        event.Skip();
+    }
+
+private:
+    wxVector<int>& m_called;
+    const int m_n;
+};
+
+TEST_CASE("wxEvtHandler::BindMany", "[event][bind]")
+{
+    // Bind enough handlers for the event handler to start using an index for
+    // them, interleaving them with the handlers for other events.
+    const int NUM_HANDLERS = 100;
+
+    wxVector<int> called;
+    wxVector<OrderRecorder*> recorders;
+
+    wxEvtHandler handler;
+    for ( int n = 0; n < NUM_HANDLERS; n++ )
+    {
+        OrderRecorder* const recorder = new OrderRecorder(called, n);
+        recorders.push_back(recorder);
+
+        if ( n % 2 )
+            handler.Bind(MyEventType, &OrderRecorder::OnEvent, recorder);
+        else
+            handler.Bind(wxEVT_IDLE, &OrderRecorder::OnEvent, recorder);
+    }
+
+    // The handlers must be called in the reverse order of binding.
+    MyEvent e;
+    handler.ProcessEvent(e);
+
+    REQUIRE( called.size() == static_cast<size_t>(NUM_HANDLERS / 2) );
+    for ( int n = 0; n < NUM_HANDLERS / 2; n++ )
+        CHECK( called[n] == NUM_HANDLERS - 1 - 2*n );
+
+    // Unbinding must work too, of course.
+    for ( int n = 1; n < NUM_HANDLERS; n += 4 )
+    {
+        CHECK( handler.Unbind(MyEventType,
+                              &OrderRecorder::OnEvent, recorders[n]) );
+    }
+
+    called.clear();
+    handler.ProcessEvent(e);
+
+    REQUIRE( called.size() == static_cast<size_t>(NUM_HANDLERS / 4) );
+    for ( int n = 0; n < NUM_HANDLERS / 4; n++ )
+        CHECK( called[n] == NUM_HANDLERS - 1 - 4*n );
+
+    // And binding more handlers after unbinding some.
+    OrderRecorder last(called, NUM_HANDLERS);
+    handler.Bind(MyEventType, &OrderRecorder::OnEvent, &last);
+
+    called.clear();
+    handler.ProcessEvent(e);
+
+    REQUIRE( called.size() == static_cast<size_t>(NUM_HANDLERS / 4 + 1) );
+    CHECK( called[0] == NUM_HANDLERS );
+
+    for ( size_t n = 0; n < recorders.size(); n++ )
+        delete recorders[n];
+}
+
+// Helper for the test below: processes another event from its handler.
+class NestedDispatcher
+{
+public:
+    explicit NestedDispatcher(wxEvtHandler& handler) : m_handler(handler) { }
+
+    void OnEvent(wxEvent& event)
+    {
+        wxIdleEvent idle;
+        m_handler.ProcessEvent(idle);
+
+        event.Skip();
+    }
+
+private:
+    wxEvtHandler& m_handler;
+
+    wxDECLARE_NO_COPY_CLASS(NestedDispatcher);
+};
+
+TEST_CASE("wxEvtHandler::UnbindNested", "[event][bind]")
+{
+    const int NUM_HANDLERS = 20;
+
+    wxVector<int> called;
+    wxVector<OrderRecorder*> recorders;
+
+    wxEvtHandler handler;
+    for ( int n = 0; n < NUM_HANDLERS; n++ )
+    {
+        OrderRecorder* const recorder = new OrderRecorder(called, n);
+        recorders.push_back(recorder);
+
+        handler.Bind(wxEVT_IDLE, &OrderRecorder::OnEvent, recorder);
+    }
+
+    NestedDispatcher dispatcher(handler);
+    handler.Bind(MyEventType, &NestedDispatcher::OnEvent, &dispatcher);
+
+    // Leave an unbound entry, which is going to be pruned by the nested
+    // dispatch of the idle event while the outer one is still in progress.
+    CHECK( handler.Unbind(wxEVT_IDLE, &OrderRecorder::OnEvent, recorders[0]) );
+
+    MyEvent e;
+    CHECK( !handler.ProcessEvent(e) );
+    CHECK( called.size() == static_cast<size_t>(NUM_HANDLERS - 1) );
+
+    // Check that everything still works after pruning.
+    called.clear();
+    wxIdleEvent idle;
+    handler.ProcessEvent(idle);
+    CHECK( called.size() == static_cast<size_t>(NUM_HANDLERS - 1) );
+
+    for ( size_t n = 0; n < recorders.size(); n++ )
+        delete recorders[n];
+}
+
+// Another helper for the test below: create an event with the given value.
+static wxThreadEvent* NewThreadEvent(int n)
+{
+    wxThreadEvent* const event = new wxThreadEvent();
+    event->SetInt(n);
+    return event;
+}
+
+TEST_CASE("wxEvtHandler::QueueEventCoalesced", "[event][queue]")
+{
+    wxVector<int> received;
+    QueueHandler handler(received);
+
+    handler.QueueEvent(NewThreadEvent(100));
+    handler.QueueEventCoalesced(NewThreadEvent(1));
+    handler.QueueEvent(NewThreadEvent(101));
+    handler.QueueEventCoalesced(NewThreadEvent(2));
+    handler.QueueEventCoalesced(NewThreadEvent(50), 1);
+    handler.QueueEvent(NewThreadEvent(102));
+    wxQueueEventCoalesced(&handler, NewThreadEvent(3));
+
+    wxTheApp->ProcessPendingEvents();
+
+    // The coalesced events take the place of the first one of them in the
+    // queue while the events with a different key are not coalesced.
+    REQUIRE( received.size() == 5 );
+    CHECK( received[0] == 100 );
+    CHECK( received[1] == 3 );
+    CHECK( received[2] == 101 );
+    CHECK( received[3] == 50 );
+    CHECK( received[4] == 102 );
+
+    // And once they're processed, the new events are queued normally.
+    received.clear();
+    handler.QueueEventCoalesced(NewThreadEvent(4));
+    handler.QueueEvent(NewThreadEvent(103));
+
+    wxTheApp->ProcessPendingEvents();
+
+    REQUIRE( received.size() == 2 );
+    CHECK( received[0] == 4 );
+    CHECK( received[1] == 103 );
+}
+
+TEST_CASE("wxEvtHandler::QueueEventCoalescedMany", "[event][queue]")
+{
+    static const int NUM_KEYS = 1000;
+
+    wxVector<int> received;
+    QueueHandler handler(received);
+
+    // Queue an event for each key and then replace all of them, in the
+    // reverse order, with a normal event between them.
+    for ( int n = 0; n < NUM_KEYS; n++ )
+        handler.QueueEventCoalesced(NewThreadEvent(n), n);
+
+    handler.QueueEvent(NewThreadEvent(2*NUM_KEYS));
+
+    for ( int n = NUM_KEYS - 1; n >= 0; n-- )
+        handler.QueueEventCoalesced(NewThreadEvent(NUM_KEYS + n), n);
+
+    wxTheApp->ProcessPendingEvents();
+
+    REQUIRE( received.size() == static_cast<size_t>(NUM_KEYS + 1) );
+    for ( int n = 0; n < NUM_KEYS; n++ )
+        CHECK( received[n] == NUM_KEYS + n );
+    CHECK( received[NUM_KEYS] == 2*NUM_KEYS );
+}
@@ -19,6 +19,7 @@
 #if wxUSE_FILE
 
 #include "wx/file.h"
+#include "wx/log.h"
 
 #include "testfile.h"
 
@@ -139,6 +140,62 @@ void FileTestCase::TempFile()
     CPPUNIT_ASSERT( wxRemoveFile(wxT("test2")) );
 }
 
+TEST_CASE("wxMappedFile", "[file][mapped]")
+{
+    TestFile tf;
+
+    wxMappedFile mf;
+    CHECK( !mf.IsOpened() );
+    CHECK( mf.GetData() == NULL );
+
+    // TestFile contains just "Before".
+    REQUIRE( mf.Open(tf.GetName()) );
+    REQUIRE( mf.GetLength() == 6 );
+    CHECK( memcmp(mf.GetData(), "Before", 6) == 0 );
+
+    mf.Close();
+    CHECK( !mf.IsOpened() );
+    CHECK( mf.GetLength() == 0 );
+
+    SECTION("Big")
+    {
+        wxCharBuffer buf(100000);
+        for ( size_t n = 0; n < buf.length(); n++ )
+            buf.data()[n] = static_cast<char>(n % 251);
+
+        {
+            wxFile fout(tf.GetName(), wxFile::write);
+            REQUIRE( fout.Write(buf.data(), buf.length()) == buf.length() );
+        }
+
+        wxMappedFile mfBig(tf.GetName());
+        REQUIRE( mfBig.IsOpened() );
+        REQUIRE( mfBig.GetLength() == buf.length() );
+        CHECK( memcmp(mfBig.GetData(), buf.data(), buf.length()) == 0 );
+#if defined(__UNIX__) || defined(__WINDOWS__)
+        CHECK( mfBig.IsMapped() );
+#endif
+    }
+
+    SECTION("Empty")
+    {
+        {
+            wxFile fout(tf.GetName(), wxFile::write);
+            REQUIRE( fout.IsOpened() );
+        }
+
+        REQUIRE( mf.Open(tf.GetName()) );
+        CHECK( mf.GetLength() == 0 );
+    }
+
+    SECTION("NonExistent")
+    {
+        wxLogNull noLog;
+        CHECK( !mf.Open("no-such-file") );
+        CHECK( !mf.IsOpened() );
+    }
+}
+
 #ifdef __LINUX__
 
 // Check that GetSize() works correctly for special files.
@@ -29,6 +29,7 @@
 #include "wx/mstream.h"
 #include "wx/zstream.h"
 #include "wx/wfstream.h"
+#include "wx/math.h"
 
 #include "testimage.h"
 
@@ -1444,6 +1445,184 @@ void ImageTestCase::ScaleCompare()
                                "image/cross_nearest_neighb_256x256.png");
 }
 
+TEST_CASE("wxImage::ScaleLanczos", "[image][scale]")
+{
+    // Uniformly coloured image must remain uniform, whatever the scale.
+    wxImage uniform(64, 48);
+    uniform.SetRGB(wxRect(0, 0, 64, 48), 10, 128, 250);
+    uniform.SetAlpha();
+    memset(uniform.GetAlpha(), 200, 64*48);
+
+    const wxSize sizes[] = { wxSize(17, 11), wxSize(1, 1), wxSize(200, 100) };
+    for ( size_t n = 0; n < WXSIZEOF(sizes); n++ )
+    {
+        const wxSize& size = sizes[n];
+        INFO("Scaling to " << size.x << "x" << size.y);
+
+        const wxImage scaled = uniform.Scale(size.x, size.y,
+                                             wxIMAGE_QUALITY_LANCZOS);
+        REQUIRE( scaled.GetWidth() == size.x );
+        REQUIRE( scaled.GetHeight() == size.y );
+        REQUIRE( scaled.HasAlpha() );
+
+        for ( int y = 0; y < size.y; y++ )
+        {
+            for ( int x = 0; x < size.x; x++ )
+            {
+                CHECK( scaled.GetRed(x, y) == 10 );
+                CHECK( scaled.GetGreen(x, y) == 128 );
+                CHECK( scaled.GetBlue(x, y) == 250 );
+                CHECK( scaled.GetAlpha(x, y) == 200 );
+            }
+        }
+    }
+
+    // Linear gradient must be preserved far enough from the image borders.
+    wxImage gradient(256, 8);
+    for ( int x = 0; x < 256; x++ )
+    {
+        for ( int y = 0; y < 8; y++ )
+            gradient.SetRGB(x, y, x, x, 255 - x);
+    }
+
+    const wxImage reduced = gradient.Scale(64, 2, wxIMAGE_QUALITY_LANCZOS);
+    for ( int x = 3; x < 61; x++ )
+    {
+        // Each destination pixel corresponds to 4 source ones.
+        const int expected = 4*x + 2;
+        CHECK( abs(reduced.GetRed(x, 1) - expected) <= 1 );
+        CHECK( abs(reduced.GetBlue(x, 1) - (255 - expected)) <= 1 );
+    }
+}
+
+// Compute the exact value of the given destination pixel when downscaling a
+// single row of pixels with Lanczos-3 filter: this uses the same definition
+// of the filter as wxImage::ResampleLanczos() but without rounding anything.
+static double LanczosDownscaleExact(const wxVector<int>& row, int newDim, int dst)
+{
+    const int oldDim = static_cast<int>(row.size());
+    const double scale = double(oldDim) / newDim;
+    const double center = (dst + 0.5) * scale;
+    const double support = 3.0 * scale;
+
+    double sum = 0,
+           total = 0;
+    for ( int src = static_cast<int>(floor(center - support));
+          src <= static_cast<int>(ceil(center + support));
+          src++ )
+    {
+        const double x = (src + 0.5 - center) / scale;
+        if ( x <= -3.0 || x >= 3.0 )
+            continue;
+
+        double w = 1.0;
+        if ( x != 0.0 )
+            w = 3.0 * sin(M_PI * x) * sin(M_PI * x / 3.0) / (M_PI * M_PI * x * x);
+
+        sum += w * row[wxMax(0, wxMin(src, oldDim - 1))];
+        total += w;
+    }
+
+    return sum / total;
+}
+
+TEST_CASE("wxImage::ScaleLanczosLarge", "[image][scale]")
+{
+    // Downscaling by a big factor uses very wide filters with small weights,
+    // check that rounding them doesn't make the result noticeably different
+    // from the exact one.
+    static const int OLD_WIDTH = 8000;
+    static const int NEW_WIDTH = 5;
+
+    wxVector<int> red(OLD_WIDTH),
+                  green(OLD_WIDTH);
+    wxImage image(OLD_WIDTH, 1);
+    for ( int x = 0; x < OLD_WIDTH; x++ )
+    {
+        red[x] = (255 * x) / (OLD_WIDTH - 1);
+        green[x] = x % 2 ? 255 : 0;
+        image.SetRGB(x, 0, red[x], green[x], 0);
+    }
+
+    const wxImage scaled = image.Scale(NEW_WIDTH, 1, wxIMAGE_QUALITY_LANCZOS);
+    for ( int x = 0; x < NEW_WIDTH; x++ )
+    {
+        INFO("Pixel " << x);
+        CHECK( abs(scaled.GetRed(x, 0) -
+                   wxRound(LanczosDownscaleExact(red, NEW_WIDTH, x))) <= 1 );
+        CHECK( abs(scaled.GetGreen(x, 0) -
+                   wxRound(LanczosDownscaleExact(green, NEW_WIDTH, x))) <= 1 );
+    }
+}
+
+static bool AreImagesIdentical(const wxImage& image1, const wxImage& image2)
+{
+    if ( image1.GetSize() != image2.GetSize() ||
+            image1.HasAlpha() != image2.HasAlpha() )
+        return false;
+
+    const size_t size = image1.GetWidth()*image1.GetHeight();
+    if ( memcmp(image1.GetData(), image2.GetData(), size*3) != 0 )
+        return false;
+
+    return !image1.HasAlpha() ||
+                memcmp(image1.GetAlpha(), image2.GetAlpha(), size) == 0;
+}
+
+// Change the maximal number of threads used for image processing and restore
+// it on scope exit, even if the test using it fails.
+class MaxProcessingThreadsChanger
+{
+public:
+    explicit MaxProcessingThreadsChanger(int count)
+        : m_countOld(wxImage::GetMaxProcessingThreads())
+    {
+        wxImage::SetMaxProcessingThreads(count);
+    }
+
+    ~MaxProcessingThreadsChanger()
+    {
+        wxImage::SetMaxProcessingThreads(m_countOld);
+    }
+
+private:
+    const int m_countOld;
+
+    wxDECLARE_NO_COPY_CLASS(MaxProcessingThreadsChanger);
+};
+
+TEST_CASE("wxImage::SetMaxProcessingThreads", "[image][thread]")
+{
+    wxImage original;
+    REQUIRE( original.LoadFile("horse.png") );
+
+    // Make the image big enough to be split into several bands of rows.
+    wxImage image = original.Scale(1024, 1024);
+    if ( !image.HasAlpha() )
+        image.InitAlpha();
+
+    REQUIRE( wxImage::GetMaxProcessingThreads() == 1 );
+
+    const wxImage blurred = image.Blur(5);
+    const wxImage rotated = image.Rotate(0.3, wxPoint(100, 200));
+    const wxImage rotatedInterp = image.Rotate(-1.2, wxPoint(0, 0), true);
+    const wxImage grey = image.ConvertToGreyscale();
+    wxImage hue = image.Copy();
+    hue.RotateHue(0.4);
+
+    MaxProcessingThreadsChanger change(4);
+
+    CHECK( AreImagesIdentical(image.Blur(5), blurred) );
+    CHECK( AreImagesIdentical(image.Rotate(0.3, wxPoint(100, 200)), rotated) );
+    CHECK( AreImagesIdentical(image.Rotate(-1.2, wxPoint(0, 0), true),
+                              rotatedInterp) );
+    CHECK( AreImagesIdentical(image.ConvertToGreyscale(), grey) );
+
+    wxImage hueParallel = image.Copy();
+    hueParallel.RotateHue(0.4);
+    CHECK( AreImagesIdentical(hueParallel, hue) );
+}
+
 #endif //wxUSE_IMAGE
 
 
@@ -21,6 +21,8 @@
 #endif // WX_PRECOMP
 
 #include "wx/intl.h"
+#include "wx/scopedptr.h"
+#include "wx/translation.h"
 
 #if wxUSE_INTL
 
@@ -220,4 +222,57 @@ void IntlTestCase::IsAvailable()
     CPPUNIT_ASSERT_EQUAL( origLocale, setlocale(LC_ALL, NULL) );
 }
 
+TEST_CASE("wxMsgCatalog::LoadOnDemand", "[intl][translations]")
+{
+    static const char* const files[] =
+    {
+        "intl/fr/internat.mo",
+        "intl/ja/internat.mo",
+    };
+
+    static const char* const strings[] =
+    {
+        "",
+        "&Open bogus file",
+        "Enter your number:",
+        "Result",
+        "You've probably entered an invalid number.",
+        "Nonexistent string",
+    };
+
+    for ( size_t n = 0; n < WXSIZEOF(files); n++ )
+    {
+        INFO("Catalog " << files[n]);
+
+        wxScopedPtr<wxMsgCatalog>
+            cat(wxMsgCatalog::CreateFromFile(files[n], "internat"));
+        REQUIRE( cat );
+
+        wxScopedPtr<wxMsgCatalog>
+            catOnDemand(wxMsgCatalog::CreateFromFile(files[n], "internat",
+                                                     wxMsgCatalog::Load_OnDemand));
+        REQUIRE( catOnDemand );
+
+        for ( size_t m = 0; m < WXSIZEOF(strings); m++ )
+        {
+            INFO("String \"" << strings[m] << "\"");
+
+            const wxString* const trans = cat->GetString(strings[m]);
+            const wxString* const transOnDemand = catOnDemand->GetString(strings[m]);
+            if ( trans )
+            {
+                REQUIRE( transOnDemand );
+                CHECK( *transOnDemand == *trans );
+
+                // the same string must be returned when it's requested again
+                CHECK( catOnDemand->GetString(strings[m]) == transOnDemand );
+            }
+            else
+            {
+                CHECK( !transOnDemand );
+            }
+        }
+    }
+}
+
 #endif // wxUSE_INTL
@@ -1509,3 +1509,65 @@ TEST_CASE("wxMBConv::cMB2WC", "[mbconv][mb2wc]")
     CHECK( wxConvUTF7.cMB2WC(wxCharBuffer()).length() == 0 );
     CHECK( wxConvUTF7.cMB2WC("+AKM-").length() == 1 );
 }
+
+TEST_CASE("wxMBConvStrictUTF8::ASCII", "[mbconv][utf8]")
+{
+    // Check that strings of all lengths are converted correctly whether or
+    // not they contain non-ASCII characters and wherever they are, as long
+    // runs of ASCII characters are handled specially.
+    for ( size_t len = 0; len < 40; len++ )
+    {
+        for ( size_t pos = 0; pos <= len; pos++ )
+        {
+            INFO("Length " << len << ", non-ASCII character at " << pos);
+
+            wxString str;
+            for ( size_t n = 0; n < len; n++ )
+                str += n == pos ? wxUniChar(0xe9) : wxUniChar('a' + n % 26);
+
+            const wxScopedCharBuffer utf8 = str.utf8_str();
+            const wxWCharBuffer wide(str.wc_str());
+
+            wxWCharBuffer wbuf(wide.length());
+            CHECK( wxConvUTF8.ToWChar(wbuf.data(), wide.length(),
+                                      utf8.data(), utf8.length())
+                    == wide.length() );
+            CHECK( wxConvUTF8.ToWChar(NULL, 0, utf8.data(), utf8.length())
+                    == wide.length() );
+            CHECK( memcmp(wbuf.data(), wide.data(),
+                          wide.length()*sizeof(wchar_t)) == 0 );
+
+            wxCharBuffer buf(utf8.length());
+            CHECK( wxConvUTF8.FromWChar(buf.data(), utf8.length(),
+                                        wide.data(), wide.length())
+                    == utf8.length() );
+            CHECK( wxConvUTF8.FromWChar(NULL, 0, wide.data(), wide.length())
+                    == utf8.length() );
+            CHECK( memcmp(buf.data(), utf8.data(), utf8.length()) == 0 );
+
+            // also check that not enough space in the output buffer is
+            // detected correctly (notice that 0 size is special as it means
+            // that only the required size should be computed)
+            if ( len > 1 )
+            {
+                CHECK( wxConvUTF8.ToWChar(wbuf.data(), wide.length() - 1,
+                                          utf8.data(), utf8.length())
+                        == wxCONV_FAILED );
+                CHECK( wxConvUTF8.FromWChar(buf.data(), utf8.length() - 1,
+                                            wide.data(), wide.length())
+                        == wxCONV_FAILED );
+            }
+
+            // and that invalid bytes are still detected anywhere
+            if ( pos < len )
+            {
+                wxCharBuffer invalid(str.utf8_str());
+                invalid.data()[pos] = '\x80';
+                CHECK( wxConvUTF8.ToWChar(NULL, 0, invalid.data(), len + 1)
+                        == wxCONV_FAILED );
+                CHECK( wxConvUTF8.ToWChar(NULL, 0, invalid.data())
+                        == wxCONV_FAILED );
+            }
+        }
+    }
+}
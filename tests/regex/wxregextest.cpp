@@ -234,6 +234,20 @@ Test *wxRegExTestSuite::suite()
         "Fri Jul 13 18:37:52 CEST 2001",
         "Fri Jul 13 18:37:52 CEST 2001\tFri\tJul\t13\t2001");
 
+    // Match tests for expressions starting with a literal prefix
+    suite->add("bar", "foobar", "bar");
+    suite->add("bar", "foobaz");
+    suite->add("bar", "ba");
+    suite->add("a(b+)c", "xabxabbc", "abbc\tbb");
+    suite->add("ab*c", "abxac", "ac");
+    suite->add("ab{2}", "abab abb", "abb");
+    suite->add("ab\\{2\\}", "abab abb", "abb", wxRE_BASIC);
+    suite->add("ab|c", "xc", "c");
+    suite->add("foo$", "foo foo", "foo");
+    suite->add("foo^", "xfoo");
+    suite->add("bar", "BAR", "BAR", wxRE_ICASE);
+    suite->add("a\nb", "a\na\nb", "a\nb", wxRE_NEWLINE);
+
     // Replace tests
     // pattern, text, replacement, expected result and number of matches
     const char *patn = "([a-z]+)[^0-9]*([0-9]+)";
@@ -245,6 +259,8 @@ Test *wxRegExTestSuite::suite()
     suite->add(patn, "123foo456foo", "\\0\\0", "123foo456foo456foo", 1);
     suite->add(patn, "foo123foo123", "bar", "barbar", 2);
     suite->add(patn, "foo123_foo456_foo789", "bar", "bar_bar_bar", 3);
+    suite->add("foo", "foo_foo_fo", "bar", "bar_bar_fo", 2);
+    suite->add("f(o+)", "fo_foo", "\\1", "o_oo", 2);
 
     return suite;
 }
@@ -335,4 +351,120 @@ CPPUNIT_TEST_SUITE_REGISTRATION(wxRegExTestSuite);
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(wxRegExTestSuite, "wxRegExTestSuite");
 
 
+TEST_CASE("wxRegEx::Iterator", "[regex]")
+{
+    wxRegEx re("([a-z]+)@([a-z]+)\\.com");
+    REQUIRE( re.IsValid() );
+
+    const wxString text = "foo@bar.com, baz@qux.com, nobody";
+
+    wxRegExIterator it(re, text);
+    size_t start, len;
+
+    REQUIRE( it.FindNext() );
+    CHECK( it.GetMatch() == "foo@bar.com" );
+    CHECK( it.GetMatch(1) == "foo" );
+    CHECK( it.GetMatch(2) == "bar" );
+    CHECK( it.GetMatch(&start, &len) );
+    CHECK( start == 0 );
+    CHECK( len == 11 );
+
+    REQUIRE( it.FindNext() );
+    CHECK( it.GetMatch() == "baz@qux.com" );
+    CHECK( it.GetMatch(&start, &len, 2) );
+    CHECK( start == 17 );
+    CHECK( len == 3 );
+
+    CHECK( !it.FindNext() );
+    CHECK( !it.FindNext() );
+
+    SECTION("Anchors")
+    {
+        wxRegEx reLine("^[a-z]+$", wxRE_NEWLINE);
+        wxRegExIterator itLine(reLine, "one\ntwo\n3\nfour");
+
+        wxString words;
+        while ( itLine.FindNext() )
+            words << itLine.GetMatch() << ' ';
+
+        CHECK( words == "one two four " );
+
+        wxRegExIterator itNotBOL(reLine, "one\ntwo", wxRE_NOTEOL);
+        REQUIRE( itNotBOL.FindNext() );
+        CHECK( itNotBOL.GetMatch() == "one" );
+        CHECK( !itNotBOL.FindNext() );
+    }
+
+    SECTION("Empty")
+    {
+        wxRegEx reEmpty("x*");
+        wxRegExIterator itEmpty(reEmpty, "axxb");
+
+        wxString matches;
+        while ( itEmpty.FindNext() )
+            matches << '[' << itEmpty.GetMatch() << ']';
+
+        CHECK( matches == "[][xx][][]" );
+    }
+
+    SECTION("Literal")
+    {
+        static const size_t starts[] = { 0, 3, 5 };
+
+        wxRegEx reLiteral("ab");
+        wxRegExIterator itLiteral(reLiteral, "abcabab");
+
+        size_t count = 0;
+        while ( itLiteral.FindNext() )
+        {
+            REQUIRE( count < WXSIZEOF(starts) );
+            CHECK( itLiteral.GetMatch(&start, &len) );
+            CHECK( start == starts[count] );
+            CHECK( len == 2 );
+            count++;
+        }
+
+        CHECK( count == WXSIZEOF(starts) );
+    }
+}
+
+TEST_CASE("wxRegEx::Cache", "[regex]")
+{
+    // the same expressions compiled with different flags must be different
+    wxRegEx re1("abc", wxRE_ICASE);
+    wxRegEx re2("abc");
+    CHECK( re1.Matches("ABC") );
+    CHECK( !re2.Matches("ABC") );
+
+    // and objects sharing the same compiled expression must still have their
+    // own matches
+    wxRegEx re3("a(b)c");
+    wxRegEx re4("a(b)c");
+    REQUIRE( re3.Matches("abc") );
+    REQUIRE( re4.Matches("xxabc") );
+
+    size_t start;
+    CHECK( re3.GetMatch(&start, NULL, 1) );
+    CHECK( start == 1 );
+    CHECK( re4.GetMatch(&start, NULL, 1) );
+    CHECK( start == 3 );
+
+    // expressions still in use remain valid when the cache is cleared
+    wxRegEx::SetCacheSize(0);
+    CHECK( re3.Matches("abc") );
+
+    wxRegEx re5("a(b)c");
+    CHECK( re5.Matches("abc") );
+
+    wxRegEx::SetCacheSize(128);
+
+    // invalid expressions are not cached
+    {
+        wxLogNull noLog;
+        CHECK( !wxRegEx("a(b").IsValid() );
+        CHECK( !wxRegEx("a(b").IsValid() );
+    }
+}
+
+
 #endif // wxUSE_REGEX
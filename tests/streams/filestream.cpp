@@ -22,6 +22,7 @@
 #include "wx/wfstream.h"
 
 #include "bstream.h"
+#include "testfile.h"
 
 #define DATABUFFER_SIZE     1024
 
@@ -147,3 +148,41 @@ wxString fileStream::GetInFileName() const
 // Register the stream sub suite, by using some stream helper macro.
 // Note: Don't forget to connect it to the base suite (See: bstream.cpp => StreamCase::suite())
 STREAM_TEST_SUBSUITE_NAMED_REGISTRATION(fileStream)
+
+// ----------------------------------------------------------------------------
+// wxMappedFileInputStream
+// ----------------------------------------------------------------------------
+
+TEST_CASE("wxMappedFileInputStream", "[stream][file][mapped]")
+{
+    TestFile tf;
+
+    {
+        wxFileOutputStream out(tf.GetName());
+        REQUIRE( out.IsOk() );
+        out.Write("0123456789", 10);
+    }
+
+    wxMappedFileInputStream in(tf.GetName());
+    REQUIRE( in.IsOk() );
+    CHECK( in.GetLength() == 10 );
+    CHECK( in.IsSeekable() );
+
+    // The data is accessible directly, without reading it.
+    REQUIRE( in.GetData() );
+    CHECK( memcmp(in.GetData(), "0123456789", 10) == 0 );
+
+    char buf[4];
+    CHECK( in.Read(buf, 3).LastRead() == 3 );
+    CHECK( memcmp(buf, "012", 3) == 0 );
+
+    CHECK( in.SeekI(7) == 7 );
+    CHECK( in.Read(buf, sizeof(buf)).LastRead() == 3 );
+    CHECK( memcmp(buf, "789", 3) == 0 );
+    CHECK( in.Read(buf, 1).LastRead() == 0 );
+    CHECK( in.Eof() );
+
+    wxLogNull noLog;
+    wxMappedFileInputStream inBad("no-such-file");
+    CHECK( !inBad.IsOk() );
+}
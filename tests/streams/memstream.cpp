@@ -20,6 +20,7 @@
 #endif
 
 #include "wx/mstream.h"
+#include "wx/sstream.h"
 
 #include "bstream.h"
 
@@ -159,3 +160,103 @@ void memStream::Ctor_InFromOut()
 // Register the stream sub suite, by using some stream helper macro.
 // Note: Don't forget to connect it to the base suite (See: bstream.cpp => StreamCase::suite())
 STREAM_TEST_SUBSUITE_NAMED_REGISTRATION(memStream)
+
+// ----------------------------------------------------------------------------
+// PeekData() and Consume() tests
+// ----------------------------------------------------------------------------
+
+// Read the entire stream using PeekData() and Consume() and check that the
+// correct data is returned.
+static void CheckPeekAll(wxInputStream& stream, const char* expected)
+{
+    wxString data;
+    for ( ;; )
+    {
+        size_t size;
+        const void* const p = stream.PeekData(&size);
+        if ( !p )
+        {
+            CHECK( size == 0 );
+            break;
+        }
+
+        REQUIRE( size > 0 );
+
+        // Consume the data in 2 steps to check that this works too.
+        const size_t half = (size + 1) / 2;
+        data += wxString::From8BitData(static_cast<const char*>(p), half);
+        stream.Consume(half);
+        CHECK( stream.LastRead() == half );
+
+        if ( half < size )
+        {
+            size_t sizeRest;
+            const void* const rest = stream.PeekData(&sizeRest);
+            REQUIRE( sizeRest == size - half );
+            CHECK( rest == static_cast<const char*>(p) + half );
+
+            data += wxString::From8BitData(static_cast<const char*>(rest), sizeRest);
+            stream.Consume(sizeRest);
+        }
+    }
+
+    CHECK( data == expected );
+    CHECK( stream.Eof() );
+}
+
+TEST_CASE("wxInputStream::PeekData", "[stream]")
+{
+    const char* const text = "Hello, zero-copy world!";
+    const size_t len = strlen(text);
+
+    SECTION("Memory")
+    {
+        wxMemoryInputStream mis(text, len);
+
+        size_t size;
+        const void* const p = mis.PeekData(&size);
+        CHECK( p == text );
+        CHECK( size == len );
+
+        mis.Consume(7);
+        CHECK( mis.TellI() == 7 );
+        CHECK( mis.GetC() == 'z' );
+
+        CheckPeekAll(mis, "ero-copy world!");
+    }
+
+    SECTION("Buffered")
+    {
+        wxMemoryInputStream mis(text, len);
+        wxBufferedInputStream bis(mis, 8);
+
+        size_t size;
+        REQUIRE( bis.PeekData(&size) );
+        CHECK( size == 8 );
+
+        CheckPeekAll(bis, text);
+    }
+
+    SECTION("Generic")
+    {
+        // This stream doesn't implement DoPeekData() and so uses the default
+        // implementation.
+        wxStringInputStream sis(text);
+
+        CHECK( sis.GetC() == 'H' );
+        CHECK( sis.Ungetch('J') );
+
+        // The data put back must be returned first.
+        size_t size;
+        const void* const p = sis.PeekData(&size);
+        REQUIRE( size == 1 );
+        CHECK( *static_cast<const char*>(p) == 'J' );
+        sis.Consume(1);
+
+        REQUIRE( sis.PeekData(&size) );
+        sis.Consume(4);
+        CHECK( sis.TellI() == 5 );
+
+        CheckPeekAll(sis, ", zero-copy world!");
+    }
+}
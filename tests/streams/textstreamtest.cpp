@@ -327,3 +327,63 @@ TEST_CASE("wxTextInputStream::GetChar", "[text][input][stream][char]")
 }
 
 #endif // wxUSE_UNICODE
+
+TEST_CASE("wxTextInputStream::Seek", "[text][input][stream][seek]")
+{
+    TempFile f("test.txt");
+
+    // Use enough data for wxTextInputStream to read ahead of the position
+    // returned to the caller.
+    {
+        wxFileOutputStream fos(f.GetName());
+        for ( int n = 0; n < 1000; n++ )
+        {
+            const wxCharBuffer line(wxString::Format("Line %04d\n", n).utf8_str());
+            fos.Write(line, line.length());
+        }
+    }
+
+    wxFileInputStream fis(f.GetName());
+    wxTextInputStream tis(fis);
+
+    CHECK( tis.ReadLine() == "Line 0000" );
+    CHECK( fis.TellI() == 10 );
+
+    CHECK( fis.SeekI(10, wxFromCurrent) == 20 );
+    CHECK( fis.TellI() == 20 );
+    CHECK( tis.ReadLine() == "Line 0002" );
+
+    CHECK( fis.SeekI(-20, wxFromCurrent) == 10 );
+    CHECK( tis.ReadLine() == "Line 0001" );
+}
+
+#ifdef __UNIX__
+
+#include "wx/unix/pipe.h"
+#include "wx/unix/private/pipestream.h"
+
+TEST_CASE("wxTextInputStream::Pipe", "[text][input][stream][pipe]")
+{
+    wxPipe pipe;
+    REQUIRE( pipe.Create() );
+
+    // Notice that the write end of the pipe remains open, so trying to read
+    // more data than was written into it would block.
+    const char* const text = "first\nsecond\n";
+    const ssize_t len = strlen(text);
+    REQUIRE( write(pipe[wxPipe::Write], text, len) == len );
+
+    wxPipeInputStream in(pipe.Detach(wxPipe::Read));
+    wxTextInputStream tis(in);
+
+    CHECK( tis.ReadLine() == "first" );
+
+    // The rest of the data must still be available, this is used by
+    // wxProcess::IsInputAvailable() to decide whether to read more.
+    CHECK( in.CanRead() );
+
+    CHECK( tis.ReadLine() == "second" );
+    CHECK( !in.CanRead() );
+}
+
+#endif // __UNIX__
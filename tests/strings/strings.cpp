@@ -20,6 +20,8 @@
     #include "wx/wx.h"
 #endif // WX_PRECOMP
 
+#include "wx/ustring.h"
+
 // ----------------------------------------------------------------------------
 // test class
 // ----------------------------------------------------------------------------
@@ -1316,3 +1318,166 @@ void StringTestCase::SupplementaryUniChar()
     */
 #endif
 }
+
+// Return the character expected at the given position in the long string
+// used by the test below: a mix of 1, 2 and 3 byte characters in UTF-8.
+static wxUniChar GetLongStringChar(size_t n)
+{
+    switch ( n % 3 )
+    {
+        case 0:
+            return wxUniChar(static_cast<int>('a' + n % 26));
+
+        case 1:
+            return wxUniChar(static_cast<int>(0x430 + n % 32));
+    }
+
+    return wxUniChar(static_cast<int>(0x4e00 + n % 100));
+}
+
+TEST_CASE("wxString::IndexLong", "[string][index]")
+{
+    // long strings are indexed in UTF-8 build, check that this works
+    static const size_t LEN = 10000;
+
+    wxString s;
+    for ( size_t n = 0; n < LEN; n++ )
+        s += GetLongStringChar(n);
+
+    REQUIRE( s.length() == LEN );
+
+    const wxString& cs = s;
+    // access the string backwards to prevent the position cache from helping
+    for ( size_t n = LEN - 1; n >= 37; n -= 37 )
+    {
+        INFO("Position " << n);
+        CHECK( cs[n] == GetLongStringChar(n) );
+    }
+
+    CHECK( cs[0] == GetLongStringChar(0) );
+    CHECK( cs.Mid(LEN - 200, 100) == s.substr(LEN - 200, 100) );
+    CHECK( cs.Mid(LEN - 50, 100).length() == 50 );
+    CHECK( cs.find(GetLongStringChar(4321), 4300) == 4321 );
+
+    // changing a character to another one of different size in UTF-8 must
+    // invalidate the index
+    s[10] = 'x';
+    CHECK( cs[9000] == GetLongStringChar(9000) );
+    CHECK( cs[10] == 'x' );
+
+    s[21] = wxUniChar(0x4e00);
+    CHECK( cs[9000] == GetLongStringChar(9000) );
+
+    s.erase(0, 3);
+    CHECK( s.length() == LEN - 3 );
+    CHECK( cs[8997] == GetLongStringChar(9000) );
+
+    s.insert(0, "abc");
+    s += wxUniChar(0x430);
+    CHECK( s.length() == LEN + 1 );
+    CHECK( cs[LEN] == wxUniChar(0x430) );
+    CHECK( cs[LEN - 1] == GetLongStringChar(LEN - 1) );
+
+    // copies of an indexed string must work too
+    wxString copy(s);
+    CHECK( copy[5000] == GetLongStringChar(5000) );
+
+    wxString assigned;
+    assigned = s;
+    assigned.swap(copy);
+    CHECK( assigned[LEN] == wxUniChar(0x430) );
+
+    // check that an ASCII string remains usable after becoming non-ASCII
+    wxString ascii('x', LEN);
+    ascii += 'y';
+    CHECK( ascii[LEN] == 'y' );
+
+    ascii[0] = wxUniChar(0x4e00);
+    CHECK( ascii[LEN] == 'y' );
+    CHECK( ascii.length() == LEN + 1 );
+}
+
+#ifdef wxHAS_RVALUE_REF
+
+TEST_CASE("wxString::Move", "[string][move]")
+{
+    // use a string long enough to not fit into any small string buffer, so
+    // that we can check that its data is not copied by comparing pointers
+    const wxString orig(wxT('x'), 100);
+
+    wxString s1(orig);
+    const wxStringCharType* const data = s1.wx_str();
+
+    wxString s2(std::move(s1));
+    CHECK( s2 == orig );
+    CHECK( s2.wx_str() == data );
+    CHECK( s1.empty() );
+
+    s1 = "Something to free";
+    s1 = std::move(s2);
+    CHECK( s1 == orig );
+    CHECK( s1.wx_str() == data );
+    CHECK( s2.empty() );
+
+    // self-assignment must work too
+    wxString& ref = s1;
+    s1 = std::move(ref);
+    CHECK( s1 == orig );
+
+    // concatenation with a temporary string should reuse its buffer
+    s1.reserve(300);
+    const wxStringCharType* const data2 = s1.wx_str();
+    const wxString sum = std::move(s1) + "abc" + orig + 'd' + wxString("e");
+    CHECK( sum == orig + "abc" + orig + "de" );
+    CHECK( sum.wx_str() == data2 );
+
+    // concatenating a temporary with wxUString must still compile
+    const wxUString usum = wxString("abc") + wxUString("def");
+    CHECK( usum == wxUString("abcdef") );
+}
+
+#endif // wxHAS_RVALUE_REF
+
+TEST_CASE("wxStringBuilder", "[string][builder]")
+{
+    wxStringBuilder builder;
+    CHECK( builder.IsEmpty() );
+    CHECK( builder.ToString().empty() );
+
+    builder << "Hello" << wxT(',') << ' ' << wxString("world") << L'!';
+    CHECK( !builder.IsEmpty() );
+    CHECK( builder.ToString() == "Hello, world!" );
+
+    builder.Clear();
+    CHECK( builder.IsEmpty() );
+
+    builder << 0 << ' ' << -17 << ' ' << 42u << ' '
+            << LONG_MIN << ' ' << ULONG_MAX << ' ' << 1.5;
+    CHECK( builder.ToString() == wxString::Format("0 -17 42 %ld %lu 1.5",
+                                                  LONG_MIN, ULONG_MAX) );
+
+    builder.Clear();
+    builder << wxUniChar(0x439) << wxUniChar(0x1F600);
+    CHECK( builder.ToString() == wxString::FromUTF8("\xd0\xb9\xf0\x9f\x98\x80") );
+
+    // check that switching from the internal buffer to the heap works
+    builder.Clear();
+
+    wxString expected;
+    for ( int n = 0; n < 1000; n++ )
+    {
+        builder << n << ',';
+        expected << n << ',';
+    }
+
+    CHECK( builder.ToString() == expected );
+
+    const wxString released = builder.Release();
+    CHECK( released == expected );
+    CHECK( builder.IsEmpty() );
+    CHECK( builder.Release().empty() );
+
+    builder.Reserve(1000);
+    builder << "Reserved";
+    CHECK( builder.Release() == "Reserved" );
+}
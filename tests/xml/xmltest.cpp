@@ -613,3 +613,348 @@ void XmlTestCase::Doctype()
     dt = wxXmlDoctype( "root", "O'Reilly (\"editor\")", "Public-ID" );
     CPPUNIT_ASSERT( !dt.IsValid() );
 }
+
+// ----------------------------------------------------------------------------
+// wxXmlReader test
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Reader logging all the events in a string.
+class LogXmlReader : public wxXmlReader
+{
+public:
+    LogXmlReader() { }
+
+    wxString m_log;
+    wxString m_subtreeElement;
+    wxString m_stopElement;
+
+protected:
+    virtual void OnStartElement(const wxString& name) wxOVERRIDE
+    {
+        m_log << "<" << name;
+        for ( size_t n = 0; n < GetAttributeCount(); n++ )
+            m_log << " " << GetAttributeName(n) << "=" << GetAttributeValue(n);
+        m_log << "@" << GetDepth() << ">";
+
+        if ( name == m_subtreeElement )
+            ReadSubtree();
+
+        if ( name == m_stopElement )
+            Stop();
+    }
+
+    virtual void OnEndElement(const wxString& name) wxOVERRIDE
+    {
+        m_log << "</" << name << "@" << GetDepth() << ">";
+    }
+
+    virtual void OnText(const wxString& text) wxOVERRIDE
+    {
+        m_log << "[" << text << "]";
+    }
+
+    virtual void OnCData(const wxString& text) wxOVERRIDE
+    {
+        m_log << "{" << text << "}";
+    }
+
+    virtual void OnComment(const wxString& comment) wxOVERRIDE
+    {
+        m_log << "#" << comment;
+    }
+
+    virtual void OnProcessingInstruction(const wxString& target,
+                                         const wxString& data) wxOVERRIDE
+    {
+        m_log << "?" << target << " " << data;
+    }
+
+    virtual void OnSubtree(wxXmlNode *node) wxOVERRIDE
+    {
+        wxScopedPtr<wxXmlNode> ptr(node);
+
+        CHECK( node->GetParent() == NULL );
+        CHECK( node->GetNext() == NULL );
+
+        m_log << "(" << node->GetName() << " " << node->GetAttribute("a")
+              << " " << node->GetNodeContent() << ")";
+    }
+};
+
+} // anon namespace
+
+TEST_CASE("wxXmlReader", "[xml][reader]")
+{
+    const char *xmlText =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<root a=\"1\" b=\"x &amp; y\">\n"
+        "  <!--comment-->\n"
+        "  <item a=\"2\">Some text &lt;here&gt;</item>\n"
+        "  <item a=\"3\"><sub>deep</sub><![CDATA[<cdata>]]></item>\n"
+        "  <?pi data?>\n"
+        "  <last/>\n"
+        "</root>\n"
+    ;
+
+    LogXmlReader reader;
+
+    SECTION("Events")
+    {
+        wxStringInputStream sis(xmlText);
+        REQUIRE( reader.Parse(sis) );
+        CHECK( reader.m_log ==
+                "<root a=1 b=x & y@1>"
+                "#comment"
+                "<item a=2@2>[Some text <here>]</item@2>"
+                "<item a=3@2><sub@3>[deep]</sub@3>{<cdata>}</item@2>"
+                "?pi data"
+                "<last@2></last@2>"
+                "</root@1>" );
+    }
+
+    SECTION("Whitespace")
+    {
+        wxStringInputStream sis("<root> <a/> x </root>");
+        REQUIRE( reader.Parse(sis, wxXMLDOC_KEEP_WHITESPACE_NODES) );
+        CHECK( reader.m_log == "<root@1>[ ]<a@2></a@2>[ x ]</root@1>" );
+    }
+
+    SECTION("Subtree")
+    {
+        reader.m_subtreeElement = "item";
+
+        wxStringInputStream sis(xmlText);
+        REQUIRE( reader.Parse(sis) );
+        CHECK( reader.m_log ==
+                "<root a=1 b=x & y@1>"
+                "#comment"
+                "<item a=2@2>(item 2 Some text <here>)"
+                "<item a=3@2>(item 3 <cdata>)"
+                "?pi data"
+                "<last@2></last@2>"
+                "</root@1>" );
+    }
+
+    SECTION("Stop")
+    {
+        reader.m_stopElement = "item";
+
+        wxStringInputStream sis(xmlText);
+        REQUIRE( reader.Parse(sis) );
+        CHECK( reader.m_log == "<root a=1 b=x & y@1>#comment<item a=2@2>" );
+    }
+
+    SECTION("Error")
+    {
+        wxLogNull noLog;
+
+        wxStringInputStream sis("<root><unclosed></root>");
+        CHECK( !reader.Parse(sis) );
+    }
+}
+
+TEST_CASE("wxXmlDocument::Arena", "[xml][arena]")
+{
+    const char *xmlText =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<!-- prolog comment -->\n"
+        "<root a=\"1\" b=\"x &amp; y\">\n"
+        "  <item a=\"2\">Some text</item>\n"
+        "  <item a=\"3\"><![CDATA[<cdata>]]></item>\n"
+        "  <?pi data?>\n"
+        "  <last/>\n"
+        "</root>\n"
+    ;
+
+    wxScopedPtr<wxXmlDocument> doc(new wxXmlDocument);
+    wxStringInputStream sis(xmlText);
+    REQUIRE( doc->Load(sis, "UTF-8", wxXMLDOC_USE_ARENA) );
+
+    // The document must be the same as when loading it without the arena.
+    wxXmlDocument docHeap;
+    wxStringInputStream sisHeap(xmlText);
+    REQUIRE( docHeap.Load(sisHeap) );
+
+    wxStringOutputStream sos, sosHeap;
+    REQUIRE( doc->Save(sos) );
+    REQUIRE( docHeap.Save(sosHeap) );
+    CHECK( sos.GetString() == sosHeap.GetString() );
+
+    wxXmlNode* const root = doc->GetRoot();
+    REQUIRE( root );
+    CHECK( root->GetName() == "root" );
+    CHECK( root->GetAttribute("b") == "x & y" );
+
+    wxXmlNode* const item1 = root->GetChildren();
+    REQUIRE( item1 );
+    wxXmlNode* const item2 = item1->GetNext();
+    REQUIRE( item2 );
+
+    // The names are stored only once.
+    CHECK( &item1->GetName() == &item2->GetName() );
+    CHECK( &item1->GetAttributes()->GetName() ==
+                &item2->GetAttributes()->GetName() );
+
+    SECTION("Modify")
+    {
+        item1->SetName("first");
+        CHECK( item1->GetName() == "first" );
+        CHECK( item2->GetName() == "item" );
+
+        item1->AddAttribute("new", "attr");
+        CHECK( item1->DeleteAttribute("a") );
+        CHECK( item1->GetAttribute("new") == "attr" );
+
+        REQUIRE( root->RemoveChild(item2) );
+        delete item2;
+
+        root->AddChild(new wxXmlNode(wxXML_ELEMENT_NODE, "heap"));
+
+        // The other forms of new must still be usable with these classes.
+        wxXmlNode* const
+            nothrow = new(std::nothrow) wxXmlNode(wxXML_ELEMENT_NODE, "nothrow");
+        REQUIRE( nothrow );
+        nothrow->AddAttribute(new(std::nothrow) wxXmlAttribute("x", "y"));
+        root->AddChild(nothrow);
+
+        wxStringOutputStream sos2;
+        REQUIRE( doc->Save(sos2) );
+        CHECK( sos2.GetString() ==
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<!-- prolog comment -->\n"
+            "<root a=\"1\" b=\"x &amp; y\">\n"
+            "  <first new=\"attr\">Some text</first>\n"
+            "  <?pi data?>\n"
+            "  <last/>\n"
+            "  <heap/>\n"
+            "  <nothrow x=\"y\"/>\n"
+            "</root>\n"
+        );
+    }
+
+    SECTION("Detach")
+    {
+        // The nodes must remain valid after the document is destroyed.
+        wxScopedPtr<wxXmlNode> detached(doc->DetachRoot());
+        wxScopedPtr<wxXmlNode> copy(new wxXmlNode(*item2));
+        wxXmlAttribute attr(*item2->GetAttributes());
+        doc.reset();
+
+        CHECK( detached->GetName() == "root" );
+        CHECK( detached->GetAttribute("a") == "1" );
+        CHECK( item1->GetNodeContent() == "Some text" );
+
+        CHECK( copy->GetName() == "item" );
+        CHECK( copy->GetAttribute("a") == "3" );
+        CHECK( copy->GetNodeContent() == "<cdata>" );
+
+        detached.reset();
+
+        CHECK( copy->GetName() == "item" );
+        CHECK( attr.GetName() == "a" );
+        CHECK( attr.GetValue() == "3" );
+    }
+
+    SECTION("Error")
+    {
+        wxLogNull noLog;
+
+        wxStringInputStream sisBad("<root><item></root>");
+        CHECK( !doc->Load(sisBad, "UTF-8", wxXMLDOC_USE_ARENA) );
+    }
+}
+
+TEST_CASE("wxXmlWriter", "[xml][writer]")
+{
+    wxStringOutputStream sos;
+
+    SECTION("Document")
+    {
+        wxXmlWriter writer(sos);
+        CHECK( writer.WriteDeclaration() );
+        CHECK( writer.WriteComment(" prolog ") );
+
+        CHECK( writer.StartElement("root") );
+        CHECK( writer.WriteAttribute("a", "1 & \"2\"") );
+        CHECK( writer.GetDepth() == 1 );
+
+        CHECK( writer.StartElement("item") );
+        CHECK( writer.WriteText("Some <text>") );
+        CHECK( writer.EndElement() );
+
+        CHECK( writer.StartElement("empty") );
+        CHECK( writer.EndElement() );
+
+        CHECK( writer.WriteCData("<cdata>") );
+        CHECK( writer.WriteProcessingInstruction("pi", "data") );
+
+        wxXmlNode node(wxXML_ELEMENT_NODE, "node");
+        node.AddAttribute("x", "y");
+        node.AddChild(new wxXmlNode(wxXML_ELEMENT_NODE, "sub"));
+        CHECK( writer.WriteNode(&node) );
+
+        CHECK( writer.EndElement() );
+        CHECK( writer.GetDepth() == 0 );
+        CHECK( writer.Flush() );
+
+        CHECK( sos.GetString() ==
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<!-- prolog -->\n"
+            "<root a=\"1 &amp; &quot;2&quot;\">\n"
+            "  <item>Some &lt;text&gt;</item>\n"
+            "  <empty/>\n"
+            "  <![CDATA[<cdata>]]>\n"
+            "  <?pi data?>\n"
+            "  <node x=\"y\">\n"
+            "    <sub/>\n"
+            "  </node>\n"
+            "</root>\n"
+        );
+    }
+
+    SECTION("NoIndentation")
+    {
+        wxXmlWriter writer(sos, wxXML_NO_INDENTATION);
+        writer.SetFileType(wxTextFileType_Dos);
+        CHECK( writer.StartElement("root") );
+        CHECK( writer.WriteText(wxString::FromUTF8("\xc3\xa9t\xc3\xa9\n")) );
+        CHECK( writer.StartElement("sub") );
+        CHECK( writer.WriteAttribute("a", "\tb\n") );
+        CHECK( writer.EndElement() );
+        CHECK( writer.EndElement() );
+        CHECK( writer.Flush() );
+
+        CHECK( sos.GetString() ==
+            wxString::FromUTF8("<root>\xc3\xa9t\xc3\xa9\n<sub a=\"&#x9;b&#xA;\"/></root>\r\n")
+        );
+    }
+
+    SECTION("Save")
+    {
+        // Saving the document must be the same as writing its nodes.
+        const char *xmlText =
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<root a=\"1\">\n"
+            "  <item>Text &amp; more</item>\n"
+            "  <!--comment-->\n"
+            "  <item/>\n"
+            "</root>\n"
+        ;
+
+        wxStringInputStream sis(xmlText);
+        wxXmlDocument doc;
+        REQUIRE( doc.Load(sis) );
+        REQUIRE( doc.Save(sos) );
+        CHECK( sos.GetString() == xmlText );
+
+        wxStringOutputStream sos2;
+        wxXmlWriter writer(sos2);
+        CHECK( writer.WriteDeclaration() );
+        CHECK( writer.WriteNode(doc.GetRoot()) );
+        CHECK( writer.Flush() );
+        CHECK( sos2.GetString() == xmlText );
+    }
+}